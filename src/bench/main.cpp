@@ -0,0 +1,670 @@
+#include "../common.h"
+#include "../config.h"
+#include "../emu.h"
+#include "../vm/event.h"
+#include "../vm/fmgen/fmlanes.h"
+#include "../vm/fmgen/opm.h"
+#include "../vm/fmgen/opna.h"
+#include "../vm/pc8801/bitplane.h"
+#include "../vm/resampler.h"
+#include "../vm/z80.h"
+#ifdef USE_DEBUGGER
+#include "../vm/debugger.h"
+#endif
+#include "osd.h"
+#include <SDL3/SDL.h>
+#include <vector>
+
+// Headless benchmark entry point.
+// Runs the VM as fast as possible for a fixed number of frames and reports
+// emulated frames/sec, effective Z80 clock and wall time.
+// With --z80, runs only a Z80 core on flat RAM to measure the interpreter.
+// With --bitplane, measures the GVRAM plane converters of draw_screen().
+// With --fm, measures the FM channel mixers of fmgen.
+// With --resampler, measures the polyphase resampler of the sound mixer.
+// With --run-ahead, runs frames ahead after every frame and reports the cost.
+
+// Flat 64KB RAM without wait or I/O for the Z80 microbenchmark.
+class BenchMemory : public DEVICE {
+public:
+  uint8_t ram[0x10000];
+  mem_page_t pages[16];
+
+  BenchMemory(VM_TEMPLATE *parent_vm, EMU *parent_emu)
+      : DEVICE(parent_vm, parent_emu) {
+    memset(ram, 0, sizeof(ram));
+    for (int i = 0; i < 16; i++) {
+      pages[i].read = pages[i].write = ram + 0x1000 * i;
+      pages[i].read_wait = pages[i].write_wait = pages[i].fetch_wait = 0;
+      pages[i].slow = false;
+    }
+    set_device_name(_T("Bench Memory"));
+  }
+  void write_data8w(uint32_t addr, uint32_t data, int *wait) {
+    ram[addr & 0xffff] = data;
+    *wait = 0;
+  }
+  uint32_t read_data8w(uint32_t addr, int *wait) {
+    *wait = 0;
+    return ram[addr & 0xffff];
+  }
+  uint32_t fetch_op(uint32_t addr, int *wait) {
+    *wait = 0;
+    return ram[addr & 0xffff];
+  }
+};
+
+// Instruction mix with memory access, prefixed opcodes, stack and branches.
+static const uint8_t z80_bench_program[] = {
+    0x31, 0x00, 0x00,       // 0000 LD   SP,0000h
+    0x21, 0x00, 0x80,       // 0003 LD   HL,8000h
+    0x11, 0x00, 0x90,       // 0006 LD   DE,9000h
+    0xdd, 0x21, 0x00, 0xa0, // 0009 LD   IX,A000h
+    0x06, 0x00,             // 000D LD   B,0
+    0x7e,                   // 000F LD   A,(HL)
+    0x80,                   // 0010 ADD  A,B
+    0x12,                   // 0011 LD   (DE),A
+    0x23,                   // 0012 INC  HL
+    0x13,                   // 0013 INC  DE
+    0xcb, 0x01,             // 0014 RLC  C
+    0xdd, 0x7e, 0x01,       // 0016 LD   A,(IX+1)
+    0xdd, 0x77, 0x02,       // 0019 LD   (IX+2),A
+    0xdd, 0x23,             // 001C INC  IX
+    0xed, 0x52,             // 001E SBC  HL,DE
+    0x19,                   // 0020 ADD  HL,DE
+    0xc5,                   // 0021 PUSH BC
+    0xc1,                   // 0022 POP  BC
+    0xe6, 0x0f,             // 0023 AND  0Fh
+    0x28, 0x00,             // 0025 JR   Z,0027h
+    0xcd, 0x30, 0x00,       // 0027 CALL 0030h
+    0x10, 0xe3,             // 002A DJNZ 000Fh
+    0xc3, 0x03, 0x00,       // 002C JP   0003h
+    0x00,                   // 002F
+    0xc9,                   // 0030 RET
+};
+
+static void run_z80_bench(VM *vm, EMU *emu, int mclocks) {
+  // The devices are appended to the VM and released with it.
+  BenchMemory *mem = new BenchMemory(vm, emu);
+  Z80 *cpu = new Z80(vm, emu);
+  cpu->set_context_mem(mem);
+  cpu->set_context_mem_pages(mem->pages);
+  cpu->set_context_io(mem);
+  cpu->set_context_intr(mem);
+#ifdef USE_DEBUGGER
+  DEBUGGER *debugger = new DEBUGGER(vm, emu);
+  cpu->set_context_debugger(debugger);
+#endif
+  memcpy(mem->ram, z80_bench_program, sizeof(z80_bench_program));
+  cpu->initialize();
+#ifdef USE_DEBUGGER
+  debugger->initialize();
+#endif
+  cpu->reset();
+
+  uint64_t target = (uint64_t)mclocks * 1000000;
+  uint64_t clocks = 0;
+  uint64_t begin = SDL_GetPerformanceCounter();
+  while (clocks < target) {
+    clocks += cpu->run(100000);
+  }
+  uint64_t end = SDL_GetPerformanceCounter();
+
+  double wall = (double)(end - begin) / (double)SDL_GetPerformanceFrequency();
+  if (wall <= 0.0) {
+    wall = 1e-9;
+  }
+  printf("z80 clocks    : %llu\n", (unsigned long long)clocks);
+  printf("wall time     : %.3f s\n", wall);
+  printf("effective z80 : %.3f MHz\n", clocks / wall / 1000000.0);
+}
+
+// Converts random planes of a 640x200 screen line by line with every bitplane
+// converter, and checks that the output is the same as the original code.
+static bool run_bitplane_bench(int frames) {
+  static uint8_t planes[3][80 * 200];
+  static uint8_t color[80 * 200];
+  static bool reverse[80 * 200];
+  static uint8_t expected[3][640 * 200];
+  static uint8_t output[640 * 200];
+
+  srand(1);
+  for (int i = 0; i < 80 * 200; i++) {
+    planes[0][i] = rand() & 0xff;
+    planes[1][i] = rand() & 0xff;
+    planes[2][i] = rand() & 0xff;
+    color[i] = rand() % 9;
+    reverse[i] = (rand() & 3) == 0;
+  }
+
+  auto convert = [&](const bitplane_t *bp, int type, uint8_t *dst) {
+    for (int y = 0; y < 200; y++) {
+      int ofs = 80 * y;
+      if (type == 0) {
+        bp->color(dst + 640 * y, planes[0] + ofs, planes[1] + ofs,
+                  planes[2] + ofs, 80);
+      } else if (type == 1) {
+        bp->mono(dst + 640 * y, planes[0] + ofs, planes[1] + ofs,
+                 planes[2] + ofs, 80);
+      } else {
+        bp->attrib(dst + 640 * y, planes[0] + ofs, planes[1] + ofs,
+                   planes[2] + ofs, color + ofs, reverse + ofs, 80);
+      }
+    }
+  };
+  for (int type = 0; type < 3; type++) {
+    convert(get_bitplane(0), type, expected[type]);
+  }
+
+  bool exact = true;
+  printf("bitplane      : color / mono / attrib usec per frame\n");
+  for (int i = 0; i < get_bitplane_count(); i++) {
+    const bitplane_t *bp = get_bitplane(i);
+    double usec[3];
+    bool same = true;
+    for (int type = 0; type < 3; type++) {
+      memset(output, 0xff, sizeof(output));
+      convert(bp, type, output);
+      same = same && memcmp(output, expected[type], sizeof(output)) == 0;
+
+      uint64_t begin = SDL_GetPerformanceCounter();
+      for (int f = 0; f < frames; f++) {
+        convert(bp, type, output);
+      }
+      uint64_t end = SDL_GetPerformanceCounter();
+      usec[type] = (double)(end - begin) * 1000000.0 /
+                   (double)SDL_GetPerformanceFrequency() / frames;
+    }
+    printf("%-14s: %.2f / %.2f / %.2f%s%s\n", bp->name, usec[0], usec[1],
+           usec[2], (bp == get_best_bitplane()) ? " (selected)" : "",
+           same ? "" : " MISMATCH");
+    exact = exact && same;
+  }
+  return exact;
+}
+
+// One step of a register log for the FM mixers: a register write, or mixing
+// the given number of samples when samples > 0.
+struct fm_log_t {
+  uint16_t addr;
+  uint8_t data;
+  int samples;
+};
+
+enum { FM_OPN, FM_OPNA, FM_OPM };
+static const int fm_rate = 55467;
+
+// Records random voices, keys, F-numbers, LFO and ch3 mode changes for
+// seconds of sound. Blocks shorter than FM::ChannelLanes::MIN_SAMPLES are
+// mixed with Channel4 between them, which checks the lane state written back.
+static void make_fm_log(int type, int seconds, std::vector<fm_log_t> &log) {
+  auto write = [&](int addr, int data) {
+    log.push_back({(uint16_t)addr, (uint8_t)data, 0});
+  };
+  int channels = (type == FM_OPN) ? 3 : (type == FM_OPNA) ? 6 : 8;
+
+  auto voice = [&](int c) {
+    if (type == FM_OPM) {
+      write(0x20 + c, (rand() & 0xff));
+      write(0x38 + c, (rand() & 0x73));
+      for (int s = 0; s < 4; s++) {
+        int ofs = s * 8 + c;
+        write(0x40 + ofs, rand() & 0x7f);
+        write(0x60 + ofs, rand() % 48);
+        write(0x80 + ofs, (rand() & 0xc0) | (16 + rand() % 16));
+        write(0xa0 + ofs, rand() & 0x9f);
+        write(0xc0 + ofs, rand() & 0xdf);
+        write(0xe0 + ofs, rand() & 0xff);
+      }
+    } else {
+      int bank = (c / 3) * 0x100, ofs = bank + c % 3;
+      for (int s = 0; s < 4; s++) {
+        write(0x30 + s * 4 + ofs, rand() & 0x7f);
+        write(0x40 + s * 4 + ofs, rand() % 48);
+        write(0x50 + s * 4 + ofs, (rand() & 0xc0) | (16 + rand() % 16));
+        write(0x60 + s * 4 + ofs, rand() & 0x9f);
+        write(0x70 + s * 4 + ofs, rand() & 0x1f);
+        write(0x80 + s * 4 + ofs, rand() & 0xff);
+        write(0x90 + s * 4 + ofs, (rand() & 3) ? 0 : (0x08 | (rand() & 7)));
+      }
+      write(0xb0 + ofs, rand() & 0x3f);
+      if (type == FM_OPNA) {
+        static const int pan[4] = {0xc0, 0xc0, 0x80, 0x40};
+        write(0xb4 + ofs, pan[rand() & 3] | (rand() & 0x37));
+      }
+    }
+  };
+  auto tone = [&](int c) {
+    if (type == FM_OPM) {
+      write(0x28 + c, rand() & 0x7f);
+      write(0x30 + c, rand() & 0xfc);
+    } else {
+      int ofs = (c / 3) * 0x100 + c % 3;
+      write(0xa4 + ofs, ((2 + rand() % 5) << 3) | (rand() & 7));
+      write(0xa0 + ofs, rand() & 0xff);
+    }
+  };
+  auto key = [&](int c, int slots) {
+    if (type == FM_OPM) {
+      write(0x08, (slots << 3) | c);
+    } else {
+      write(0x28, (slots << 4) | (c < 3 ? c : c + 1));
+    }
+  };
+  auto lfo = [&]() {
+    if (type == FM_OPM) {
+      write(0x01, (rand() & 7) ? 0 : 0x02);
+      write(0x0f, (rand() & 1) ? (0x80 | (rand() & 0x1f)) : 0);
+      write(0x18, rand() & 0xff);
+      write(0x19, rand() & 0xff);
+      write(0x1b, rand() & 3);
+    } else {
+      if (type == FM_OPNA) {
+        write(0x22, (rand() & 1) ? (0x08 | (rand() & 7)) : 0);
+      }
+      write(0x27, (rand() & 3) ? 0 : 0x40);
+      for (int i = 0; i < 3; i++) {
+        write(0xac + i, ((2 + rand() % 5) << 3) | (rand() & 7));
+        write(0xa8 + i, rand() & 0xff);
+      }
+    }
+  };
+
+  if (type == FM_OPNA) {
+    write(0x29, 0x80);
+  }
+  for (int c = 0; c < channels; c++) {
+    voice(c);
+    tone(c);
+    key(c, 15);
+  }
+  lfo();
+  for (int total = 0; total < seconds * fm_rate;) {
+    int c = rand() % channels;
+    switch (rand() & 7) {
+    case 0:
+      voice(c);
+      break;
+    case 1:
+    case 2:
+      tone(c);
+      key(c, 15);
+      break;
+    case 3:
+      key(c, rand() & 15);
+      break;
+    case 4:
+      key(c, 0);
+      break;
+    case 5:
+      tone(c);
+      break;
+    case 6:
+      if ((rand() & 3) == 0) {
+        lfo();
+      }
+      break;
+    }
+    int samples = (rand() & 7) ? 16 + rand() % 300 : 1 + rand() % 15;
+    log.push_back({0, 0, samples});
+    total += samples;
+  }
+}
+
+static void replay_fm_log(int type, const std::vector<fm_log_t> &log,
+                          std::vector<FM::Sample> &output) {
+  FM::OPN opn;
+  FM::OPNA opna;
+  FM::OPM opm;
+  if (type == FM_OPN) {
+    opn.Init(3993600, fm_rate);
+  } else if (type == FM_OPNA) {
+    opna.Init(7987200, fm_rate);
+  } else {
+    opm.Init(4000000, fm_rate);
+  }
+  // the noise waveform of the OPM LFO uses rand()
+  srand(2);
+  size_t pos = 0;
+  for (const fm_log_t &l : log) {
+    if (l.samples > 0) {
+      FM::Sample *dst = &output[pos];
+      memset(dst, 0, sizeof(FM::Sample) * 2 * l.samples);
+      if (type == FM_OPN) {
+        opn.Mix(dst, l.samples);
+      } else if (type == FM_OPNA) {
+        opna.Mix(dst, l.samples);
+      } else {
+        opm.Mix(dst, l.samples);
+      }
+      pos += 2 * l.samples;
+    } else if (type == FM_OPN) {
+      opn.SetReg(l.addr, l.data);
+    } else if (type == FM_OPNA) {
+      opna.SetReg(l.addr, l.data);
+    } else {
+      opm.SetReg(l.addr, l.data);
+    }
+  }
+}
+
+// Replays the register logs of YM2203/YM2608/YM2151 with every FM channel
+// mixer, and checks that the output is the same as the original code.
+static bool run_fm_bench(int seconds) {
+  std::vector<fm_log_t> log[3];
+  std::vector<FM::Sample> expected[3], output;
+  srand(1);
+  for (int type = 0; type < 3; type++) {
+    make_fm_log(type, seconds, log[type]);
+    size_t samples = 0;
+    for (const fm_log_t &l : log[type]) {
+      samples += l.samples;
+    }
+    expected[type].resize(samples * 2);
+  }
+  int selected = FM::ChannelLanes::GetSelectedImpl();
+  FM::ChannelLanes::SelectImpl(0);
+  for (int type = 0; type < 3; type++) {
+    replay_fm_log(type, log[type], expected[type]);
+  }
+
+  // Replays a log once untimed before timing it, so that the first kernel
+  // is not charged for cold caches and the clock ramping up.
+  auto replay = [&](int type, double &msec) {
+    output.assign(expected[type].size(), 0);
+    replay_fm_log(type, log[type], output);
+    output.assign(expected[type].size(), 0);
+    uint64_t begin = SDL_GetPerformanceCounter();
+    replay_fm_log(type, log[type], output);
+    uint64_t end = SDL_GetPerformanceCounter();
+    msec = (double)(end - begin) * 1000.0 /
+           (double)SDL_GetPerformanceFrequency();
+    return output == expected[type];
+  };
+
+  // OPN (3 channels) always mixes with the per-channel code, so it is timed
+  // once instead of once per kernel.
+  double msec[3];
+  bool exact = replay(FM_OPN, msec[FM_OPN]);
+  printf("fm            : msec per %d sec of sound\n", seconds);
+  printf("opn           : %.2f (per-channel, every kernel)%s\n", msec[FM_OPN],
+         exact ? "" : " MISMATCH");
+  printf("fm lanes      : opna / opm\n");
+  for (int i = 0; i < FM::ChannelLanes::GetImplCount(); i++) {
+    FM::ChannelLanes::SelectImpl(i);
+    bool same = true;
+    for (int type = FM_OPNA; type <= FM_OPM; type++) {
+      same = replay(type, msec[type]) && same;
+    }
+    printf("%-14s: %.2f / %.2f%s%s\n", FM::ChannelLanes::GetImplName(i),
+           msec[FM_OPNA], msec[FM_OPM], (i == selected) ? " (selected)" : "",
+           same ? "" : " MISMATCH");
+    exact = exact && same;
+  }
+  FM::ChannelLanes::SelectImpl(selected);
+  return exact;
+}
+
+// Converts random stereo sound from the native rate of the sound devices to
+// the usual host rates with every resampler kernel, and checks that the output
+// is the same as the scalar code.
+static bool run_resampler_bench(int seconds) {
+  static const int out_rates[3] = {44100, 48000, 96000};
+  const int block = 1024;
+  std::vector<int32_t> input;
+  std::vector<uint16_t> expected[3], output;
+
+  srand(1);
+  input.resize((size_t)SOUND_NATIVE_RATE * seconds * 2);
+  for (size_t i = 0; i < input.size(); i++) {
+    // a bit louder than 16 bits so that clipping is measured too
+    input[i] = (rand() % 81920) - 40960;
+  }
+
+  auto convert = [&](const resampler_kernel_t *kernel, int out_rate,
+                     std::vector<uint16_t> &dst) {
+    RESAMPLER resampler;
+    int max_input = block * SOUND_NATIVE_RATE / out_rate + 1 + RESAMPLER_TAPS;
+    resampler.initialize(SOUND_NATIVE_RATE, out_rate, max_input);
+    resampler.set_kernel(kernel);
+    size_t in_pos = 0, out_pos = 0;
+    for (;;) {
+      int in_samples = resampler.get_input_samples(block);
+      if (in_pos + in_samples > input.size() / 2) {
+        break;
+      }
+      resampler.process(&input[in_pos * 2], in_samples, &dst[out_pos * 2],
+                        block);
+      in_pos += in_samples;
+      out_pos += block;
+    }
+  };
+  for (int r = 0; r < 3; r++) {
+    size_t samples = (size_t)out_rates[r] * seconds + block;
+    expected[r].assign(samples * 2, 0);
+    convert(get_resampler_kernel(0), out_rates[r], expected[r]);
+  }
+
+  bool exact = true;
+  printf("resampler     : %d -> 44100 / 48000 / 96000 msec per %d sec of "
+         "sound\n",
+         SOUND_NATIVE_RATE, seconds);
+  for (int i = 0; i < get_resampler_kernel_count(); i++) {
+    const resampler_kernel_t *kernel = get_resampler_kernel(i);
+    double msec[3];
+    bool same = true;
+    for (int r = 0; r < 3; r++) {
+      output.assign(expected[r].size(), 0);
+      uint64_t begin = SDL_GetPerformanceCounter();
+      convert(kernel, out_rates[r], output);
+      uint64_t end = SDL_GetPerformanceCounter();
+      msec[r] = (double)(end - begin) * 1000.0 /
+                (double)SDL_GetPerformanceFrequency();
+      same = same && output == expected[r];
+    }
+    printf("%-14s: %.2f / %.2f / %.2f%s%s\n", kernel->name, msec[0], msec[1],
+           msec[2], (kernel == get_best_resampler_kernel()) ? " (selected)" : "",
+           same ? "" : " MISMATCH");
+    exact = exact && same;
+  }
+  return exact;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [options] [disk1.d88 [disk2.d88]]\n"
+          "  -f, --frames N    frames to measure (default 3600)\n"
+          "  -w, --warmup N    frames to run before measuring (default 60)\n"
+          "  -c, --config PATH load settings from ini (default: built-in)\n"
+          "  -d, --draw        render the screen every frame\n"
+          "  -n, --no-sound    do not drain the sound buffer\n"
+          "  -z, --z80 N       run only a Z80 core for N million clocks\n"
+          "  -b, --bitplane N  run only the bitplane converters for N frames\n"
+          "  -m, --fm N        run only the FM channel mixers for N sec of sound\n"
+          "  -s, --resampler N run only the sound resampler for N sec of sound\n"
+          "  -r, --run-ahead N run N frames ahead and roll back every frame\n"
+          "ROM images are loaded from the executable directory.\n",
+          prog);
+}
+
+int main(int argc, char *argv[]) {
+  int frames = 3600;
+  int warmup = 60;
+  bool draw = false;
+  bool sound = true;
+  int z80_mclocks = 0;
+  int bitplane_frames = 0;
+  int fm_seconds = 0;
+  int resampler_seconds = 0;
+  int run_ahead_frames = 0;
+  const char *config_path = NULL;
+  const char *disk_path[2] = {NULL, NULL};
+  int disks = 0;
+
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool has_value = (i + 1 < argc);
+    if ((!strcmp(arg, "-f") || !strcmp(arg, "--frames")) && has_value) {
+      frames = atoi(argv[++i]);
+    } else if ((!strcmp(arg, "-w") || !strcmp(arg, "--warmup")) && has_value) {
+      warmup = atoi(argv[++i]);
+    } else if ((!strcmp(arg, "-c") || !strcmp(arg, "--config")) && has_value) {
+      config_path = argv[++i];
+    } else if (!strcmp(arg, "-d") || !strcmp(arg, "--draw")) {
+      draw = true;
+    } else if (!strcmp(arg, "-n") || !strcmp(arg, "--no-sound")) {
+      sound = false;
+    } else if ((!strcmp(arg, "-z") || !strcmp(arg, "--z80")) && has_value) {
+      z80_mclocks = atoi(argv[++i]);
+      if (z80_mclocks <= 0) {
+        usage(argv[0]);
+        return 1;
+      }
+    } else if ((!strcmp(arg, "-b") || !strcmp(arg, "--bitplane")) &&
+               has_value) {
+      bitplane_frames = atoi(argv[++i]);
+      if (bitplane_frames <= 0) {
+        usage(argv[0]);
+        return 1;
+      }
+    } else if ((!strcmp(arg, "-m") || !strcmp(arg, "--fm")) && has_value) {
+      fm_seconds = atoi(argv[++i]);
+      if (fm_seconds <= 0) {
+        usage(argv[0]);
+        return 1;
+      }
+    } else if ((!strcmp(arg, "-s") || !strcmp(arg, "--resampler")) &&
+               has_value) {
+      resampler_seconds = atoi(argv[++i]);
+      if (resampler_seconds <= 0) {
+        usage(argv[0]);
+        return 1;
+      }
+    } else if ((!strcmp(arg, "-r") || !strcmp(arg, "--run-ahead")) &&
+               has_value) {
+      run_ahead_frames = atoi(argv[++i]);
+      if (run_ahead_frames <= 0 || run_ahead_frames > MAX_RUN_AHEAD_FRAMES) {
+        usage(argv[0]);
+        return 1;
+      }
+    } else if (arg[0] != '-' && disks < 2) {
+      disk_path[disks++] = arg;
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (frames <= 0 || warmup < 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (bitplane_frames > 0) {
+    return run_bitplane_bench(bitplane_frames) ? 0 : 1;
+  }
+  if (fm_seconds > 0) {
+    return run_fm_bench(fm_seconds) ? 0 : 1;
+  }
+  if (resampler_seconds > 0) {
+    return run_resampler_bench(resampler_seconds) ? 0 : 1;
+  }
+
+  common_initialize();
+
+  // Fixed configuration: defaults unless an ini is given explicitly, so that
+  // results do not depend on the user's BubiC-8801MA.ini.
+  if (config_path != NULL) {
+    load_config(char_to_tchar(config_path));
+  } else {
+    initialize_config();
+  }
+  config.full_speed = true;
+  config.run_ahead_frames = run_ahead_frames;
+
+  EMU *emu = new EMU();
+  OSD *osd = emu->get_osd();
+  VM *vm = (VM *)emu->get_vm();
+  osd->consume_sound = sound;
+
+  if (z80_mclocks > 0) {
+    run_z80_bench(vm, emu, z80_mclocks);
+    delete emu;
+    return 0;
+  }
+
+  for (int drv = 0; drv < disks; drv++) {
+    if (!FILEIO::IsFileExisting(char_to_tchar(disk_path[drv]))) {
+      fprintf(stderr, "bench: %s not found\n", disk_path[drv]);
+      delete emu;
+      return 1;
+    }
+    emu->open_floppy_disk(drv, char_to_tchar(disk_path[drv]), 0);
+  }
+
+  auto run_frame = [&]() {
+    int extra_frames = 0;
+    osd->update_sound(&extra_frames);
+    vm->run();
+    if (run_ahead_frames > 0) {
+      emu->run_ahead();
+    } else if (draw) {
+      vm->draw_screen();
+    }
+    return 1 + extra_frames;
+  };
+
+  for (int i = 0; i < warmup;) {
+    i += run_frame();
+  }
+
+  uint64_t emulated_clocks = 0;
+  uint32_t prev_clock = vm->pc88event->get_current_clock();
+  uint64_t main_idle_begin = vm->pc88cpu->get_idle_skipped_clocks();
+  uint64_t sub_idle_begin =
+      vm->pc88cpu_sub ? vm->pc88cpu_sub->get_idle_skipped_clocks() : 0;
+  uint64_t begin = SDL_GetPerformanceCounter();
+  int ran = 0;
+  while (ran < frames) {
+    ran += run_frame();
+    uint32_t cur_clock = vm->pc88event->get_current_clock();
+    emulated_clocks += (uint32_t)(cur_clock - prev_clock);
+    prev_clock = cur_clock;
+  }
+  uint64_t end = SDL_GetPerformanceCounter();
+
+  double wall = (double)(end - begin) / (double)SDL_GetPerformanceFrequency();
+  if (wall <= 0.0) {
+    wall = 1e-9;
+  }
+  double frame_rate = vm->get_frame_rate();
+
+  printf("frames        : %d\n", ran);
+  printf("wall time     : %.3f s\n", wall);
+  printf("frames/sec    : %.2f (x%.2f realtime)\n", ran / wall,
+         ran / wall / frame_rate);
+  printf("z80 clocks    : %llu\n", (unsigned long long)emulated_clocks);
+  printf("effective z80 : %.3f MHz\n", emulated_clocks / wall / 1000000.0);
+  if (sound) {
+    printf("sound blocks  : %llu\n", (unsigned long long)osd->sound_blocks);
+  }
+  if (run_ahead_frames > 0) {
+    double save_msec, load_msec, total_msec;
+    emu->get_run_ahead_cost(&save_msec, &load_msec, &total_msec);
+    printf("run-ahead     : %d frames, %.3f ms per frame\n", run_ahead_frames,
+           total_msec);
+    printf("state save    : %.3f ms\n", save_msec);
+    printf("state load    : %.3f ms\n", load_msec);
+  }
+  if (config.skip_main_cpu_idle) {
+    uint64_t skipped = vm->pc88cpu->get_idle_skipped_clocks() - main_idle_begin;
+    printf("main idle skip: %llu clocks\n", (unsigned long long)skipped);
+  }
+  if (vm->pc88cpu_sub && config.skip_sub_cpu_idle) {
+    uint64_t skipped =
+        vm->pc88cpu_sub->get_idle_skipped_clocks() - sub_idle_begin;
+    printf("sub idle skip : %llu clocks\n", (unsigned long long)skipped);
+  }
+
+  delete emu;
+  return 0;
+}
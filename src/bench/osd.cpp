@@ -0,0 +1,93 @@
+#include "osd.h"
+#include "../config.h"
+#include "../emu.h"
+#include "../vm/event.h"
+
+#include "../vm/vm.h"
+
+OSD::OSD() {
+  lock_count = 0;
+  terminated = false;
+  vm = NULL;
+  emu = NULL;
+  vm_screen_buffer = NULL;
+  vm_screen_buffer_stale = false;
+  vm_screen_width = 0;
+  vm_screen_height = 0;
+  sound_rate = 0;
+  sound_samples = 0;
+  consume_sound = true;
+  sound_blocks = 0;
+  screen_skip_line = false;
+  memset(key_status, 0, sizeof(key_status));
+  memset(joy_status, 0, sizeof(joy_status));
+  memset(mouse_status, 0, sizeof(mouse_status));
+}
+
+OSD::~OSD() { release(); }
+
+void OSD::initialize(int rate, int samples) {
+  // Timer subsystem only; video/audio are never opened.
+  SDL_Init(0);
+  reconfigure_sound(rate, samples);
+  set_vm_screen_size(640, 400, 640, 400, 640, 400);
+}
+
+void OSD::release() {
+  if (vm_screen_buffer) {
+    free(vm_screen_buffer);
+    vm_screen_buffer = NULL;
+  }
+}
+
+void OSD::open_message_box(const _TCHAR *text) {
+  fprintf(stderr, "[OSD] %s\n", tchar_to_char(text));
+}
+
+void OSD::set_vm_screen_size(int screen_width, int screen_height,
+                             int window_width, int window_height,
+                             int window_width_aspect,
+                             int window_height_aspect) {
+  if (vm_screen_width == screen_width && vm_screen_height == screen_height &&
+      vm_screen_buffer != NULL) {
+    return;
+  }
+  if (vm_screen_buffer) {
+    free(vm_screen_buffer);
+  }
+  vm_screen_buffer =
+      (scrntype_t *)malloc(screen_width * screen_height * sizeof(scrntype_t));
+  vm_screen_width = screen_width;
+  vm_screen_height = screen_height;
+  memset(vm_screen_buffer, 0, screen_width * screen_height * sizeof(scrntype_t));
+  vm_screen_buffer_stale = true;
+}
+
+void OSD::set_vm_screen_lines(int lines) {
+  int height = (lines <= 200) ? 400 : lines;
+  set_vm_screen_size(640, height, 640, height, 640, height);
+}
+
+void OSD::update_sound(int *extra_frames) {
+  if (extra_frames) {
+    *extra_frames = 0;
+  }
+  if (!consume_sound || !vm || sound_samples <= 0) {
+    return;
+  }
+  // Drain one block whenever the mixer has produced it, like an audio device
+  // that never underruns. create_sound() may drive extra frames to fill it.
+  if (vm->get_sound_buffer_ptr() >= sound_samples) {
+    vm->create_sound(extra_frames);
+    sound_blocks++;
+  }
+}
+
+bool OSD::reconfigure_sound(int rate, int samples) {
+  if (rate <= 0 || samples <= 0) {
+    return false;
+  }
+  sound_rate = rate;
+  sound_samples = samples;
+  return true;
+}
@@ -0,0 +1,202 @@
+/*
+    Null OSD Implementation for BubiC-8801MA headless benchmark
+
+    No window, renderer, audio device or ImGui is created.
+    SDL3 is only used for its timer functions.
+*/
+
+#ifndef _BENCH_OSD_H_
+#define _BENCH_OSD_H_
+
+#include "../common.h"
+#include "../vm/vm.h"
+#include <SDL3/SDL.h>
+
+#define OSD_CONSOLE_BLUE 1
+#define OSD_CONSOLE_GREEN 2
+#define OSD_CONSOLE_RED 4
+#define OSD_CONSOLE_INTENSITY 8
+#ifndef VK_ESCAPE
+#define VK_ESCAPE 0x1B
+#define VK_LSHIFT 0xA0
+#define VK_RSHIFT 0xA1
+#endif
+
+typedef struct bitmap_s {
+  bool initialized() { return false; }
+  int width, height;
+} bitmap_t;
+
+typedef struct font_s {
+  bool initialized() { return false; }
+} font_t;
+
+typedef struct pen_s {
+  bool initialized() { return false; }
+} pen_t;
+
+class OSD {
+private:
+  int lock_count;
+  bool terminated;
+
+  uint8_t key_status[256];
+  uint32_t joy_status[4];
+  int32_t mouse_status[8];
+
+  scrntype_t *vm_screen_buffer;
+  bool vm_screen_buffer_stale;
+  int vm_screen_width, vm_screen_height;
+
+  int sound_rate;
+  int sound_samples;
+
+public:
+  OSD();
+  ~OSD();
+
+  VM_TEMPLATE *vm;
+  class EMU *emu;
+
+  // Drain generated sound blocks so mixing cost stays in the measurement.
+  bool consume_sound;
+  uint64_t sound_blocks;
+
+  void initialize(int rate, int samples);
+  void release();
+  void power_off() { terminated = true; }
+  void suspend() {}
+  void restore() {}
+  void lock_vm() { lock_count++; }
+  void unlock_vm() { lock_count--; }
+  bool is_vm_locked() { return lock_count != 0; }
+  bool is_terminated() const { return terminated; }
+  bool is_ui_interacting() const { return false; }
+  void force_unlock_vm() {}
+  void sleep(uint32_t ms) { SDL_Delay(ms); }
+
+  // Console
+  void open_message_box(const _TCHAR *text);
+  void open_console(int width, int height, const char *title) {}
+  void close_console() {}
+  void write_console(const char *buffer, unsigned int length) {}
+  void write_console_char(const char *buffer, unsigned int length) {}
+  void set_console_text_attribute(unsigned short attr) {}
+  unsigned int get_console_code_page() { return 65001; }
+  int read_console_input(char *buffer, unsigned int length) { return 0; }
+  bool is_console_closed() { return true; }
+  void close_debugger_console() {}
+  void get_console_cursor_position(int *x, int *y) {
+    if (x)
+      *x = 0;
+    if (y)
+      *y = 0;
+  }
+  void set_console_cursor_position(int x, int y) {}
+  void write_console_wchar(const wchar_t *buffer, unsigned int length) {}
+  bool is_console_key_pressed(int vk) { return false; }
+
+  // Input
+  void update_input() {}
+  void key_down(int code, bool extended, bool repeat) {}
+  void key_up(int code, bool extended) {}
+  uint8_t *get_key_buffer() { return key_status; }
+  void key_lost_focus() {}
+  void enable_mouse() {}
+  void disable_mouse() {}
+  void toggle_mouse() {}
+  bool is_mouse_enabled() { return false; }
+  void consume_mouse_delta(int32_t &dx, int32_t &dy) { dx = dy = 0; }
+  int32_t *get_mouse_buffer() { return mouse_status; }
+  uint32_t *get_joy_buffer() { return joy_status; }
+  void key_down_native(int vk, bool extended) {}
+  void key_up_native(int vk) {}
+  bool now_auto_key = false;
+
+  // Screen
+  int draw_screen() { return 1; }
+  void set_vm_screen_size(int screen_width, int screen_height, int window_width,
+                          int window_height, int window_width_aspect,
+                          int window_height_aspect);
+  void set_host_window_size(int width, int height, bool window_mode) {}
+  void set_vm_screen_lines(int lines);
+  void update_window_scale() {}
+  double get_window_mode_power(int mode) { return 1.0; }
+  int get_window_mode_width(int mode) { return 640; }
+  int get_window_mode_height(int mode) { return 400; }
+  int get_vm_window_width() { return vm_screen_width; }
+  int get_vm_window_height() { return vm_screen_height; }
+  int get_vm_window_width_aspect() { return vm_screen_width; }
+  int get_vm_window_height_aspect() { return vm_screen_height; }
+  scrntype_t *get_vm_screen_buffer(int y) {
+    if (vm_screen_buffer && y >= 0 && y < vm_screen_height) {
+      return vm_screen_buffer + y * vm_screen_width;
+    }
+    return NULL;
+  }
+  void lock_vm_screen_buffer(int *top, int *bottom) {
+    // the vm renders the whole screen into a new buffer
+    if (vm_screen_buffer_stale) {
+      *top = 0;
+      *bottom = vm_screen_height;
+      vm_screen_buffer_stale = false;
+    }
+  }
+  void unlock_vm_screen_buffer() {}
+  void set_emulation_thread(bool running) {}
+  bool screen_skip_line;
+
+  // Sound
+  void update_sound(int *extra_frames);
+  void add_extra_frames(int frames) {}
+  void stop_sound() {}
+  bool reconfigure_sound(int rate, int samples);
+  int get_sound_block_samples(int rate, int samples) { return samples; }
+  int get_audio_source_rate() const { return sound_rate; }
+  int get_audio_device_rate() const { return sound_rate; }
+  void set_audio_pause_for_ui(bool pause) {}
+  void mute_sound() {}
+  void start_record_sound() {}
+  void stop_record_sound() {}
+  void restart_record_sound() {}
+  bool now_record_sound = false;
+
+  // Debugger synchronization
+  void start_waiting_in_debugger() {}
+  void finish_waiting_in_debugger() {}
+  void process_waiting_in_debugger() {}
+
+  // Video
+  bool now_record_video = false;
+  bool start_record_video(int fps) { return false; }
+  void stop_record_video() {}
+  void restart_record_video() {}
+  void capture_screen() {}
+
+  // Printer
+  void create_bitmap(bitmap_t *bitmap, int width, int height) {}
+  void release_bitmap(bitmap_t *bitmap) {}
+  void create_font(font_t *font, const _TCHAR *family, int width, int height,
+                   int rotate, bool bold, bool italic) {}
+  void release_font(font_t *font) {}
+  void create_pen(pen_t *pen, int width, uint8_t r, uint8_t g, uint8_t b) {}
+  void release_pen(pen_t *pen) {}
+  void clear_bitmap(bitmap_t *bitmap, uint8_t r, uint8_t g, uint8_t b) {}
+  int get_text_width(bitmap_t *bitmap, font_t *font, const char *text) {
+    return 0;
+  }
+  void draw_text_to_bitmap(bitmap_t *bitmap, font_t *font, int x, int y,
+                           const char *text, uint8_t r, uint8_t g, uint8_t b) {}
+  void draw_line_to_bitmap(bitmap_t *bitmap, pen_t *pen, int sx, int sy, int ex,
+                           int ey) {}
+  void draw_rectangle_to_bitmap(bitmap_t *bitmap, int x, int y, int width,
+                                int height, uint8_t r, uint8_t g, uint8_t b) {}
+  void draw_point_to_bitmap(bitmap_t *bitmap, int x, int y, uint8_t r,
+                            uint8_t g, uint8_t b) {}
+  void stretch_bitmap(bitmap_t *dest, int dest_x, int dest_y, int dest_width,
+                      int dest_height, bitmap_t *source, int source_x,
+                      int source_y, int source_width, int source_height) {}
+  void write_bitmap_to_file(bitmap_t *bitmap, const char *path) {}
+};
+
+#endif
@@ -123,6 +123,9 @@ void initialize_config()
 	config.mouse_enabled = false;
 	config.mouse_sensitivity = 50;
 	config.sound_strict_rendering = true;
+	config.sound_worker_thread = false;
+	config.sound_callback = false;
+	config.sound_resampler = false;
 	config.sound_mute_fm = false;
 	config.sound_mute_ssg = false;
 	config.sound_mute_adpcm = false;
@@ -253,6 +256,17 @@ void load_config(const _TCHAR* config_path)
 	config.compress_state = MyGetPrivateProfileBool(_T("Control"), _T("CompressState"), config.compress_state, config_path);
 	config.reset_on_dd = MyGetPrivateProfileBool(_T("Control"), _T("ResetOnDD"), config.reset_on_dd, config_path);
 	config.drive_vm_in_opecode = MyGetPrivateProfileBool(_T("Control"), _T("DriveVMInOpecode"), config.drive_vm_in_opecode, config_path);
+	config.batch_primary_cpu = MyGetPrivateProfileBool(_T("Control"), _T("BatchPrimaryCPU"), config.batch_primary_cpu, config_path);
+	config.lazy_sub_cpu_sync = MyGetPrivateProfileBool(_T("Control"), _T("LazySubCPUSync"), config.lazy_sub_cpu_sync, config_path);
+	config.skip_sub_cpu_idle = MyGetPrivateProfileBool(_T("Control"), _T("SkipSubCPUIdle"), config.skip_sub_cpu_idle, config_path);
+	config.skip_main_cpu_idle = MyGetPrivateProfileBool(_T("Control"), _T("SkipMainCPUIdle"), config.skip_main_cpu_idle, config_path);
+	config.z80_block_cache = MyGetPrivateProfileBool(_T("Control"), _T("Z80BlockCache"), config.z80_block_cache, config_path);
+	config.emulation_thread = MyGetPrivateProfileBool(_T("Control"), _T("EmulationThread"), config.emulation_thread, config_path);
+	config.vline_rendering = MyGetPrivateProfileBool(_T("Control"), _T("VLineRendering"), config.vline_rendering, config_path);
+	config.run_ahead_frames = MyGetPrivateProfileInt(_T("Control"), _T("RunAheadFrames"), config.run_ahead_frames, config_path);
+	config.run_ahead_frames = max(0, min(MAX_RUN_AHEAD_FRAMES, config.run_ahead_frames));
+	config.auto_frame_skip = MyGetPrivateProfileInt(_T("Control"), _T("AutoFrameSkip"), config.auto_frame_skip, config_path);
+	config.auto_frame_skip = max(0, min(MAX_AUTO_FRAME_SKIP, config.auto_frame_skip));
 	
 	// recent files
 	#ifdef USE_CART
@@ -355,6 +369,9 @@ void load_config(const _TCHAR* config_path)
 	if (config.master_volume < 0) config.master_volume = 0;
 	if (config.master_volume > 100) config.master_volume = 100;
 	config.sound_strict_rendering = MyGetPrivateProfileBool(_T("Sound"), _T("StrictRendering"), config.sound_strict_rendering, config_path);
+	config.sound_worker_thread = MyGetPrivateProfileBool(_T("Sound"), _T("WorkerThread"), config.sound_worker_thread, config_path);
+	config.sound_callback = MyGetPrivateProfileBool(_T("Sound"), _T("Callback"), config.sound_callback, config_path);
+	config.sound_resampler = MyGetPrivateProfileBool(_T("Sound"), _T("Resampler"), config.sound_resampler, config_path);
 	config.sound_mute_fm = MyGetPrivateProfileBool(_T("Sound"), _T("MuteFM"), config.sound_mute_fm, config_path);
 	config.sound_mute_ssg = MyGetPrivateProfileBool(_T("Sound"), _T("MuteSSG"), config.sound_mute_ssg, config_path);
 	config.sound_mute_adpcm = MyGetPrivateProfileBool(_T("Sound"), _T("MuteADPCM"), config.sound_mute_adpcm, config_path);
@@ -521,6 +538,15 @@ void save_config(const _TCHAR* config_path)
 	MyWritePrivateProfileBool(_T("Control"), _T("CompressState"), config.compress_state, config_path);
 	MyWritePrivateProfileBool(_T("Control"), _T("ResetOnDD"), config.reset_on_dd, config_path);
 	MyWritePrivateProfileBool(_T("Control"), _T("DriveVMInOpecode"), config.drive_vm_in_opecode, config_path);
+	MyWritePrivateProfileBool(_T("Control"), _T("BatchPrimaryCPU"), config.batch_primary_cpu, config_path);
+	MyWritePrivateProfileBool(_T("Control"), _T("LazySubCPUSync"), config.lazy_sub_cpu_sync, config_path);
+	MyWritePrivateProfileBool(_T("Control"), _T("SkipSubCPUIdle"), config.skip_sub_cpu_idle, config_path);
+	MyWritePrivateProfileBool(_T("Control"), _T("SkipMainCPUIdle"), config.skip_main_cpu_idle, config_path);
+	MyWritePrivateProfileBool(_T("Control"), _T("Z80BlockCache"), config.z80_block_cache, config_path);
+	MyWritePrivateProfileBool(_T("Control"), _T("EmulationThread"), config.emulation_thread, config_path);
+	MyWritePrivateProfileBool(_T("Control"), _T("VLineRendering"), config.vline_rendering, config_path);
+	MyWritePrivateProfileInt(_T("Control"), _T("RunAheadFrames"), config.run_ahead_frames, config_path);
+	MyWritePrivateProfileInt(_T("Control"), _T("AutoFrameSkip"), config.auto_frame_skip, config_path);
 	
 	// recent files
 	#ifdef USE_CART
@@ -621,6 +647,9 @@ void save_config(const _TCHAR* config_path)
 	MyWritePrivateProfileInt(_T("Sound"), _T("Latency"), config.sound_latency, config_path);
 	MyWritePrivateProfileInt(_T("Sound"), _T("MasterVolume"), config.master_volume, config_path);
 	MyWritePrivateProfileBool(_T("Sound"), _T("StrictRendering"), config.sound_strict_rendering, config_path);
+	MyWritePrivateProfileBool(_T("Sound"), _T("WorkerThread"), config.sound_worker_thread, config_path);
+	MyWritePrivateProfileBool(_T("Sound"), _T("Callback"), config.sound_callback, config_path);
+	MyWritePrivateProfileBool(_T("Sound"), _T("Resampler"), config.sound_resampler, config_path);
 	MyWritePrivateProfileBool(_T("Sound"), _T("MuteFM"), config.sound_mute_fm, config_path);
 	MyWritePrivateProfileBool(_T("Sound"), _T("MuteSSG"), config.sound_mute_ssg, config_path);
 	MyWritePrivateProfileBool(_T("Sound"), _T("MuteADPCM"), config.sound_mute_adpcm, config_path);
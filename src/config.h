@@ -35,6 +35,8 @@
 #endif
 
 #define MAX_HISTORY	8
+#define MAX_RUN_AHEAD_FRAMES	4
+#define MAX_AUTO_FRAME_SKIP	9
 
 #ifdef USE_SHARED_DLL
 	#define USE_CART_TMP		8
@@ -128,7 +130,10 @@ typedef struct {
 	bool compress_state;
 	bool reset_on_dd;
 	float cpu_power;
-	bool full_speed, drive_vm_in_opecode;
+	bool full_speed, drive_vm_in_opecode, batch_primary_cpu, lazy_sub_cpu_sync, skip_sub_cpu_idle, skip_main_cpu_idle;
+	bool z80_block_cache;
+	bool emulation_thread, vline_rendering;
+	int run_ahead_frames, auto_frame_skip;
 	
 	// recent files
 	#if defined(USE_SHARED_DLL) || defined(USE_CART)
@@ -188,6 +193,9 @@ typedef struct {
 	int sound_latency;
 	int master_volume; // 0..100
 	bool sound_strict_rendering;
+	bool sound_worker_thread;
+	bool sound_callback;
+	bool sound_resampler;
 	bool sound_mute_fm;
 	bool sound_mute_ssg;
 	bool sound_mute_adpcm;
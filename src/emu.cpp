@@ -209,7 +209,8 @@ EMU::EMU()
 #endif
   now_waiting_in_debugger = false;
   initialize_media();
-  vm->initialize_sound(sound_rate, sound_samples);
+  vm->initialize_sound(sound_rate,
+                       osd->get_sound_block_samples(sound_rate, sound_samples));
 #ifdef USE_SOUND_VOLUME
   for (int i = 0; i < USE_SOUND_VOLUME; i++) {
     vm->set_sound_device_volume(i, config.sound_volume_l[i],
@@ -231,10 +232,36 @@ EMU::EMU()
   EMU_LOG("vm->reset() done");
 
   now_suspended = false;
+  emulation_thread_running = false;
+  emulation_thread_terminated = false;
+  pacing_begin_ns = 0;
+  pacing_frames = 0;
+  pacing_frame_ns = 0.0;
+  next_frame_ns = 0;
+  sleep_margin_ns = 1000000;
+  jitter_sum_ns = jitter_max_ns = 0;
+  jitter_count = 0;
+  jitter_avg_usec = jitter_max_usec = 0.0;
+  frame_skipped = false;
+  frame_skip_count = 0;
+  skipped_frames = skipped_frames_accum = 0;
+  frame_stats_begin_ns = 0;
+#ifdef USE_STATE
+  run_ahead_state = NULL;
+  run_ahead_drawn = false;
+  run_ahead_begin_tick = 0;
+  run_ahead_save_ticks = run_ahead_load_ticks = run_ahead_total_ticks = 0;
+  run_ahead_count = 0;
+  run_ahead_save_msec = run_ahead_load_msec = run_ahead_total_msec = 0.0;
+#endif
   EMU_LOG("EMU constructor completed");
 }
 
 EMU::~EMU() {
+  stop_emulation_thread();
+#ifdef USE_STATE
+  delete run_ahead_state;
+#endif
 #ifdef USE_AUTO_KEY
   release_auto_key();
 #endif
@@ -284,6 +311,72 @@ int EMU::get_frame_interval() {
 bool EMU::is_frame_skippable() { return vm->is_frame_skippable(); }
 
 int EMU::run() {
+  if (emulation_thread_running) {
+    // The VM runs on the emulation thread; only poll host input here.
+    osd->lock_vm();
+    osd->update_input();
+    osd->unlock_vm();
+    return 0;
+  }
+  osd->update_input();
+  int ran_frames = run_vm();
+  if (ran_frames == 0) {
+    // Too early for next frame. Wait for it and run it at once rather than
+    // after another present; the wait is kept within one frame so that the
+    // main loop still presents when audio-driven batching ran ahead.
+    if (wait_next_frame()) {
+      ran_frames = run_vm();
+    } else if (osd->is_ui_interacting()) {
+      SDL_Delay(1);
+    }
+  }
+  return ran_frames;
+}
+
+bool EMU::wait_next_frame() {
+  // Sleep until shortly before the next frame is due and spin the rest, as a
+  // sleep may wake up late by up to the timer slack of the host. The margin
+  // follows how late the sleeps wake up. Returns true if the frame is due.
+  if (config.full_speed || pacing_begin_ns == 0 || osd->is_ui_interacting()) {
+    return false;
+  }
+  uint64_t now = SDL_GetTicksNS();
+  uint64_t target = next_frame_ns;
+  uint64_t limit = now + (uint64_t)pacing_frame_ns;
+  bool due = true;
+  if (target > limit) {
+    target = limit;
+    due = false;
+  }
+  if (target > now + sleep_margin_ns) {
+    uint64_t wake = target - sleep_margin_ns;
+    SDL_DelayNS(wake - now);
+    uint64_t late = SDL_GetTicksNS() - wake;
+    if ((int64_t)late < 0) {
+      late = 0;
+    }
+    // grow at once on a late wake up, shrink slowly back toward 0.25ms
+    uint64_t margin = late + 250000;
+    if (margin > sleep_margin_ns) {
+      sleep_margin_ns = (margin < 4000000) ? margin : 4000000;
+    } else {
+      sleep_margin_ns -= (sleep_margin_ns - margin) / 16;
+    }
+  }
+  while (SDL_GetTicksNS() < target) {
+    SDL_CPUPauseInstruction();
+  }
+  return due;
+}
+
+void EMU::get_frame_jitter(double *avg_usec, double *max_usec,
+                           double *spin_usec) {
+  *avg_usec = jitter_avg_usec;
+  *max_usec = jitter_max_usec;
+  *spin_usec = sleep_margin_ns / 1000.0;
+}
+
+int EMU::run_vm() {
 #if defined(USE_DEBUGGER) && defined(USE_STATE)
   if (request_save_state >= 0 || request_load_state >= 0) {
     if (request_save_state >= 0) {
@@ -321,7 +414,6 @@ int EMU::run() {
     osd->restore();
     now_suspended = false;
   }
-  osd->update_input();
 #ifdef USE_AUTO_KEY
   update_auto_key();
 #endif
@@ -337,77 +429,81 @@ int EMU::run() {
   update_media();
 
   // Precision timing: Synchronize VM execution with real-time.
-  static const int MS_SHIFT = 16;
-  static uint64_t begin_tick = 0;
-  static uint64_t total_frame_time = 0;
-
   // Pause VM while UI is interacting to prevent glitches.
   if (osd->is_ui_interacting()) {
-    begin_tick = SDL_GetTicks();
-    total_frame_time = 0;
-    SDL_Delay(1);
+    pacing_begin_ns = 0;
+    frame_skipped = false;
     return 0;
   }
-  
-  if (begin_tick == 0) begin_tick = SDL_GetTicks();
 
-  uint64_t current_tick = SDL_GetTicks();
-  uint64_t elapsed_time;
-
-  if (config.full_speed) {
-    begin_tick = current_tick;
-    total_frame_time = 0;
-    elapsed_time = 0;
-  } else {
-    float speed_mul = (config.cpu_power < 0.25f) ? 1.0f : config.cpu_power;
-    elapsed_time =
-        (uint64_t)(((uint64_t)(current_tick - begin_tick) << MS_SHIFT) * speed_mul);
-    // Prevent long "no-run" stalls when accumulated frame time gets too far
-    // ahead of wall clock (can happen after audio-driven burst generation).
-    if ((int64_t)(total_frame_time - elapsed_time) > (200LL << MS_SHIFT)) {
-      total_frame_time = elapsed_time;
-    }
+  uint64_t current_ns = SDL_GetTicksNS();
+  float speed_mul = (config.cpu_power < 0.25f) ? 1.0f : config.cpu_power;
+  double rate = vm->get_frame_rate();
+  if (rate < 1.0) rate = FRAMES_PER_SEC;
+  double frame_ns = 1000000000.0 / (rate * speed_mul);
+
+  // (Re)start the schedule from now when it is not running or its period
+  // changed.
+  if (config.full_speed || pacing_begin_ns == 0 || frame_ns != pacing_frame_ns) {
+    pacing_begin_ns = current_ns;
+    pacing_frames = 0;
+    pacing_frame_ns = frame_ns;
+  }
+  auto frame_due_ns = [&](uint64_t frames) -> uint64_t {
+    return pacing_begin_ns + (uint64_t)((double)frames * pacing_frame_ns);
+  };
+  // Prevent long "no-run" stalls when the schedule gets too far ahead of wall
+  // clock (can happen after audio-driven burst generation).
+  if (!config.full_speed &&
+      (int64_t)(frame_due_ns(pacing_frames) - current_ns) > 200000000LL) {
+    pacing_begin_ns = current_ns;
+    pacing_frames = 0;
   }
 
   int ran_frames = 0;
-  float speed_mul = (config.cpu_power < 0.25f) ? 1.0f : config.cpu_power;
   // Prioritize render cadence at x1; allow more catch-up only at high speed.
   const int max_batches = config.full_speed ? 1 : ((speed_mul <= 1.0f) ? 1 : (int)(speed_mul * 4));
 
-  uint64_t ms_per_frame = 0;
-  if (!config.full_speed) {
-    double rate = vm->get_frame_rate();
-    if (rate < 1.0) rate = 60.0;
-    ms_per_frame = (uint64_t)((1000.0 * (1 << MS_SHIFT)) / rate);
-  }
-
   auto advance_timing = [&](int frames) -> bool {
     if (config.full_speed || frames <= 0) {
       return true;
     }
-    total_frame_time += ms_per_frame * (uint64_t)frames;
+    pacing_frames += frames;
     // Resync if timing drift is too large (e.g. after sleep or heavy load).
-    if ((int64_t)(elapsed_time - total_frame_time) > (500LL << MS_SHIFT)) {
-      begin_tick = current_tick;
-      total_frame_time = 0;
+    if ((int64_t)(current_ns - frame_due_ns(pacing_frames)) > 500000000LL) {
+      pacing_begin_ns = current_ns;
+      pacing_frames = 0;
       return false;
     }
     return true;
   };
 
   // Drive audio queue every loop (common_source_project style).
+  // The ui thread rebuilds the audio stream and the sound buffers of the vm
+  // under the VM lock when the sound settings change.
   int sound_frames = 0;
+  osd->lock_vm();
   osd->update_sound(&sound_frames);
+  osd->unlock_vm();
   if (sound_frames > 0) {
     ran_frames += sound_frames;
     advance_timing(sound_frames);
   }
 
   // Catch up VM slices when still behind schedule.
-  while (config.full_speed || (int64_t)(elapsed_time - total_frame_time) >= 0) {
+  while (config.full_speed || frame_due_ns(pacing_frames) <= current_ns) {
     if (ran_frames >= max_batches) {
       break;
     }
+    if (!config.full_speed && ran_frames == 0) {
+      // how late the frame starts against the schedule
+      uint64_t late = SDL_GetTicksNS() - frame_due_ns(pacing_frames);
+      jitter_sum_ns += late;
+      if (late > jitter_max_ns) {
+        jitter_max_ns = late;
+      }
+      jitter_count++;
+    }
 
     osd->lock_vm();
     vm->run();
@@ -418,20 +514,163 @@ int EMU::run() {
       break;
     }
   }
+  next_frame_ns = frame_due_ns(pacing_frames);
+
+  // Auto frame skip: leave the screen undrawn while the vm is still a frame or
+  // more behind the schedule after running, so that the time of drawing and
+  // presenting goes to the vm. The frame cost of a slow host shows up as this
+  // delay. Frames the vm marks as skippable (tape loading) are skipped too, up
+  // to config.auto_frame_skip frames in a row.
+  frame_skipped = false;
+  if (ran_frames > 0 && config.auto_frame_skip > 0 && !config.full_speed &&
+      frame_skip_count < config.auto_frame_skip) {
+    if (SDL_GetTicksNS() >= frame_due_ns(pacing_frames + 1) ||
+        vm->is_frame_skippable()) {
+      frame_skipped = true;
+    }
+  }
+  if (frame_skipped) {
+    frame_skip_count++;
+    skipped_frames_accum++;
+  } else if (ran_frames > 0) {
+    frame_skip_count = 0;
+  }
+  // Per second statistics of the frame skip and pacing.
+  if (current_ns - frame_stats_begin_ns >= 1000000000) {
+    skipped_frames = skipped_frames_accum;
+    skipped_frames_accum = 0;
+    jitter_avg_usec = jitter_count ? jitter_sum_ns / 1000.0 / jitter_count : 0.0;
+    jitter_max_usec = jitter_max_ns / 1000.0;
+    jitter_sum_ns = jitter_max_ns = 0;
+    jitter_count = 0;
+    frame_stats_begin_ns = current_ns;
+  }
 
   if (ran_frames > 0) {
+#ifdef USE_STATE
+    if (!frame_skipped) {
+      run_ahead();
+    }
+#endif
     osd->add_extra_frames(ran_frames);
     return ran_frames;
   }
-
-  // Too early for next frame.
-  // Don't sleep for the full gap here; long sleeps reduce render cadence
-  // drastically when audio-driven batching advances multiple VM frames.
-  // Yield briefly and let the main loop keep presenting.
-  SDL_Delay(0);
   return 0;
 }
 
+#ifdef USE_STATE
+void EMU::run_ahead() {
+  // Save the machine, run the next frames with the current input and show the
+  // last of them, then roll back. The frames are not mixed into the sound.
+  int frames = config.run_ahead_frames;
+#ifdef USE_DEBUGGER
+  if (now_debugging) {
+    frames = 0;
+  }
+#endif
+  bool drawn = false;
+  if (frames > 0) {
+    if (run_ahead_state == NULL) {
+      run_ahead_state = new FILEIO();
+    }
+    osd->lock_vm();
+    uint64_t begin = SDL_GetPerformanceCounter();
+    bool saved = false;
+    if (run_ahead_state->Mopen(FILEIO_WRITE_BINARY)) {
+      saved = vm->process_state(run_ahead_state, false);
+      run_ahead_state->Fclose();
+    }
+    uint64_t saved_tick = SDL_GetPerformanceCounter();
+    if (saved) {
+      vm->set_sound_muted(true);
+      for (int i = 0; i < frames; i++) {
+        vm->run();
+      }
+      vm->draw_screen();
+      drawn = true;
+
+      uint64_t load_tick = SDL_GetPerformanceCounter();
+      run_ahead_state->Mopen(FILEIO_READ_BINARY);
+      if (!vm->process_state(run_ahead_state, true)) {
+        out_debug_log(_T("failed to roll back run-ahead frames\n"));
+      }
+      run_ahead_state->Fclose();
+      vm->set_sound_muted(false);
+      uint64_t end = SDL_GetPerformanceCounter();
+
+      run_ahead_save_ticks += saved_tick - begin;
+      run_ahead_load_ticks += end - load_tick;
+      run_ahead_total_ticks += end - begin;
+      run_ahead_count++;
+    }
+    osd->unlock_vm();
+  }
+  // the screen is drawn here while run-ahead is running
+  run_ahead_drawn = drawn;
+
+  uint64_t tick = SDL_GetTicks();
+  if (tick - run_ahead_begin_tick >= 1000) {
+    double ticks_per_msec = (double)SDL_GetPerformanceFrequency() / 1000.0;
+    double count = (run_ahead_count > 0) ? run_ahead_count : 1;
+    run_ahead_save_msec = run_ahead_save_ticks / ticks_per_msec / count;
+    run_ahead_load_msec = run_ahead_load_ticks / ticks_per_msec / count;
+    run_ahead_total_msec = run_ahead_total_ticks / ticks_per_msec / count;
+    run_ahead_save_ticks = run_ahead_load_ticks = run_ahead_total_ticks = 0;
+    run_ahead_count = 0;
+    run_ahead_begin_tick = tick;
+  }
+}
+
+void EMU::get_run_ahead_cost(double *save_msec, double *load_msec,
+                             double *total_msec) {
+  *save_msec = run_ahead_save_msec;
+  *load_msec = run_ahead_load_msec;
+  *total_msec = run_ahead_total_msec;
+}
+#endif
+
+void EMU::start_emulation_thread() {
+  if (emulation_thread_running) {
+    return;
+  }
+  // The OSD switches to triple buffered screens before the thread draws.
+  osd->set_emulation_thread(true);
+  emulation_thread_terminated = false;
+  emulation_thread_running = true;
+  emulation_thread = std::thread(&EMU::emulation_thread_main, this);
+}
+
+void EMU::stop_emulation_thread() {
+  if (!emulation_thread_running) {
+    return;
+  }
+  emulation_thread_terminated = true;
+  emulation_thread.join();
+  emulation_thread_running = false;
+  osd->set_emulation_thread(false);
+}
+
+void EMU::emulation_thread_main() {
+  while (!emulation_thread_terminated) {
+    // The UI takes the VM lock only to poll the input and to apply the menu
+    // and dialog actions queued while it built its frame.
+    osd->lock_vm();
+    int ran_frames = run_vm();
+#ifdef USE_STATE
+    if (ran_frames > 0 && !frame_skipped && !run_ahead_drawn) {
+#else
+    if (ran_frames > 0 && !frame_skipped) {
+#endif
+      vm->draw_screen();
+    }
+    osd->unlock_vm();
+    // the next frame is run on the next pass once it is due
+    if (ran_frames == 0 && !wait_next_frame()) {
+      SDL_Delay(1);
+    }
+  }
+}
+
 bool EMU::apply_host_sound_settings() {
   if (!osd || !vm) {
     return false;
@@ -475,7 +714,7 @@ bool EMU::apply_host_sound_settings() {
     sound_latency = requested_latency;
     sound_rate = rate;
     sound_samples = samples;
-    vm->update_sound_rate(rate, samples);
+    vm->update_sound_rate(rate, osd->get_sound_block_samples(rate, samples));
 #ifdef USE_SOUND_VOLUME
     for (int i = 0; i < USE_SOUND_VOLUME; i++) {
       vm->set_sound_device_volume(i, config.sound_volume_l[i],
@@ -552,7 +791,8 @@ void EMU::reset() {
 #if defined(_USE_QT)
     osd->reset_vm_node();
 #endif
-    vm->initialize_sound(sound_rate, sound_samples);
+    vm->initialize_sound(
+        sound_rate, osd->get_sound_block_samples(sound_rate, sound_samples));
 #ifdef USE_SOUND_VOLUME
     for (int i = 0; i < USE_SOUND_VOLUME; i++) {
       vm->set_sound_device_volume(i, config.sound_volume_l[i],
@@ -1681,7 +1921,17 @@ bool EMU::is_screen_changed() { return vm->is_screen_changed(); }
 #endif
 
 int EMU::draw_screen() {
-  if (vm) {
+  // neither the vm screen nor the window is updated for a skipped frame
+  if (frame_skipped && !emulation_thread_running) {
+    return 0;
+  }
+  // The emulation thread draws the VM screen after each batch of frames, and
+  // run-ahead draws it before rolling back.
+#ifdef USE_STATE
+  if (vm && !emulation_thread_running && !run_ahead_drawn) {
+#else
+  if (vm && !emulation_thread_running) {
+#endif
     vm->draw_screen();
   }
 
@@ -1693,10 +1943,28 @@ int EMU::draw_screen() {
   return osd->draw_screen();
 }
 
+bool EMU::is_screen_publishable_in_frame() {
+  // the ui thread presents the published screen at once, so the frame is not
+  // left to the end of vm->run(). Run-ahead frames are rolled back and only
+  // the last one is drawn.
+#ifdef USE_STATE
+  if (config.run_ahead_frames > 0) {
+    return false;
+  }
+#endif
+  return emulation_thread_running;
+}
+
 scrntype_t *EMU::get_screen_buffer(int y) {
   return osd->get_vm_screen_buffer(y);
 }
 
+void EMU::lock_screen_buffer(int *top, int *bottom) {
+  osd->lock_vm_screen_buffer(top, bottom);
+}
+
+void EMU::unlock_screen_buffer() { osd->unlock_vm_screen_buffer(); }
+
 #ifdef USE_SCREEN_FILTER
 void EMU::screen_skip_line(bool skip_line) {
   osd->screen_skip_line = skip_line;
@@ -1723,6 +1991,10 @@ void EMU::get_invalidated_rect(int *left, int *top, int *right, int *bottom) {
 }
 
 void EMU::reload_bitmap() { osd->reload_bitmap(); }
+#else
+bool EMU::get_invalidated_rect(int *left, int *top, int *right, int *bottom) {
+  return vm->get_invalidated_rect(left, top, right, bottom);
+}
 #endif
 
 #ifdef OSD_WIN32
@@ -3213,7 +3485,9 @@ bool EMU::load_state_tmp(const _TCHAR *file_path) {
           sound_samples =
               (int)(sound_rate * sound_latency_table[config.sound_latency] +
                     0.5);
-          vm->initialize_sound(sound_rate, sound_samples);
+          vm->initialize_sound(
+              sound_rate,
+              osd->get_sound_block_samples(sound_rate, sound_samples));
 #ifdef USE_SOUND_VOLUME
           for (int i = 0; i < USE_SOUND_VOLUME; i++) {
             vm->set_sound_device_volume(i, config.sound_volume_l[i],
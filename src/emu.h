@@ -28,6 +28,8 @@
 #include "vm/vm.h"
 #include <assert.h>
 #include <stdio.h>
+#include <atomic>
+#include <thread>
 
 #if defined(_USE_QT)
 #include <pthread.h>
@@ -35,6 +37,11 @@
 #elif defined(_USE_SDL)
 #include <pthread.h>
 #define OSD_SDL
+#elif defined(USE_BENCH)
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+#define OSD_BENCH
 #elif defined(USE_SDL3)
 #if !defined(_WIN32)
 #include <pthread.h>
@@ -53,6 +60,8 @@
 #include "qt/osd.h"
 #elif defined(OSD_SDL)
 #include "sdl/osd.h"
+#elif defined(OSD_BENCH)
+#include "bench/osd.h"
 #elif defined(OSD_SDL3)
 #include "sdl3/osd.h"
 #elif defined(OSD_WIN32)
@@ -183,6 +192,41 @@ private:
 #endif
   bool now_suspended;
 
+  // emulation thread
+  int run_vm();
+  void emulation_thread_main();
+  std::thread emulation_thread;
+  std::atomic<bool> emulation_thread_running;
+  std::atomic<bool> emulation_thread_terminated;
+
+  // frame pacing: frame n of the schedule is due at pacing_begin_ns +
+  // n * pacing_frame_ns, so the period keeps the fraction of the vm rate
+  uint64_t pacing_begin_ns;
+  uint64_t pacing_frames;
+  double pacing_frame_ns;
+  uint64_t next_frame_ns;
+  uint64_t sleep_margin_ns;
+  bool wait_next_frame();
+  uint64_t jitter_sum_ns, jitter_max_ns;
+  int jitter_count;
+  double jitter_avg_usec, jitter_max_usec;
+
+  // auto frame skip
+  bool frame_skipped;
+  int frame_skip_count;
+  int skipped_frames, skipped_frames_accum;
+  uint64_t frame_stats_begin_ns;
+
+  // run-ahead
+#ifdef USE_STATE
+  FILEIO *run_ahead_state;
+  bool run_ahead_drawn;
+  uint64_t run_ahead_begin_tick;
+  uint64_t run_ahead_save_ticks, run_ahead_load_ticks, run_ahead_total_ticks;
+  int run_ahead_count;
+  double run_ahead_save_msec, run_ahead_load_msec, run_ahead_total_msec;
+#endif
+
   // input
 #ifdef USE_AUTO_KEY
   FIFO *auto_key_buffer;
@@ -225,6 +269,25 @@ public:
   int get_frame_interval();
   bool is_frame_skippable();
   int run();
+  // run the vm on its own thread, run() only polls host input meanwhile
+  void start_emulation_thread();
+  void stop_emulation_thread();
+  bool is_emulation_thread_running() { return emulation_thread_running; }
+  // frames left undrawn by the auto frame skip in the last second
+  int get_skipped_frames() { return skipped_frames; }
+  // average and worst lateness of the frame starts against their schedule in
+  // the last second, and the part of the wait left to spinning
+  void get_frame_jitter(double *avg_usec, double *max_usec,
+                        double *spin_usec);
+#ifdef USE_STATE
+  // run config.run_ahead_frames frames ahead after the frames of run(), draw
+  // the last one and roll back
+  void run_ahead();
+  // average time per host frame spent to save and load the run-ahead state
+  // and for the whole run-ahead, updated every second
+  void get_run_ahead_cost(double *save_msec, double *load_msec,
+                          double *total_msec);
+#endif
   void reset();
 #ifdef USE_SPECIAL_RESET
   void special_reset();
@@ -293,12 +356,21 @@ public:
 #endif
   int draw_screen();
   scrntype_t *get_screen_buffer(int y);
+  // lines top..bottom-1 are written between lock and unlock
+  void lock_screen_buffer(int *top, int *bottom);
+  void unlock_screen_buffer();
+  // the vm may publish its screen as soon as the last line is rendered,
+  // before the frame ends, while the emulation thread runs without run-ahead
+  bool is_screen_publishable_in_frame();
 #ifdef USE_SCREEN_FILTER
   void screen_skip_line(bool skip_line);
 #endif
 #ifdef ONE_BOARD_MICRO_COMPUTER
   void get_invalidated_rect(int *left, int *top, int *right, int *bottom);
   void reload_bitmap();
+#else
+  // returns false if the whole screen should be updated
+  bool get_invalidated_rect(int *left, int *top, int *right, int *bottom);
 #endif
 #ifdef OSD_WIN32
   void invalidate_screen();
@@ -88,11 +88,15 @@ FILEIO::FILEIO()
 #endif
 	fp = NULL;
 	path[0] = _T('\0');
+	mem_opened = false;
+	mem_buffer = NULL;
+	mem_size = mem_capacity = mem_pos = 0;
 }
 
 FILEIO::~FILEIO(void)
 {
 	Fclose();
+	free(mem_buffer);
 }
 
 bool FILEIO::IsFileExisting(const _TCHAR *file_path)
@@ -269,6 +273,26 @@ bool FILEIO::Gzopen(const _TCHAR *file_path, int mode)
 }
 #endif
 
+bool FILEIO::Mopen(int mode)
+{
+	Fclose();
+	
+	switch(mode) {
+	case FILEIO_READ_BINARY:
+		break;
+	case FILEIO_WRITE_BINARY:
+		mem_size = 0;
+		break;
+	default:
+		return false;
+	}
+	path[0] = _T('\0');
+	open_mode = mode;
+	mem_pos = 0;
+	mem_opened = true;
+	return true;
+}
+
 void FILEIO::Fclose()
 {
 #ifdef USE_ZLIB
@@ -281,6 +305,7 @@ void FILEIO::Fclose()
 		fclose(fp);
 		fp = NULL;
 	}
+	mem_opened = false;
 	path[0] = _T('\0');
 }
 
@@ -850,6 +875,9 @@ int FILEIO::Fgetc()
 		return gzgetc(gz);
 	} else
 #endif
+	if(mem_opened) {
+		return (mem_pos < mem_size) ? mem_buffer[mem_pos++] : EOF;
+	}
 	if(fp != NULL) {
 		return fgetc(fp);
 	}
@@ -863,6 +891,10 @@ int FILEIO::Fputc(int c)
 		return gzputc(gz, c);
 	} else
 #endif
+	if(mem_opened) {
+		uint8_t data = (uint8_t)c;
+		return (Fwrite(&data, 1, 1) == 1) ? data : EOF;
+	}
 	if(fp != NULL) {
 		return fputc(c, fp);
 	}
@@ -950,6 +982,15 @@ size_t FILEIO::Fread(void* buffer, size_t size, size_t count)
 		return gzfread(buffer, size, count, gz);
 	} else
 #endif
+	if(mem_opened) {
+		size_t remain = mem_size - mem_pos;
+		if(size == 0 || count > remain / size) {
+			count = (size != 0) ? remain / size : 0;
+		}
+		memcpy(buffer, mem_buffer + mem_pos, size * count);
+		mem_pos += size * count;
+		return count;
+	}
 	if(fp != NULL) {
 		return fread(buffer, size, count, fp);
 	}
@@ -963,6 +1004,27 @@ size_t FILEIO::Fwrite(const void* buffer, size_t size, size_t count)
 		return gzfwrite(buffer, size, count, gz);
 	} else
 #endif
+	if(mem_opened) {
+		size_t length = size * count;
+		if(mem_pos + length > mem_capacity) {
+			size_t capacity = (mem_capacity != 0) ? mem_capacity : 0x10000;
+			while(capacity < mem_pos + length) {
+				capacity <<= 1;
+			}
+			uint8_t *tmp = (uint8_t *)realloc(mem_buffer, capacity);
+			if(tmp == NULL) {
+				return 0;
+			}
+			mem_buffer = tmp;
+			mem_capacity = capacity;
+		}
+		memcpy(mem_buffer + mem_pos, buffer, length);
+		mem_pos += length;
+		if(mem_size < mem_pos) {
+			mem_size = mem_pos;
+		}
+		return count;
+	}
 	if(fp != NULL) {
 		return fwrite(buffer, size, count, fp);
 	}
@@ -983,6 +1045,22 @@ int FILEIO::Fseek(long offset, int origin)
 		}
 	} else
 #endif
+	if(mem_opened) {
+		long pos = offset;
+		switch(origin) {
+		case FILEIO_SEEK_CUR:
+			pos += (long)mem_pos;
+			break;
+		case FILEIO_SEEK_END:
+			pos += (long)mem_size;
+			break;
+		}
+		if(pos < 0 || pos > (long)mem_size) {
+			return -1;
+		}
+		mem_pos = (size_t)pos;
+		return 0;
+	}
 	if(fp != NULL) {
 		switch(origin) {
 		case FILEIO_SEEK_CUR:
@@ -1003,6 +1081,9 @@ long FILEIO::Ftell()
 		return gztell(gz);
 	} else
 #endif
+	if(mem_opened) {
+		return (long)mem_pos;
+	}
 	if(fp != NULL) {
 		return ftell(fp);
 	}
@@ -1201,107 +1282,145 @@ void FILEIO::StateValue(wchar_t &val)
 
 void FILEIO::StateArray(bool *buffer, size_t size, size_t count)
 {
-	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
-		StateValue(buffer[i]);
-	}
+	// the byte order does not matter, so transfer the whole array at once
+	StateBuffer(buffer, size, count);
 }
 
 void FILEIO::StateArray(uint8_t *buffer, size_t size, size_t count)
 {
-	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
-		StateValue(buffer[i]);
-	}
+	StateBuffer(buffer, size, count);
 }
 
 void FILEIO::StateArray(uint16_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	// the state is little endian, same as the host
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(uint32_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(uint64_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(int8_t *buffer, size_t size, size_t count)
 {
-	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
-		StateValue(buffer[i]);
-	}
+	StateBuffer(buffer, size, count);
 }
 
 void FILEIO::StateArray(int16_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(int32_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(int64_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(pair16_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(pair32_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(pair64_t *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(float *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(double *buffer, size_t size, size_t count)
 {
+#ifdef __LITTLE_ENDIAN__
+	StateBuffer(buffer, size, count);
+#else
 	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
 		StateValue(buffer[i]);
 	}
+#endif
 }
 
 void FILEIO::StateArray(char *buffer, size_t size, size_t count)
 {
-	for(unsigned int i = 0; i < size / sizeof(buffer[0]) * count; i++) {
-		StateValue(buffer[i]);
-	}
+	StateBuffer(buffer, size, count);
 }
 
 void FILEIO::StateArray(wchar_t *buffer, size_t size, size_t count)
@@ -42,6 +42,10 @@ private:
 	FILE* fp;
 	_TCHAR path[_MAX_PATH];
 	int open_mode;
+	// memory stream
+	bool mem_opened;
+	uint8_t *mem_buffer;
+	size_t mem_size, mem_capacity, mem_pos;
 	
 public:
 	FILEIO();
@@ -56,6 +60,9 @@ public:
 #ifdef USE_ZLIB
 	bool Gzopen(const _TCHAR *file_path, int mode);
 #endif
+	// memory stream, FILEIO_WRITE_BINARY starts a new stream and FILEIO_READ_BINARY
+	// reads what was written, the buffer is kept over Fclose() and reused
+	bool Mopen(int mode);
 	void Fclose();
 	bool IsOpened()
 	{
@@ -64,6 +71,9 @@ public:
 			return true;
 		} else
 #endif
+		if(mem_opened) {
+			return true;
+		}
 		return (fp != NULL);
 	}
 	const _TCHAR *FilePath()
@@ -36,6 +36,11 @@ int main(int argc, char *argv[]) {
   OSD *osd = emu->get_osd();
   LOG("OSD obtained: %p", (void*)osd);
 
+  if (config.emulation_thread) {
+    LOG("Starting emulation thread...");
+    emu->start_emulation_thread();
+  }
+
   LOG("Entering main loop...");
   int frame_count = 0;
   while (!osd->is_terminated()) {
@@ -56,6 +61,7 @@ int main(int argc, char *argv[]) {
   }
 
   LOG("Main loop exited after %d frames", frame_count);
+  emu->stop_emulation_thread();
 
   LOG("Saving config...");
   save_config(create_local_path(_T("BubiC-8801MA.ini")));
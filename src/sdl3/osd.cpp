@@ -149,6 +149,11 @@ namespace Lang {
   static constexpr Msg VolumeLabel = {"Vol:", "音量:", "音量:", "음량:", "Vol:", "Vol:"};
   static constexpr Msg FPSView = {"FPS: %.1f", "表示: %.1f", "帧率: %.1f", "표시: %.1f", "FPS: %.1f", "IPS: %.1f"};
   static constexpr Msg FPSCore = {"Core: %.1f", "実行: %.1f", "核心: %.1f", "실행: %.1f", "Núcleo: %.1f", "Cœur: %.1f"};
+  static constexpr Msg FrameSkip = {"Skip: %d", "スキップ: %d", "跳帧: %d", "스킵: %d", "Salto: %d", "Saut : %d"};
+  // frame start lateness average / worst, and the spun part of the wait
+  static constexpr Msg FrameJitter = {"Frame jitter: %.0f/%.0f us (spin %.0f us)", "フレーム遅れ: %.0f/%.0f us (スピン %.0f us)", "帧抖动: %.0f/%.0f us (自旋 %.0f us)", "프레임 지터: %.0f/%.0f us (스핀 %.0f us)", "Fluctuación: %.0f/%.0f us (espera activa %.0f us)", "Gigue : %.0f/%.0f us (attente active %.0f us)"};
+  // state save + load / whole run-ahead per frame
+  static constexpr Msg RunAheadCost = {"Run-ahead %d: %.2f/%.2f ms", "先行実行 %d: %.2f/%.2f ms", "预运行 %d: %.2f/%.2f ms", "런어헤드 %d: %.2f/%.2f ms", "Adelanto %d: %.2f/%.2f ms", "Anticipation %d : %.2f/%.2f ms"};
 }
 
 // Alpha mask derived from the supplied mouse.png and reduced to 11x16.
@@ -340,6 +345,15 @@ static int sanitize_sound_samples_for_rate(int rate, int samples) {
   return samples;
 }
 
+// Audio callback: the vm hands out its sound in blocks of 1/50 sec. A block
+// and the samples of a frame must fit in the vm's buffer of two blocks.
+static const int SOUND_CALLBACK_BLOCKS_PER_SEC = 50;
+// The playback ratio moves at most this far from 1 to hold the fill level.
+static const double SOUND_RATE_CONTROL_MAX = 0.005;
+// Weight of the newest fill level in its running average.
+static const double SOUND_RATE_CONTROL_SMOOTH = 1.0 / 8.0;
+static const int SOUND_CALLBACK_CHUNK = 512;
+
 static int samples_to_latency_ms(int rate, int samples) {
   if (rate <= 0 || samples <= 0) {
     return 0;
@@ -387,6 +401,12 @@ OSD::OSD() {
   window = NULL;
   renderer = NULL;
   screen_texture = NULL;
+  screen_texture_invalid = true;
+  screen_texture_pixels = NULL;
+  screen_texture_pitch = 0;
+  screen_texture_top = screen_texture_bottom = 0;
+  screen_texture_updated = false;
+  vm_screen_buffer_stale = false;
   audio_stream = NULL;
   audio_speed_ratio = 1.0f;
   audio_src_rate = 0;
@@ -394,6 +414,13 @@ OSD::OSD() {
   requested_audio_rate = 0;
   requested_audio_latency_ms = 0;
   audio_paused_by_ui = false;
+  sound_callback = false;
+  sound_ring_target = 0;
+  sound_ring_phase = 0;
+  sound_ring_prev[0] = sound_ring_prev[1] = 0;
+  sound_ring_next[0] = sound_ring_next[1] = 0;
+  sound_ring_fill = 0.0;
+  sound_ring_primed = false;
   joystick = NULL;
   vm_mutex = SDL_CreateMutex();
   last_fps_tick = 0;
@@ -409,6 +436,7 @@ OSD::OSD() {
   show_menu = true;
   pending_memdump = false;
   native_dialog_open = false;
+  floppy_disk_accessed = 0;
   imgui_initialized = false;
   ui_interacting = false;
   ui_interacting_reason = UI_REASON_NONE;
@@ -421,6 +449,20 @@ OSD::OSD() {
   fd2_path[0] = _T('\0');
   pending_blank_type = 0;
   vm_screen_buffer = NULL;
+  emulation_thread_running = false;
+  for (int i = 0; i < 3; i++) {
+    screen_buffer[i] = NULL;
+    screen_buffer_top[i] = screen_buffer_bottom[i] = 0;
+    screen_buffer_serial[i] = 0;
+    screen_buffer_dirty_top[i] = screen_buffer_dirty_bottom[i] = 0;
+  }
+  screen_buffer_back = 0;
+  screen_buffer_front = 1;
+  screen_buffer_ready = 2;
+  screen_lock_top = screen_lock_bottom = 0;
+  screen_serial = displayed_screen_serial = 0;
+  screen_resize_pending = false;
+  requested_screen_width = requested_screen_height = 0;
   vm_screen_width = 0;
   vm_screen_height = 0;
   vm_screen_rect = {0, 0, 0, 0};
@@ -593,10 +635,13 @@ void OSD::release() {
     SDL_CloseJoystick(joystick);
     joystick = NULL;
   }
-  if (vm_screen_buffer) {
-    free(vm_screen_buffer);
-    vm_screen_buffer = NULL;
+  for (int i = 0; i < 3; i++) {
+    if (screen_buffer[i]) {
+      free(screen_buffer[i]);
+      screen_buffer[i] = NULL;
+    }
   }
+  vm_screen_buffer = NULL;
   if (screen_texture) {
     SDL_DestroyTexture(screen_texture);
     screen_texture = NULL;
@@ -629,6 +674,7 @@ void OSD::release_sound() {
     SDL_DestroyAudioStream(audio_stream);
     audio_stream = NULL;
   }
+  sound_callback = false;
   audio_src_rate = 0;
   audio_dst_rate = 0;
   audio_paused_by_ui = false;
@@ -670,6 +716,26 @@ void OSD::update_sound(int *extra_frames) {
     }
   }
 
+  // Keep sample timing stable on SDL3 path and let frequency-ratio handle speed.
+  ((VM *)vm)->pc88event->set_sample_multi(0x1000);
+
+  if (sound_callback) {
+    // Take only what the frames run so far have mixed. If the ring is full
+    // the rest is dropped.
+    const int block = get_sound_block_samples(sound_rate, sound_samples);
+    while (vm->get_sound_buffer_ptr() >= block) {
+      uint16_t *buffer = vm->create_sound(NULL);
+      if (!buffer) {
+        break;
+      }
+      sound_ring.write((const int16_t *)buffer, block);
+    }
+    if (extra_frames) {
+      *extra_frames = 0;
+    }
+    return;
+  }
+
   const int bytes_per_sample = 2 * (int)sizeof(uint16_t);
   const int block_bytes = sound_samples * bytes_per_sample;
   const int min_queued_bytes = block_bytes;
@@ -684,9 +750,6 @@ void OSD::update_sound(int *extra_frames) {
   }
   int total_extra_frames = 0;
 
-  // Keep sample timing stable on SDL3 path and let frequency-ratio handle speed.
-  ((VM *)vm)->pc88event->set_sample_multi(0x1000);
-
   // If queue is already large enough, avoid generating more this turn.
   if (queued >= max_queued_bytes) {
     if (extra_frames) {
@@ -743,9 +806,112 @@ void OSD::update_sound(int *extra_frames) {
 void OSD::stop_sound() {
   if (audio_stream) {
     SDL_ClearAudioStream(audio_stream);
+    clear_sound_ring();
   }
 }
 
+int OSD::get_sound_block_samples(int rate, int samples) {
+  if (config.sound_callback) {
+    int block = rate / SOUND_CALLBACK_BLOCKS_PER_SEC;
+    if (block > 0 && block < samples) {
+      return block;
+    }
+  }
+  return samples;
+}
+
+void SDLCALL OSD::audio_callback(void *userdata, SDL_AudioStream *stream,
+                                 int additional_amount, int total_amount) {
+  (void)total_amount;
+  const int frame_bytes = 2 * (int)sizeof(int16_t);
+  if (additional_amount >= frame_bytes) {
+    ((OSD *)userdata)->fill_audio_stream(stream, additional_amount / frame_bytes);
+  }
+}
+
+void OSD::fill_audio_stream(SDL_AudioStream *stream, int frames) {
+  // Dynamic rate control: read the ring slightly faster while it is fuller
+  // than the target and slower while it is emptier, so the fill level stays
+  // near the latency without the vm running ahead or behind.
+  int avail = sound_ring.readable();
+  if (!sound_ring_primed && avail >= sound_ring_target / 2) {
+    sound_ring_primed = true;
+    sound_ring_fill = avail;
+  }
+  sound_ring_fill += (avail - sound_ring_fill) * SOUND_RATE_CONTROL_SMOOTH;
+  double ratio = 1.0;
+  if (sound_ring_target > 0) {
+    ratio += SOUND_RATE_CONTROL_MAX * (sound_ring_fill - sound_ring_target) /
+             sound_ring_target;
+  }
+  ratio = std::clamp(ratio, 1.0 - SOUND_RATE_CONTROL_MAX,
+                     1.0 + SOUND_RATE_CONTROL_MAX);
+  const uint32_t step = (uint32_t)(ratio * 0x10000 + 0.5);
+
+  int16_t output[SOUND_CALLBACK_CHUNK * 2];
+  int used = 0;
+  while (frames > 0) {
+    const int count = std::min(frames, SOUND_CALLBACK_CHUNK);
+    for (int i = 0; i < count; i++) {
+      // Linear interpolation. On an underrun the last frame is held until
+      // the ring is half full again.
+      while (sound_ring_primed && sound_ring_phase >= 0x10000) {
+        if (used >= avail) {
+          sound_ring_primed = false;
+          break;
+        }
+        const int16_t *src = sound_ring.frame(used++);
+        sound_ring_prev[0] = sound_ring_next[0];
+        sound_ring_prev[1] = sound_ring_next[1];
+        sound_ring_next[0] = src[0];
+        sound_ring_next[1] = src[1];
+        sound_ring_phase -= 0x10000;
+      }
+      if (!sound_ring_primed) {
+        output[i * 2] = sound_ring_next[0];
+        output[i * 2 + 1] = sound_ring_next[1];
+        continue;
+      }
+      for (int ch = 0; ch < 2; ch++) {
+        int64_t delta = sound_ring_next[ch] - sound_ring_prev[ch];
+        output[i * 2 + ch] = (int16_t)(sound_ring_prev[ch] +
+                                       ((delta * sound_ring_phase) >> 16));
+      }
+      sound_ring_phase += step;
+    }
+    (void)SDL_PutAudioStreamData(stream, output, count * 2 * (int)sizeof(int16_t));
+    frames -= count;
+  }
+  sound_ring.skip(used);
+}
+
+void OSD::reset_sound_ring(int samples) {
+  // Called with the VM lock held while the callback is stopped or locked out,
+  // so neither side sees the buffer reallocated.
+  // Room for the target fill level, a block written on top of it, and the
+  // slack for the rate control to absorb.
+  sound_ring.resize(samples * 4);
+  sound_ring_target = samples;
+  sound_ring_phase = 0x10000;
+  sound_ring_prev[0] = sound_ring_prev[1] = 0;
+  sound_ring_next[0] = sound_ring_next[1] = 0;
+  sound_ring_fill = 0.0;
+  sound_ring_primed = false;
+}
+
+void OSD::clear_sound_ring() {
+  if (!audio_stream || !sound_callback) {
+    return;
+  }
+  // update_sound() writes the ring under the VM lock, and the callback reads
+  // it with the stream locked.
+  lock_vm();
+  SDL_LockAudioStream(audio_stream);
+  reset_sound_ring(sound_ring_target);
+  SDL_UnlockAudioStream(audio_stream);
+  unlock_vm();
+}
+
 bool OSD::reconfigure_sound(int rate, int samples) {
   rate = normalize_sound_rate_hz(rate);
   samples = sanitize_sound_samples_for_rate(rate, samples);
@@ -755,20 +921,49 @@ bool OSD::reconfigure_sound(int rate, int samples) {
   spec.format = SDL_AUDIO_S16;
   spec.freq = rate;
 
+  // The ring has a single consumer, so the old stream has to stop calling
+  // back before the new one starts. The callback runs with the stream locked.
+  const bool old_callback = audio_stream && sound_callback;
+  if (old_callback) {
+    (void)SDL_PauseAudioStreamDevice(audio_stream);
+    SDL_LockAudioStream(audio_stream);
+    SDL_UnlockAudioStream(audio_stream);
+  }
+  auto resume_old_stream = [&]() {
+    if (old_callback && !audio_paused_by_ui) {
+      (void)SDL_ResumeAudioStreamDevice(audio_stream);
+    }
+  };
+
+  const bool use_callback = config.sound_callback;
   SDL_AudioStream *new_stream =
-      SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, NULL,
-                                NULL);
+      SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec,
+                                use_callback ? audio_callback : NULL,
+                                use_callback ? this : NULL);
   if (!new_stream) {
     fprintf(stderr, "OSD: SDL_OpenAudioDeviceStream failed: %s\n",
             SDL_GetError());
     fflush(stderr);
+    resume_old_stream();
     return false;
   }
 
   (void)SDL_SetAudioStreamFrequencyRatio(new_stream, 1.0f);
   (void)SDL_SetAudioStreamGain(new_stream, config.master_volume / 100.0f);
+  // No callback runs now, and update_sound() is kept out by the VM lock.
+  if (use_callback || old_callback) {
+    lock_vm();
+    reset_sound_ring(samples);
+    unlock_vm();
+  }
   if (!SDL_ResumeAudioStreamDevice(new_stream)) {
     SDL_DestroyAudioStream(new_stream);
+    if (old_callback) {
+      lock_vm();
+      reset_sound_ring(sound_samples);
+      unlock_vm();
+    }
+    resume_old_stream();
     return false;
   }
 
@@ -787,6 +982,7 @@ bool OSD::reconfigure_sound(int rate, int samples) {
 
   SDL_AudioStream *old_stream = audio_stream;
   audio_stream = new_stream;
+  sound_callback = use_callback;
   sound_rate = rate;
   sound_samples = samples;
   audio_speed_ratio = 1.0f;
@@ -816,6 +1012,7 @@ void OSD::set_audio_pause_for_ui(bool pause) {
     (void)SDL_PauseAudioStreamDevice(audio_stream);
   } else {
     SDL_ClearAudioStream(audio_stream);
+    clear_sound_ring();
     (void)SDL_ResumeAudioStreamDevice(audio_stream);
   }
 }
@@ -1187,21 +1384,39 @@ void OSD::set_vm_screen_size(int screen_width, int screen_height,
                              int window_width, int window_height,
                              int window_width_aspect,
                              int window_height_aspect) {
+  if (emulation_thread_running) {
+    // the ui thread may be uploading a buffer, and textures belong to it
+    requested_screen_width = screen_width;
+    requested_screen_height = screen_height;
+    screen_resize_pending = true;
+    return;
+  }
+  resize_vm_screen(screen_width, screen_height);
+}
+
+void OSD::resize_vm_screen(int screen_width, int screen_height) {
   if (vm_screen_width == screen_width && vm_screen_height == screen_height &&
       vm_screen_buffer != NULL && screen_texture != NULL) {
     return;
   }
 
   if (vm_screen_width != screen_width || vm_screen_height != screen_height || vm_screen_buffer == NULL) {
-    if (vm_screen_buffer) {
-      free(vm_screen_buffer);
-    }
-    vm_screen_buffer =
-        (scrntype_t *)malloc(screen_width * screen_height * sizeof(scrntype_t));
+    for (int i = 0; i < 3; i++) {
+      if (screen_buffer[i]) {
+        free(screen_buffer[i]);
+      }
+      screen_buffer[i] =
+          (scrntype_t *)malloc(screen_width * screen_height * sizeof(scrntype_t));
+      memset(screen_buffer[i], 0,
+             screen_width * screen_height * sizeof(scrntype_t));
+      screen_buffer_dirty_top[i] = 0;
+      screen_buffer_dirty_bottom[i] = screen_height;
+    }
+    vm_screen_buffer = screen_buffer[screen_buffer_back];
     vm_screen_width = screen_width;
     vm_screen_height = screen_height;
-    memset(vm_screen_buffer, 0,
-           screen_width * screen_height * sizeof(scrntype_t));
+    // the vm renders the whole screen into the new buffer
+    vm_screen_buffer_stale = true;
   }
 
   if (renderer) {
@@ -1211,6 +1426,7 @@ void OSD::set_vm_screen_size(int screen_width, int screen_height,
     screen_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_XRGB8888,
                                        SDL_TEXTUREACCESS_STREAMING, screen_width,
                                        screen_height);
+    screen_texture_invalid = true;
   }
 }
 
@@ -1241,8 +1457,141 @@ void OSD::update_window_scale() {
   SDL_SetWindowSize(window, window_width, window_height);
 }
 
+static const int SCREEN_BUFFER_FRESH = 4;
+
+void OSD::lock_vm_screen_buffer(int *top, int *bottom) {
+  if (emulation_thread_running) {
+    // the back buffer misses the lines rendered into the other buffers
+    int back = screen_buffer_back;
+    if (screen_buffer_dirty_top[back] < screen_buffer_dirty_bottom[back]) {
+      if (*top < *bottom) {
+        *top = min(*top, screen_buffer_dirty_top[back]);
+        *bottom = max(*bottom, screen_buffer_dirty_bottom[back]);
+      } else {
+        *top = screen_buffer_dirty_top[back];
+        *bottom = screen_buffer_dirty_bottom[back];
+      }
+      screen_buffer_dirty_top[back] = vm_screen_height;
+      screen_buffer_dirty_bottom[back] = 0;
+    }
+    *top = max(*top, 0);
+    *bottom = min(*bottom, vm_screen_height);
+    screen_lock_top = *top;
+    screen_lock_bottom = *bottom;
+    return;
+  }
+  if (screen_texture_invalid) {
+    *top = 0;
+    *bottom = vm_screen_height;
+  }
+  *top = max(*top, 0);
+  *bottom = min(*bottom, vm_screen_height);
+  // render into the texture directly unless the screen buffer is read later
+  bool direct = (renderer != NULL && screen_texture != NULL && !show_state_dialog);
+  if (direct) {
+    std::lock_guard<std::mutex> lock(screenshot_mutex);
+    direct = pending_screenshot_path.empty();
+  }
+  if (direct) {
+    if (*top >= *bottom) {
+      return;
+    }
+    SDL_Rect rect = {0, *top, vm_screen_width, *bottom - *top};
+    if (SDL_LockTexture(screen_texture, &rect, &screen_texture_pixels, &screen_texture_pitch)) {
+      screen_texture_top = *top;
+      screen_texture_bottom = *bottom;
+      vm_screen_buffer_stale = true;
+      return;
+    }
+    screen_texture_pixels = NULL;
+  }
+  // the screen buffer is not updated while rendering into the texture
+  if (vm_screen_buffer_stale) {
+    *top = 0;
+    *bottom = vm_screen_height;
+    vm_screen_buffer_stale = false;
+  }
+}
+
+void OSD::unlock_vm_screen_buffer() {
+  if (emulation_thread_running) {
+    int back = screen_buffer_back;
+    screen_buffer_top[back] = screen_lock_top;
+    screen_buffer_bottom[back] = screen_lock_bottom;
+    screen_buffer_serial[back] = ++screen_serial;
+    if (screen_lock_top < screen_lock_bottom) {
+      for (int i = 0; i < 3; i++) {
+        if (i != back) {
+          screen_buffer_dirty_top[i] = min(screen_buffer_dirty_top[i], screen_lock_top);
+          screen_buffer_dirty_bottom[i] = max(screen_buffer_dirty_bottom[i], screen_lock_bottom);
+        }
+      }
+    }
+    // publish the frame and take the buffer draw_screen() has not taken yet,
+    // or released after the previous frame
+    back = screen_buffer_ready.exchange(back | SCREEN_BUFFER_FRESH) & 3;
+    screen_buffer_back = back;
+    vm_screen_buffer = screen_buffer[back];
+    return;
+  }
+  if (screen_texture_pixels) {
+    SDL_UnlockTexture(screen_texture);
+    screen_texture_pixels = NULL;
+    screen_texture_invalid = false;
+    screen_texture_updated = true;
+  }
+}
+
+void OSD::set_emulation_thread(bool running) {
+  // called while the emulation thread is not running
+  if (screen_resize_pending.exchange(false)) {
+    resize_vm_screen(requested_screen_width, requested_screen_height);
+  }
+  emulation_thread_running = running;
+  screen_buffer_back = 0;
+  screen_buffer_front = 1;
+  screen_buffer_ready = 2;
+  for (int i = 0; i < 3; i++) {
+    screen_buffer_dirty_top[i] = 0;
+    screen_buffer_dirty_bottom[i] = vm_screen_height;
+  }
+  vm_screen_buffer = screen_buffer[screen_buffer_back];
+  vm_screen_buffer_stale = true;
+  screen_texture_invalid = true;
+  displayed_screen_serial = screen_serial;
+}
+
+scrntype_t *OSD::get_displayed_screen_buffer() {
+  if (emulation_thread_running) {
+    return screen_buffer[screen_buffer_front];
+  }
+  // NULL until the vm renders into the screen buffer again
+  return vm_screen_buffer_stale ? NULL : vm_screen_buffer;
+}
+
+void OSD::update_screen_texture(const scrntype_t *buffer, int left, int top, int right, int bottom) {
+  left = max(left, 0);
+  top = max(top, 0);
+  right = min(right, vm_screen_width);
+  bottom = min(bottom, vm_screen_height);
+
+  void *pixels;
+  int pitch;
+  SDL_Rect rect = {left, top, right - left, bottom - top};
+
+  if (rect.w > 0 && rect.h > 0 && SDL_LockTexture(screen_texture, &rect, &pixels, &pitch)) {
+    for (int y = 0; y < rect.h; y++) {
+      memcpy((uint8_t *)pixels + y * pitch,
+             buffer + (top + y) * vm_screen_width + left,
+             rect.w * sizeof(scrntype_t));
+    }
+    SDL_UnlockTexture(screen_texture);
+    screen_texture_invalid = false;
+  }
+}
+
 int OSD::draw_screen() {
-  if (!renderer || !screen_texture || !vm_screen_buffer)
+  if (!renderer || !screen_texture || !screen_buffer[0])
     return 0;
 
   uint64_t current_tick = SDL_GetTicks();
@@ -1259,30 +1608,46 @@ int OSD::draw_screen() {
 
 
 
-  void *pixels;
-
-  int pitch;
-
-  if (SDL_LockTexture(screen_texture, NULL, &pixels, &pitch)) {
-
-    for (int y = 0; y < vm_screen_height; y++) {
-
-      memcpy((uint8_t *)pixels + y * pitch,
-
-             vm_screen_buffer + y * vm_screen_width,
-
-             vm_screen_width * sizeof(scrntype_t));
-
+  // upload only the lines rendered by the vm, the texture keeps other lines
+  if (emulation_thread_running) {
+    if (screen_resize_pending.exchange(false)) {
+      lock_vm();
+      resize_vm_screen(requested_screen_width, requested_screen_height);
+      unlock_vm();
     }
-
-    SDL_UnlockTexture(screen_texture);
-
+    // take the latest frame published by the emulation thread
+    if (screen_buffer_ready.load() & SCREEN_BUFFER_FRESH) {
+      int front = screen_buffer_ready.exchange(screen_buffer_front) & 3;
+      screen_buffer_front = front;
+      int top = screen_buffer_top[front], bottom = screen_buffer_bottom[front];
+      // frames skipped in between may have rendered other lines
+      if (screen_buffer_serial[front] != displayed_screen_serial + 1 || screen_texture_invalid) {
+        top = 0;
+        bottom = vm_screen_height;
+      }
+      displayed_screen_serial = screen_buffer_serial[front];
+      update_screen_texture(screen_buffer[front], 0, top, vm_screen_width, bottom);
+    } else if (screen_texture_invalid) {
+      update_screen_texture(screen_buffer[screen_buffer_front], 0, 0, vm_screen_width, vm_screen_height);
+    }
+  } else if (screen_texture_updated) {
+    // already rendered into the texture
+    screen_texture_updated = false;
+  } else {
+    int left = 0, top = 0, right = vm_screen_width, bottom = vm_screen_height;
+    if (!emu->get_invalidated_rect(&left, &top, &right, &bottom) || screen_texture_invalid) {
+      left = top = 0;
+      right = vm_screen_width;
+      bottom = vm_screen_height;
+    }
+    update_screen_texture(vm_screen_buffer, left, top, right, bottom);
   }
 
 
 
-  // Speed control via VSync. Apply only when mode changes.
-  const int desired_vsync_mode = config.full_speed ? 0 : 1;
+  // Speed control via VSync. Apply only when mode changes. The emulation
+  // thread runs at full speed by itself, so the ui keeps presenting on vsync.
+  const int desired_vsync_mode = (config.full_speed && !emulation_thread_running) ? 0 : 1;
   if (applied_vsync_mode != desired_vsync_mode) {
     SDL_SetRenderVSync(renderer, desired_vsync_mode);
     applied_vsync_mode = desired_vsync_mode;
@@ -1308,6 +1673,8 @@ int OSD::draw_screen() {
       return 0;
     }
 
+    // the ui frame is built without the VM lock, menus and dialogs queue their
+    // actions on the vm by post_vm_action()
     ImGui_ImplSDLRenderer3_NewFrame();
     ImGui_ImplSDL3_NewFrame();
     ImGui::NewFrame();
@@ -1341,27 +1708,6 @@ int OSD::draw_screen() {
       ImGui::EndMainMenuBar();
     }
 
-    // Process pending memory dump from folder dialog callback
-    if (pending_memdump && !pending_memdump_dir.empty()) {
-      std::time_t t = std::time(nullptr);
-      std::tm tm_local;
-#if defined(_WIN32)
-      localtime_s(&tm_local, &t);
-#else
-      localtime_r(&t, &tm_local);
-#endif
-      char stamp[32];
-      std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm_local);
-      std::string dir = pending_memdump_dir + "/BubiC_memdump_" + stamp;
-      bool ok = vm ? vm->dump_memory(dir.c_str()) : false;
-      fprintf(stderr, "%s %s\n",
-              ok ? "Memory dump written to"
-                 : "Memory dump FAILED at",
-              dir.c_str());
-      pending_memdump = false;
-      pending_memdump_dir.clear();
-    }
-
     // Draw Status Bar at the bottom
     const float status_height = 24.0f;
     if (ui_visible) {
@@ -1429,10 +1775,37 @@ int OSD::draw_screen() {
     vm_screen_rect_valid = true;
     SDL_RenderTexture(renderer, screen_texture, NULL, &dest_rect);
 
+    // apply the actions of this frame to the vm
+    lock_vm();
+    process_vm_actions();
     process_pending_insert();
     process_pending_dd();
     process_pending_save();
-    process_pending_screenshot();
+
+    // Process pending memory dump from folder dialog callback
+    if (pending_memdump && !pending_memdump_dir.empty()) {
+      std::time_t t = std::time(nullptr);
+      std::tm tm_local;
+#if defined(_WIN32)
+      localtime_s(&tm_local, &t);
+#else
+      localtime_r(&t, &tm_local);
+#endif
+      char stamp[32];
+      std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm_local);
+      std::string dir = pending_memdump_dir + "/BubiC_memdump_" + stamp;
+      bool ok = vm ? vm->dump_memory(dir.c_str()) : false;
+      fprintf(stderr, "%s %s\n",
+              ok ? "Memory dump written to"
+                 : "Memory dump FAILED at",
+              dir.c_str());
+      pending_memdump = false;
+      pending_memdump_dir.clear();
+    }
+
+    if (vm) {
+      floppy_disk_accessed = ((VM*)vm)->is_floppy_disk_accessed();
+    }
 
     // Pause emulation only when settings UI is actually open.
     // Hovering the menu bar should not pause the VM.
@@ -1456,6 +1829,9 @@ int OSD::draw_screen() {
     ui_interacting = next_ui_interacting;
     ui_interacting_reason = next_reason;
     prev_ui_interacting = next_ui_interacting;
+    unlock_vm();
+
+    process_pending_screenshot();
 
 
 
@@ -1497,6 +1873,19 @@ void OSD::unlock_vm() {
   }
 }
 
+void OSD::post_vm_action(std::function<void()> action) {
+  vm_actions.push_back(std::move(action));
+}
+
+void OSD::process_vm_actions() {
+  // actions may queue other actions
+  for (size_t i = 0; i < vm_actions.size(); i++) {
+    std::function<void()> action = std::move(vm_actions[i]);
+    action();
+  }
+  vm_actions.clear();
+}
+
 void OSD::draw_status_bar() {
   ImGuiViewport* viewport = ImGui::GetMainViewport();
   const float status_height = 24.0f;
@@ -1513,10 +1902,7 @@ void OSD::draw_status_bar() {
 
   if (ImGui::Begin("StatusBar", NULL, flags)) {
     // Disk Access Lamps
-    uint32_t accessed = 0;
-    if (vm) {
-      accessed = ((VM*)vm)->is_floppy_disk_accessed();
-    }
+    uint32_t accessed = floppy_disk_accessed;
 
     for (int i = 1; i >= 0; i--) {
       if (i != 1) {
@@ -1572,11 +1958,27 @@ void OSD::draw_status_bar() {
       emu_fps = 0.0f;
     }
 
-    char fps_text[128];
+    char fps_text[192];
     char view_text[64], core_text[64];
     snprintf(view_text, sizeof(view_text), (const char*)Lang::FPSView, current_fps);
     snprintf(core_text, sizeof(core_text), (const char*)Lang::FPSCore, emu_fps);
     snprintf(fps_text, sizeof(fps_text), "%s  %s", view_text, core_text);
+    if (config.auto_frame_skip > 0) {
+      // frames skipped in the last second
+      char skip_text[32];
+      snprintf(skip_text, sizeof(skip_text), (const char*)Lang::FrameSkip, emu->get_skipped_frames());
+      strncat(fps_text, "  ", sizeof(fps_text) - strlen(fps_text) - 1);
+      strncat(fps_text, skip_text, sizeof(fps_text) - strlen(fps_text) - 1);
+    }
+    if (config.run_ahead_frames > 0) {
+      char run_ahead_text[64];
+      double save_msec, load_msec, total_msec;
+      emu->get_run_ahead_cost(&save_msec, &load_msec, &total_msec);
+      snprintf(run_ahead_text, sizeof(run_ahead_text), (const char*)Lang::RunAheadCost,
+               config.run_ahead_frames, save_msec + load_msec, total_msec);
+      strncat(fps_text, "  ", sizeof(fps_text) - strlen(fps_text) - 1);
+      strncat(fps_text, run_ahead_text, sizeof(fps_text) - strlen(fps_text) - 1);
+    }
 
     char clock_text[64] = "";
     const char *boot_str = "";
@@ -1616,6 +2018,11 @@ void OSD::draw_status_bar() {
     ImGui::SameLine(right - fps_w);
     ImGui::AlignTextToFramePadding();
     ImGui::Text("%s", fps_text);
+    if (ImGui::IsItemHovered() && !config.full_speed) {
+      double avg_usec, max_usec, spin_usec;
+      emu->get_frame_jitter(&avg_usec, &max_usec, &spin_usec);
+      ImGui::SetTooltip((const char*)Lang::FrameJitter, avg_usec, max_usec, spin_usec);
+    }
     right -= (fps_w + 16.0f);
 
     if (clock_text[0] != '\0') {
@@ -1686,14 +2093,15 @@ void OSD::refresh_state_thumbnails() {
 }
 
 void OSD::save_state_thumbnail_for_slot(int slot) {
-  if (!emu || !vm_screen_buffer || vm_screen_width <= 0 || vm_screen_height <= 0) return;
+  scrntype_t *buffer = get_displayed_screen_buffer();
+  if (!emu || !buffer || vm_screen_width <= 0 || vm_screen_height <= 0) return;
   _TCHAR state_path_copy[_MAX_PATH];
   my_tcscpy_s(state_path_copy, _MAX_PATH, emu->state_file_path(slot));
   std::string thumb = thumbnail_path_for_state(state_path_copy);
 
   SDL_Surface *src = SDL_CreateSurfaceFrom(
       vm_screen_width, vm_screen_height, SDL_PIXELFORMAT_XRGB8888,
-      vm_screen_buffer, vm_screen_width * (int)sizeof(scrntype_t));
+      buffer, vm_screen_width * (int)sizeof(scrntype_t));
   if (!src) return;
 
   const int tw = 256;
@@ -1781,7 +2189,8 @@ void OSD::draw_state_dialog() {
     if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
       state_dialog_selected = i;
       if (slot_exists[i]) {
-        emu->load_state(slot_path[i]);
+        std::string path(slot_path[i]);
+        post_vm_action([this, path]() { emu->load_state(path.c_str()); });
         ImGui::PopID();
         ImGui::EndChild();
         ImGui::End();
@@ -1836,14 +2245,20 @@ void OSD::draw_state_dialog() {
   bool sel_exists = (sel >= 0 && sel < 10) ? slot_exists[sel] : false;
 
   if (ImGui::Button((const char *)Lang::SaveBtn, ImVec2(-FLT_MIN, 0))) {
-    emu->save_state(slot_path[sel]);
-    save_state_thumbnail_for_slot(sel);
-    refresh_state_thumbnails();
+    std::string path(slot_path[sel]);
+    post_vm_action([this, path, sel]() {
+      emu->save_state(path.c_str());
+      save_state_thumbnail_for_slot(sel);
+      if (show_state_dialog) {
+        refresh_state_thumbnails();
+      }
+    });
   }
   ImGui::Spacing();
   ImGui::BeginDisabled(!sel_exists);
   if (ImGui::Button((const char *)Lang::LoadBtn, ImVec2(-FLT_MIN, 0))) {
-    emu->load_state(slot_path[sel]);
+    std::string path(slot_path[sel]);
+    post_vm_action([this, path]() { emu->load_state(path.c_str()); });
     ImGui::EndDisabled();
     ImGui::EndChild();
     ImGui::End();
@@ -2195,19 +2610,19 @@ bool OSD::draw_menu_contents() {
     if (ImGui::BeginMenu(Lang::Control)) {
       menu_tree_open = true;
       if (ImGui::MenuItem(Lang::Reset)) {
-        if (emu) emu->reset();
+        post_vm_action([this]() { if (emu) emu->reset(); });
       }
       ImGui::Separator();
-      if (ImGui::MenuItem("CPU x0.25", NULL, config.cpu_power == 0.25f)) { config.cpu_power = 0.25f; if(vm) vm->update_config(); }
-      if (ImGui::MenuItem("CPU x0.5", NULL, config.cpu_power == 0.5f)) { config.cpu_power = 0.5f; if(vm) vm->update_config(); }
-      if (ImGui::MenuItem("CPU x1", NULL, config.cpu_power == 1.0f)) { config.cpu_power = 1.0f; if(vm) vm->update_config(); }
-      if (ImGui::MenuItem("CPU x2", NULL, config.cpu_power == 2.0f)) { config.cpu_power = 2.0f; if(vm) vm->update_config(); }
-      if (ImGui::MenuItem("CPU x4", NULL, config.cpu_power == 4.0f)) { config.cpu_power = 4.0f; if(vm) vm->update_config(); }
-      if (ImGui::MenuItem("CPU x8", NULL, config.cpu_power == 8.0f)) { config.cpu_power = 8.0f; if(vm) vm->update_config(); }
-      if (ImGui::MenuItem("CPU x16", NULL, config.cpu_power == 16.0f)) { config.cpu_power = 16.0f; if(vm) vm->update_config(); }
-      if (ImGui::MenuItem(Lang::FullSpeed, NULL, config.full_speed)) { config.full_speed = !config.full_speed; }
+      if (ImGui::MenuItem("CPU x0.25", NULL, config.cpu_power == 0.25f)) { post_vm_action([this]() { config.cpu_power = 0.25f; if(vm) vm->update_config(); }); }
+      if (ImGui::MenuItem("CPU x0.5", NULL, config.cpu_power == 0.5f)) { post_vm_action([this]() { config.cpu_power = 0.5f; if(vm) vm->update_config(); }); }
+      if (ImGui::MenuItem("CPU x1", NULL, config.cpu_power == 1.0f)) { post_vm_action([this]() { config.cpu_power = 1.0f; if(vm) vm->update_config(); }); }
+      if (ImGui::MenuItem("CPU x2", NULL, config.cpu_power == 2.0f)) { post_vm_action([this]() { config.cpu_power = 2.0f; if(vm) vm->update_config(); }); }
+      if (ImGui::MenuItem("CPU x4", NULL, config.cpu_power == 4.0f)) { post_vm_action([this]() { config.cpu_power = 4.0f; if(vm) vm->update_config(); }); }
+      if (ImGui::MenuItem("CPU x8", NULL, config.cpu_power == 8.0f)) { post_vm_action([this]() { config.cpu_power = 8.0f; if(vm) vm->update_config(); }); }
+      if (ImGui::MenuItem("CPU x16", NULL, config.cpu_power == 16.0f)) { post_vm_action([this]() { config.cpu_power = 16.0f; if(vm) vm->update_config(); }); }
+      if (ImGui::MenuItem(Lang::FullSpeed, NULL, config.full_speed)) { post_vm_action([]() { config.full_speed = !config.full_speed; }); }
       ImGui::Separator();
-      if (ImGui::MenuItem(Lang::RomajiToKana, NULL, config.romaji_to_kana)) { config.romaji_to_kana = !config.romaji_to_kana; }
+      if (ImGui::MenuItem(Lang::RomajiToKana, NULL, config.romaji_to_kana)) { post_vm_action([]() { config.romaji_to_kana = !config.romaji_to_kana; }); }
       ImGui::Separator();
       if (ImGui::MenuItem(Lang::StateDialogMenu)) {
         open_state_dialog();
@@ -2227,30 +2642,38 @@ bool OSD::draw_menu_contents() {
         menu_tree_open = true;
         if (ImGui::MenuItem(Lang::Insert)) { select_file(drv); }
         if (ImGui::MenuItem(Lang::Eject)) {
-          if (vm) {
-            vm->is_floppy_disk_protected(drv, false); // Clear write protect on eject
-            vm->close_floppy_disk(drv);
-          }
-          if (drv == 0) fd1_path[0] = '\0'; else fd2_path[0] = '\0';
-          if (emu) {
-            emu->floppy_disk_status[drv].path[0] = '\0';
-            emu->d88_file[drv].path[0] = '\0';
-          }
+          post_vm_action([this, drv]() {
+            if (vm) {
+              vm->is_floppy_disk_protected(drv, false); // Clear write protect on eject
+              vm->close_floppy_disk(drv);
+            }
+            if (drv == 0) fd1_path[0] = '\0'; else fd2_path[0] = '\0';
+            if (emu) {
+              emu->floppy_disk_status[drv].path[0] = '\0';
+              emu->d88_file[drv].path[0] = '\0';
+            }
+          });
         }
         if (ImGui::MenuItem(Lang::InsertBlank2D)) { select_save_file(drv, 0x00); }
         if (ImGui::MenuItem(Lang::InsertBlank2HD)) { select_save_file(drv, 0x20); }
         ImGui::Separator(); // ----
         bool inserted = (vm && vm->is_floppy_disk_inserted(drv));
         if (ImGui::MenuItem(Lang::WriteProtected, NULL, (vm && vm->is_floppy_disk_protected(drv)), inserted)) {
-          if(vm) vm->is_floppy_disk_protected(drv, !vm->is_floppy_disk_protected(drv));
+          post_vm_action([this, drv]() {
+            if(vm) vm->is_floppy_disk_protected(drv, !vm->is_floppy_disk_protected(drv));
+          });
         }
         if (ImGui::MenuItem(Lang::CorrectTiming, NULL, config.correct_disk_timing[drv])) {
-          config.correct_disk_timing[drv] = !config.correct_disk_timing[drv];
-          if(vm) vm->update_config();
+          post_vm_action([this, drv]() {
+            config.correct_disk_timing[drv] = !config.correct_disk_timing[drv];
+            if(vm) vm->update_config();
+          });
         }
         if (ImGui::MenuItem(Lang::IgnoreCRC, NULL, config.ignore_disk_crc[drv])) {
-          config.ignore_disk_crc[drv] = !config.ignore_disk_crc[drv];
-          if(vm) vm->update_config();
+          post_vm_action([this, drv]() {
+            config.ignore_disk_crc[drv] = !config.ignore_disk_crc[drv];
+            if(vm) vm->update_config();
+          });
         }
         ImGui::Separator(); // ----
 
@@ -2272,9 +2695,11 @@ bool OSD::draw_menu_contents() {
                 snprintf(b_label, sizeof(b_label), (const char*)Lang::ImageN, b + 1);
               }
               if (ImGui::MenuItem(b_label, NULL, emu->d88_file[drv].cur_bank == b)) {
-                if (vm) vm->open_floppy_disk(drv, emu->d88_file[drv].path, b);
-                emu->floppy_disk_status[drv].bank = b;
-                emu->d88_file[drv].cur_bank = b;
+                post_vm_action([this, drv, b]() {
+                  if (vm) vm->open_floppy_disk(drv, emu->d88_file[drv].path, b);
+                  emu->floppy_disk_status[drv].bank = b;
+                  emu->d88_file[drv].cur_bank = b;
+                });
               }
             }
           }
@@ -2296,31 +2721,36 @@ bool OSD::draw_menu_contents() {
             snprintf(label, sizeof(label), "%s##recent_%d", filename_utf8.c_str(), i);
 
             if (ImGui::MenuItem(label)) {
-              if (vm) {
-                vm->open_floppy_disk(drv, r_path, 0);
-                if (drv == 0) my_tcscpy_s(fd1_path, _MAX_PATH, utf8_path_to_tchar(filename_utf8.c_str()));
-                else my_tcscpy_s(fd2_path, _MAX_PATH, utf8_path_to_tchar(filename_utf8.c_str()));
-
-                if (emu) {
-                  my_tcscpy_s(emu->floppy_disk_status[drv].path, _MAX_PATH, r_path);
-                  emu->floppy_disk_status[drv].bank = 0;
-                  int banks = get_disk_names(tchar_to_char(r_path), drv, emu);
-                  emu->d88_file[drv].cur_bank = 0;
-
-                  // FD1選択時、FD2が空なら2番目のイメージを自動装填
-                  if (drv == 0 && fd2_path[0] == '\0' && banks >= 2) {
-                    vm->open_floppy_disk(1, r_path, 1);
-                    my_tcscpy_s(fd2_path, _MAX_PATH, utf8_path_to_tchar(filename_utf8.c_str()));
-                    my_tcscpy_s(emu->floppy_disk_status[1].path, _MAX_PATH, r_path);
-                    emu->floppy_disk_status[1].bank = 1;
-                    get_disk_names(tchar_to_char(r_path), 1, emu);
-                    emu->d88_file[1].cur_bank = 1;
-                    // 自動装填した分も履歴に追加
-                    add_recent_disk(r_path, 1);
+              // the recent list is reordered when the disk is inserted
+              std::string path(r_path);
+              post_vm_action([this, drv, path, filename_utf8]() {
+                const _TCHAR* r_path = path.c_str();
+                if (vm) {
+                  vm->open_floppy_disk(drv, r_path, 0);
+                  if (drv == 0) my_tcscpy_s(fd1_path, _MAX_PATH, utf8_path_to_tchar(filename_utf8.c_str()));
+                  else my_tcscpy_s(fd2_path, _MAX_PATH, utf8_path_to_tchar(filename_utf8.c_str()));
+
+                  if (emu) {
+                    my_tcscpy_s(emu->floppy_disk_status[drv].path, _MAX_PATH, r_path);
+                    emu->floppy_disk_status[drv].bank = 0;
+                    int banks = get_disk_names(tchar_to_char(r_path), drv, emu);
+                    emu->d88_file[drv].cur_bank = 0;
+
+                    // FD1選択時、FD2が空なら2番目のイメージを自動装填
+                    if (drv == 0 && fd2_path[0] == '\0' && banks >= 2) {
+                      vm->open_floppy_disk(1, r_path, 1);
+                      my_tcscpy_s(fd2_path, _MAX_PATH, utf8_path_to_tchar(filename_utf8.c_str()));
+                      my_tcscpy_s(emu->floppy_disk_status[1].path, _MAX_PATH, r_path);
+                      emu->floppy_disk_status[1].bank = 1;
+                      get_disk_names(tchar_to_char(r_path), 1, emu);
+                      emu->d88_file[1].cur_bank = 1;
+                      // 自動装填した分も履歴に追加
+                      add_recent_disk(r_path, 1);
+                    }
                   }
                 }
-              }
-              add_recent_disk(r_path, drv);
+                add_recent_disk(r_path, drv);
+              });
             }
           }
           ImGui::EndMenu();
@@ -2332,35 +2762,37 @@ bool OSD::draw_menu_contents() {
     if (ImGui::BeginMenu(Lang::Device)) {
       menu_tree_open = true;
       if (ImGui::BeginMenu(Lang::Boot)) {
-        if (ImGui::MenuItem("N88-V1(S) mode", NULL, config.boot_mode == 0)) { config.boot_mode = 0; if(emu) emu->reset(); }
-        if (ImGui::MenuItem("N88-V1(H) mode", NULL, config.boot_mode == 1)) { config.boot_mode = 1; if(emu) emu->reset(); }
-        if (ImGui::MenuItem("N88-V2 mode", NULL, config.boot_mode == 2)) { config.boot_mode = 2; if(emu) emu->reset(); }
-        if (ImGui::MenuItem("N mode", NULL, config.boot_mode == 3)) { config.boot_mode = 3; if(vm) vm->update_config(); } // Keep VM update if intended
+        if (ImGui::MenuItem("N88-V1(S) mode", NULL, config.boot_mode == 0)) { post_vm_action([this]() { config.boot_mode = 0; if(emu) emu->reset(); }); }
+        if (ImGui::MenuItem("N88-V1(H) mode", NULL, config.boot_mode == 1)) { post_vm_action([this]() { config.boot_mode = 1; if(emu) emu->reset(); }); }
+        if (ImGui::MenuItem("N88-V2 mode", NULL, config.boot_mode == 2)) { post_vm_action([this]() { config.boot_mode = 2; if(emu) emu->reset(); }); }
+        if (ImGui::MenuItem("N mode", NULL, config.boot_mode == 3)) { post_vm_action([this]() { config.boot_mode = 3; if(vm) vm->update_config(); }); } // Keep VM update if intended
         ImGui::EndMenu();
       }
       if (ImGui::BeginMenu(Lang::CPU)) {
-        if (ImGui::MenuItem("Z80 8MHz", NULL, config.cpu_type == 0)) { config.cpu_type = 0; if(vm) vm->update_config(); }
-        if (ImGui::MenuItem("Z80 4MHz", NULL, config.cpu_type == 1)) { config.cpu_type = 1; if(vm) vm->update_config(); }
-        if (ImGui::MenuItem("Z80 8MHz (FE2/MC)", NULL, config.cpu_type == 2)) { config.cpu_type = 2; if(vm) vm->update_config(); }
+        if (ImGui::MenuItem("Z80 8MHz", NULL, config.cpu_type == 0)) { post_vm_action([this]() { config.cpu_type = 0; if(vm) vm->update_config(); }); }
+        if (ImGui::MenuItem("Z80 4MHz", NULL, config.cpu_type == 1)) { post_vm_action([this]() { config.cpu_type = 1; if(vm) vm->update_config(); }); }
+        if (ImGui::MenuItem("Z80 8MHz (FE2/MC)", NULL, config.cpu_type == 2)) { post_vm_action([this]() { config.cpu_type = 2; if(vm) vm->update_config(); }); }
         ImGui::EndMenu();
       }
       if (ImGui::BeginMenu(Lang::Sound)) {
         bool is_opna = (config.sound_type == 0 || config.sound_type == 4 || config.sound_type == 5);
         if (ImGui::MenuItem("SOUND BOARD II", NULL, is_opna)) {
-          config.sound_type = is_opna ? 1 : 0; // Toggle between OPNA(0) and OPN(1)
-          if(emu) emu->reset();
+          post_vm_action([this, is_opna]() {
+            config.sound_type = is_opna ? 1 : 0; // Toggle between OPNA(0) and OPN(1)
+            if(emu) emu->reset();
+          });
         }
         ImGui::EndMenu();
       }
       if (ImGui::BeginMenu(Lang::Display)) {
-        if (ImGui::MenuItem(Lang::HighResolution, NULL, config.monitor_type == 0)) { config.monitor_type = 0; if(vm) vm->update_config(); }
-        if (ImGui::MenuItem(Lang::Standard, NULL, config.monitor_type == 1)) { config.monitor_type = 1; if(vm) vm->update_config(); }
+        if (ImGui::MenuItem(Lang::HighResolution, NULL, config.monitor_type == 0)) { post_vm_action([this]() { config.monitor_type = 0; if(vm) vm->update_config(); }); }
+        if (ImGui::MenuItem(Lang::Standard, NULL, config.monitor_type == 1)) { post_vm_action([this]() { config.monitor_type = 1; if(vm) vm->update_config(); }); }
         ImGui::Separator();
-        if (ImGui::MenuItem(Lang::ScanlineAuto, NULL, config.scan_line_auto)) { config.scan_line_auto = !config.scan_line_auto; if(vm) vm->update_config(); }
-        if (ImGui::MenuItem(Lang::Scanline, NULL, config.scan_line)) { config.scan_line = !config.scan_line; if(vm) vm->update_config(); }
+        if (ImGui::MenuItem(Lang::ScanlineAuto, NULL, config.scan_line_auto)) { post_vm_action([this]() { config.scan_line_auto = !config.scan_line_auto; if(vm) vm->update_config(); }); }
+        if (ImGui::MenuItem(Lang::Scanline, NULL, config.scan_line)) { post_vm_action([this]() { config.scan_line = !config.scan_line; if(vm) vm->update_config(); }); }
         ImGui::Separator();
         if (ImGui::MenuItem(Lang::IgnorePalette, NULL, (config.dipswitch & (1 << 5)) != 0)) {
-          config.dipswitch ^= (1 << 5); if(vm) vm->update_config();
+          post_vm_action([this]() { config.dipswitch ^= (1 << 5); if(vm) vm->update_config(); });
         }
         ImGui::EndMenu();
       }
@@ -2387,22 +2819,28 @@ bool OSD::draw_menu_contents() {
       if (ImGui::BeginMenu(Lang::Input)) {
         if (ImGui::MenuItem(Lang::EnableMouseInput, NULL,
                             config.mouse_enabled)) {
-          config.mouse_enabled = !config.mouse_enabled;
-          if (!config.mouse_enabled) disable_mouse();
-          if (vm) vm->update_config();
+          post_vm_action([this]() {
+            config.mouse_enabled = !config.mouse_enabled;
+            if (!config.mouse_enabled) disable_mouse();
+            if (vm) vm->update_config();
+          });
         }
         ImGui::MenuItem(Lang::ReleaseMouseCaptureHint, NULL, false, false);
         if (ImGui::BeginMenu(Lang::MouseMode, config.mouse_enabled)) {
           if (ImGui::MenuItem(Lang::Mouse, NULL, config.joystick_type == 1)) {
-            disable_mouse();
-            config.joystick_type = 1;
-            if (vm) vm->update_config();
+            post_vm_action([this]() {
+              disable_mouse();
+              config.joystick_type = 1;
+              if (vm) vm->update_config();
+            });
           }
           if (ImGui::MenuItem(Lang::MouseAsJoystick, NULL,
                               config.joystick_type == 2)) {
-            disable_mouse();
-            config.joystick_type = 2;
-            if (vm) vm->update_config();
+            post_vm_action([this]() {
+              disable_mouse();
+              config.joystick_type = 2;
+              if (vm) vm->update_config();
+            });
           }
           ImGui::EndMenu();
         }
@@ -2462,8 +2900,6 @@ bool OSD::draw_menu_contents() {
             if (ImGui::MenuItem(frequency_labels[i], NULL,
                                 config.sound_frequency == i)) {
               if (config.sound_frequency != i) {
-                const int prev_freq = config.sound_frequency;
-                const int prev_latency = config.sound_latency;
                 const int requested_rate = frequency_values[i];
                 const int requested_latency =
                     latency_values_ms[(config.sound_latency >= 0 &&
@@ -2472,15 +2908,18 @@ bool OSD::draw_menu_contents() {
                                           : 1];
                 requested_audio_rate = requested_rate;
                 requested_audio_latency_ms = requested_latency;
-                config.sound_frequency = i;
-                if (emu) {
-                  bool ok = emu->apply_host_sound_settings();
-                  if (!ok) {
-                    config.sound_frequency = prev_freq;
-                    config.sound_latency = prev_latency;
-                    continue;
+                post_vm_action([this, i]() {
+                  const int prev_freq = config.sound_frequency;
+                  const int prev_latency = config.sound_latency;
+                  config.sound_frequency = i;
+                  if (emu) {
+                    bool ok = emu->apply_host_sound_settings();
+                    if (!ok) {
+                      config.sound_frequency = prev_freq;
+                      config.sound_latency = prev_latency;
+                    }
                   }
-                }
+                });
               }
             }
           }
@@ -2491,8 +2930,6 @@ bool OSD::draw_menu_contents() {
             if (ImGui::MenuItem(latency_labels[i], NULL,
                                 config.sound_latency == i)) {
               if (config.sound_latency != i) {
-                const int prev_freq = config.sound_frequency;
-                const int prev_latency = config.sound_latency;
                 const int requested_rate =
                     frequency_values[(config.sound_frequency >= 0 &&
                                       config.sound_frequency < 5)
@@ -2501,15 +2938,18 @@ bool OSD::draw_menu_contents() {
                 const int requested_latency = latency_values_ms[i];
                 requested_audio_rate = requested_rate;
                 requested_audio_latency_ms = requested_latency;
-                config.sound_latency = i;
-                if (emu) {
-                  bool ok = emu->apply_host_sound_settings();
-                  if (!ok) {
-                    config.sound_frequency = prev_freq;
-                    config.sound_latency = prev_latency;
-                    continue;
+                post_vm_action([this, i]() {
+                  const int prev_freq = config.sound_frequency;
+                  const int prev_latency = config.sound_latency;
+                  config.sound_latency = i;
+                  if (emu) {
+                    bool ok = emu->apply_host_sound_settings();
+                    if (!ok) {
+                      config.sound_frequency = prev_freq;
+                      config.sound_latency = prev_latency;
+                    }
                   }
-                }
+                });
               }
             }
           }
@@ -2544,24 +2984,32 @@ bool OSD::draw_menu_contents() {
       }
       ImGui::Separator();
       if (ImGui::MenuItem(Lang::MuteFM, NULL, config.sound_mute_fm)) {
-        config.sound_mute_fm = !config.sound_mute_fm;
-        if (vm)
-          vm->update_mute();
+        post_vm_action([this]() {
+          config.sound_mute_fm = !config.sound_mute_fm;
+          if (vm)
+            vm->update_mute();
+        });
       }
       if (ImGui::MenuItem(Lang::MuteSSG, NULL, config.sound_mute_ssg)) {
-        config.sound_mute_ssg = !config.sound_mute_ssg;
-        if (vm)
-          vm->update_mute();
+        post_vm_action([this]() {
+          config.sound_mute_ssg = !config.sound_mute_ssg;
+          if (vm)
+            vm->update_mute();
+        });
       }
       if (ImGui::MenuItem(Lang::MuteADPCM, NULL, config.sound_mute_adpcm)) {
-        config.sound_mute_adpcm = !config.sound_mute_adpcm;
-        if (vm)
-          vm->update_mute();
+        post_vm_action([this]() {
+          config.sound_mute_adpcm = !config.sound_mute_adpcm;
+          if (vm)
+            vm->update_mute();
+        });
       }
       if (ImGui::MenuItem(Lang::MuteRhythm, NULL, config.sound_mute_rhythm)) {
-        config.sound_mute_rhythm = !config.sound_mute_rhythm;
-        if (vm)
-          vm->update_mute();
+        post_vm_action([this]() {
+          config.sound_mute_rhythm = !config.sound_mute_rhythm;
+          if (vm)
+            vm->update_mute();
+        });
       }
       ImGui::Separator();
       if (ImGui::BeginMenu(Lang::LanguageLabel)) {
@@ -2778,7 +3226,8 @@ void OSD::process_pending_screenshot() {
   std::string path_str;
   {
     std::lock_guard<std::mutex> lock(screenshot_mutex);
-    if (pending_screenshot_path.empty()) return;
+    // wait until the next frame is rendered into the screen buffer
+    if (pending_screenshot_path.empty() || !get_displayed_screen_buffer()) return;
     path_str = pending_screenshot_path;
     pending_screenshot_path.clear();
   }
@@ -2792,14 +3241,15 @@ void OSD::process_pending_screenshot() {
   }
 
   // Build surface from the VM's internal screen buffer (no UI overlay).
-  if (!vm_screen_buffer || vm_screen_width <= 0 || vm_screen_height <= 0) {
+  scrntype_t *buffer = get_displayed_screen_buffer();
+  if (!buffer || vm_screen_width <= 0 || vm_screen_height <= 0) {
     OSD_LOG("Screenshot failed: no screen buffer");
     return;
   }
 
   SDL_Surface *surface = SDL_CreateSurfaceFrom(
       vm_screen_width, vm_screen_height, SDL_PIXELFORMAT_XRGB8888,
-      vm_screen_buffer, vm_screen_width * (int)sizeof(scrntype_t));
+      buffer, vm_screen_width * (int)sizeof(scrntype_t));
   if (!surface) {
     OSD_LOG("Screenshot surface creation failed: %s", SDL_GetError());
     return;
@@ -9,7 +9,10 @@
 #include "../vm/vm.h"
 #include <SDL3/SDL.h>
 #include <string>
+#include <functional>
 #include <mutex>
+#include <atomic>
+#include <vector>
 
 // SDL3 specific definitions
 #define OSD_CONSOLE_BLUE 1
@@ -40,6 +43,60 @@ typedef struct pen_s {
   bool initialized() { return false; }
 } pen_t;
 
+// Lock-free single-producer/single-consumer ring of stereo 16-bit frames. The
+// emulation thread writes and the audio callback reads. resize() and clear()
+// must not run while either side is using the ring.
+class sound_ring_t {
+public:
+  sound_ring_t() : mask(0), read_pos(0), write_pos(0) {}
+  void resize(int frames) {
+    uint32_t size = 1;
+    while (size < (uint32_t)frames) {
+      size <<= 1;
+    }
+    buffer.assign(size * 2, 0);
+    mask = size - 1;
+    clear();
+  }
+  void clear() {
+    read_pos.store(0, std::memory_order_relaxed);
+    write_pos.store(0, std::memory_order_relaxed);
+  }
+  // Producer side: returns the frames written, the rest does not fit.
+  int write(const int16_t *src, int frames) {
+    uint32_t w = write_pos.load(std::memory_order_relaxed);
+    uint32_t space =
+        (uint32_t)(buffer.size() / 2) - (w - read_pos.load(std::memory_order_acquire));
+    if ((uint32_t)frames > space) {
+      frames = (int)space;
+    }
+    for (int i = 0; i < frames; i++) {
+      uint32_t p = ((w + i) & mask) * 2;
+      buffer[p] = src[i * 2];
+      buffer[p + 1] = src[i * 2 + 1];
+    }
+    write_pos.store(w + frames, std::memory_order_release);
+    return frames;
+  }
+  // Consumer side: frame(i) is the i-th unread frame, i < readable().
+  int readable() const {
+    return (int)(write_pos.load(std::memory_order_acquire) -
+                 read_pos.load(std::memory_order_relaxed));
+  }
+  const int16_t *frame(int i) const {
+    return &buffer[((read_pos.load(std::memory_order_relaxed) + i) & mask) * 2];
+  }
+  void skip(int frames) {
+    read_pos.store(read_pos.load(std::memory_order_relaxed) + frames,
+                   std::memory_order_release);
+  }
+
+private:
+  std::vector<int16_t> buffer;
+  uint32_t mask;
+  std::atomic<uint32_t> read_pos, write_pos;
+};
+
 class OSD {
 private:
   int lock_count;
@@ -68,7 +125,34 @@ private:
   SDL_Window *window;
   SDL_Renderer *renderer;
   SDL_Texture *screen_texture;
+  bool screen_texture_invalid;
+  // the vm renders into the locked texture instead of vm_screen_buffer
+  void *screen_texture_pixels;
+  int screen_texture_pitch;
+  int screen_texture_top, screen_texture_bottom;
+  bool screen_texture_updated;
+  bool vm_screen_buffer_stale;
   scrntype_t *vm_screen_buffer;
+  // triple buffered screen while the vm runs on the emulation thread:
+  // the vm renders into the back buffer and publishes it as the ready buffer,
+  // draw_screen() swaps the ready buffer with the front buffer it uploads
+  bool emulation_thread_running;
+  scrntype_t *screen_buffer[3];
+  int screen_buffer_back, screen_buffer_front;
+  std::atomic<int> screen_buffer_ready; // | SCREEN_BUFFER_FRESH until taken
+  int screen_buffer_top[3], screen_buffer_bottom[3];
+  uint32_t screen_buffer_serial[3];
+  // lines rendered into other buffers since the buffer was last rendered
+  int screen_buffer_dirty_top[3], screen_buffer_dirty_bottom[3];
+  int screen_lock_top, screen_lock_bottom;
+  uint32_t screen_serial, displayed_screen_serial;
+  // the vm asks for a new screen size on the emulation thread, and
+  // draw_screen() resizes the buffers and the texture on the ui thread
+  std::atomic<bool> screen_resize_pending;
+  int requested_screen_width, requested_screen_height;
+  void resize_vm_screen(int screen_width, int screen_height);
+  scrntype_t *get_displayed_screen_buffer();
+  void update_screen_texture(const scrntype_t *buffer, int left, int top, int right, int bottom);
   int vm_screen_width, vm_screen_height;
   int window_width, window_height;
   SDL_FRect vm_screen_rect;
@@ -88,6 +172,24 @@ private:
   int requested_audio_latency_ms;
   bool audio_paused_by_ui;
 
+  // Audio callback ([Sound] Callback): update_sound() writes every block the
+  // vm has mixed into sound_ring, and the callback resamples it at a ratio
+  // that keeps the fill level near the latency, so the vm never has to run
+  // extra frames to feed the device.
+  static void SDLCALL audio_callback(void *userdata, SDL_AudioStream *stream,
+                                     int additional_amount, int total_amount);
+  void fill_audio_stream(SDL_AudioStream *stream, int frames);
+  void reset_sound_ring(int samples);
+  void clear_sound_ring();
+  bool sound_callback;
+  sound_ring_t sound_ring;
+  int sound_ring_target;
+  // touched only by the callback once the device is running
+  uint32_t sound_ring_phase; // 16.16 position between the two frames
+  int16_t sound_ring_prev[2], sound_ring_next[2];
+  double sound_ring_fill;
+  bool sound_ring_primed;
+
   SDL_Joystick *joystick;
   SDL_Mutex *vm_mutex;
 
@@ -133,6 +235,13 @@ private:
   std::mutex screenshot_mutex;
   void show_screenshot_dialog();
   void process_pending_screenshot();
+  // actions on the vm are queued while the ui frame is built without the VM
+  // lock, and run under the lock after the frame is built
+  std::vector<std::function<void()>> vm_actions;
+  void post_vm_action(std::function<void()> action);
+  void process_vm_actions();
+  // access lamps are sampled with the actions, reading them clears them
+  uint32_t floppy_disk_accessed;
   // Save/Load state dialog
   bool show_state_dialog;
   int state_dialog_selected;
@@ -244,6 +353,7 @@ public:
   void add_extra_frames(int frames);
   void stop_sound();
   bool reconfigure_sound(int rate, int samples);
+  int get_sound_block_samples(int rate, int samples);
   int get_audio_source_rate() const { return audio_src_rate; }
   int get_audio_device_rate() const { return audio_dst_rate; }
   void mute_sound() {}
@@ -264,11 +374,21 @@ public:
   void restart_record_video() {}
   void capture_screen() {}
   scrntype_t *get_vm_screen_buffer(int y) {
+    if (screen_texture_pixels) {
+      if (y >= screen_texture_top && y < screen_texture_bottom) {
+        return (scrntype_t *)((uint8_t *)screen_texture_pixels +
+                              (y - screen_texture_top) * screen_texture_pitch);
+      }
+      return NULL;
+    }
     if (vm_screen_buffer && y >= 0 && y < vm_screen_height) {
       return vm_screen_buffer + y * vm_screen_width;
     }
     return NULL;
   }
+  void lock_vm_screen_buffer(int *top, int *bottom);
+  void unlock_vm_screen_buffer();
+  void set_emulation_thread(bool running);
   bool screen_skip_line;
 
   // Printer (Stub)
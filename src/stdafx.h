@@ -39,7 +39,9 @@
 
 // --- 3. Third-Party Library Headers ---
 #include <SDL3/SDL.h>
+#ifndef USE_BENCH
 #include "imgui.h"
+#endif
 
 // --- 4. Project's Own Common Header ---
 // This header relies on the headers above being included first.
@@ -43,6 +43,14 @@
 #define SIG_SCSI_ACK		309
 #define SIG_SCSI_RST		310
 
+// 4KB memory page that cpu can access directly without calling the memory device
+typedef struct {
+	uint8_t* read;
+	uint8_t* write;
+	int read_wait, write_wait, fetch_wait;
+	bool slow;	// read_data8w(), write_data8w() and fetch_op() must be called
+} mem_page_t;
+
 class DEVICE
 {
 protected:
@@ -678,12 +686,33 @@ public:
 		}
 		return event_manager->get_cpu_clocks(device);
 	}
-	virtual void update_event_in_op(int clock)
+	virtual int update_event_in_op(int clock)
+	{
+		if(event_manager == NULL) {
+			event_manager = vm->first_device->next_device;
+		}
+		return event_manager->update_event_in_op(clock);
+	}
+	virtual int get_clocks_until_input_event()
+	{
+		if(event_manager == NULL) {
+			event_manager = vm->first_device->next_device;
+		}
+		return event_manager->get_clocks_until_input_event();
+	}
+	virtual void catch_up_sub_cpu()
+	{
+		if(event_manager == NULL) {
+			event_manager = vm->first_device->next_device;
+		}
+		event_manager->catch_up_sub_cpu();
+	}
+	virtual void update_sub_cpu_clock(int clock)
 	{
 		if(event_manager == NULL) {
 			event_manager = vm->first_device->next_device;
 		}
-		event_manager->update_event_in_op(clock);
+		event_manager->update_sub_cpu_clock(clock);
 	}
 	virtual void register_event(DEVICE* device, int event_id, double usec, bool loop, int* register_id)
 	{
@@ -825,6 +854,14 @@ public:
 		}
 		event_manager->touch_sound();
 	}
+	// samples touch_sound() would mix now, a write made now lands after them
+	virtual int get_sound_pending_samples()
+	{
+		if(event_manager == NULL) {
+			event_manager = vm->first_device->next_device;
+		}
+		return event_manager->get_sound_pending_samples();
+	}
 	virtual void set_realtime_render(DEVICE* device, bool flag)
 	{
 		if(event_manager == NULL) {
@@ -843,6 +880,12 @@ public:
 	
 	// sound
 	virtual void mix(int32_t* buffer, int cnt) {}
+	// add the samples mixed on another thread, buffer holds the last cnt
+	// samples passed to mix(), returns true if any were added
+	virtual bool collect_sound(int32_t* buffer, int cnt)
+	{
+		return false;
+	}
 	virtual void set_volume(int ch, int decibel_l, int decibel_r) {} // +1 equals +0.5dB (same as fmgen)
 	
 #ifdef USE_DEBUGGER
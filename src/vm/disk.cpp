@@ -2956,13 +2956,29 @@ bool DISK::solid_to_d88(FILEIO *fio, int type, int ncyl, int nside, int nsec,
   return true;
 }
 
-#define STATE_VERSION 16
+#define STATE_VERSION 17
 
 bool DISK::process_state(FILEIO *state_fio, bool loading) {
-  if (!state_fio->StateCheckUint32(STATE_VERSION)) {
+  // version 16 had the whole buffer, it can still be loaded
+  uint32_t version = STATE_VERSION;
+  state_fio->StateValue(version);
+  if (!(version == STATE_VERSION || (loading && version == 16))) {
     return false;
   }
-  state_fio->StateArray(buffer, sizeof(buffer), 1);
+  if (version == 16) {
+    state_fio->StateArray(buffer, sizeof(buffer), 1);
+  } else {
+    // only the image and the track being formatted
+    state_fio->StateValue(file_size.d);
+    state_fio->StateValue(trim_required);
+    if (file_size.d > DISK_BUFFER_SIZE) {
+      return false;
+    }
+    state_fio->StateArray(buffer, file_size.d, 1);
+    if (trim_required) {
+      state_fio->StateArray(buffer + DISK_BUFFER_SIZE, TRACK_BUFFER_SIZE, 1);
+    }
+  }
   state_fio->StateArray(orig_path, sizeof(orig_path), 1);
   state_fio->StateArray(dest_path, sizeof(dest_path), 1);
   state_fio->StateValue(file_size.d);
@@ -2989,7 +3005,18 @@ bool DISK::process_state(FILEIO *state_fio, bool loading) {
   state_fio->StateValue(changed);
   state_fio->StateValue(media_type);
   state_fio->StateValue(is_special_disk);
-  state_fio->StateArray(track, sizeof(track), 1);
+  if (version == 16) {
+    state_fio->StateArray(track, sizeof(track), 1);
+  } else {
+    // the raw track is made within the track size, 12500 bytes of 1.44MB
+    // unless the size is given by the vm
+    int track_length = min(max(get_track_size(), 12500), TRACK_BUFFER_SIZE);
+    state_fio->StateValue(track_length);
+    if (track_length < 0 || track_length > TRACK_BUFFER_SIZE) {
+      return false;
+    }
+    state_fio->StateArray(track, track_length, 1);
+  }
   state_fio->StateValue(sector_num.sd);
   state_fio->StateValue(track_mfm);
   state_fio->StateValue(invalid_format);
@@ -114,6 +114,7 @@ public:
 		inserted = ejected = write_protected = changed = false;
 		is_special_disk = 0;
 		file_size.d = 0;
+		trim_required = false;
 		sector_size.sd = sector_num.sd = 0;
 		sector = unstable = NULL;
 		drive_type = DRIVE_TYPE_UNK;
@@ -33,10 +33,10 @@ void EVENT::initialize()
 	clocks_per_vline[0] = (int)((double)d_cpu[0].cpu_clocks / (double)FRAMES_PER_SEC / (double)LINES_PER_FRAME + 0.5);
 }
 
-void EVENT::initialize_sound(int rate, int samples)
+void EVENT::initialize_sound(int rate, int samples, int mix_rate)
 {
 	// Reconfigure path may call this repeatedly. Remove old mixer events first.
-	for(int i = 0; i < MAX_EVENT; i++) {
+	for(int i = 0; i < event_count; i++) {
 		if(event[i].active && event[i].device == this && event[i].event_id == EVENT_MIX) {
 			cancel_event(NULL, i);
 		}
@@ -54,6 +54,7 @@ void EVENT::initialize_sound(int rate, int samples)
 	}
 	
 	// release existing buffers for safe reinitialization
+	collect_mixed_sound();
 	if(sound_buffer) {
 		free(sound_buffer);
 		sound_buffer = NULL;
@@ -63,9 +64,25 @@ void EVENT::initialize_sound(int rate, int samples)
 		sound_tmp = NULL;
 	}
 	
+	if(mix_rate <= 0) {
+		mix_rate = rate;
+	}
+	if(resampler) {
+		delete resampler;
+		resampler = NULL;
+	}
+	
 	// initialize sound buffers
 	sound_samples = samples;
 	sound_tmp_samples = samples * 2;
+	sound_mix_rate = mix_rate;
+	if(mix_rate != rate) {
+		// sound_tmp holds the input of two blocks at the mixing rate
+		int input = (int)((int64_t)samples * mix_rate / rate) + 1;
+		sound_tmp_samples = (input + RESAMPLER_TAPS) * 2;
+		resampler = new RESAMPLER();
+		resampler->initialize(mix_rate, rate, sound_tmp_samples);
+	}
 	sound_buffer = (uint16_t*)malloc(sound_samples * sizeof(uint16_t) * 2);
 	sound_tmp = (int32_t*)malloc(sound_tmp_samples * sizeof(int32_t) * 2);
 	if(sound_buffer) {
@@ -76,14 +93,14 @@ void EVENT::initialize_sound(int rate, int samples)
 	}
 	buffer_ptr = 0;
 	mix_counter = 1;
-	mix_limit = (int)((double)(emu->get_sound_rate() / 2000.0)); // per 0.5ms.
+	mix_limit = (int)((double)(mix_rate / 2000.0)); // per 0.5ms.
 	if(mix_limit < 1) {
 		mix_limit = 1;
 	}
 	sound_changed = false;
 	
 	// register looped mixer event
-	this->register_event(this, EVENT_MIX, 1000000.0 / rate, true, NULL);
+	this->register_event(this, EVENT_MIX, 1000000.0 / mix_rate, true, NULL);
 }
 
 void EVENT::release()
@@ -95,12 +112,16 @@ void EVENT::release()
 	if(sound_tmp) {
 		free(sound_tmp);
 	}
+	if(resampler) {
+		delete resampler;
+		resampler = NULL;
+	}
 }
 
 void EVENT::reset()
 {
 	// clear events except loop event
-	for(int i = 0; i < MAX_EVENT; i++) {
+	for(int i = 0; i < event_count; i++) {
 		if(event[i].active && event[i].loop_clock == 0) {
 			cancel_event(NULL, i);
 		}
@@ -110,12 +131,16 @@ void EVENT::reset()
 	cpu_clocks_remain = cpu_clocks_accum = cpu_clocks_done = 0;
 	
 	// reset sound
+	collect_mixed_sound();
 	if(sound_buffer) {
 		memset(sound_buffer, 0, sound_samples * sizeof(uint16_t) * 2);
 	}
 	if(sound_tmp) {
 		memset(sound_tmp, 0, sound_tmp_samples * sizeof(int32_t) * 2);
 	}
+	if(resampler) {
+		resampler->reset();
+	}
 //	buffer_ptr = 0;
 	
 #ifdef _DEBUG_LOG
@@ -165,6 +190,10 @@ void EVENT::drive()
 	cur_vline = 0;
 	start_vline();
 	
+	// sub cpus are already synchronized to the primary cpu at the end of the previous frame
+	sub_cpu_lazy_sync = (dcount_cpu > 1 && config.lazy_sub_cpu_sync);
+	sub_cpu_event_clocks = event_clocks;
+	
 	// run virtual machine for 1 frame period
 	if(event_clocks_remain < 0) {
 		if(-event_clocks_remain > clocks_per_frame) {
@@ -180,10 +209,11 @@ void EVENT::drive()
 		int event_clocks_done = event_clocks_remain;
 		if(cpu_clocks_remain > 0) {
 			int cpu_clocks_done_tmp = 0;
-			if(dcount_cpu == 1) {
-				// run one opecode on primary cpu
+			if(dcount_cpu == 1 || sub_cpu_lazy_sync) {
+				// run one opecode (or opecodes until the next event in batch mode) on primary cpu,
+				// sub cpus will catch up when events are fired or they interact with primary cpu
 				cpu_clocks_in_op = 0;
-				cpu_clocks_done_tmp  = d_cpu[0].device->run(-1);
+				cpu_clocks_done_tmp  = d_cpu[0].device->run(get_primary_cpu_clocks());
 				cpu_clocks_done_tmp -= cpu_clocks_in_op;
 				#ifdef _DEBUG
 					assert(cpu_clocks_done_tmp >= 0);
@@ -192,9 +222,9 @@ void EVENT::drive()
 			} else {
 				// sync to sub cpus
 				if(cpu_clocks_done == 0) {
-					// run one opecode on primary cpu
+					// run one opecode (or opecodes until the next event in batch mode) on primary cpu
 					cpu_clocks_in_op = 0;
-					cpu_clocks_done  = d_cpu[0].device->run(-1);
+					cpu_clocks_done  = d_cpu[0].device->run(get_primary_cpu_clocks());
 					cpu_clocks_done -= cpu_clocks_in_op;
 					#ifdef _DEBUG
 						assert(cpu_clocks_done >= 0);
@@ -203,15 +233,7 @@ void EVENT::drive()
 					
 					// run sub cpus because the event has been aleady proceeded
 					if(cpu_clocks_in_op > 0) {
-						for(int i = 1; i < dcount_cpu; i++) {
-							// run sub cpus
-							d_cpu[i].accum_clocks += d_cpu[i].update_clocks * cpu_clocks_in_op;
-							int sub_clock = d_cpu[i].accum_clocks >> 10;
-							if(sub_clock) {
-								d_cpu[i].accum_clocks -= sub_clock << 10;
-								d_cpu[i].device->run(sub_clock);
-							}
-						}
+						run_sub_cpu(cpu_clocks_in_op);
 					}
 				}
 				if(cpu_clocks_done > 0) {
@@ -219,16 +241,7 @@ void EVENT::drive()
 					// so I need to give small enough clocks...
 					cpu_clocks_done_tmp = (cpu_clocks_done < 4) ? cpu_clocks_done : 4;
 					cpu_clocks_done -= cpu_clocks_done_tmp;
-					
-					for(int i = 1; i < dcount_cpu; i++) {
-						// run sub cpus
-						d_cpu[i].accum_clocks += d_cpu[i].update_clocks * cpu_clocks_done_tmp;
-						int sub_clock = d_cpu[i].accum_clocks >> 10;
-						if(sub_clock) {
-							d_cpu[i].accum_clocks -= sub_clock << 10;
-							d_cpu[i].device->run(sub_clock);
-						}
-					}
+					run_sub_cpu(cpu_clocks_done_tmp);
 				}
 			}
 			if(cpu_clocks_done_tmp > 0) {
@@ -251,6 +264,52 @@ void EVENT::drive()
 			event_clocks_remain -= event_clocks_done;
 		}
 	}
+	catch_up_sub_cpu();
+}
+
+void EVENT::run_sub_cpu(int clock)
+{
+	for(int i = 1; i < dcount_cpu; i++) {
+		d_cpu[i].accum_clocks += d_cpu[i].update_clocks * clock;
+		int sub_clock = d_cpu[i].accum_clocks >> 10;
+		if(sub_clock) {
+			d_cpu[i].accum_clocks -= sub_clock << 10;
+			if(sub_cpu_catching_up) {
+				event_clocks = sub_cpu_start_clocks;
+			}
+			sub_cpu_index = i;
+			d_cpu[i].device->run(sub_clock);
+		}
+	}
+}
+
+void EVENT::run_sub_cpu_until(uint64_t target_clocks)
+{
+	// sub cpus run from the clock where they have stopped, and event_clocks follows them
+	// (see update_sub_cpu_clock) so that their devices get the current clock and register
+	// events at the same clocks as sub cpus run in lockstep
+	sub_cpu_start_clocks = sub_cpu_event_clocks;
+	sub_cpu_event_clocks = target_clocks;
+	sub_cpu_catching_up = true;
+	run_sub_cpu((int)(target_clocks - sub_cpu_start_clocks));
+	sub_cpu_catching_up = false;
+	
+	// fire events registered by devices of sub cpus while catching up before the target,
+	// events at the target are fired by the caller in their order
+	if(next_fire_clock < target_clocks) {
+		fire_events(target_clocks - 1);
+	}
+	event_clocks = target_clocks;
+}
+
+void EVENT::update_sub_cpu_clock(int clock)
+{
+	// this is called from sub cpu before it accesses devices, and the given clocks are
+	// passed since it started to run
+	if(sub_cpu_catching_up && d_cpu[sub_cpu_index].update_clocks != 0) {
+		uint64_t clocks = sub_cpu_start_clocks + ((uint64_t)clock << 10) / d_cpu[sub_cpu_index].update_clocks;
+		event_clocks = (clocks < sub_cpu_event_clocks) ? clocks : sub_cpu_event_clocks;
+	}
 }
 
 void EVENT::start_vline()
@@ -265,9 +324,10 @@ void EVENT::start_vline()
 	}
 }
 
-void EVENT::update_event_in_op(int clock)
+int EVENT::update_event_in_op(int clock)
 {
 	// this is called from primary cpu while running one opecode
+	// returns the clocks that the cpu can run before the next call may fire events
 	if(config.drive_vm_in_opecode) {
 		cpu_clocks_in_op += clock;
 		
@@ -286,38 +346,69 @@ void EVENT::update_event_in_op(int clock)
 			}
 			event_clocks_remain -= event_clocks_done;
 		}
+		if(event_clocks_remain <= 0) {
+			return 0;
+		}
+		if(next_fire_clock - event_clocks < (uint64_t)event_clocks_remain) {
+			return (int)(next_fire_clock - event_clocks);
+		}
+		return event_clocks_remain;
 	}
+	return INT_MAX;
 }
 
-void EVENT::update_event(int clock)
+void EVENT::fire_events(uint64_t event_clocks_tmp)
 {
-	uint64_t event_clocks_tmp = event_clocks + clock;
-	
-	while(first_fire_event != NULL && first_fire_event->expired_clock <= event_clocks_tmp) {
-		event_t *event_handle = first_fire_event;
+	while(next_fire_clock <= event_clocks_tmp) {
+		event_t *event_handle = &event[fire_heap[0].index];
 		uint64_t expired_clock = event_handle->expired_clock;
+		DEVICE *device = event_handle->device;
+		int event_id = event_handle->event_id;
 		
-		first_fire_event = event_handle->next;
-		if(first_fire_event != NULL) {
-			first_fire_event->prev = NULL;
-		}
 		if(event_handle->loop_clock != 0) {
 			event_handle->accum_clocks += event_handle->loop_clock;
 			uint64_t clock_tmp = event_handle->accum_clocks >> 10;
 			event_handle->accum_clocks -= clock_tmp << 10;
 			event_handle->expired_clock += clock_tmp;
-			insert_event(event_handle);
+			fire_heap[0].expired_clock = event_handle->expired_clock;
+			fire_heap[0].insert_order = insert_order++;
+			heap_down(0);
 		} else {
+			heap_remove(0);
 			event_handle->active = false;
-			event_handle->next = first_free_event;
-			first_free_event = event_handle;
+			event_handle->next_free = first_free_event;
+			first_free_event = event_handle->index;
 		}
+		update_next_fire_clock();
 		event_clocks = expired_clock;
-		event_handle->device->event_callback(event_handle->event_id, 0);
+		catch_up_sub_cpu();
+		device->event_callback(event_id, 0);
 	}
 	event_clocks = event_clocks_tmp;
 }
 
+int EVENT::get_clocks_until_input_event()
+{
+	// sound mixing does not change any input of cpus, so it is not counted
+	uint64_t fire_clock = next_fire_clock;
+	if(fire_count != 0) {
+		const event_t &e = event[fire_heap[0].index];
+		if(e.device == this && e.event_id == EVENT_MIX) {
+			fire_clock = UINT64_MAX;
+			for(int i = 1; i <= 2 && i < fire_count; i++) {
+				if(fire_clock > fire_heap[i].expired_clock) {
+					fire_clock = fire_heap[i].expired_clock;
+				}
+			}
+		}
+	}
+	int clocks = (cpu_clocks_remain < event_clocks_remain) ? cpu_clocks_remain : event_clocks_remain;
+	if(fire_clock - event_clocks < (uint64_t)clocks) {
+		clocks = (int)(fire_clock - event_clocks);
+	}
+	return (clocks > 0) ? clocks : 0;
+}
+
 uint32_t EVENT::get_current_clock()
 {
 	return (uint32_t)(event_clocks & 0xffffffff);
@@ -358,7 +449,7 @@ void EVENT::register_event(DEVICE* device, int event_id, double usec, bool loop,
 #endif
 	
 	// register event
-	if(first_free_event == NULL) {
+	if(first_free_event == NO_EVENT && !grow_event_pool()) {
 #ifdef _DEBUG_LOG
 		this->out_debug_log(_T("EVENT: too many events !!!\n"));
 #endif
@@ -367,8 +458,8 @@ void EVENT::register_event(DEVICE* device, int event_id, double usec, bool loop,
 		}
 		return;
 	}
-	event_t *event_handle = first_free_event;
-	first_free_event = first_free_event->next;
+	event_t *event_handle = &event[first_free_event];
+	first_free_event = event_handle->next_free;
 	
 	if(register_id != NULL) {
 		*register_id = event_handle->index;
@@ -401,7 +492,7 @@ void EVENT::register_event_by_clock(DEVICE* device, int event_id, uint64_t clock
 #endif
 	
 	// register event
-	if(first_free_event == NULL) {
+	if(first_free_event == NO_EVENT && !grow_event_pool()) {
 #ifdef _DEBUG_LOG
 		this->out_debug_log(_T("EVENT: too many events !!!\n"));
 #endif
@@ -410,8 +501,8 @@ void EVENT::register_event_by_clock(DEVICE* device, int event_id, uint64_t clock
 		}
 		return;
 	}
-	event_t *event_handle = first_free_event;
-	first_free_event = first_free_event->next;
+	event_t *event_handle = &event[first_free_event];
+	first_free_event = event_handle->next_free;
 	
 	if(register_id != NULL) {
 		*register_id = event_handle->index;
@@ -428,59 +519,113 @@ void EVENT::register_event_by_clock(DEVICE* device, int event_id, uint64_t clock
 
 void EVENT::insert_event(event_t *event_handle)
 {
-	if(first_fire_event == NULL) {
-		first_fire_event = event_handle;
-		event_handle->prev = event_handle->next = NULL;
+	// events with the same expired clock fire in the order of insertion
+	fire_t entry;
+	entry.expired_clock = event_handle->expired_clock;
+	entry.insert_order = insert_order++;
+	entry.index = event_handle->index;
+	heap_set(fire_count++, entry);
+	heap_up(fire_count - 1);
+	update_next_fire_clock();
+}
+
+void EVENT::heap_up(int pos)
+{
+	fire_t entry = fire_heap[pos];
+	while(pos > 0) {
+		int parent = (pos - 1) >> 1;
+		if(!fires_before(entry, fire_heap[parent])) {
+			break;
+		}
+		heap_set(pos, fire_heap[parent]);
+		pos = parent;
+	}
+	heap_set(pos, entry);
+}
+
+void EVENT::heap_down(int pos)
+{
+	fire_t entry = fire_heap[pos];
+	for(;;) {
+		int child = pos * 2 + 1;
+		if(child >= fire_count) {
+			break;
+		}
+		if(child + 1 < fire_count && fires_before(fire_heap[child + 1], fire_heap[child])) {
+			child++;
+		}
+		if(!fires_before(fire_heap[child], entry)) {
+			break;
+		}
+		heap_set(pos, fire_heap[child]);
+		pos = child;
+	}
+	heap_set(pos, entry);
+}
+
+void EVENT::heap_remove(int pos)
+{
+	fire_t last = fire_heap[--fire_count];
+	if(pos < fire_count) {
+		heap_set(pos, last);
+		if(pos > 0 && fires_before(last, fire_heap[(pos - 1) >> 1])) {
+			heap_up(pos);
+		} else {
+			heap_down(pos);
+		}
+	}
+}
+
+bool EVENT::grow_event_pool()
+{
+	int new_count = event_count + MAX_EVENT;
+	event_t *new_event = (event_t *)realloc(event, new_count * sizeof(event_t));
+	if(new_event == NULL) {
+		return false;
+	}
+	event = new_event;
+	fire_t *new_heap = (fire_t *)realloc(fire_heap, new_count * sizeof(fire_t));
+	if(new_heap == NULL) {
+		return false;
+	}
+	fire_heap = new_heap;
+	
+	// new slots are appended to the tail of the free list
+	memset(&event[event_count], 0, (new_count - event_count) * sizeof(event_t));
+	for(int i = event_count; i < new_count; i++) {
+		event[i].active = false;
+		event[i].index = i;
+		event[i].heap_pos = -1;
+		event[i].next_free = (i + 1 < new_count) ? i + 1 : NO_EVENT;
+	}
+	if(first_free_event == NO_EVENT) {
+		first_free_event = event_count;
 	} else {
-		for(event_t *insert_pos = first_fire_event; insert_pos != NULL; insert_pos = insert_pos->next) {
-			if(insert_pos->expired_clock > event_handle->expired_clock) {
-				if(insert_pos->prev != NULL) {
-					// insert
-					insert_pos->prev->next = event_handle;
-					event_handle->prev = insert_pos->prev;
-					event_handle->next = insert_pos;
-					insert_pos->prev = event_handle;
-					break;
-				} else {
-					// add to head
-					first_fire_event = event_handle;
-					event_handle->prev = NULL;
-					event_handle->next = insert_pos;
-					insert_pos->prev = event_handle;
-					break;
-				}
-			} else if(insert_pos->next == NULL) {
-				// add to tail
-				insert_pos->next = event_handle;
-				event_handle->prev = insert_pos;
-				event_handle->next = NULL;
-				break;
-			}
+		int tail = first_free_event;
+		while(event[tail].next_free != NO_EVENT) {
+			tail = event[tail].next_free;
 		}
+		event[tail].next_free = event_count;
 	}
+	event_count = new_count;
+	return true;
 }
 
 void EVENT::cancel_event(DEVICE* device, int register_id)
 {
 	// cancel registered event
-	if(0 <= register_id && register_id < MAX_EVENT) {
+	if(0 <= register_id && register_id < event_count) {
 		event_t *event_handle = &event[register_id];
 		if(device != NULL && device != event_handle->device) {
 			this->out_debug_log(_T("EVENT: device (name=%s, id=%d) tries to calcel event that is not its own !!!\n"), device->this_device_name, device->this_device_id);
 			return;
 		}
 		if(event_handle->active) {
-			if(event_handle->prev != NULL) {
-				event_handle->prev->next = event_handle->next;
-			} else {
-				first_fire_event = event_handle->next;
-			}
-			if(event_handle->next != NULL) {
-				event_handle->next->prev = event_handle->prev;
-			}
+			heap_remove(event_handle->heap_pos);
+			update_next_fire_clock();
 			event_handle->active = false;
-			event_handle->next = first_free_event;
-			first_free_event = event_handle;
+			event_handle->next_free = first_free_event;
+			first_free_event = event_handle->index;
 		}
 	}
 }
@@ -516,10 +661,10 @@ void EVENT::register_vline_event(DEVICE* device)
 
 uint32_t EVENT::get_event_remaining_clock(int register_id)
 {
-	if(0 <= register_id && register_id < MAX_EVENT) {
+	if(0 <= register_id && register_id < event_count) {
 		event_t *event_handle = &event[register_id];
-		if(event_handle->active && event->expired_clock > event_clocks) {
-			return (uint32_t)(event->expired_clock - event_clocks);
+		if(event_handle->active && event_handle->expired_clock > event_clocks) {
+			return (uint32_t)(event_handle->expired_clock - event_clocks);
 		}
 	}
 	return 0;
@@ -544,6 +689,20 @@ void EVENT::touch_sound()
 	}
 }
 
+int EVENT::get_sound_pending_samples()
+{
+	if(!(config.sound_strict_rendering || (need_mix > 0))) {
+		int samples = mix_counter;
+		if(samples >= (sound_tmp_samples - buffer_ptr)) {
+			samples = sound_tmp_samples - buffer_ptr;
+		}
+		if(samples > 0) {
+			return samples;
+		}
+	}
+	return 0;
+}
+
 void EVENT::set_realtime_render(DEVICE* device, bool flag)
 {
 	assert(device != NULL && device->this_device_id < MAX_DEVICE);
@@ -568,7 +727,11 @@ void EVENT::event_callback(int event_id, int err)
 	} else if(event_id == EVENT_MIX) {
 		// mix sound
 		if(prev_skip && dont_skip_frames == 0 && !sound_changed) {
-			buffer_ptr = 0;
+			// the samples mixed on another thread may change the sound
+			collect_mixed_sound();
+			if(!sound_changed) {
+				buffer_ptr = 0;
+			}
 		}
 		int remain = sound_tmp_samples - buffer_ptr;
 		
@@ -601,6 +764,9 @@ void EVENT::event_callback(int event_id, int err)
 
 void EVENT::mix_sound(int samples)
 {
+	if(sound_muted) {
+		return;
+	}
 	if(samples > 0) {
 		int32_t* buffer = sound_tmp + buffer_ptr * 2;
 		memset(buffer, 0, samples * sizeof(int32_t) * 2);
@@ -624,6 +790,29 @@ void EVENT::mix_sound(int samples)
 	}
 }
 
+void EVENT::collect_mixed_sound()
+{
+	// add the samples of the devices mixing on another thread before they
+	// leave sound_tmp
+	if(sound_tmp == NULL || buffer_ptr <= 0) {
+		return;
+	}
+	bool collected = false;
+	for(int i = 0; i < dcount_sound; i++) {
+		if(d_sound[i]->collect_sound(sound_tmp, buffer_ptr)) {
+			collected = true;
+		}
+	}
+	if(collected && !sound_changed) {
+		for(int i = 0; i < buffer_ptr * 2; i += 2) {
+			if(sound_tmp[i] != sound_tmp[0] || sound_tmp[i + 1] != sound_tmp[1]) {
+				sound_changed = true;
+				break;
+			}
+		}
+	}
+}
+
 uint16_t* EVENT::create_sound(int* extra_frames) {
 	if(extra_frames) {
 		*extra_frames = 0;
@@ -631,6 +820,7 @@ uint16_t* EVENT::create_sound(int* extra_frames) {
 	if(!sound_buffer || !sound_tmp || sound_samples <= 0 || sound_tmp_samples <= 0) {
 		return sound_buffer;
 	}
+	collect_mixed_sound();
 
 	if(prev_skip && dont_skip_frames == 0 && !sound_changed) {
 
@@ -651,6 +841,10 @@ uint16_t* EVENT::create_sound(int* extra_frames) {
 	// Dynamic sample adjustment (XM8 style)
 
 	int target_samples = (sound_samples * sample_multi + 0x800) >> 12;
+	if(resampler) {
+		// the input for a block depends on the position of the resampler
+		target_samples = resampler->get_input_samples(sound_samples);
+	}
 	if(target_samples < 1) {
 		target_samples = 1;
 	}
@@ -669,6 +863,24 @@ uint16_t* EVENT::create_sound(int* extra_frames) {
 		frames++;
 
 	}
+	if(frames > 0) {
+		collect_mixed_sound();
+	}
+	
+	if(resampler) {
+		// convert to the host rate in one pass, and keep the input left over
+		resampler->process(sound_tmp, target_samples, sound_buffer, sound_samples);
+		if(buffer_ptr > target_samples) {
+			buffer_ptr -= target_samples;
+			memmove(sound_tmp, sound_tmp + target_samples * 2, buffer_ptr * sizeof(int32_t) * 2);
+		} else {
+			buffer_ptr = 0;
+		}
+		if(extra_frames) {
+			*extra_frames = frames;
+		}
+		return sound_buffer;
+	}
 
 #ifdef LOW_PASS_FILTER
 
@@ -708,9 +920,27 @@ uint16_t* EVENT::create_sound(int* extra_frames) {
 
 int EVENT::get_sound_buffer_ptr()
 {
+	// in samples at the host rate
+	if(resampler) {
+		return resampler->get_output_samples(buffer_ptr);
+	}
 	return buffer_ptr;
 }
 
+void EVENT::set_sound_muted(bool value)
+{
+	// while muted, frames are run without mixing and the sound buffer is kept
+	// when the state is loaded, so they can be rolled back without a glitch
+	if(value && !sound_muted) {
+		muted_mix_counter = mix_counter;
+		muted_next_skip = next_skip;
+	} else if(!value && sound_muted) {
+		mix_counter = muted_mix_counter;
+		next_skip = muted_next_skip;
+	}
+	sound_muted = value;
+}
+
 void EVENT::request_skip_frames()
 {
 	next_skip = true;
@@ -739,11 +969,16 @@ void EVENT::update_config()
 	// CPU speed multiplier is handled by EMU timing control.
 }
 
-#define STATE_VERSION	5
+#define STATE_VERSION	6
 
 bool EVENT::process_state(FILEIO* state_fio, bool loading)
 {
-	if(!state_fio->StateCheckUint32(STATE_VERSION)) {
+	collect_mixed_sound();
+	
+	// version 5 had the fixed 64-slot event array, it can still be loaded
+	uint32_t version = STATE_VERSION;
+	state_fio->StateValue(version);
+	if(!(version == STATE_VERSION || (loading && version == 5))) {
 		return false;
 	}
 	if(!state_fio->StateCheckInt32(this_device_id)) {
@@ -765,31 +1000,120 @@ bool EVENT::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(cpu_clocks_done);
 	state_fio->StateValue(cpu_clocks_in_op);
 	state_fio->StateValue(event_clocks);
-	for(int i = 0; i < MAX_EVENT; i++) {
-		if(loading) {
+	
+	// events are stored as the old sorted list (next/prev indices of the
+	// fire order, free list chained by next) to keep the layout unchanged
+	int saved_count = event_count;
+	if(version >= 6) {
+		state_fio->StateValue(saved_count);
+	} else {
+		saved_count = MAX_EVENT;
+	}
+	if(saved_count < 0) {
+		return false;
+	}
+	if(loading) {
+		while(event_count < saved_count) {
+			if(!grow_event_pool()) {
+				return false;
+			}
+		}
+		for(int i = 0; i < event_count; i++) {
+			event[i].active = false;
+			event[i].heap_pos = -1;
+			event[i].next_free = NO_EVENT;
+		}
+		fire_count = 0;
+		for(int i = 0; i < saved_count; i++) {
 			event[i].device = vm->get_device(state_fio->FgetInt32_LE());
-		} else {
-			state_fio->FputInt32_LE(event[i].device != NULL ? event[i].device->this_device_id : -1);
+			state_fio->StateValue(event[i].event_id);
+			state_fio->StateValue(event[i].expired_clock);
+			state_fio->StateValue(event[i].loop_clock);
+			state_fio->StateValue(event[i].accum_clocks);
+			state_fio->StateValue(event[i].active);
+			int next = state_fio->FgetInt32_LE();
+			state_fio->FgetInt32_LE(); // prev
+			event[i].next_free = (next >= 0 && next < saved_count) ? next : NO_EVENT;
 		}
-		state_fio->StateValue(event[i].event_id);
-		state_fio->StateValue(event[i].expired_clock);
-		state_fio->StateValue(event[i].loop_clock);
-		state_fio->StateValue(event[i].accum_clocks);
-		state_fio->StateValue(event[i].active);
-		if(loading) {
-			event[i].next = (event_t *)get_event(state_fio->FgetInt32_LE());
-			event[i].prev = (event_t *)get_event(state_fio->FgetInt32_LE());
-		} else {
-			state_fio->FputInt32_LE(event[i].next != NULL ? event[i].next->index : -1);
-			state_fio->FputInt32_LE(event[i].prev != NULL ? event[i].prev->index : -1);
+		int free_index = state_fio->FgetInt32_LE();
+		int fire_index = state_fio->FgetInt32_LE();
+		
+		// rebuild the fire heap in the saved order
+		insert_order = 0;
+		for(int i = 0; i < saved_count && fire_index >= 0 && fire_index < saved_count; i++) {
+			event_t *event_handle = &event[fire_index];
+			if(!event_handle->active || event_handle->heap_pos >= 0) {
+				break;
+			}
+			fire_index = event_handle->next_free;
+			insert_event(event_handle);
 		}
-	}
-	if(loading) {
-		first_free_event = (event_t *)get_event(state_fio->FgetInt32_LE());
-		first_fire_event = (event_t *)get_event(state_fio->FgetInt32_LE());
+		// rebuild the free list, slots not in the saved state go to the tail
+		int *link = &first_free_event;
+		for(int i = 0; i < saved_count && free_index >= 0 && free_index < saved_count; i++) {
+			event_t *event_handle = &event[free_index];
+			if(event_handle->active || event_handle->heap_pos == -2) {
+				break;
+			}
+			event_handle->heap_pos = -2;
+			*link = free_index;
+			link = &event_handle->next_free;
+			free_index = event_handle->next_free;
+		}
+		for(int i = 0; i < event_count; i++) {
+			event_t *event_handle = &event[i];
+			if(event_handle->heap_pos == -2) {
+				event_handle->heap_pos = -1;
+			} else if(event_handle->active && event_handle->heap_pos < 0) {
+				// active but not reachable from the fire list
+				event_handle->active = false;
+				*link = i;
+				link = &event_handle->next_free;
+			} else if(!event_handle->active) {
+				*link = i;
+				link = &event_handle->next_free;
+			}
+		}
+		*link = NO_EVENT;
 	} else {
-		state_fio->FputInt32_LE(first_free_event != NULL ? first_free_event->index : -1);
-		state_fio->FputInt32_LE(first_fire_event != NULL ? first_fire_event->index : -1);
+		// sort active events into fire order
+		fire_t *order = (fire_t *)malloc((fire_count + 1) * sizeof(fire_t));
+		int *next = (int *)malloc(event_count * sizeof(int) * 2);
+		if(order == NULL || next == NULL) {
+			free(order);
+			free(next);
+			return false;
+		}
+		int *prev = next + event_count;
+		for(int i = 0; i < fire_count; i++) {
+			int j = i;
+			for(; j > 0 && fires_before(fire_heap[i], order[j - 1]); j--) {
+				order[j] = order[j - 1];
+			}
+			order[j] = fire_heap[i];
+		}
+		for(int i = 0; i < event_count; i++) {
+			next[i] = event[i].active ? NO_EVENT : event[i].next_free;
+			prev[i] = NO_EVENT;
+		}
+		for(int i = 0; i < fire_count; i++) {
+			next[order[i].index] = (i + 1 < fire_count) ? order[i + 1].index : NO_EVENT;
+			prev[order[i].index] = (i > 0) ? order[i - 1].index : NO_EVENT;
+		}
+		for(int i = 0; i < event_count; i++) {
+			state_fio->FputInt32_LE(event[i].device != NULL ? event[i].device->this_device_id : -1);
+			state_fio->StateValue(event[i].event_id);
+			state_fio->StateValue(event[i].expired_clock);
+			state_fio->StateValue(event[i].loop_clock);
+			state_fio->StateValue(event[i].accum_clocks);
+			state_fio->StateValue(event[i].active);
+			state_fio->FputInt32_LE(next[i]);
+			state_fio->FputInt32_LE(prev[i]);
+		}
+		state_fio->FputInt32_LE(first_free_event);
+		state_fio->FputInt32_LE(fire_count != 0 ? order[0].index : NO_EVENT);
+		free(order);
+		free(next);
 	}
 	state_fio->StateValue(frames_per_sec);
 	state_fio->StateValue(next_frames_per_sec);
@@ -799,24 +1123,19 @@ bool EVENT::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(need_mix);
 	
 	// post process
-	if(loading) {
+	if(loading && !sound_muted) {
 		if(sound_buffer) {
 			memset(sound_buffer, 0, sound_samples * sizeof(uint16_t) * 2);
 		}
 		if(sound_tmp) {
 			memset(sound_tmp, 0, sound_tmp_samples * sizeof(int32_t) * 2);
 		}
+		if(resampler) {
+			resampler->reset();
+		}
 		buffer_ptr = 0;
 		mix_counter = 1;
-		mix_limit = (int)((double)(emu->get_sound_rate() / 2000.0));  // per 0.5ms.
+		mix_limit = (int)((double)(sound_mix_rate / 2000.0));  // per 0.5ms.
 	}
 	return true;
 }
-
-void* EVENT::get_event(int index)
-{
-	if(index >= 0 && index < MAX_EVENT) {
-		return &event[index];
-	}
-	return NULL;
-}
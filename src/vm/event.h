@@ -13,12 +13,13 @@
 #include "vm.h"
 #include "../emu.h"
 #include "device.h"
+#include "resampler.h"
 
 #define MAX_DEVICE	64
 #define MAX_CPU		8
 #define MAX_SOUND	32
 #define MAX_LINES	1024
-#define MAX_EVENT	64
+#define MAX_EVENT	64	// initial size of event pool (grows on demand)
 #define NO_EVENT	-1
 
 class EVENT : public DEVICE
@@ -41,6 +42,13 @@ private:
 	int cpu_clocks_remain, cpu_clocks_accum, cpu_clocks_done, cpu_clocks_in_op;
 	uint64_t event_clocks;
 	
+	// sub cpus run only when they have to catch up with the primary cpu
+	bool sub_cpu_lazy_sync, sub_cpu_catching_up;
+	uint64_t sub_cpu_event_clocks, sub_cpu_start_clocks;
+	int sub_cpu_index;
+	void run_sub_cpu(int clock);
+	void run_sub_cpu_until(uint64_t target_clocks);
+	
 	typedef struct event_t {
 		DEVICE* device;
 		int event_id;
@@ -49,12 +57,24 @@ private:
 		uint64_t accum_clocks;
 		bool active;
 		int index;
-		event_t *next;
-		event_t *prev;
+		int heap_pos;
+		int next_free;
 	} event_t;
-	event_t event[MAX_EVENT];
-	event_t *first_free_event;
-	event_t *first_fire_event;
+	event_t* event;
+	int event_count;
+	int first_free_event;
+	
+	// binary min-heap of active events, ordered by expired clock and then
+	// by insertion order (same firing order as the old sorted list)
+	typedef struct {
+		uint64_t expired_clock;
+		uint64_t insert_order;
+		int index;
+	} fire_t;
+	fire_t* fire_heap;
+	int fire_count;
+	uint64_t next_fire_clock;
+	uint64_t insert_order;
 	
 	DEVICE* frame_event[MAX_EVENT];
 	DEVICE* vline_event[MAX_EVENT];
@@ -66,8 +86,47 @@ private:
 	int cur_vline;
 	
 	void start_vline();
-	void update_event(int clock);
+	void update_event(int clock)
+	{
+		uint64_t event_clocks_tmp = event_clocks + clock;
+		if(next_fire_clock <= event_clocks_tmp) {
+			fire_events(event_clocks_tmp);
+		} else {
+			event_clocks = event_clocks_tmp;
+		}
+	}
+	void fire_events(uint64_t event_clocks_tmp);
+	int get_primary_cpu_clocks()
+	{
+		// batch mode needs the primary cpu to update events in opecode
+		if(!(config.batch_primary_cpu && config.drive_vm_in_opecode)) {
+			return -1; // run only one opecode
+		}
+		// run opecodes until the next event will be fired
+		int clocks = (cpu_clocks_remain < event_clocks_remain) ? cpu_clocks_remain : event_clocks_remain;
+		if(next_fire_clock - event_clocks < (uint64_t)clocks) {
+			clocks = (int)(next_fire_clock - event_clocks);
+		}
+		return (clocks > 1) ? clocks : -1;
+	}
 	void insert_event(event_t *event_handle);
+	bool grow_event_pool();
+	static bool fires_before(const fire_t &a, const fire_t &b)
+	{
+		return a.expired_clock < b.expired_clock || (a.expired_clock == b.expired_clock && a.insert_order < b.insert_order);
+	}
+	void heap_set(int pos, const fire_t &entry)
+	{
+		fire_heap[pos] = entry;
+		event[entry.index].heap_pos = pos;
+	}
+	void heap_up(int pos);
+	void heap_down(int pos);
+	void heap_remove(int pos);
+	void update_next_fire_clock()
+	{
+		next_fire_clock = (fire_count != 0) ? fire_heap[0].expired_clock : UINT64_MAX;
+	}
 	
 	// sound manager
 	DEVICE* d_sound[MAX_SOUND];
@@ -79,6 +138,11 @@ private:
 	int sound_samples;
 	int sound_tmp_samples;
 	
+	// the devices mix at sound_mix_rate, and the resampler converts their
+	// sound to the host rate if it is another rate
+	int sound_mix_rate;
+	RESAMPLER* resampler;
+	
 	int dont_skip_frames;
 	bool prev_skip, next_skip;
 	bool sound_changed;
@@ -89,8 +153,12 @@ private:
 	bool dev_need_mix[MAX_DEVICE];
 	int need_mix;
 	
+	// sound muted for frames that will be rolled back
+	bool sound_muted;
+	int muted_mix_counter;
+	bool muted_next_skip;
+	
 	void mix_sound(int samples);
-	void* get_event(int index);
 	
 #ifdef _DEBUG_LOG
 	bool initialize_done;
@@ -103,16 +171,18 @@ public:
 		frame_event_count = vline_event_count = 0;
 		
 		// initialize event
-		memset(event, 0, sizeof(event));
-		for(int i = 0; i < MAX_EVENT; i++) {
-			event[i].active = false;
-			event[i].index = i;
-			event[i].next = (i + 1 < MAX_EVENT) ? &event[i + 1] : NULL;
-		}
-		first_free_event = &event[0];
-		first_fire_event = NULL;
+		event = NULL;
+		fire_heap = NULL;
+		event_count = fire_count = 0;
+		first_free_event = NO_EVENT;
+		next_fire_clock = UINT64_MAX;
+		insert_order = 0;
+		grow_event_pool();
 		
 		event_clocks = 0;
+		sub_cpu_lazy_sync = sub_cpu_catching_up = false;
+		sub_cpu_event_clocks = sub_cpu_start_clocks = 0;
+		sub_cpu_index = 1;
 		
 		// force update timing in the first frame
 		frames_per_sec = 0.0;
@@ -124,13 +194,20 @@ public:
 		memset(dev_need_mix, 0, sizeof(dev_need_mix));
 		need_mix = 0;
 		sample_multi = 0x1000;
+		sound_muted = false;
+		sound_mix_rate = 0;
+		resampler = NULL;
 		
 #ifdef _DEBUG_LOG
 		initialize_done = false;
 #endif
 		set_device_name(_T("Event Manager"));
 	}
-	~EVENT() {}
+	~EVENT()
+	{
+		free(event);
+		free(fire_heap);
+	}
 	
 	// common functions
 	void initialize();
@@ -181,7 +258,15 @@ public:
 	{
 		return next_lines_per_frame;
 	}
-	void update_event_in_op(int clock);
+	int update_event_in_op(int clock);
+	void catch_up_sub_cpu()
+	{
+		if(sub_cpu_lazy_sync && sub_cpu_event_clocks < event_clocks) {
+			run_sub_cpu_until(event_clocks);
+		}
+	}
+	void update_sub_cpu_clock(int clock);
+	int get_clocks_until_input_event();
 	void register_event(DEVICE* device, int event_id, double usec, bool loop, int* register_id);
 	void register_event_by_clock(DEVICE* device, int event_id, uint64_t clock, bool loop, int* register_id);
 	void cancel_event(DEVICE* device, int register_id);
@@ -205,6 +290,7 @@ public:
 	uint32_t get_cpu_pc(int index);
 	void request_skip_frames();
 	void touch_sound();
+	int get_sound_pending_samples();
 	void set_realtime_render(DEVICE* device, bool flag);
 	void set_sample_multi(int multi)
 	{
@@ -218,9 +304,15 @@ public:
 	}
 	void drive();
 	
-	void initialize_sound(int rate, int samples);
+	void initialize_sound(int rate, int samples, int mix_rate = 0);
+	int get_sound_mix_rate()
+	{
+		return sound_mix_rate;
+	}
 	uint16_t* create_sound(int* extra_frames);
+	void collect_mixed_sound();
 	int get_sound_buffer_ptr();
+	void set_sound_muted(bool value);
 	
 	void set_context_cpu(DEVICE* device, uint32_t clocks)
 	{
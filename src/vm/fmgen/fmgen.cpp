@@ -313,6 +313,8 @@ FM::Operator::Operator()
 	keyon_ = false;
 	tl_out_ = false;
 	ssg_type_ = 0;
+	ssg_offset_ = 0;
+	ssg_vector_ = 1;
 
 	// PG Part
 	multiple_ = 0;
@@ -43,6 +43,7 @@ namespace FM
 	void StoreSample(ISample& dest, int data);
 
 	class Chip;
+	class ChannelLanes;
 
 	//	Operator -------------------------------------------------------------
 	class Operator
@@ -184,6 +185,7 @@ namespace FM
 
 	//	friends --------------------------------------------------------------
 		friend class Channel4;
+		friend class ChannelLanes;
 //		friend void __stdcall FM_NextPhase(Operator* op);
 
 	public:
@@ -235,6 +237,8 @@ namespace FM
 		static bool tablehasmade;
 		static int 	kftable[64];
 
+		friend class ChannelLanes;
+
 
 	public:
 		Operator op[4];
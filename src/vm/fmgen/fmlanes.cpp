@@ -0,0 +1,913 @@
+// ---------------------------------------------------------------------------
+//	FM Sound Generator - SoA/SIMD channel mixer
+// ---------------------------------------------------------------------------
+//	Channel4::Calc() はオペレータを 2, 1, 3, 0 の順に計算する.
+//	レーンでも同じ順に計算し, アルゴリズムによる接続はマスクで選ぶ.
+//	  op[2] の入力は op[0], op[1] の前回の値
+//	  op[1] の入力は op[0] の前回の値
+//	  op[3] の入力は op[0] の前回の値と op[1], op[2] の今回の値
+//	  op[0] はセルフフィードバックのみ
+//	EG の変移 (EGCalc) はまれなので該当するレーンだけスカラーで処理する.
+
+#include "headers.h"
+#include "misc.h"
+#include "fmgen.h"
+#include "fmgeninl.h"
+#include "fmlanes.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FM_LANES_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define FM_LANES_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FM_LANES_AVX2_TARGET
+#else
+//	カーネル全体を avx2 の関数の中に展開する
+#define FM_LANES_AVX2_TARGET __attribute__((target("avx2")))
+#define FM_LANES_AVX2_FLATTEN __attribute__((target("avx2"), flatten))
+#endif
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define FM_LANES_NEON
+#include <arm_neon.h>
+#endif
+
+#ifndef FM_LANES_AVX2_FLATTEN
+#define FM_LANES_AVX2_FLATTEN FM_LANES_AVX2_TARGET
+#endif
+
+namespace FM
+{
+	extern int pmtable[2][8][FM_LFOENTS];
+	extern uint amtable[2][4][FM_LFOENTS];
+}
+
+using namespace FM;
+
+// ---------------------------------------------------------------------------
+//	8 レーンのベクトル
+//
+//	load/store		int32[8] の読み書き
+//	set1			全レーンに同じ値
+//	add/sub/and_	レーンごとの演算 (2 の補数で桁あふれ)
+//	srl/sra/sll		定数シフト
+//	srav			レーンごとの算術右シフト (0-31)
+//	mul				下位 32bit の乗算
+//	cmpgt			a > b のレーンを -1
+//	mask			レーンの最上位ビットを bit0-7 に
+//	gather			table[idx]
+//	lin				idx < FM_CLENTS ? cltable[idx] : 0
+//	sinlin			lin(eg + sinetable[phase & (FM_OPSINENTS - 1)])
+//	hsum			全レーンの和
+
+namespace
+{
+
+// ---------------------------------------------------------------------------
+//	汎用 (ループ)
+//
+struct VecGeneric
+{
+	int32 v[8];
+
+	static VecGeneric load(const int32* p)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = p[i];
+		return r;
+	}
+	void store(int32* p) const
+	{
+		for (int i = 0; i < 8; i++)
+			p[i] = v[i];
+	}
+	static VecGeneric set1(int32 a)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = a;
+		return r;
+	}
+	static VecGeneric add(const VecGeneric& a, const VecGeneric& b)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = int32(uint32(a.v[i]) + uint32(b.v[i]));
+		return r;
+	}
+	static VecGeneric sub(const VecGeneric& a, const VecGeneric& b)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = int32(uint32(a.v[i]) - uint32(b.v[i]));
+		return r;
+	}
+	static VecGeneric and_(const VecGeneric& a, const VecGeneric& b)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = a.v[i] & b.v[i];
+		return r;
+	}
+	template <int n> static VecGeneric srl(const VecGeneric& a)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = int32(uint32(a.v[i]) >> n);
+		return r;
+	}
+	template <int n> static VecGeneric sra(const VecGeneric& a)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = a.v[i] >> n;
+		return r;
+	}
+	template <int n> static VecGeneric sll(const VecGeneric& a)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = int32(uint32(a.v[i]) << n);
+		return r;
+	}
+	static VecGeneric srav(const VecGeneric& a, const VecGeneric& n)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = a.v[i] >> n.v[i];
+		return r;
+	}
+	static VecGeneric mul(const VecGeneric& a, const VecGeneric& b)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = int32(uint32(a.v[i]) * uint32(b.v[i]));
+		return r;
+	}
+	static VecGeneric cmpgt(const VecGeneric& a, const VecGeneric& b)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = a.v[i] > b.v[i] ? -1 : 0;
+		return r;
+	}
+	static uint mask(const VecGeneric& a)
+	{
+		uint r = 0;
+		for (int i = 0; i < 8; i++)
+			r |= (uint32(a.v[i]) >> 31) << i;
+		return r;
+	}
+	static VecGeneric gather(const int32* table, const VecGeneric& idx)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = table[idx.v[i]];
+		return r;
+	}
+	static VecGeneric lin(const int32* table, const VecGeneric& idx)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+			r.v[i] = uint32(idx.v[i]) < FM_CLENTS ? table[idx.v[i]] : 0;
+		return r;
+	}
+	static VecGeneric sinlin(const int32* sine, const int32* cl, const VecGeneric& phase, const VecGeneric& eg)
+	{
+		VecGeneric r;
+		for (int i = 0; i < 8; i++)
+		{
+			uint32 idx = uint32(eg.v[i]) + uint32(sine[phase.v[i] & (FM_OPSINENTS - 1)]);
+			r.v[i] = idx < FM_CLENTS ? cl[idx] : 0;
+		}
+		return r;
+	}
+	static int32 hsum(const VecGeneric& a)
+	{
+		uint32 r = 0;
+		for (int i = 0; i < 8; i++)
+			r += uint32(a.v[i]);
+		return int32(r);
+	}
+};
+
+// ---------------------------------------------------------------------------
+//	SSE2 (4 レーン x 2)
+//
+#ifdef FM_LANES_SSE2
+struct VecSSE2
+{
+	__m128i lo, hi;
+
+	static VecSSE2 make(__m128i lo, __m128i hi)
+	{
+		VecSSE2 r;
+		r.lo = lo, r.hi = hi;
+		return r;
+	}
+	static VecSSE2 load(const int32* p)
+	{
+		return make(_mm_load_si128((const __m128i*) p), _mm_load_si128((const __m128i*) (p + 4)));
+	}
+	void store(int32* p) const
+	{
+		_mm_store_si128((__m128i*) p, lo);
+		_mm_store_si128((__m128i*) (p + 4), hi);
+	}
+	static VecSSE2 set1(int32 a)
+	{
+		__m128i v = _mm_set1_epi32(a);
+		return make(v, v);
+	}
+	static VecSSE2 add(const VecSSE2& a, const VecSSE2& b)
+	{
+		return make(_mm_add_epi32(a.lo, b.lo), _mm_add_epi32(a.hi, b.hi));
+	}
+	static VecSSE2 sub(const VecSSE2& a, const VecSSE2& b)
+	{
+		return make(_mm_sub_epi32(a.lo, b.lo), _mm_sub_epi32(a.hi, b.hi));
+	}
+	static VecSSE2 and_(const VecSSE2& a, const VecSSE2& b)
+	{
+		return make(_mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi));
+	}
+	template <int n> static VecSSE2 srl(const VecSSE2& a)
+	{
+		return make(_mm_srli_epi32(a.lo, n), _mm_srli_epi32(a.hi, n));
+	}
+	template <int n> static VecSSE2 sra(const VecSSE2& a)
+	{
+		return make(_mm_srai_epi32(a.lo, n), _mm_srai_epi32(a.hi, n));
+	}
+	template <int n> static VecSSE2 sll(const VecSSE2& a)
+	{
+		return make(_mm_slli_epi32(a.lo, n), _mm_slli_epi32(a.hi, n));
+	}
+	//	SSE2 にはレーンごとのシフトがない
+	static VecSSE2 srav(const VecSSE2& a, const VecSSE2& n)
+	{
+		alignas(16) int32 va[8], vn[8];
+		a.store(va);
+		n.store(vn);
+		for (int i = 0; i < 8; i++)
+			va[i] >>= vn[i];
+		return load(va);
+	}
+	//	SSE2 には 32bit の乗算がないので偶数/奇数レーンに分ける
+	static __m128i mul4(__m128i a, __m128i b)
+	{
+		__m128i even = _mm_mul_epu32(a, b);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+								  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+	static VecSSE2 mul(const VecSSE2& a, const VecSSE2& b)
+	{
+		return make(mul4(a.lo, b.lo), mul4(a.hi, b.hi));
+	}
+	static VecSSE2 cmpgt(const VecSSE2& a, const VecSSE2& b)
+	{
+		return make(_mm_cmpgt_epi32(a.lo, b.lo), _mm_cmpgt_epi32(a.hi, b.hi));
+	}
+	static uint mask(const VecSSE2& a)
+	{
+		return _mm_movemask_ps(_mm_castsi128_ps(a.lo)) | (_mm_movemask_ps(_mm_castsi128_ps(a.hi)) << 4);
+	}
+	static VecSSE2 gather(const int32* table, const VecSSE2& idx)
+	{
+		alignas(16) int32 v[8];
+		idx.store(v);
+		for (int i = 0; i < 8; i++)
+			v[i] = table[v[i]];
+		return load(v);
+	}
+	static VecSSE2 lin(const int32* table, const VecSSE2& idx)
+	{
+		alignas(16) int32 v[8];
+		idx.store(v);
+		for (int i = 0; i < 8; i++)
+			v[i] = uint32(v[i]) < FM_CLENTS ? table[v[i]] : 0;
+		return load(v);
+	}
+	//	表引きは一度に書き出してまとめて行う
+	static VecSSE2 sinlin(const int32* sine, const int32* cl, const VecSSE2& phase, const VecSSE2& eg)
+	{
+		alignas(16) int32 p[8], v[8];
+		phase.store(p);
+		eg.store(v);
+		for (int i = 0; i < 8; i++)
+		{
+			uint32 idx = uint32(v[i]) + uint32(sine[p[i] & (FM_OPSINENTS - 1)]);
+			v[i] = idx < FM_CLENTS ? cl[idx] : 0;
+		}
+		return load(v);
+	}
+	static int32 hsum(const VecSSE2& a)
+	{
+		__m128i s = _mm_add_epi32(a.lo, a.hi);
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(s);
+	}
+};
+#endif
+
+// ---------------------------------------------------------------------------
+//	AVX2 (8 レーン)
+//
+#ifdef FM_LANES_AVX2
+static bool has_avx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	// avx と osxsave, OS が ymm を保存するか
+	__cpuid(info, 1);
+	if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+		return false;
+	if ((_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+struct VecAVX2
+{
+	__m256i v;
+
+	FM_LANES_AVX2_TARGET static VecAVX2 make(__m256i v)
+	{
+		VecAVX2 r;
+		r.v = v;
+		return r;
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 load(const int32* p)
+	{
+		return make(_mm256_load_si256((const __m256i*) p));
+	}
+	FM_LANES_AVX2_TARGET void store(int32* p) const
+	{
+		_mm256_store_si256((__m256i*) p, v);
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 set1(int32 a)
+	{
+		return make(_mm256_set1_epi32(a));
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 add(const VecAVX2& a, const VecAVX2& b)
+	{
+		return make(_mm256_add_epi32(a.v, b.v));
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 sub(const VecAVX2& a, const VecAVX2& b)
+	{
+		return make(_mm256_sub_epi32(a.v, b.v));
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 and_(const VecAVX2& a, const VecAVX2& b)
+	{
+		return make(_mm256_and_si256(a.v, b.v));
+	}
+	template <int n> FM_LANES_AVX2_TARGET static VecAVX2 srl(const VecAVX2& a)
+	{
+		return make(_mm256_srli_epi32(a.v, n));
+	}
+	template <int n> FM_LANES_AVX2_TARGET static VecAVX2 sra(const VecAVX2& a)
+	{
+		return make(_mm256_srai_epi32(a.v, n));
+	}
+	template <int n> FM_LANES_AVX2_TARGET static VecAVX2 sll(const VecAVX2& a)
+	{
+		return make(_mm256_slli_epi32(a.v, n));
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 srav(const VecAVX2& a, const VecAVX2& n)
+	{
+		return make(_mm256_srav_epi32(a.v, n.v));
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 mul(const VecAVX2& a, const VecAVX2& b)
+	{
+		return make(_mm256_mullo_epi32(a.v, b.v));
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 cmpgt(const VecAVX2& a, const VecAVX2& b)
+	{
+		return make(_mm256_cmpgt_epi32(a.v, b.v));
+	}
+	FM_LANES_AVX2_TARGET static uint mask(const VecAVX2& a)
+	{
+		return _mm256_movemask_ps(_mm256_castsi256_ps(a.v));
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 gather(const int32* table, const VecAVX2& idx)
+	{
+		return make(_mm256_i32gather_epi32((const int*) table, idx.v, 4));
+	}
+	//	SSG-EG では負の添字もある. LogToLin() と同じく符号なしで比較する
+	FM_LANES_AVX2_TARGET static VecAVX2 lin(const int32* table, const VecAVX2& idx)
+	{
+		__m256i m = _mm256_cmpeq_epi32(_mm256_and_si256(idx.v, _mm256_set1_epi32(~(FM_CLENTS - 1))), _mm256_setzero_si256());
+		return make(_mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int*) table, idx.v, m, 4));
+	}
+	FM_LANES_AVX2_TARGET static VecAVX2 sinlin(const int32* sine, const int32* cl, const VecAVX2& phase, const VecAVX2& eg)
+	{
+		return lin(cl, add(eg, gather(sine, and_(phase, set1(FM_OPSINENTS - 1)))));
+	}
+	FM_LANES_AVX2_TARGET static int32 hsum(const VecAVX2& a)
+	{
+		__m128i s = _mm_add_epi32(_mm256_castsi256_si128(a.v), _mm256_extracti128_si256(a.v, 1));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(s);
+	}
+};
+#endif
+
+// ---------------------------------------------------------------------------
+//	NEON (4 レーン x 2)
+//
+#ifdef FM_LANES_NEON
+struct VecNEON
+{
+	int32x4_t lo, hi;
+
+	static VecNEON make(int32x4_t lo, int32x4_t hi)
+	{
+		VecNEON r;
+		r.lo = lo, r.hi = hi;
+		return r;
+	}
+	static VecNEON load(const int32* p)
+	{
+		return make(vld1q_s32(p), vld1q_s32(p + 4));
+	}
+	void store(int32* p) const
+	{
+		vst1q_s32(p, lo);
+		vst1q_s32(p + 4, hi);
+	}
+	static VecNEON set1(int32 a)
+	{
+		int32x4_t v = vdupq_n_s32(a);
+		return make(v, v);
+	}
+	static VecNEON add(const VecNEON& a, const VecNEON& b)
+	{
+		return make(vaddq_s32(a.lo, b.lo), vaddq_s32(a.hi, b.hi));
+	}
+	static VecNEON sub(const VecNEON& a, const VecNEON& b)
+	{
+		return make(vsubq_s32(a.lo, b.lo), vsubq_s32(a.hi, b.hi));
+	}
+	static VecNEON and_(const VecNEON& a, const VecNEON& b)
+	{
+		return make(vandq_s32(a.lo, b.lo), vandq_s32(a.hi, b.hi));
+	}
+	template <int n> static VecNEON srl(const VecNEON& a)
+	{
+		return make(vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a.lo), n)),
+					vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a.hi), n)));
+	}
+	template <int n> static VecNEON sra(const VecNEON& a)
+	{
+		return make(vshrq_n_s32(a.lo, n), vshrq_n_s32(a.hi, n));
+	}
+	template <int n> static VecNEON sll(const VecNEON& a)
+	{
+		return make(vshlq_n_s32(a.lo, n), vshlq_n_s32(a.hi, n));
+	}
+	//	負のシフト量で右シフトになる
+	static VecNEON srav(const VecNEON& a, const VecNEON& n)
+	{
+		return make(vshlq_s32(a.lo, vnegq_s32(n.lo)), vshlq_s32(a.hi, vnegq_s32(n.hi)));
+	}
+	static VecNEON mul(const VecNEON& a, const VecNEON& b)
+	{
+		return make(vmulq_s32(a.lo, b.lo), vmulq_s32(a.hi, b.hi));
+	}
+	static VecNEON cmpgt(const VecNEON& a, const VecNEON& b)
+	{
+		return make(vreinterpretq_s32_u32(vcgtq_s32(a.lo, b.lo)), vreinterpretq_s32_u32(vcgtq_s32(a.hi, b.hi)));
+	}
+	static uint mask(const VecNEON& a)
+	{
+		static const uint32 bits[4] = { 1, 2, 4, 8 };
+		uint32x4_t b = vld1q_u32(bits);
+		uint32x4_t lo = vandq_u32(vshrq_n_u32(vreinterpretq_u32_s32(a.lo), 31), b);
+		uint32x4_t hi = vandq_u32(vshrq_n_u32(vreinterpretq_u32_s32(a.hi), 31), b);
+		return vaddvq_u32(lo) | (vaddvq_u32(hi) << 4);
+	}
+	static VecNEON gather(const int32* table, const VecNEON& idx)
+	{
+		alignas(16) int32 v[8];
+		idx.store(v);
+		for (int i = 0; i < 8; i++)
+			v[i] = table[v[i]];
+		return load(v);
+	}
+	static VecNEON lin(const int32* table, const VecNEON& idx)
+	{
+		alignas(16) int32 v[8];
+		idx.store(v);
+		for (int i = 0; i < 8; i++)
+			v[i] = uint32(v[i]) < FM_CLENTS ? table[v[i]] : 0;
+		return load(v);
+	}
+	static VecNEON sinlin(const int32* sine, const int32* cl, const VecNEON& phase, const VecNEON& eg)
+	{
+		alignas(16) int32 p[8], v[8];
+		phase.store(p);
+		eg.store(v);
+		for (int i = 0; i < 8; i++)
+		{
+			uint32 idx = uint32(v[i]) + uint32(sine[p[i] & (FM_OPSINENTS - 1)]);
+			v[i] = idx < FM_CLENTS ? cl[idx] : 0;
+		}
+		return load(v);
+	}
+	static int32 hsum(const VecNEON& a)
+	{
+		return vaddvq_s32(vaddq_s32(a.lo, a.hi));
+	}
+};
+#endif
+
+// ---------------------------------------------------------------------------
+//	カーネル
+//
+//	fmgen.cpp と同じシフト量
+#define IS2EC_SHIFT		((20 + FM_PGBITS) - 13)
+#define PG_SHIFT		(20 + FM_PGBITS - FM_OPSINBITS)
+
+//	sinetable/cltable は Operator の private なので呼び出し側から受け取る
+struct Tables
+{
+	const int32* sine;
+	const int32* cl;
+	const int32* pm;
+	const int32* am;
+};
+
+//	Operator::Calc/CalcL の pgin 以降
+template <class V, bool lfo>
+inline V CalcOp(const Tables& t, ChannelLanes::Slot& sl, const V& pg, const V& in, const V& aml)
+{
+	V pgin = V::add(pg, V::template sra<PG_SHIFT - (2 + IS2EC_SHIFT)>(in));
+	V eg = V::load(sl.eg_out);
+	if (lfo)
+		eg = V::add(eg, V::gather(t.am, V::add(V::load(sl.ams), aml)));
+	return V::sinlin(t.sine, t.cl, pgin, eg);
+}
+
+template <class V, bool lfo>
+void CalcLanes(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	ChannelLanes::Slot* sl = l->slot;
+	const V one = V::set1(1);
+	V am = V::set1(0);
+	V pm = V::set1(0);
+
+	for (int i = 0; i < nsamples; i++)
+	{
+		// EG
+		for (int s = 0; s < 4; s++)
+		{
+			V c = V::sub(V::load(sl[s].eg_count), V::load(sl[s].eg_count_diff));
+			c.store(sl[s].eg_count);
+			uint m = V::mask(V::cmpgt(one, c));
+			if (m)
+				l->EGCalc(s, m);
+		}
+
+		// PG
+		if (lfo)
+		{
+			am = V::set1(aml[i]);
+			pm = V::gather(t.pm, V::add(V::load(l->pms), V::set1(pml[i])));
+			pm.store(l->pmv);
+		}
+		V pg[4];
+		for (int s = 0; s < 4; s++)
+		{
+			V c = V::load(sl[s].pg_count);
+			c.store(sl[s].pg_out);
+			pg[s] = V::template srl<PG_SHIFT>(c);
+			c = V::add(c, V::load(sl[s].pg_diff));
+			if (lfo)
+				c = V::add(c, V::template sra<5>(V::mul(V::load(sl[s].pg_diff_lfo), pm)));
+			c.store(sl[s].pg_count);
+		}
+
+		V o0 = V::load(sl[0].out);
+		V o1 = V::load(sl[1].out);
+		V o2 = V::load(sl[2].out);
+		V o3 = V::load(sl[3].out);
+
+		V in = V::add(V::and_(o0, V::load(l->in2_0)), V::and_(o1, V::load(l->in2_1)));
+		V n2 = CalcOp<V, lfo>(t, sl[2], pg[2], in, am);
+		in = V::and_(o0, V::load(l->in1_0));
+		V n1 = CalcOp<V, lfo>(t, sl[1], pg[1], in, am);
+		in = V::add(V::add(V::and_(o0, V::load(l->in3_0)), V::and_(n1, V::load(l->in3_1))), V::and_(n2, V::load(l->in3_2)));
+		V n3 = CalcOp<V, lfo>(t, sl[3], pg[3], in, am);
+
+		// op[0] (CalcFB/CalcFBL)
+		V fb = V::add(o0, V::load(sl[0].out2));
+		fb = V::and_(V::srav(V::template sll<1 + IS2EC_SHIFT>(fb), V::load(l->fb_shift)), V::load(l->fb_mask));
+		V eg = V::load(sl[0].eg_out);
+		if (lfo)
+			eg = V::add(eg, V::gather(t.am, V::add(V::load(sl[0].ams), am)));
+		V n0 = V::sinlin(t.sine, t.cl, V::add(pg[0], fb), eg);
+
+		o0.store(sl[0].out2);
+		if (!lfo)
+		{
+			// Calc() のみ out2_ を更新する
+			o1.store(sl[1].out2);
+			o2.store(sl[2].out2);
+			o3.store(sl[3].out2);
+		}
+		n0.store(sl[0].out);
+		n1.store(sl[1].out);
+		n2.store(sl[2].out);
+		n3.store(sl[3].out);
+
+		// CalcFB() は前回の値, CalcFBL() は今回の値を返す
+		V r = V::add(V::add(V::and_(n1, V::load(l->out_op[1])), V::and_(n2, V::load(l->out_op[2]))),
+					 V::add(V::and_(n3, V::load(l->out_op[3])), V::and_(lfo ? n0 : o0, V::load(l->out_op[0]))));
+		left[i] = V::hsum(V::and_(r, V::load(l->out_l)));
+		right[i] = V::hsum(V::and_(r, V::load(l->out_r)));
+	}
+}
+
+typedef void (*CalcFunc)(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples);
+
+void CalcGeneric(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	CalcLanes<VecGeneric, false>(l, t, left, right, aml, pml, nsamples);
+}
+void CalcGenericL(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	CalcLanes<VecGeneric, true>(l, t, left, right, aml, pml, nsamples);
+}
+
+#ifdef FM_LANES_SSE2
+void CalcSSE2(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	CalcLanes<VecSSE2, false>(l, t, left, right, aml, pml, nsamples);
+}
+void CalcSSE2L(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	CalcLanes<VecSSE2, true>(l, t, left, right, aml, pml, nsamples);
+}
+#endif
+
+#ifdef FM_LANES_AVX2
+FM_LANES_AVX2_FLATTEN
+void CalcAVX2(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	CalcLanes<VecAVX2, false>(l, t, left, right, aml, pml, nsamples);
+}
+FM_LANES_AVX2_FLATTEN
+void CalcAVX2L(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	CalcLanes<VecAVX2, true>(l, t, left, right, aml, pml, nsamples);
+}
+#endif
+
+#ifdef FM_LANES_NEON
+void CalcNEON(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	CalcLanes<VecNEON, false>(l, t, left, right, aml, pml, nsamples);
+}
+void CalcNEONL(ChannelLanes* l, const Tables& t, ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	CalcLanes<VecNEON, true>(l, t, left, right, aml, pml, nsamples);
+}
+#endif
+
+struct Impl
+{
+	const char* name;
+	CalcFunc calc;
+	CalcFunc calcl;
+	bool fast;			// Channel4 より速いので既定で使う
+};
+
+//	0 は Channel4 による元のコード. 表引きを 1 レーンずつ行う実装は
+//	Channel4 より遅いので比較用
+const Impl impls[] =
+{
+	{ "channel", 0, 0, false },
+	{ "generic", CalcGeneric, CalcGenericL, false },
+#ifdef FM_LANES_SSE2
+	{ "sse2", CalcSSE2, CalcSSE2L, false },
+#endif
+#ifdef FM_LANES_AVX2
+	{ "avx2", CalcAVX2, CalcAVX2L, true },
+#endif
+#ifdef FM_LANES_NEON
+	{ "neon", CalcNEON, CalcNEONL, false },
+#endif
+};
+
+int selected_impl = -1;
+
+}	// namespace
+
+// ---------------------------------------------------------------------------
+//	実装の選択
+//
+int ChannelLanes::GetImplCount()
+{
+	static const int count = []()
+	{
+		int n = int(sizeof(impls) / sizeof(impls[0]));
+#ifdef FM_LANES_AVX2
+		// x86 では avx2 が最後
+		if (!has_avx2())
+			n--;
+#endif
+		return n;
+	}();
+	return count;
+}
+
+const char* ChannelLanes::GetImplName(int index)
+{
+	if (index < 0 || index >= GetImplCount())
+		return 0;
+	return impls[index].name;
+}
+
+void ChannelLanes::SelectImpl(int index)
+{
+	if (0 <= index && index < GetImplCount())
+		selected_impl = index;
+}
+
+int ChannelLanes::GetSelectedImpl()
+{
+	if (selected_impl < 0)
+	{
+		selected_impl = 0;
+		for (int i = 0; i < GetImplCount(); i++)
+			if (impls[i].fast)
+				selected_impl = i;
+	}
+	return selected_impl;
+}
+
+bool ChannelLanes::IsEnabled(int nsamples)
+{
+	return nsamples >= MIN_SAMPLES && GetSelectedImpl() != 0;
+}
+
+// ---------------------------------------------------------------------------
+//	構築
+//
+ChannelLanes::ChannelLanes(Chip* chip, bool lfo)
+: chip_(chip), lfo_(lfo), count_(0)
+{
+	memset(slot, 0, sizeof(slot));
+	memset(in1_0, 0, sizeof(in1_0));
+	memset(in2_0, 0, sizeof(in2_0));
+	memset(in2_1, 0, sizeof(in2_1));
+	memset(in3_0, 0, sizeof(in3_0));
+	memset(in3_1, 0, sizeof(in3_1));
+	memset(in3_2, 0, sizeof(in3_2));
+	memset(out_op, 0, sizeof(out_op));
+	memset(out_l, 0, sizeof(out_l));
+	memset(out_r, 0, sizeof(out_r));
+	memset(fb_shift, 0, sizeof(fb_shift));
+	memset(fb_mask, 0, sizeof(fb_mask));
+	memset(pms, 0, sizeof(pms));
+	memset(pmv, 0, sizeof(pmv));
+	// 空きレーンの EG は変移しない
+	for (int s = 0; s < 4; s++)
+		for (int i = 0; i < MAX_CH; i++)
+			slot[s].eg_count[i] = 1;
+}
+
+//	チャンネルの状態をレーンに読み込む
+void ChannelLanes::Add(Channel4* ch, bool left, bool right)
+{
+	//	各アルゴリズムの接続 (op[2], op[1], op[3], op[0] の順に計算)
+	//	in: 1<-0, 2<-0, 2<-1, 3<-0, 3<-1, 3<-2  out: op[0]-op[3]
+	static const uint8 table[8][10] =
+	{
+		{ 1, 0, 1, 0, 0, 1,  0, 0, 0, 1 },
+		{ 0, 1, 1, 0, 0, 1,  0, 0, 0, 1 },
+		{ 0, 0, 1, 1, 0, 1,  0, 0, 0, 1 },
+		{ 1, 0, 0, 0, 1, 1,  0, 0, 0, 1 },
+		{ 1, 0, 0, 0, 0, 1,  0, 1, 0, 1 },
+		{ 1, 1, 0, 1, 0, 0,  0, 1, 1, 1 },
+		{ 1, 0, 0, 0, 0, 0,  0, 1, 1, 1 },
+		{ 0, 0, 0, 0, 0, 0,  1, 1, 1, 1 },
+	};
+
+	assert(count_ < MAX_CH);
+	int i = count_++;
+	ch_[i] = ch;
+
+	for (int s = 0; s < 4; s++)
+	{
+		Operator& op = ch->op[s];
+		Slot& sl = slot[s];
+		sl.eg_count[i] = op.eg_count_;
+		sl.eg_count_diff[i] = op.eg_count_diff_;
+		sl.eg_out[i] = op.eg_out_;
+		sl.pg_count[i] = int32(op.pg_count_);
+		sl.pg_diff[i] = int32(op.pg_diff_);
+		sl.pg_diff_lfo[i] = op.pg_diff_lfo_;
+		sl.pg_out[i] = op.dbgpgout_;
+		sl.out[i] = op.out_;
+		sl.out2[i] = op.out2_;
+		sl.ams[i] = int32(op.ams_ - &amtable[0][0][0]);
+	}
+
+	const uint8* c = table[ch->algo_ & 7];
+	in1_0[i] = -c[0];
+	in2_0[i] = -c[1];
+	in2_1[i] = -c[2];
+	in3_0[i] = -c[3];
+	in3_1[i] = -c[4];
+	in3_2[i] = -c[5];
+	for (int s = 0; s < 4; s++)
+		out_op[s][i] = -c[6 + s];
+	out_l[i] = left ? -1 : 0;
+	out_r[i] = right ? -1 : 0;
+
+	//	((in << 17) >> fb) >> 19 を 1 回のシフトで
+	fb_shift[i] = ch->fb < 31 ? ch->fb + PG_SHIFT : 0;
+	fb_mask[i] = ch->fb < 31 ? -1 : 0;
+	pms[i] = int32(ch->pms - &pmtable[0][0][0]);
+}
+
+//	EG の変移があったレーンを Operator で処理する
+void ChannelLanes::EGCalc(int s, uint lanes)
+{
+	Slot& sl = slot[s];
+	for (int i = 0; i < count_; i++)
+	{
+		if (lanes & (1 << i))
+		{
+			Operator& op = ch_[i]->op[s];
+			op.EGCalc();
+			sl.eg_count[i] = op.eg_count_;
+			sl.eg_count_diff[i] = op.eg_count_diff_;
+			sl.eg_out[i] = op.eg_out_;
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+//	合成
+//
+void ChannelLanes::Calc(ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples)
+{
+	assert(nsamples <= BLOCK);
+	if (!count_)
+	{
+		memset(left, 0, nsamples * sizeof(ISample));
+		memset(right, 0, nsamples * sizeof(ISample));
+		return;
+	}
+
+	Tables t;
+	t.sine = (const int32*) Operator::sinetable;
+	t.cl = Operator::cltable;
+	t.pm = &pmtable[0][0][0];
+	t.am = (const int32*) &amtable[0][0][0];
+
+	const Impl& impl = impls[GetSelectedImpl()];
+	(lfo_ ? impl.calcl : impl.calc)(this, t, left, right, aml, pml, nsamples);
+
+	//	Channel4::CalcL() は最後に合成したチャンネルの PM を残す
+	if (lfo_)
+		chip_->SetPMV(pmv[count_ - 1]);
+}
+
+//	レーンの状態をチャンネルに書き戻す
+void ChannelLanes::Store()
+{
+	for (int i = 0; i < count_; i++)
+	{
+		for (int s = 0; s < 4; s++)
+		{
+			Operator& op = ch_[i]->op[s];
+			Slot& sl = slot[s];
+			op.eg_count_ = sl.eg_count[i];
+			op.pg_count_ = uint32(sl.pg_count[i]);
+			op.out_ = sl.out[i];
+			op.out2_ = sl.out2[i];
+			op.dbgpgout_ = sl.pg_out[i];
+			// CalcFB() のみ前回の値
+			op.dbgopout_ = (s == 0 && !lfo_) ? sl.out2[i] : sl.out[i];
+		}
+	}
+}
@@ -0,0 +1,89 @@
+// ---------------------------------------------------------------------------
+//	FM Sound Generator - SoA/SIMD channel mixer
+// ---------------------------------------------------------------------------
+//	全チャンネルの同じスロットのオペレータを SIMD の各レーンで同時に計算する.
+//	結果は Channel4::Calc()/CalcL() を順に呼んだ場合と完全に一致する.
+
+#ifndef FM_LANES_H
+#define FM_LANES_H
+
+#include "fmgen.h"
+
+namespace FM
+{
+	class ChannelLanes
+	{
+	public:
+		enum
+		{
+			MAX_CH = 8,			// レーン数
+			MIN_SAMPLES = 16,	// これより短いブロックは Channel4 で合成する
+			BLOCK = 64,			// 一度に合成するサンプル数の上限
+		};
+
+		//	実装の選択. 0 は Channel4 による元のコード. 既定は Channel4 より速いもの
+		static int GetImplCount();
+		static const char* GetImplName(int index);
+		static void SelectImpl(int index);
+		static int GetSelectedImpl();
+
+		//	nsamples の合成にレーンを使うか
+		static bool IsEnabled(int nsamples);
+
+		ChannelLanes(Chip* chip, bool lfo);
+
+		//	合成するチャンネルを追加する. 出力は left/right の真偽で振り分ける
+		void Add(Channel4* ch, bool left, bool right);
+		int GetCount() { return count_; }
+
+		//	nsamples (BLOCK 以下) を合成して left/right に書き込む.
+		//	aml/pml はサンプルごとの LFO の値 (lfo のときのみ)
+		void Calc(ISample* left, ISample* right, const uint8* aml, const uint8* pml, int nsamples);
+
+		//	レーンの状態をチャンネルに書き戻す
+		void Store();
+
+		//	EG の変移 (内部用)
+		void EGCalc(int slot, uint lanes);
+
+		//	レーンごとの状態 (内部用). slot は Channel4::op の添字
+		struct Slot
+		{
+			alignas(32) int32 eg_count[MAX_CH];
+			alignas(32) int32 eg_count_diff[MAX_CH];
+			alignas(32) int32 eg_out[MAX_CH];
+			alignas(32) int32 pg_count[MAX_CH];
+			alignas(32) int32 pg_diff[MAX_CH];
+			alignas(32) int32 pg_diff_lfo[MAX_CH];
+			alignas(32) int32 pg_out[MAX_CH];		// 最後の PGCalc の値
+			alignas(32) int32 out[MAX_CH];
+			alignas(32) int32 out2[MAX_CH];
+			alignas(32) int32 ams[MAX_CH];			// amtable 内の位置
+		};
+		Slot slot[4];
+
+		//	接続 (0 または -1)
+		alignas(32) int32 in1_0[MAX_CH];		// op[1] <- op[0]
+		alignas(32) int32 in2_0[MAX_CH];		// op[2] <- op[0]
+		alignas(32) int32 in2_1[MAX_CH];		// op[2] <- op[1]
+		alignas(32) int32 in3_0[MAX_CH];		// op[3] <- op[0]
+		alignas(32) int32 in3_1[MAX_CH];		// op[3] <- op[1]
+		alignas(32) int32 in3_2[MAX_CH];		// op[3] <- op[2]
+		alignas(32) int32 out_op[4][MAX_CH];	// キャリア
+		alignas(32) int32 out_l[MAX_CH];
+		alignas(32) int32 out_r[MAX_CH];
+
+		alignas(32) int32 fb_shift[MAX_CH];		// op[0] のフィードバック
+		alignas(32) int32 fb_mask[MAX_CH];
+		alignas(32) int32 pms[MAX_CH];			// pmtable 内の位置
+		alignas(32) int32 pmv[MAX_CH];			// 最後のサンプルの PM の値
+
+	private:
+		Channel4* ch_[MAX_CH];
+		Chip* chip_;
+		bool lfo_;
+		int count_;
+	};
+}
+
+#endif // FM_LANES_H
@@ -8,6 +8,7 @@
 #include "misc.h"
 #include "opm.h"
 #include "fmgeninl.h"
+#include "fmlanes.h"
 
 #include "../../fileio.h"
 
@@ -26,6 +27,7 @@ OPM::OPM()
 {
 	lfo_count_ = 0;
 	lfo_count_prev_ = ~0;
+	lfo_step_ = 0;
 	BuildLFOTable();
 	for (int i=0; i<8; i++)
 	{
@@ -495,6 +497,12 @@ void OPM::Mix(Sample* buffer, int nsamples)
 		if (reg01 & 0x02)
 			activech &= 0x5555;
 
+		if (ChannelLanes::IsEnabled(nsamples))
+		{
+			MixLanes(buffer, nsamples, activech);
+			return;
+		}
+
 		// Mix
 		ISample ibuf[8];
 		ISample* idest[8];
@@ -524,6 +532,56 @@ void OPM::Mix(Sample* buffer, int nsamples)
 #undef IStoSampleR
 }
 
+//	全チャンネルをまとめて合成 (ノイズの ch7 は Channel4 で合成)
+void OPM::MixLanes(Sample* buffer, int nsamples, uint activech)
+{
+#define IStoSampleL(s)	((Limit(s, 0xffff, -0x10000) * fmvolume_l) >> 14)
+#define IStoSampleR(s)	((Limit(s, 0xffff, -0x10000) * fmvolume_r) >> 14)
+
+	bool lfo = (activech & 0xaaaa) != 0;
+	bool noise7 = (activech & 0x0001) && (noisedelta & 0x80);
+	ChannelLanes lanes(&chip, lfo);
+	for (int i = 0; i < 8; i++)
+	{
+		if ((activech & (0x4000 >> (i * 2))) && !(i == 7 && noise7))
+			lanes.Add(&ch[i], (pan[i] & 1) != 0, (pan[i] & 2) != 0);
+	}
+
+	ISample ibuf_l[ChannelLanes::BLOCK], ibuf_r[ChannelLanes::BLOCK];
+	uint8 aml[ChannelLanes::BLOCK], pml[ChannelLanes::BLOCK];
+	Sample* dest = buffer;
+	for (int n; nsamples > 0; nsamples -= n)
+	{
+		n = Min(nsamples, ChannelLanes::BLOCK);
+		for (int i=0; i<n; i++)
+		{
+			LFO();
+			aml[i] = chip.GetAML();
+			pml[i] = chip.GetPML();
+		}
+		lanes.Calc(ibuf_l, ibuf_r, aml, pml, n);
+		if (noise7)
+		{
+			for (int i=0; i<n; i++)
+			{
+				chip.SetAML(aml[i]);
+				chip.SetPML(pml[i]);
+				ISample s = lfo ? ch[7].CalcLN(Noise()) : ch[7].CalcN(Noise());
+				if (pan[7] & 1) ibuf_l[i] += s;
+				if (pan[7] & 2) ibuf_r[i] += s;
+			}
+		}
+		for (int i=0; i<n; i++, dest+=2)
+		{
+			StoreSample(dest[0], IStoSampleL(ibuf_l[i]));
+			StoreSample(dest[1], IStoSampleR(ibuf_r[i]));
+		}
+	}
+	lanes.Store();
+#undef IStoSampleL
+#undef IStoSampleR
+}
+
 // ---------------------------------------------------------------------------
 //	ステートセーブ
 //
@@ -110,6 +110,7 @@ namespace FM
 		void	RebuildTimeTable();
 		void	MixSub(int activech, ISample**);
 		void	MixSubL(int activech, ISample**);
+		void	MixLanes(Sample* buffer, int nsamples, uint activech);
 		void	LFO();
 		uint	Noise();
 		
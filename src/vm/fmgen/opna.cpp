@@ -8,6 +8,7 @@
 #include "headers.h"
 #include "misc.h"
 #include "fmgeninl.h"
+#include "fmlanes.h"
 
 
 #include "../../fileio.h"
@@ -1218,6 +1219,11 @@ inline void OPNABase::LFO() {
 #define IStoSampleR(s) ((Limit(s, 0x7fff, -0x8000) * fmvolume_r) >> 14)
 
 void OPNABase::Mix6(Sample *buffer, int nsamples, int activech) {
+  if (ChannelLanes::IsEnabled(nsamples)) {
+    Mix6Lanes(buffer, nsamples, activech);
+    return;
+  }
+
   // Mix
   ISample ibuf[4];
   ISample *idest[6];
@@ -1240,6 +1246,36 @@ void OPNABase::Mix6(Sample *buffer, int nsamples, int activech) {
   }
 }
 
+//	全チャンネルをまとめて合成
+void OPNABase::Mix6Lanes(Sample *buffer, int nsamples, int activech) {
+  bool lfo = (activech & 0xaaa) != 0;
+  ChannelLanes lanes(&chip, lfo);
+  for (int i = 0; i < 6; i++) {
+    if (activech & (1 << (i * 2)))
+      lanes.Add(&ch[i], (pan[i] & 2) != 0, (pan[i] & 1) != 0);
+  }
+
+  ISample ibuf_l[ChannelLanes::BLOCK], ibuf_r[ChannelLanes::BLOCK];
+  uint8 aml[ChannelLanes::BLOCK], pml[ChannelLanes::BLOCK];
+  Sample *dest = buffer;
+  for (int n; nsamples > 0; nsamples -= n) {
+    n = Min(nsamples, ChannelLanes::BLOCK);
+    if (lfo) {
+      for (int i = 0; i < n; i++) {
+        LFO();
+        aml[i] = chip.GetAML();
+        pml[i] = chip.GetPML();
+      }
+    }
+    lanes.Calc(ibuf_l, ibuf_r, aml, pml, n);
+    for (int i = 0; i < n; i++, dest += 2) {
+      StoreSample(dest[0], IStoSampleL(ibuf_l[i]));
+      StoreSample(dest[1], IStoSampleR(ibuf_r[i]));
+    }
+  }
+  lanes.Store();
+}
+
 // ---------------------------------------------------------------------------
 //	ステートセーブ
 //
@@ -159,6 +159,7 @@ namespace FM
 	protected:
 		void	FMMix(Sample* buffer, int nsamples);
 		void 	Mix6(Sample* buffer, int nsamples, int activech);
+		void 	Mix6Lanes(Sample* buffer, int nsamples, int activech);
 		
 		void	MixSubS(int activech, ISample**);
 		void	MixSubSL(int activech, ISample**);
@@ -286,6 +287,8 @@ namespace FM
 	
 		bool	SetRate(uint c, uint r, bool = false);
 		void 	Mix(Sample* buffer, int nsamples);
+		// ADPCM のみ (状態を保つ側のチップ用)
+		void	MixADPCM(Sample* buffer, int nsamples) { ADPCMBMix(buffer, nsamples); }
 
 		void	Reset();
 		void 	SetReg(uint addr, uint data);
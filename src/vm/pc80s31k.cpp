@@ -10,6 +10,7 @@
 #include "pc80s31k.h"
 #include "disk.h"
 #include "upd765a.h"
+#include "z80.h"
 
 //#define _DEBUG_PC80S31K
 
@@ -114,12 +115,14 @@ uint32_t PC80S31K::read_io8(uint32_t addr)
 		return d_fdc->read_io8(addr & 1);
 	case 0xfc:
 	case 0xfd:
+		d_cpu->write_signal(SIG_Z80_IDLE_POLL, 1, 1);
 		val = d_pio->read_io8(addr & 3);
 #ifdef _DEBUG_PC80S31K
 		this->out_debug_log(_T("SUB\tIN RECV(%d)=%2x\n"), addr & 3, val);
 #endif
 		return val;
 	case 0xfe:
+		d_cpu->write_signal(SIG_Z80_IDLE_POLL, 1, 1);
 		val = d_pio->read_io8(addr & 3);
 #ifdef _DEBUG_PC80S31K
 		{
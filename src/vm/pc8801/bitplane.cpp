@@ -0,0 +1,458 @@
+/*
+	Bitplane converters for BubiC-8801MA
+
+	Expand B/R/G GVRAM planes to one byte per pixel for draw_screen().
+	The best implementation for the host cpu is selected at runtime.
+
+	[ bitplane ]
+*/
+
+#include "bitplane.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BITPLANE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define BITPLANE_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BITPLANE_AVX2_TARGET
+#else
+#define BITPLANE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define BITPLANE_NEON
+#include <arm_neon.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// original scalar code
+// ----------------------------------------------------------------------------
+
+static void color_generic(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                          const uint8_t *g, int n) {
+  for (int i = 0; i < n; i++, dst += 8) {
+    uint8_t pb = b[i], pr = r[i], pg = g[i];
+    dst[0] = ((pb & 0x80) >> 7) | ((pr & 0x80) >> 6) | ((pg & 0x80) >> 5);
+    dst[1] = ((pb & 0x40) >> 6) | ((pr & 0x40) >> 5) | ((pg & 0x40) >> 4);
+    dst[2] = ((pb & 0x20) >> 5) | ((pr & 0x20) >> 4) | ((pg & 0x20) >> 3);
+    dst[3] = ((pb & 0x10) >> 4) | ((pr & 0x10) >> 3) | ((pg & 0x10) >> 2);
+    dst[4] = ((pb & 0x08) >> 3) | ((pr & 0x08) >> 2) | ((pg & 0x08) >> 1);
+    dst[5] = ((pb & 0x04) >> 2) | ((pr & 0x04) >> 1) | ((pg & 0x04));
+    dst[6] = ((pb & 0x02) >> 1) | ((pr & 0x02)) | ((pg & 0x02) << 1);
+    dst[7] = ((pb & 0x01)) | ((pr & 0x01) << 1) | ((pg & 0x01) << 2);
+  }
+}
+
+static void mono_generic(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                         const uint8_t *g, int n) {
+  for (int i = 0; i < n; i++, dst += 8) {
+    uint8_t brg = b[i] | r[i] | g[i];
+    dst[0] = (brg & 0x80) >> 7;
+    dst[1] = (brg & 0x40) >> 6;
+    dst[2] = (brg & 0x20) >> 5;
+    dst[3] = (brg & 0x10) >> 4;
+    dst[4] = (brg & 0x08) >> 3;
+    dst[5] = (brg & 0x04) >> 2;
+    dst[6] = (brg & 0x02) >> 1;
+    dst[7] = (brg & 0x01);
+  }
+}
+
+static void attrib_generic(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                           const uint8_t *g, const uint8_t *color,
+                           const bool *reverse, int n) {
+  for (int i = 0; i < n; i++, dst += 8) {
+    uint8_t c = color[i];
+    uint8_t brg = b[i] | r[i] | g[i];
+    if (reverse[i]) {
+      brg ^= 0xff;
+    }
+    dst[0] = (brg & 0x80) ? c : 0;
+    dst[1] = (brg & 0x40) ? c : 0;
+    dst[2] = (brg & 0x20) ? c : 0;
+    dst[3] = (brg & 0x10) ? c : 0;
+    dst[4] = (brg & 0x08) ? c : 0;
+    dst[5] = (brg & 0x04) ? c : 0;
+    dst[6] = (brg & 0x02) ? c : 0;
+    dst[7] = (brg & 0x01) ? c : 0;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// lookup table
+// ----------------------------------------------------------------------------
+
+// 8 pixels of 0 or 1 for each plane byte, so that 8 pixels are processed as
+// one 64bit word without carries between pixels
+typedef struct expand_table_s {
+  uint8_t pixels[256][8];
+  constexpr expand_table_s() : pixels() {
+    for (int i = 0; i < 256; i++) {
+      for (int j = 0; j < 8; j++) {
+        pixels[i][j] = (i >> (7 - j)) & 1;
+      }
+    }
+  }
+} expand_table_t;
+
+static constexpr expand_table_t expand_table;
+
+static inline uint64_t expand_lut(uint8_t p) {
+  uint64_t val;
+  memcpy(&val, expand_table.pixels[p], 8);
+  return val;
+}
+
+static void color_lut(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                      const uint8_t *g, int n) {
+  for (int i = 0; i < n; i++, dst += 8) {
+    uint64_t val =
+        expand_lut(b[i]) | (expand_lut(r[i]) << 1) | (expand_lut(g[i]) << 2);
+    memcpy(dst, &val, 8);
+  }
+}
+
+static void mono_lut(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                     const uint8_t *g, int n) {
+  for (int i = 0; i < n; i++, dst += 8) {
+    uint64_t val = expand_lut(b[i] | r[i] | g[i]);
+    memcpy(dst, &val, 8);
+  }
+}
+
+static void attrib_lut(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                       const uint8_t *g, const uint8_t *color,
+                       const bool *reverse, int n) {
+  for (int i = 0; i < n; i++, dst += 8) {
+    uint8_t brg = b[i] | r[i] | g[i];
+    if (reverse[i]) {
+      brg ^= 0xff;
+    }
+    uint64_t val = expand_lut(brg) * color[i];
+    memcpy(dst, &val, 8);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// SSE2: 16 plane bytes for each iteration
+// ----------------------------------------------------------------------------
+
+#ifdef BITPLANE_SSE2
+// broadcast each byte of p to 8 bytes, out[k] has bytes 2k and 2k+1
+static inline void broadcast_sse2(__m128i p, __m128i out[8]) {
+  __m128i lo = _mm_unpacklo_epi8(p, p);
+  __m128i hi = _mm_unpackhi_epi8(p, p);
+  __m128i q0 = _mm_unpacklo_epi16(lo, lo);
+  __m128i q1 = _mm_unpackhi_epi16(lo, lo);
+  __m128i q2 = _mm_unpacklo_epi16(hi, hi);
+  __m128i q3 = _mm_unpackhi_epi16(hi, hi);
+  out[0] = _mm_unpacklo_epi32(q0, q0);
+  out[1] = _mm_unpackhi_epi32(q0, q0);
+  out[2] = _mm_unpacklo_epi32(q1, q1);
+  out[3] = _mm_unpackhi_epi32(q1, q1);
+  out[4] = _mm_unpacklo_epi32(q2, q2);
+  out[5] = _mm_unpackhi_epi32(q2, q2);
+  out[6] = _mm_unpacklo_epi32(q3, q3);
+  out[7] = _mm_unpackhi_epi32(q3, q3);
+}
+
+// 0xff for each set bit of p
+static inline void expand_sse2(__m128i p, __m128i out[8]) {
+  const __m128i bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, (char)128, 1, 2,
+                                    4, 8, 16, 32, 64, (char)128);
+  broadcast_sse2(p, out);
+  for (int k = 0; k < 8; k++) {
+    out[k] = _mm_cmpeq_epi8(_mm_and_si128(out[k], bits), bits);
+  }
+}
+
+static void color_sse2(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                       const uint8_t *g, int n) {
+  const __m128i one = _mm_set1_epi8(1);
+  const __m128i two = _mm_set1_epi8(2);
+  const __m128i four = _mm_set1_epi8(4);
+  int i = 0;
+  for (; i + 16 <= n; i += 16, dst += 128) {
+    __m128i eb[8], er[8], eg[8];
+    expand_sse2(_mm_loadu_si128((const __m128i *)(b + i)), eb);
+    expand_sse2(_mm_loadu_si128((const __m128i *)(r + i)), er);
+    expand_sse2(_mm_loadu_si128((const __m128i *)(g + i)), eg);
+    for (int k = 0; k < 8; k++) {
+      __m128i val = _mm_or_si128(
+          _mm_and_si128(eb[k], one),
+          _mm_or_si128(_mm_and_si128(er[k], two), _mm_and_si128(eg[k], four)));
+      _mm_storeu_si128((__m128i *)(dst + 16 * k), val);
+    }
+  }
+  color_lut(dst, b + i, r + i, g + i, n - i);
+}
+
+static void mono_sse2(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                      const uint8_t *g, int n) {
+  const __m128i one = _mm_set1_epi8(1);
+  int i = 0;
+  for (; i + 16 <= n; i += 16, dst += 128) {
+    __m128i brg = _mm_or_si128(
+        _mm_loadu_si128((const __m128i *)(b + i)),
+        _mm_or_si128(_mm_loadu_si128((const __m128i *)(r + i)),
+                     _mm_loadu_si128((const __m128i *)(g + i))));
+    __m128i e[8];
+    expand_sse2(brg, e);
+    for (int k = 0; k < 8; k++) {
+      _mm_storeu_si128((__m128i *)(dst + 16 * k), _mm_and_si128(e[k], one));
+    }
+  }
+  mono_lut(dst, b + i, r + i, g + i, n - i);
+}
+
+static void attrib_sse2(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                        const uint8_t *g, const uint8_t *color,
+                        const bool *reverse, int n) {
+  const __m128i zero = _mm_setzero_si128();
+  int i = 0;
+  for (; i + 16 <= n; i += 16, dst += 128) {
+    __m128i brg = _mm_or_si128(
+        _mm_loadu_si128((const __m128i *)(b + i)),
+        _mm_or_si128(_mm_loadu_si128((const __m128i *)(r + i)),
+                     _mm_loadu_si128((const __m128i *)(g + i))));
+    // reverse is 0 or 1, and 0 - 1 is 0xff
+    __m128i rev = _mm_sub_epi8(zero, _mm_loadu_si128((const __m128i *)(reverse + i)));
+    __m128i e[8], c[8];
+    expand_sse2(_mm_xor_si128(brg, rev), e);
+    broadcast_sse2(_mm_loadu_si128((const __m128i *)(color + i)), c);
+    for (int k = 0; k < 8; k++) {
+      _mm_storeu_si128((__m128i *)(dst + 16 * k), _mm_and_si128(e[k], c[k]));
+    }
+  }
+  attrib_lut(dst, b + i, r + i, g + i, color + i, reverse + i, n - i);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// AVX2: 4 plane bytes for each 32 pixels
+// ----------------------------------------------------------------------------
+
+#ifdef BITPLANE_AVX2
+static bool has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  // avx and osxsave, and the os saves ymm registers
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+    return false;
+  }
+  if ((_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// broadcast each of 4 bytes at src to 8 bytes
+BITPLANE_AVX2_TARGET
+static inline __m256i broadcast_avx2(const void *src) {
+  const __m256i index =
+      _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2,
+                       2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  int32_t val;
+  memcpy(&val, src, 4);
+  return _mm256_shuffle_epi8(_mm256_set1_epi32(val), index);
+}
+
+BITPLANE_AVX2_TARGET
+static inline __m256i expand_avx2(__m256i p) {
+  const __m256i bits = _mm256_setr_epi8(
+      (char)128, 64, 32, 16, 8, 4, 2, 1, (char)128, 64, 32, 16, 8, 4, 2, 1,
+      (char)128, 64, 32, 16, 8, 4, 2, 1, (char)128, 64, 32, 16, 8, 4, 2, 1);
+  return _mm256_cmpeq_epi8(_mm256_and_si256(p, bits), bits);
+}
+
+BITPLANE_AVX2_TARGET
+static void color_avx2(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                       const uint8_t *g, int n) {
+  const __m256i one = _mm256_set1_epi8(1);
+  const __m256i two = _mm256_set1_epi8(2);
+  const __m256i four = _mm256_set1_epi8(4);
+  int i = 0;
+  for (; i + 4 <= n; i += 4, dst += 32) {
+    __m256i eb = expand_avx2(broadcast_avx2(b + i));
+    __m256i er = expand_avx2(broadcast_avx2(r + i));
+    __m256i eg = expand_avx2(broadcast_avx2(g + i));
+    __m256i val = _mm256_or_si256(
+        _mm256_and_si256(eb, one),
+        _mm256_or_si256(_mm256_and_si256(er, two), _mm256_and_si256(eg, four)));
+    _mm256_storeu_si256((__m256i *)dst, val);
+  }
+  color_lut(dst, b + i, r + i, g + i, n - i);
+}
+
+BITPLANE_AVX2_TARGET
+static void mono_avx2(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                      const uint8_t *g, int n) {
+  const __m256i one = _mm256_set1_epi8(1);
+  int i = 0;
+  for (; i + 4 <= n; i += 4, dst += 32) {
+    __m256i brg = _mm256_or_si256(
+        broadcast_avx2(b + i),
+        _mm256_or_si256(broadcast_avx2(r + i), broadcast_avx2(g + i)));
+    _mm256_storeu_si256((__m256i *)dst, _mm256_and_si256(expand_avx2(brg), one));
+  }
+  mono_lut(dst, b + i, r + i, g + i, n - i);
+}
+
+BITPLANE_AVX2_TARGET
+static void attrib_avx2(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                        const uint8_t *g, const uint8_t *color,
+                        const bool *reverse, int n) {
+  const __m256i zero = _mm256_setzero_si256();
+  int i = 0;
+  for (; i + 4 <= n; i += 4, dst += 32) {
+    __m256i brg = _mm256_or_si256(
+        broadcast_avx2(b + i),
+        _mm256_or_si256(broadcast_avx2(r + i), broadcast_avx2(g + i)));
+    // reverse is 0 or 1, and 0 - 1 is 0xff
+    __m256i rev = _mm256_sub_epi8(zero, broadcast_avx2(reverse + i));
+    __m256i val = _mm256_and_si256(expand_avx2(_mm256_xor_si256(brg, rev)),
+                                   broadcast_avx2(color + i));
+    _mm256_storeu_si256((__m256i *)dst, val);
+  }
+  attrib_lut(dst, b + i, r + i, g + i, color + i, reverse + i, n - i);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// NEON: 16 plane bytes for each iteration
+// ----------------------------------------------------------------------------
+
+#ifdef BITPLANE_NEON
+static const uint8_t neon_index[8][16] = {
+    {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1},
+    {2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3},
+    {4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5},
+    {6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7},
+    {8, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9},
+    {10, 10, 10, 10, 10, 10, 10, 10, 11, 11, 11, 11, 11, 11, 11, 11},
+    {12, 12, 12, 12, 12, 12, 12, 12, 13, 13, 13, 13, 13, 13, 13, 13},
+    {14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15},
+};
+static const uint8_t neon_bits[16] = {128, 64, 32, 16, 8, 4, 2, 1,
+                                      128, 64, 32, 16, 8, 4, 2, 1};
+
+static void color_neon(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                       const uint8_t *g, int n) {
+  const uint8x16_t bits = vld1q_u8(neon_bits);
+  const uint8x16_t one = vdupq_n_u8(1);
+  const uint8x16_t two = vdupq_n_u8(2);
+  const uint8x16_t four = vdupq_n_u8(4);
+  int i = 0;
+  for (; i + 16 <= n; i += 16, dst += 128) {
+    uint8x16_t pb = vld1q_u8(b + i);
+    uint8x16_t pr = vld1q_u8(r + i);
+    uint8x16_t pg = vld1q_u8(g + i);
+    for (int k = 0; k < 8; k++) {
+      uint8x16_t index = vld1q_u8(neon_index[k]);
+      uint8x16_t eb = vtstq_u8(vqtbl1q_u8(pb, index), bits);
+      uint8x16_t er = vtstq_u8(vqtbl1q_u8(pr, index), bits);
+      uint8x16_t eg = vtstq_u8(vqtbl1q_u8(pg, index), bits);
+      uint8x16_t val = vorrq_u8(vandq_u8(eb, one),
+                                vorrq_u8(vandq_u8(er, two), vandq_u8(eg, four)));
+      vst1q_u8(dst + 16 * k, val);
+    }
+  }
+  color_lut(dst, b + i, r + i, g + i, n - i);
+}
+
+static void mono_neon(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                      const uint8_t *g, int n) {
+  const uint8x16_t bits = vld1q_u8(neon_bits);
+  const uint8x16_t one = vdupq_n_u8(1);
+  int i = 0;
+  for (; i + 16 <= n; i += 16, dst += 128) {
+    uint8x16_t brg =
+        vorrq_u8(vld1q_u8(b + i), vorrq_u8(vld1q_u8(r + i), vld1q_u8(g + i)));
+    for (int k = 0; k < 8; k++) {
+      uint8x16_t e = vtstq_u8(vqtbl1q_u8(brg, vld1q_u8(neon_index[k])), bits);
+      vst1q_u8(dst + 16 * k, vandq_u8(e, one));
+    }
+  }
+  mono_lut(dst, b + i, r + i, g + i, n - i);
+}
+
+static void attrib_neon(uint8_t *dst, const uint8_t *b, const uint8_t *r,
+                        const uint8_t *g, const uint8_t *color,
+                        const bool *reverse, int n) {
+  const uint8x16_t bits = vld1q_u8(neon_bits);
+  int i = 0;
+  for (; i + 16 <= n; i += 16, dst += 128) {
+    uint8x16_t brg =
+        vorrq_u8(vld1q_u8(b + i), vorrq_u8(vld1q_u8(r + i), vld1q_u8(g + i)));
+    // reverse is 0 or 1, and 0 - 1 is 0xff
+    uint8x16_t rev =
+        vsubq_u8(vdupq_n_u8(0), vld1q_u8((const uint8_t *)(reverse + i)));
+    uint8x16_t c = vld1q_u8(color + i);
+    brg = veorq_u8(brg, rev);
+    for (int k = 0; k < 8; k++) {
+      uint8x16_t index = vld1q_u8(neon_index[k]);
+      uint8x16_t e = vtstq_u8(vqtbl1q_u8(brg, index), bits);
+      vst1q_u8(dst + 16 * k, vandq_u8(e, vqtbl1q_u8(c, index)));
+    }
+  }
+  attrib_lut(dst, b + i, r + i, g + i, color + i, reverse + i, n - i);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// selection
+// ----------------------------------------------------------------------------
+
+// ordered from the slowest, simd converters follow the scalar ones
+static const bitplane_t bitplanes[] = {
+    {"generic", color_generic, mono_generic, attrib_generic},
+    {"lut", color_lut, mono_lut, attrib_lut},
+#ifdef BITPLANE_SSE2
+    {"sse2", color_sse2, mono_sse2, attrib_sse2},
+#endif
+#ifdef BITPLANE_AVX2
+    {"avx2", color_avx2, mono_avx2, attrib_avx2},
+#endif
+#ifdef BITPLANE_NEON
+    {"neon", color_neon, mono_neon, attrib_neon},
+#endif
+};
+
+int get_bitplane_count() {
+  static int count = -1;
+  if (count < 0) {
+    count = (int)array_length(bitplanes);
+#ifdef BITPLANE_AVX2
+    // avx2 is the last one on x86
+    if (!has_avx2()) {
+      count--;
+    }
+#endif
+  }
+  return count;
+}
+
+const bitplane_t *get_bitplane(int index) {
+  if (index < 0 || index >= get_bitplane_count()) {
+    return NULL;
+  }
+  return &bitplanes[index];
+}
+
+const bitplane_t *get_best_bitplane() {
+  return &bitplanes[get_bitplane_count() - 1];
+}
@@ -0,0 +1,38 @@
+/*
+	Bitplane converters for BubiC-8801MA
+
+	Expand B/R/G GVRAM planes to one byte per pixel for draw_screen().
+	The best implementation for the host cpu is selected at runtime.
+
+	[ bitplane ]
+*/
+
+#ifndef _BITPLANE_H_
+#define _BITPLANE_H_
+
+#include "../../common.h"
+
+// all converters take n plane bytes and write 8 * n pixels, bit 7 first
+
+// pixel = b | (r << 1) | (g << 2)
+typedef void (*bitplane_color_t)(uint8_t *dst, const uint8_t *b, const uint8_t *r, const uint8_t *g, int n);
+// pixel = b | r | g
+typedef void (*bitplane_mono_t)(uint8_t *dst, const uint8_t *b, const uint8_t *r, const uint8_t *g, int n);
+// pixel = (b | r | g) ^ reverse[i] ? color[i] : 0, one color and reverse flag for each plane byte
+typedef void (*bitplane_attrib_t)(uint8_t *dst, const uint8_t *b, const uint8_t *r, const uint8_t *g, const uint8_t *color, const bool *reverse, int n);
+
+typedef struct {
+	const char *name;
+	bitplane_color_t color;
+	bitplane_mono_t mono;
+	bitplane_attrib_t attrib;
+} bitplane_t;
+
+// converters supported by the host cpu, 0 is the original scalar code
+int get_bitplane_count();
+const bitplane_t *get_bitplane(int index);
+
+// the fastest converters supported by the host cpu
+const bitplane_t *get_best_bitplane();
+
+#endif
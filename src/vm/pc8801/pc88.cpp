@@ -284,6 +284,24 @@ void PC88::initialize() {
 #if defined(PC8801SR_VARIANT)
   memset(tvram, 0, sizeof(tvram));
 #endif
+  redraw_screen = true;
+  bitplane = get_best_bitplane();
+  vline_rendering = vline_published = false;
+  vline_next = vline_max = 0;
+  vline_dirty_top = 400;
+  vline_dirty_bottom = 0;
+  vline_screen_lines = 200;
+  vline_skip_line = true;
+  memset(vline_key, 0, sizeof(vline_key));
+  memset(vline_screen, 0, sizeof(vline_screen));
+  memset(palette_line_pc, 0, sizeof(palette_line_pc));
+  memset(palette_line_pc_id, 0, sizeof(palette_line_pc_id));
+  palette_pc_id = 0;
+  memset(screen_palette_id, 0, sizeof(screen_palette_id));
+  memset(glyph_cache, 0, sizeof(glyph_cache));
+  glyph_generation = 1;
+  invalidated_top = 0;
+  invalidated_bottom = 400;
 
   // #ifdef SUPPORT_PC88_KANJI1
   memset(kanji1, 0xff, sizeof(kanji1));
@@ -668,6 +686,7 @@ void PC88::reset() {
   tvram_wait_clocks_r = get_tvram_wait(true);
   tvram_wait_clocks_w = get_tvram_wait(false);
 #endif
+  update_mem_pages();
   memcpy(prev_port, port, sizeof(port));
 
   // crtc
@@ -742,6 +761,7 @@ void PC88::reset() {
 #ifdef SUPPORT_PC88_PCG8100
   // pcg
   memcpy(pcg_pattern, kanji1 + 0x1000, sizeof(pcg_pattern));
+  invalidate_glyph_cache();
   write_io8(1, 0);
   write_io8(2, 0);
   write_io8(3, 0);
@@ -777,6 +797,7 @@ void PC88::write_data8w(uint32_t addr, uint32_t data, int *wait) {
       addr = (Port70_TEXTWND << 8) + (addr & 0x3ff);
     }
     ram[addr & 0xffff] = data;
+    d_cpu->invalidate_block_cache(addr);
     return;
   }
 #endif
@@ -786,6 +807,8 @@ void PC88::write_data8w(uint32_t addr, uint32_t data, int *wait) {
 #else
   if ((addr & 0xc000) == 0x8000) {
 #endif
+    // each plane is mapped only at this address
+    d_cpu->invalidate_block_cache(addr);
     switch (gvram_sel) {
     case 1:
       *wait = gvram_wait_clocks_w;
@@ -845,6 +868,7 @@ void PC88::write_data8w(uint32_t addr, uint32_t data, int *wait) {
   }
 #endif
   wbank[addr >> 12][addr & 0xfff] = data;
+  d_cpu->invalidate_block_cache(addr);
 }
 
 uint32_t PC88::read_data8w(uint32_t addr, int *wait) {
@@ -1090,6 +1114,7 @@ void PC88::write_io8(uint32_t addr, uint32_t data) {
       } else {
         pcg_pattern[0x400 | pcg_addr] = pcg_data;
       }
+      invalidate_glyph_cache();
     }
     pcg_addr = (pcg_addr & 0x0ff) | ((data & 3) << 8);
     pcg_ctrl = data;
@@ -1220,6 +1245,7 @@ void PC88::write_io8(uint32_t addr, uint32_t data) {
       //{
       update_tvram_memmap();
       f000_m1_wait_clocks = get_m1_wait(true);
+      update_mem_pages();
       //			}
     }
     if (mod & 0x40) {
@@ -1673,6 +1699,9 @@ void PC88::write_io8(uint32_t addr, uint32_t data) {
       // effect only 0x00 or 0x01
       port[0xf1] ^= mod;
     }
+#ifdef SUPPORT_PC88_DICTIONARY
+    update_mem_pages();
+#endif
     break;
 #endif
 #ifdef SUPPORT_PC88_FDD_8INCH
@@ -1691,6 +1720,8 @@ void PC88::write_io8(uint32_t addr, uint32_t data) {
   case 0xfd:
   case 0xfe:
   case 0xff:
+    // the sub cpu must see this write at the same clock as the main cpu
+    catch_up_sub_cpu();
     d_pio->write_io8(addr, data);
     break;
   }
@@ -1888,6 +1919,8 @@ uint32_t PC88::read_io8_debug(uint32_t addr)
     return port[0x32];
 #endif
   case 0x40:
+    // vblank can be polled in idle loop
+    d_cpu->write_signal(SIG_Z80_IDLE_POLL, 1, 1);
     // XM8 version 1.10
     //		return (crtc.vblank ? 0x20 : 0) | (d_rtc->read_signal(0) ? 0x10
     //: 0) | (usart_dcd ? 4 : 0) | (hireso ? 0 : 2) | 0xc1;
@@ -2214,6 +2247,7 @@ uint32_t PC88::read_io8_debug(uint32_t addr)
   case 0xfc:
   case 0xfd:
   case 0xfe:
+    catch_up_sub_cpu();
     return d_pio->read_io8(addr);
   }
   return 0xff;
@@ -2234,6 +2268,7 @@ uint32_t PC88::read_dma_data8(uint32_t addr) {
 void PC88::write_dma_data8(uint32_t addr, uint32_t data) {
   // to ram
   ram[addr & 0xffff] = data;
+  d_cpu->invalidate_block_cache(addr);
 }
 
 void PC88::write_dma_io8(uint32_t addr, uint32_t data) {
@@ -2273,6 +2308,9 @@ void PC88::update_config() {
 #endif
   ((VM*)vm)->pc88event->set_context_cpu_clock(d_cpu, clocks);
   
+  // the font may be changed by the option switch
+  invalidate_glyph_cache();
+
   // Update wait clocks
   m1_wait_clocks = get_m1_wait(false);
   f000_m1_wait_clocks = get_m1_wait(true);
@@ -2282,6 +2320,7 @@ void PC88::update_config() {
   tvram_wait_clocks_r = get_tvram_wait(true);
   tvram_wait_clocks_w = get_tvram_wait(false);
 #endif
+  update_mem_pages();
 }
 
 int PC88::get_m1_wait(bool addr_f000) {
@@ -2377,6 +2416,80 @@ int PC88::get_tvram_wait(bool read) {
 }
 #endif
 
+void PC88::update_mem_pages() {
+  // rebuild the page table used by cpu to access plain ram/rom directly,
+  // pages that need the special handling in read_data8w()/write_data8w()
+  // are marked as slow
+  for (int i = 0; i < 16; i++) {
+    mem_page_t *page = &mem_pages[i];
+    uint32_t addr = i << 12;
+    page->read = rbank[i];
+    page->write = wbank[i];
+    page->read_wait = mem_wait_clocks_r;
+    page->write_wait = mem_wait_clocks_w;
+    page->slow = false;
+    bool gvram_page = false;
+
+#if defined(PC8801_VARIANT)
+    if (addr == 0x8000) {
+      // text window
+      page->slow = true;
+    }
+#endif
+#if defined(SUPPORT_PC88_GVRAM)
+#if defined(PC8801_VARIANT)
+    if ((addr & 0xc000) == 0xc000) {
+#else
+    if ((addr & 0xc000) == 0x8000) {
+#endif
+      int plane = -1;
+      switch (gvram_sel) {
+      case 1:
+        plane = 0;
+        break;
+#if defined(_PC8001SR) || defined(PC8801_VARIANT)
+      case 2:
+        plane = 1;
+        break;
+      case 4:
+        plane = 2;
+        break;
+#endif
+#if defined(_PC8001SR) || defined(PC8801SR_VARIANT)
+      case 8:
+        // alu
+        page->slow = true;
+        gvram_page = true;
+        break;
+#endif
+      }
+      if (plane >= 0) {
+        page->read = page->write = gvram + 0x4000 * plane + (addr & 0x3000);
+        page->read_wait = gvram_wait_clocks_r;
+        page->write_wait = gvram_wait_clocks_w;
+        gvram_page = true;
+      }
+#ifdef SUPPORT_PC88_DICTIONARY
+      if (!gvram_page && PortF1_DICROM) {
+        page->slow = true;
+      }
+#endif
+    }
+#endif
+#if defined(PC8801SR_VARIANT)
+    if (addr == 0xf000 && !gvram_page) {
+      // high speed ram
+      page->read_wait += tvram_wait_clocks_r;
+      page->write_wait += tvram_wait_clocks_w;
+    }
+#endif
+    page->fetch_wait = page->read_wait +
+                       ((addr == 0xf000) ? f000_m1_wait_clocks : m1_wait_clocks);
+  }
+  // the block cache of cpu checks the new pages
+  d_cpu->notify_mem_pages_changed();
+}
+
 #if defined(SUPPORT_PC88_GVRAM)
 int PC88::get_gvram_wait(bool read) {
   // XM8 version 1.20
@@ -2476,6 +2589,7 @@ int PC88::get_gvram_wait(bool read) {
 void PC88::update_gvram_wait() {
   gvram_wait_clocks_r = get_gvram_wait(true);
   gvram_wait_clocks_w = get_gvram_wait(false);
+  update_mem_pages();
 }
 
 void PC88::update_gvram_sel() {
@@ -2493,6 +2607,7 @@ void PC88::update_gvram_sel() {
     gvram_sel = gvram_plane;
   }
   f000_m1_wait_clocks = get_m1_wait(true);
+  update_mem_pages();
 }
 #endif
 
@@ -2501,13 +2616,18 @@ void PC88::update_n80_write() {
 #if defined(PC88_EXRAM_BANKS)
   if (PortE2_WREN || Port31_MMODE) {
     SET_BANK_W(0x0000, 0x7fff, exram);
-    return;
-  }
+  } else
 #endif
-  SET_BANK_W(0x0000, 0x7fff, wdmy);
+    SET_BANK_W(0x0000, 0x7fff, wdmy);
+  update_mem_pages();
 }
 
 void PC88::update_n80_read() {
+  update_n80_read_sub();
+  update_mem_pages();
+}
+
+void PC88::update_n80_read_sub() {
 #if defined(PC88_EXRAM_BANKS)
   if (PortE2_RDEN || Port31_MMODE) {
     SET_BANK_R(0x0000, 0x7fff, exram);
@@ -2547,6 +2667,7 @@ void PC88::update_low_read() {
     SET_BANK_R(0x0000, 0x1fff, boot_16bit);
   }
 #endif
+  update_mem_pages();
 }
 
 void PC88::update_low_read_sub() {
@@ -2601,6 +2722,7 @@ void PC88::update_low_write() {
     SET_BANK_W(0x0000, 0x1fff, wdmy);
   }
 #endif
+  update_mem_pages();
 }
 
 void PC88::update_low_write_sub() {
@@ -2627,6 +2749,7 @@ void PC88::update_tvram_memmap() {
   } else {
     SET_BANK(0xf000, 0xffff, tvram, tvram);
   }
+  update_mem_pages();
 }
 #endif
 #endif
@@ -2824,6 +2947,30 @@ uint8_t PC88::read_mouse_joy() {
 void PC88::event_vline(int v, int clock) {
   int disp_line = crtc.height * crtc.char_height;
 
+  // render the lines the beam has passed
+  if (vline_rendering) {
+    int passed = (v == 0) ? vline_max : min(v, vline_max);
+    while (vline_next < passed) {
+      draw_vline(vline_next++);
+    }
+    // publish the frame when the last line is rendered, it is v == disp_line
+    // unless the text area is shorter than the graphic screen
+    if (v != 0 && vline_next == vline_max && !vline_published &&
+        emu->is_screen_publishable_in_frame()) {
+#if defined(PC8801_VARIANT) && defined(SUPPORT_PC88_VAB)
+      if (!PortB4_VAB_DISP)
+#endif
+      {
+        draw_vline_screen();
+        vline_published = true;
+      }
+    }
+  }
+  if (v == 0) {
+    if ((vline_rendering = config.vline_rendering)) {
+      start_vline_frame(disp_line);
+    }
+  }
   if (v == 0) {
     if (crtc.status & 0x10) {
       // start dma transfer to crtc
@@ -3106,6 +3253,19 @@ bool PC88::check_data_carrier() {
 }
 
 void PC88::draw_screen() {
+  if (vline_rendering) {
+#if defined(PC8801_VARIANT) && defined(SUPPORT_PC88_VAB)
+    if (!PortB4_VAB_DISP)
+#endif
+    {
+      // lines are already rendered, and may be published, by event_vline()
+      if (!vline_published) {
+        draw_vline_screen();
+      }
+      return;
+    }
+  }
+
   // copy port data at starting vblank
   uint8_t cur_port[256];
 
@@ -3114,266 +3274,502 @@ void PC88::draw_screen() {
 
   // render text screen
   draw_text();
+  update_changed_lines();
 
   // render graph screen
-  bool disp_color_graph = true;
-  bool draw_scanline_black = config.scan_line;
+  bool disp_color_graph, draw_scanline_black;
+  emu->set_vm_screen_lines(draw_graph(0, 400, &disp_color_graph, &draw_scanline_black));
+
+  // update host palettes of lines where the palette is changed
+#if defined(PC8801_VARIANT)
+  int disp_line = crtc.height * crtc.char_height;
+  int ymax = (disp_line <= 200) ? 200 : 400;
+#else
+  int ymax = 200;
+#endif
+  int palette_line_src[400];
+
+  for (int y = 0, v = 0; y < ymax; y++) {
+    if (palette_line_changed[y] &&
+        (y == 0 || (config.dipswitch & DIPSWITCH_PALETTE) == 0)) {
+      update_palette_line_pc(y, disp_color_graph);
+      v = y;
+    }
+    palette_line_src[y] = v;
+  }
+
+  // select palettes and find lines changed since the last frame
+  scrntype_t *line_pal_t[400];
+  scrntype_t *line_pal_g[400];
+
+  invalidated_top = 400;
+  invalidated_bottom = 0;
+#if defined(PC8801_VARIANT) && defined(SUPPORT_PC88_VAB)
+  if (PortB4_VAB_DISP) {
+    invalidated_top = 0;
+    invalidated_bottom = 400;
+  } else
+#endif
+  {
+    for (int y = 0; y < 400; y++) {
+      int v = palette_line_src[(ymax == 200) ? (y >> 1) : y];
+
+      get_line_palettes(v, &line_pal_t[y], &line_pal_g[y]);
+      if (is_screen_line_changed(y, palette_line_pc_id[v], redraw_screen)) {
+        if (invalidated_top > y) {
+          invalidated_top = y;
+        }
+        invalidated_bottom = y + 1;
+      }
+    }
+  }
+
+  // the screen buffer may be the locked texture of osd, so all lines in the
+  // range (it may be widened by osd) are written
+  emu->lock_screen_buffer(&invalidated_top, &invalidated_bottom);
+
+  // copy to screen buffer
+#if defined(PC8801_VARIANT) && defined(SUPPORT_PC88_VAB)
+  // X88000
+  if (PortB4_VAB_DISP) {
+    uint8_t *src = &exram[(0x8000 * 4) * PC88_VAB_PAGE];
+
+    for (int y = 0; y < 400; y += 2) {
+      scrntype_t *dest0 = emu->get_screen_buffer(y);
+      scrntype_t *dest1 = emu->get_screen_buffer(y + 1);
+
+      for (int x = 0; x < 640; x += 2) {
+        pair16_t c;
+        c.b.l = *src++;
+        c.b.h = *src++;
+        dest0[x] = dest0[x + 1] = palette_vab_pc[c.w];
+      }
+      if (config.scan_line) {
+        memset(dest1, 0, sizeof(scrntype_t) * 640);
+      } else {
+        memcpy(dest1, dest0, sizeof(scrntype_t) * 640);
+      }
+    }
+    emu->screen_skip_line(true);
+  } else
+#endif
+  {
+    bool line400 = is_400line_screen();
+
+    for (int y = invalidated_top; y < invalidated_bottom; y++) {
+      scrntype_t *dest = emu->get_screen_buffer(y);
+      if (!dest) continue;
+      draw_screen_line(dest, y, line_pal_t[y], line_pal_g[y], line400,
+                       draw_scanline_black);
+    }
+    emu->screen_skip_line(!line400);
+  }
+  emu->unlock_screen_buffer();
+
+#if defined(PC8801_VARIANT) && defined(SUPPORT_PC88_VAB)
+  // the next frame may not be shown on vab
+  redraw_screen = PortB4_VAB_DISP;
+#else
+  redraw_screen = false;
+#endif
+
+  // restore port
+  memcpy(port, cur_port, 256);
+}
+
+int PC88::draw_graph(int top, int bottom, bool *disp_color_graph,
+                     bool *draw_scanline_black) {
+  // render graph lines in [top, bottom) and return the lines of the screen
+  int lines = 200;
+
+  *disp_color_graph = true;
+  *draw_scanline_black = config.scan_line;
 #if defined(SUPPORT_PC88_GVRAM)
 #if defined(PC8001_VARIANT)
 #if defined(_PC8001SR)
   if (config.boot_mode != MODE_PC80_V2) {
 #endif
     if (Port31_V1_320x200) {
-      disp_color_graph = draw_320x200_4color_graph();
+      *disp_color_graph = draw_320x200_4color_graph(top, bottom);
+      memset(graph_line_changed + top, 1, bottom - top);
     } else if (Port31_V1_MONO) {
-      draw_640x200_mono_graph();
+      draw_640x200_mono_graph(top, bottom);
     } else {
       if (hireso) {
-        draw_scanline_black = false;
+        *draw_scanline_black = false;
       }
-      draw_640x200_attrib_graph();
+      draw_640x200_attrib_graph(top, bottom);
     }
-    emu->set_vm_screen_lines(200);
 #if defined(_PC8001SR)
   } else {
     if (Port31_HCOLOR) {
       if (Port31_320x200) {
-        disp_color_graph = draw_320x200_color_graph();
+        *disp_color_graph = draw_320x200_color_graph(top, bottom);
+        memset(graph_line_changed + top, 1, bottom - top);
       } else {
-        disp_color_graph = draw_640x200_color_graph();
+        *disp_color_graph = draw_640x200_color_graph(top, bottom);
       }
-      emu->set_vm_screen_lines(200);
     } else {
       if (Port31_320x200) {
-        draw_320x200_attrib_graph();
+        draw_320x200_attrib_graph(top, bottom);
+        memset(graph_line_changed + top, 1, bottom - top);
       } else {
-        draw_640x200_attrib_graph();
+        draw_640x200_attrib_graph(top, bottom);
       }
       if (hireso) {
-        draw_scanline_black = false;
+        *draw_scanline_black = false;
       }
-      emu->set_vm_screen_lines(200);
     }
   }
 #endif
 #else
   if (Port31_HCOLOR) {
-    disp_color_graph = draw_640x200_color_graph();
-    emu->set_vm_screen_lines(200);
+    *disp_color_graph = draw_640x200_color_graph(top, bottom);
   } else if (Port31_400LINE) {
     if (hireso) {
-      draw_scanline_black = false;
+      *draw_scanline_black = false;
     }
-    draw_640x400_attrib_graph();
-    //		draw_640x400_mono_graph();
-    emu->set_vm_screen_lines(400);
+    draw_640x400_attrib_graph(top, bottom);
+    //		draw_640x400_mono_graph(top, bottom);
+    lines = 400;
   } else {
     if (hireso) {
-      draw_scanline_black = false;
+      *draw_scanline_black = false;
     }
-    draw_640x200_attrib_graph();
-    //		draw_640x200_mono_graph();
-    emu->set_vm_screen_lines(200);
+    draw_640x200_attrib_graph(top, bottom);
+    //		draw_640x200_mono_graph(top, bottom);
   }
 #endif
 #else
   //	memset(graph, 0, sizeof(graph));
-  emu->set_vm_screen_lines(200);
 #endif
+  return lines;
+}
 
-  // create palette for each scanline
+bool PC88::is_400line_screen() {
 #if defined(PC8801_VARIANT)
-  int disp_line = crtc.height * crtc.char_height;
-  int ymax = (disp_line <= 200) ? 200 : 400;
+  return !Port31_HCOLOR && Port31_400LINE;
 #else
-  int ymax = 200;
+  return false;
 #endif
-  static const uint32_t pex[8] = {
-      0, 36, 73, 109, 146, 182, 219, 255 // from m88
-  };
-  scrntype_t palette_digital_text_pc[9];
-  scrntype_t palette_analog_text_pc[9];
-  scrntype_t palette_digital_graph_pc[9];
-  scrntype_t palette_analog_graph_pc[9];
+}
 
-  scrntype_t palette_line_digital_text_pc[400][9];
-  scrntype_t palette_line_analog_graph_pc[400][9];
-#if defined(PC8801_VARIANT)
-  scrntype_t palette_line_analog_text_pc[400][9];
-  scrntype_t palette_line_digital_graph_pc[400][9];
+void PC88::get_line_palettes(int v, scrntype_t **pal_t, scrntype_t **pal_g) {
+#if defined(PC8001_VARIANT)
+  *pal_t = palette_line_pc[v][0];
+  *pal_g = palette_line_pc[v][3];
+#else
+  if (Port31_HCOLOR) {
+    *pal_t = palette_line_pc[v][0];
+    *pal_g = palette_line_pc[v][3];
+  } else if (Port32_PMODE) {
+    *pal_t = palette_line_pc[v][1];
+    *pal_g = palette_line_pc[v][3];
+  } else {
+    *pal_t = palette_line_pc[v][0];
+    *pal_g = palette_line_pc[v][2];
+  }
 #endif
+}
 
-  for (int y = 0; y < ymax; y++) {
-    if (palette_line_changed[y]) {
-      for (int i = 0; i < 9; i++) {
-        // A is a flag for crt filter
-        palette_digital_text_pc[i] =
-            RGBA_COLOR(pex[palette_line_digital[y][i].r],
-                       pex[palette_line_digital[y][i].g],
-                       pex[palette_line_digital[y][i].b], 255);
-        palette_analog_text_pc[i] = RGBA_COLOR(
-            pex[palette_line_analog[y][i].r], pex[palette_line_analog[y][i].g],
-            pex[palette_line_analog[y][i].b], 255);
-        palette_digital_graph_pc[i] =
-            RGBA_COLOR(pex[palette_line_digital[y][i].r],
-                       pex[palette_line_digital[y][i].g],
-                       pex[palette_line_digital[y][i].b], 0);
-        palette_analog_graph_pc[i] = RGBA_COLOR(
-            pex[palette_line_analog[y][i].r], pex[palette_line_analog[y][i].g],
-            pex[palette_line_analog[y][i].b], 0);
-      }
-      // set back color to black if cg screen is off in color mode
-      if (!disp_color_graph) {
-        palette_digital_text_pc[0] = palette_analog_text_pc[0] =
-            palette_digital_graph_pc[0] = palette_analog_graph_pc[0] = 0;
-      }
-      palette_analog_text_pc[8] = palette_digital_text_pc[0];
-      palette_analog_graph_pc[8] = palette_digital_graph_pc[0];
+void PC88::draw_screen_line(scrntype_t *dest, int y, const scrntype_t *pal_t,
+                            const scrntype_t *pal_g, bool line400,
+                            bool draw_scanline_black) {
+  const uint8_t *src_t = text[y >> 1];
+  const uint8_t *src_g = graph[y];
+
+  if (line400) {
+    for (int x = 0; x < 640; x++) {
+      uint32_t t = src_t[x];
+      dest[x] = t ? pal_t[t] : pal_g[src_g[x]];
     }
-    if (ymax == 200) {
-      for (int i = 0; i < 9; i++) {
-        palette_line_digital_text_pc[2 * y][i] =
-            palette_line_digital_text_pc[2 * y + 1][i] =
-                palette_digital_text_pc[i];
-        palette_line_analog_graph_pc[2 * y][i] =
-            palette_line_analog_graph_pc[2 * y + 1][i] =
-                palette_analog_graph_pc[i];
-#if defined(PC8801_VARIANT)
-        palette_line_analog_text_pc[2 * y][i] =
-            palette_line_analog_text_pc[2 * y + 1][i] =
-                palette_analog_text_pc[i];
-        palette_line_digital_graph_pc[2 * y][i] =
-            palette_line_digital_graph_pc[2 * y + 1][i] =
-                palette_digital_graph_pc[i];
+    return;
+  }
+#if defined(_PC8001SR)
+  if (Port33_PR2) {
+    for (int x = 0; x < 640; x++) {
+      uint32_t t = src_t[x];
+      uint32_t g = src_g[x];
+      dest[x] = (!g && t)                          ? pal_t[t]
+                : ((y & 1) && draw_scanline_black) ? 0
+                                                   : pal_g[g];
+    }
+    return;
+  }
 #endif
-      }
-    } else {
-      for (int i = 0; i < 9; i++) {
-        palette_line_digital_text_pc[y][i] = palette_digital_text_pc[i];
-        palette_line_analog_graph_pc[y][i] = palette_analog_graph_pc[i];
-#if defined(PC8801_VARIANT)
-        palette_line_analog_text_pc[y][i] = palette_analog_text_pc[i];
-        palette_line_digital_graph_pc[y][i] = palette_digital_graph_pc[i];
+  for (int x = 0; x < 640; x++) {
+    uint32_t t = src_t[x];
+    dest[x] = t                                  ? pal_t[t]
+              : ((y & 1) && draw_scanline_black) ? 0
+                                                 : pal_g[src_g[x]];
+  }
+}
+
+void PC88::get_screen_key(uint8_t *key) {
+  // ports and settings to select the renderers and the palettes
+  key[0] = port[0x31];
+  key[1] = port[0x32];
+  key[2] = port[0x33];
+  key[3] = port[0x53];
+  key[4] = config.scan_line ? 1 : 0;
+  key[5] = hireso ? 1 : 0;
+  key[6] = (uint8_t)config.boot_mode;
+  key[7] = (config.dipswitch & DIPSWITCH_PALETTE) ? 1 : 0;
+}
+
+void PC88::update_changed_lines() {
+  uint8_t key[8];
+  get_screen_key(key);
+
+  // the osd widens the locked range when the screen buffer is allocated again
+  if (memcmp(screen_key, key, sizeof(key)) != 0) {
+    memcpy(screen_key, key, sizeof(key));
+    redraw_screen = true;
+  }
+  for (int y = 0; y < 200; y++) {
+    update_changed_text_line(y, redraw_screen);
+#if defined(SUPPORT_PC88_GVRAM)
+    gvram_line_changed[y] = update_changed_gvram_line(y, 7, redraw_screen);
 #endif
+  }
+  // graph lines are set when they are rendered again
+  memset(graph_line_changed, redraw_screen ? 1 : 0, sizeof(graph_line_changed));
+}
+
+void PC88::update_changed_text_line(int y, bool redraw) {
+  if ((text_line_changed[y] = (redraw || memcmp(text_shadow[y], text[y], 640) != 0))) {
+    memcpy(text_shadow[y], text[y], 640);
+  }
+  if ((text_attrib_changed[y] = (redraw ||
+                                 memcmp(text_color_shadow[y], text_color[y], 80) != 0 ||
+                                 memcmp(text_reverse_shadow[y], text_reverse[y], sizeof(text_reverse[y])) != 0))) {
+    memcpy(text_color_shadow[y], text_color[y], 80);
+    memcpy(text_reverse_shadow[y], text_reverse[y], sizeof(text_reverse[y]));
+  }
+}
+
+#if defined(SUPPORT_PC88_GVRAM)
+bool PC88::update_changed_gvram_line(int y, int planes, bool redraw) {
+  // compare the planes, a line is converted again if any plane is changed
+  bool changed = redraw;
+  for (int i = 0; i < 3; i++) {
+    if (planes & (1 << i)) {
+      uint8_t *src = gvram + 0x4000 * i + y * 80;
+      if (changed || memcmp(gvram_shadow[i] + y * 80, src, 80) != 0) {
+        memcpy(gvram_shadow[i] + y * 80, src, 80);
+        changed = true;
       }
     }
-    if (y == 0 && (config.dipswitch & DIPSWITCH_PALETTE) != 0) {
-      break;
-    }
   }
+  return changed;
+}
+#endif
 
-  // copy to screen buffer
+void PC88::update_palette_line_pc(int v, bool disp_color_graph) {
+  static const uint32_t pex[8] = {
+      0, 36, 73, 109, 146, 182, 219, 255 // from m88
+  };
+  scrntype_t pal[4][9];
+
+  for (int i = 0; i < 9; i++) {
+    // A is a flag for crt filter
+    pal[0][i] = RGBA_COLOR(pex[palette_line_digital[v][i].r],
+                           pex[palette_line_digital[v][i].g],
+                           pex[palette_line_digital[v][i].b], 255);
+    pal[1][i] = RGBA_COLOR(pex[palette_line_analog[v][i].r],
+                           pex[palette_line_analog[v][i].g],
+                           pex[palette_line_analog[v][i].b], 255);
+    pal[2][i] = RGBA_COLOR(pex[palette_line_digital[v][i].r],
+                           pex[palette_line_digital[v][i].g],
+                           pex[palette_line_digital[v][i].b], 0);
+    pal[3][i] = RGBA_COLOR(pex[palette_line_analog[v][i].r],
+                           pex[palette_line_analog[v][i].g],
+                           pex[palette_line_analog[v][i].b], 0);
+  }
+  // set back color to black if cg screen is off in color mode
+  if (!disp_color_graph) {
+    pal[0][0] = pal[1][0] = pal[2][0] = pal[3][0] = 0;
+  }
+  pal[1][8] = pal[0][0];
+  pal[3][8] = pal[2][0];
+
+  if (memcmp(palette_line_pc[v], pal, sizeof(pal)) != 0) {
+    memcpy(palette_line_pc[v], pal, sizeof(pal));
+    palette_line_pc_id[v] = ++palette_pc_id;
+  }
+}
+
+bool PC88::is_screen_line_changed(int y, uint32_t palette_id, bool redraw) {
+  if (redraw || text_line_changed[y >> 1] || graph_line_changed[y] ||
+      screen_palette_id[y] != palette_id) {
+    screen_palette_id[y] = palette_id;
+    return true;
+  }
+  return false;
+}
+
+void PC88::start_vline_frame(int disp_line) {
+  vline_redraw = redraw_screen;
+  redraw_screen = false;
+  vline_next = 0;
+  vline_published = false;
 #if defined(PC8801_VARIANT)
-#if defined(SUPPORT_PC88_VAB)
-  // X88000
-  if (PortB4_VAB_DISP) {
-    uint8_t *src = &exram[(0x8000 * 4) * PC88_VAB_PAGE];
+  vline_max = (disp_line <= 200) ? 200 : 400;
+#else
+  vline_max = 200;
+#endif
 
-    for (int y = 0; y < 400; y += 2) {
-      scrntype_t *dest0 = emu->get_screen_buffer(y);
-      scrntype_t *dest1 = emu->get_screen_buffer(y + 1);
+  // character rows are drawn when the beam reaches them
+  vline_text_row = vline_text_ytop = vline_text_next = 0;
+  vline_text_char_height = get_text_char_height();
+  vline_text_enabled = (dmac.ch[3].count.sd != 0);
+  vline_text_blank = false;
+  memset(text, vline_text_enabled ? 8 : 0, sizeof(text));
+  memset(text_color, 7, sizeof(text_color));
+  memset(text_reverse, 0, sizeof(text_reverse));
+#if defined(_PC8001SR)
+  update_kana_pattern();
+#endif
+  vline_palette_src = 0;
+}
 
-      for (int x = 0; x < 640; x += 2) {
-        pair16_t c;
-        c.b.l = *src++;
-        c.b.h = *src++;
-        dest0[x] = dest0[x + 1] = palette_vab_pc[c.w];
-      }
-      if (config.scan_line) {
-        memset(dest1, 0, sizeof(scrntype_t) * 640);
-      } else {
-        memcpy(dest1, dest0, sizeof(scrntype_t) * 640);
-      }
+void PC88::draw_vline(int v) {
+  // screen lines and text line shown on this line
+  int top = (vline_max == 200) ? (v << 1) : v;
+  int bottom = (vline_max == 200) ? (top + 2) : (top + 1);
+  int t = top >> 1;
+
+  // the line is rendered again when the ports to select the renderers are changed
+  uint8_t key[8];
+  bool redraw = vline_redraw;
+
+  get_screen_key(key);
+  if (memcmp(vline_key[v], key, sizeof(key)) != 0) {
+    memcpy(vline_key[v], key, sizeof(key));
+    redraw = true;
+  }
+
+  // render text
+  while (vline_text_row < crtc.height && vline_text_ytop < 400 &&
+         (vline_text_ytop >> 1) <= t) {
+    draw_vline_text_row();
+  }
+  while (vline_text_next <= t) {
+    update_changed_text_line(vline_text_next++, redraw);
+  }
+
+  // render graph
+  bool line400 = is_400line_screen();
+#if defined(SUPPORT_PC88_GVRAM)
+  for (int y = top; y < bottom; y++) {
+    if (line400) {
+      // blue plane is shown on the upper half, and red plane on the lower half
+      gvram_line_changed[y % 200] = update_changed_gvram_line(y % 200, (y < 200) ? 1 : 2, redraw);
+    } else if (!(y & 1)) {
+      gvram_line_changed[y >> 1] = update_changed_gvram_line(y >> 1, 7, redraw);
     }
-    emu->screen_skip_line(true);
-  } else
+  }
 #endif
-      if (!Port31_HCOLOR && Port31_400LINE) {
-    for (int y = 0; y < 400; y++) {
-      scrntype_t *dest = emu->get_screen_buffer(y);
-      if (!dest) continue;
-      uint8_t *src_t = text[y >> 1];
-      uint8_t *src_g = graph[y];
-      scrntype_t *pal_t;
-      scrntype_t *pal_g;
-      int yy = ((config.dipswitch & DIPSWITCH_PALETTE) != 0) ? 0 : y;
-
-      //			if(Port31_HCOLOR) {
-      //				pal_t = palette_line_digital_text_pc
-      //[yy]; 				pal_g = palette_line_analog_graph_pc
-      //[yy]; 			} else
-      if (Port32_PMODE) {
-        pal_t = palette_line_analog_text_pc[yy];
-        pal_g = palette_line_analog_graph_pc[yy];
-      } else {
-        pal_t = palette_line_digital_text_pc[yy];
-        pal_g = palette_line_digital_graph_pc[yy];
+  memset(graph_line_changed + top, redraw ? 1 : 0, bottom - top);
+
+  bool disp_color_graph, draw_scanline_black;
+  vline_screen_lines = draw_graph(top, bottom, &disp_color_graph, &draw_scanline_black);
+
+  // update host palette, the last changed palette is used until it is changed again
+  if (palette_line_changed[v] &&
+      (v == 0 || (config.dipswitch & DIPSWITCH_PALETTE) == 0)) {
+    vline_palette_src = v;
+    vline_palette_color_graph = disp_color_graph;
+    update_palette_line_pc(v, disp_color_graph);
+  } else if (vline_palette_color_graph != disp_color_graph) {
+    vline_palette_color_graph = disp_color_graph;
+    update_palette_line_pc(vline_palette_src, disp_color_graph);
+  }
+  scrntype_t *pal_t, *pal_g;
+  uint32_t palette_id = palette_line_pc_id[vline_palette_src];
+
+  get_line_palettes(vline_palette_src, &pal_t, &pal_g);
+
+  // render screen lines changed since the last frame
+  for (int y = top; y < bottom; y++) {
+    if (is_screen_line_changed(y, palette_id, redraw)) {
+      draw_screen_line(vline_screen[y], y, pal_t, pal_g, line400, draw_scanline_black);
+      if (vline_dirty_top > y) {
+        vline_dirty_top = y;
       }
-      for (int x = 0; x < 640; x++) {
-        uint32_t t = src_t[x];
-        dest[x] = t ? pal_t[t] : pal_g[src_g[x]];
+      if (vline_dirty_bottom < y + 1) {
+        vline_dirty_bottom = y + 1;
       }
     }
-    emu->screen_skip_line(false);
-  } else
-#endif
-  {
-    for (int y = 0; y < 400; y++) {
-      scrntype_t *dest = emu->get_screen_buffer(y);
-      if (!dest) continue;
-      uint8_t *src_t = text[y >> 1];
-      uint8_t *src_g = graph[y];
-      scrntype_t *pal_t;
-      scrntype_t *pal_g;
-      int yy = ((config.dipswitch & DIPSWITCH_PALETTE) != 0) ? 0 : y;
+  }
+  vline_skip_line = !line400;
+}
 
-#if defined(PC8001_VARIANT)
-      pal_t = palette_line_digital_text_pc[yy];
-      pal_g = palette_line_analog_graph_pc[yy];
+void PC88::draw_vline_text_row() {
+  int cy = vline_text_row++;
+  int ytop = vline_text_ytop;
 
-#if defined(_PC8001SR)
-      if (Port33_PR2) {
-        for (int x = 0; x < 640; x++) {
-          uint32_t t = src_t[x];
-          uint32_t g = src_g[x];
-          dest[x] = (!g && t)                          ? pal_t[t]
-                    : ((y & 1) && draw_scanline_black) ? 0
-                                                       : pal_g[g];
-        }
-      } else
-#endif
-      {
-        for (int x = 0; x < 640; x++) {
-          uint32_t t = src_t[x];
-          dest[x] = t                                  ? pal_t[t]
-                    : ((y & 1) && draw_scanline_black) ? 0
-                                                       : pal_g[src_g[x]];
-        }
-      }
-#else
-      if (Port31_HCOLOR) {
-        pal_t = palette_line_digital_text_pc[yy];
-        pal_g = palette_line_analog_graph_pc[yy];
-      } else if (Port32_PMODE) {
-        pal_t = palette_line_analog_text_pc[yy];
-        pal_g = palette_line_analog_graph_pc[yy];
-      } else {
-        pal_t = palette_line_digital_text_pc[yy];
-        pal_g = palette_line_digital_graph_pc[yy];
-      }
-      for (int x = 0; x < 640; x++) {
-        uint32_t t = src_t[x];
-        dest[x] = t                                  ? pal_t[t]
-                  : ((y & 1) && draw_scanline_black) ? 0
-                                                     : pal_g[src_g[x]];
-      }
-#endif
+  vline_text_ytop += vline_text_char_height;
+  if (!vline_text_enabled) {
+    return;
+  }
+  crtc.expand_row(cy);
+
+  if ((crtc.status & 0x88) || vline_text_blank) {
+    // dma underrun
+    if (crtc.status & 0x80) {
+      crtc.status &= ~0x80;
+      vline_text_blank = true;
+    }
+    memset(crtc.text.expand[cy], 0, 80);
+    memset(crtc.attrib.expand[cy], crtc.reverse ? 3 : 2, 80);
+  }
+  // for Advanced Fantasian Opening (20line) (XM8 version 1.00)
+  if (!(crtc.status & 0x10) || Port53_TEXTDS) {
+    memset(crtc.text.expand[cy], 0, 80);
+    for (int x = 0; x < 80; x++) {
+      crtc.attrib.expand[cy][x] &= 0xe0;
+      crtc.attrib.expand[cy][x] |= 0x02;
+    }
+  }
+  draw_text_row(cy, ytop, vline_text_char_height);
+}
+
+void PC88::draw_vline_screen() {
+  // lines after the last vline event of the frame
+  if (!emu->now_waiting_in_debugger) {
+    while (vline_next < vline_max) {
+      draw_vline(vline_next++);
     }
-    emu->screen_skip_line(true);
   }
+  emu->set_vm_screen_lines(vline_screen_lines);
 
-  // restore port
-  memcpy(port, cur_port, 256);
+  // copy lines rendered since the last call, all lines in the range (it may
+  // be widened by osd) are written
+  invalidated_top = vline_dirty_top;
+  invalidated_bottom = vline_dirty_bottom;
+  emu->lock_screen_buffer(&invalidated_top, &invalidated_bottom);
+
+  for (int y = invalidated_top; y < invalidated_bottom; y++) {
+    scrntype_t *dest = emu->get_screen_buffer(y);
+    if (dest) {
+      memcpy(dest, vline_screen[y], sizeof(vline_screen[y]));
+    }
+  }
+  emu->screen_skip_line(vline_skip_line);
+  emu->unlock_screen_buffer();
+
+  vline_dirty_top = 400;
+  vline_dirty_bottom = 0;
+}
+
+bool PC88::get_invalidated_rect(int *left, int *top, int *right, int *bottom) {
+  // lines rendered by the last draw_screen()
+  *left = 0;
+  *right = 640;
+  *top = invalidated_top;
+  *bottom = invalidated_bottom;
+  return true;
 }
 
 /*
@@ -3481,10 +3877,20 @@ void PC88::draw_text() {
   }
   memset(text, 8, sizeof(text));
 
+  int char_height = get_text_char_height();
+#if defined(_PC8001SR)
+  update_kana_pattern();
+#endif
+  //	for(int cy = 0, ytop = 0; cy < 64 && ytop < 400; cy++, ytop +=
+  // char_height) {
+  for (int cy = 0, ytop = 0; cy < crtc.height && ytop < 400;
+       cy++, ytop += char_height) {
+    draw_text_row(cy, ytop, char_height);
+  }
+}
+
+int PC88::get_text_char_height() {
   int char_height = crtc.char_height;
-  uint8_t color_mask = Port30_COLOR ? 0 : 7;
-  uint8_t code_expand, attr_expand;
-  bool attrib_graph = false;
 
   if (!hireso) {
     char_height <<= 1;
@@ -3495,6 +3901,28 @@ void PC88::draw_text() {
   if (crtc.skip_line) {
     char_height <<= 1;
   }
+  return char_height;
+}
+
+#if defined(_PC8001SR)
+void PC88::update_kana_pattern() {
+  // select katakana or hiragana
+  uint8_t *src = Port33_HIRA ? hiragana : katakana;
+  uint8_t *dest = (config.option_switch & OPTION_SWITCH_PCG8100)
+                      ? (pcg_pattern + 0x500)
+                      : (kanji1 + 0x1500);
+  if (memcmp(dest, src, 0x200) != 0) {
+    memcpy(dest, src, 0x200);
+    invalidate_glyph_cache();
+  }
+}
+#endif
+
+void PC88::draw_text_row(int cy, int ytop, int char_height) {
+  uint8_t color_mask = Port30_COLOR ? 0 : 7;
+  uint8_t code_expand = 0, attr_expand = 0;
+  bool attrib_graph = false;
+
   if (Port31_GRAPH && !Port31_HCOLOR) {
 #if defined(PC8001_VARIANT)
     if (config.boot_mode != MODE_PC80_V2) {
@@ -3505,94 +3933,114 @@ void PC88::draw_text() {
 #endif
       attrib_graph = true;
   }
-#if defined(_PC8001SR)
-  // select katakana or hiragana
-  if (config.option_switch & OPTION_SWITCH_PCG8100) {
-    memcpy(pcg_pattern + 0x500, Port33_HIRA ? hiragana : katakana, 0x200);
-  } else {
-    memcpy(kanji1 + 0x1500, Port33_HIRA ? hiragana : katakana, 0x200);
-  }
-#endif
-  //	for(int cy = 0, ytop = 0; cy < 64 && ytop < 400; cy++, ytop +=
-  // char_height) {
-  for (int cy = 0, ytop = 0; cy < crtc.height && ytop < 400;
-       cy++, ytop += char_height) {
-    for (int x = 0, cx = 0; cx < crtc.width; x += 8, cx++) {
-      if (Port30_40 && (cx & 1)) {
-        // don't update code/attrib
-      } else {
-        code_expand = crtc.text.expand[cy][cx];
-        attr_expand = crtc.attrib.expand[cy][cx];
-      }
-      uint8_t attrib = attr_expand; // crtc.attrib.expand[cy][cx];
-      //			uint8_t color = !(Port30_COLOR && (attrib & 8))
-      //? 7 : (attrib & 0xe0) ? (attrib >> 5) : 8;
-      uint8_t color = (attrib & 0xe0) ? ((attrib >> 5) | color_mask) : 8;
-      bool under_line = ((attrib & 8) != 0);
-      bool upper_line = ((attrib & 4) != 0);
-      bool secret = ((attrib & 2) != 0);
-      bool reverse = ((attrib & 1) != 0);
-
-      uint8_t color_tmp = color;
-      bool reverse_tmp = reverse;
+  static const uint8_t pat_null[80] = {0};
+  static const bool reverse_null[80] = {0};
+  const uint8_t *glyph[80];
+  uint8_t glyph_color[80];
+  uint8_t line_color[80];
+  bool line_reverse[80];
 
-      // from ePC-8801MA改
-      //			if(Port31_GRAPH && !Port31_HCOLOR) {
-      if (attrib_graph) {
-        if (reverse) {
-          reverse = false;
-          color = 8;
-        }
+  for (int cx = 0; cx < crtc.width; cx++) {
+    if (Port30_40 && (cx & 1)) {
+      // don't update code/attrib
+    } else {
+      code_expand = crtc.text.expand[cy][cx];
+      attr_expand = crtc.attrib.expand[cy][cx];
+    }
+    uint8_t attrib = attr_expand; // crtc.attrib.expand[cy][cx];
+    //			uint8_t color = !(Port30_COLOR && (attrib & 8))
+    //? 7 : (attrib & 0xe0) ? (attrib >> 5) : 8;
+    uint8_t color = (attrib & 0xe0) ? ((attrib >> 5) | color_mask) : 8;
+    bool under_line = ((attrib & 8) != 0);
+    bool upper_line = ((attrib & 4) != 0);
+    bool secret = ((attrib & 2) != 0);
+    bool reverse = ((attrib & 1) != 0);
+
+    // store text attributes for monocolor graph screen
+    line_color[cx] = color;
+    line_reverse[cx] = reverse;
+
+    // from ePC-8801MA改
+    //			if(Port31_GRAPH && !Port31_HCOLOR) {
+    if (attrib_graph) {
+      if (reverse) {
+        reverse = false;
+        color = 8;
       }
-      uint8_t code = secret ? 0 : code_expand; // crtc.text.expand[cy][cx];
-      uint8_t *pattern;
+    }
+    uint8_t code = secret ? 0 : code_expand; // crtc.text.expand[cy][cx];
+    int half = Port30_40 ? ((cx & 1) ? 2 : 1) : 0;
+
+    glyph[cx] = get_glyph((attrib & 0x10) != 0, code, upper_line, under_line,
+                          reverse, half);
+    glyph_color[cx] = color;
+  }
+  for (int l = 0, y = ytop; l < char_height / 2 && y < 400; l++, y += 2) {
+    uint8_t pat[80];
+    int i = (l < 8) ? l : 8;
+
+    for (int cx = 0; cx < crtc.width; cx++) {
+      pat[cx] = glyph[cx][i];
+    }
+    bitplane->attrib(text[y >> 1], pat, pat_null, pat_null, glyph_color,
+                     reverse_null, crtc.width);
+    memcpy(text_color[y >> 1], line_color, crtc.width);
+    memcpy(text_reverse[y >> 1], line_reverse, sizeof(bool) * crtc.width);
+  }
+}
+
+void PC88::invalidate_glyph_cache() {
+  if (++glyph_generation == 0) {
+    memset(glyph_cache, 0, sizeof(glyph_cache));
+    glyph_generation = 1;
+  }
+}
+
+const uint8_t *PC88::get_glyph(bool graph, uint8_t code, bool upper_line,
+                               bool under_line, bool reverse, int half) {
+  int index = (graph ? 0x100 : 0) | code;
+  index = index * 8 + (upper_line ? 4 : 0) + (under_line ? 2 : 0) +
+          (reverse ? 1 : 0);
+  glyph_t *glyph = &glyph_cache[index * 3 + half];
+
+  if (glyph->generation != glyph_generation) {
+    uint8_t *pattern;
 #ifdef SUPPORT_PC88_PCG8100
-      if (config.option_switch & OPTION_SWITCH_PCG8100) {
-        pattern = ((attrib & 0x10) ? sg_pattern : pcg_pattern) + code * 8;
-      } else
+    if (config.option_switch & OPTION_SWITCH_PCG8100) {
+      pattern = (graph ? sg_pattern : pcg_pattern) + code * 8;
+    } else
 #endif
-        pattern = ((attrib & 0x10) ? sg_pattern : kanji1 + 0x1000) + code * 8;
+      pattern = (graph ? sg_pattern : kanji1 + 0x1000) + code * 8;
 
-      for (int l = 0, y = ytop; l < char_height / 2 && y < 400; l++, y += 2) {
-        uint8_t pat = (l < 8) ? pattern[l] : 0;
+    for (int l = 0; l < 9; l++) {
+      uint8_t pat = (l < 8) ? pattern[l] : 0;
 
-        if (Port30_40) {
-          // from ePC-8801MA改
-          static const uint8_t wct[16] = {0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33,
-                                          0x3c, 0x3f, 0xc0, 0xc3, 0xcc, 0xcf,
-                                          0xf0, 0xf3, 0xfc, 0xff};
-          pat = wct[(cx & 1) ? (pat & 0x0f) : (pat >> 4)];
-        }
-        if ((upper_line && l == 0) || (under_line && l >= 7)) {
-          pat = 0xff;
-        }
-        if (reverse) {
-          pat ^= 0xff;
-        }
-        uint8_t *dest = &text[y >> 1][x];
-        dest[0] = (pat & 0x80) ? color : 0;
-        dest[1] = (pat & 0x40) ? color : 0;
-        dest[2] = (pat & 0x20) ? color : 0;
-        dest[3] = (pat & 0x10) ? color : 0;
-        dest[4] = (pat & 0x08) ? color : 0;
-        dest[5] = (pat & 0x04) ? color : 0;
-        dest[6] = (pat & 0x02) ? color : 0;
-        dest[7] = (pat & 0x01) ? color : 0;
-
-        // store text attributes for monocolor graph screen
-        text_color[y >> 1][cx] = color_tmp;
-        text_reverse[y >> 1][cx] = reverse_tmp;
+      if (half) {
+        // from ePC-8801MA改
+        static const uint8_t wct[16] = {0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33,
+                                        0x3c, 0x3f, 0xc0, 0xc3, 0xcc, 0xcf,
+                                        0xf0, 0xf3, 0xfc, 0xff};
+        pat = wct[(half == 2) ? (pat & 0x0f) : (pat >> 4)];
+      }
+      if ((upper_line && l == 0) || (under_line && l >= 7)) {
+        pat = 0xff;
       }
+      if (reverse) {
+        pat ^= 0xff;
+      }
+      glyph->pat[l] = pat;
     }
+    glyph->generation = glyph_generation;
   }
+  return glyph->pat;
 }
 
 #if defined(SUPPORT_PC88_GVRAM)
 #if defined(PC8001_VARIANT)
 #if defined(_PC8001SR)
-bool PC88::draw_320x200_color_graph() {
+bool PC88::draw_320x200_color_graph(int top, int bottom) {
   if (!Port31_GRAPH || (Port53_G0DS && Port53_G1DS)) {
-    memset(graph, 0, sizeof(graph));
+    memset(graph[top], 0, sizeof(graph[0]) * (bottom - top));
     return false;
   }
   uint8_t *gvram_b0 = Port53_G0DS ? gvram_null : (gvram + 0x0000);
@@ -3616,7 +4064,8 @@ bool PC88::draw_320x200_color_graph() {
     gvram_g1 = tmp;
   }
 
-  for (int y = 0, addr = 0; y < 400; y += 2) {
+  for (int y = top & ~1; y < bottom; y += 2) {
+    int addr = (y >> 1) * 40;
     for (int x = 0; x < 640; x += 16) {
       uint8_t b0 = gvram_b0[addr];
       uint8_t r0 = gvram_r0[addr];
@@ -3662,16 +4111,17 @@ bool PC88::draw_320x200_color_graph() {
 }
 #endif
 
-bool PC88::draw_320x200_4color_graph() {
+bool PC88::draw_320x200_4color_graph(int top, int bottom) {
   if (!Port31_GRAPH || (Port53_G0DS && Port53_G1DS && Port53_G2DS)) {
-    memset(graph, 0, sizeof(graph));
+    memset(graph[top], 0, sizeof(graph[0]) * (bottom - top));
     return false;
   }
   uint8_t *gvram_b = Port53_G0DS ? gvram_null : (gvram + 0x0000);
   uint8_t *gvram_r = Port53_G1DS ? gvram_null : (gvram + 0x4000);
   uint8_t *gvram_g = Port53_G2DS ? gvram_null : (gvram + 0x8000);
 
-  for (int y = 0, addr = 0; y < 400; y += 2) {
+  for (int y = top & ~1; y < bottom; y += 2) {
+    int addr = (y >> 1) * 80;
     for (int x = 0; x < 640; x += 8) {
       uint8_t brg = gvram_b[addr] | gvram_r[addr] | gvram_g[addr];
       addr++;
@@ -3690,10 +4140,10 @@ bool PC88::draw_320x200_4color_graph() {
   return true;
 }
 
-void PC88::draw_320x200_attrib_graph() {
+void PC88::draw_320x200_attrib_graph(int top, int bottom) {
   if (!Port31_GRAPH || (Port53_G0DS && Port53_G1DS && Port53_G2DS &&
                         Port53_G3DS && Port53_G4DS && Port53_G5DS)) {
-    memset(graph, 0, sizeof(graph));
+    memset(graph[top], 0, sizeof(graph[0]) * (bottom - top));
     return;
   }
   uint8_t *gvram_b0 = Port53_G0DS ? gvram_null : (gvram + 0x0000);
@@ -3704,7 +4154,8 @@ void PC88::draw_320x200_attrib_graph() {
   uint8_t *gvram_g1 = Port53_G5DS ? gvram_null : (gvram + 0xa000);
 
   if (Port30_40) {
-    for (int y = 0, addr = 0; y < 400; y += 2) {
+    for (int y = top & ~1; y < bottom; y += 2) {
+      int addr = (y >> 1) * 40;
       for (int x = 0, cx = 0; x < 640; x += 16, cx += 2) {
         uint8_t color = text_color[y >> 1][cx];
         uint8_t brg0 = gvram_b0[addr] | gvram_r0[addr] | gvram_g0[addr] |
@@ -3745,7 +4196,8 @@ void PC88::draw_320x200_attrib_graph() {
       }
     }
   } else {
-    for (int y = 0, addr = 0; y < 400; y += 2) {
+    for (int y = top & ~1; y < bottom; y += 2) {
+      int addr = (y >> 1) * 40;
       for (int x = 0, cx = 0; x < 640; x += 16, cx += 2) {
         uint8_t color_l = text_color[y >> 1][cx + 0];
         uint8_t color_r = text_color[y >> 1][cx + 1];
@@ -3794,35 +4246,27 @@ void PC88::draw_320x200_attrib_graph() {
 }
 #endif
 
-bool PC88::draw_640x200_color_graph() {
+bool PC88::draw_640x200_color_graph(int top, int bottom) {
 #if defined(_PC8001SR)
   if (!Port31_GRAPH || Port53_G0DS) {
 #else
   if (!Port31_GRAPH /* || (Port53_G0DS && Port53_G1DS && Port53_G2DS)*/) {
 #endif
-    memset(graph, 0, sizeof(graph));
+    memset(graph[top], 0, sizeof(graph[0]) * (bottom - top));
     return false;
   }
   uint8_t *gvram_b = /*Port53_G0DS ? gvram_null : */ (gvram + 0x0000);
   uint8_t *gvram_r = /*Port53_G1DS ? gvram_null : */ (gvram + 0x4000);
   uint8_t *gvram_g = /*Port53_G2DS ? gvram_null : */ (gvram + 0x8000);
 
-  for (int y = 0, addr = 0; y < 400; y += 2) {
-    for (int x = 0; x < 640; x += 8) {
-      uint8_t b = gvram_b[addr];
-      uint8_t r = gvram_r[addr];
-      uint8_t g = gvram_g[addr];
-      addr++;
-      uint8_t *dest = &graph[y][x];
-      dest[0] = ((b & 0x80) >> 7) | ((r & 0x80) >> 6) | ((g & 0x80) >> 5);
-      dest[1] = ((b & 0x40) >> 6) | ((r & 0x40) >> 5) | ((g & 0x40) >> 4);
-      dest[2] = ((b & 0x20) >> 5) | ((r & 0x20) >> 4) | ((g & 0x20) >> 3);
-      dest[3] = ((b & 0x10) >> 4) | ((r & 0x10) >> 3) | ((g & 0x10) >> 2);
-      dest[4] = ((b & 0x08) >> 3) | ((r & 0x08) >> 2) | ((g & 0x08) >> 1);
-      dest[5] = ((b & 0x04) >> 2) | ((r & 0x04) >> 1) | ((g & 0x04));
-      dest[6] = ((b & 0x02) >> 1) | ((r & 0x02)) | ((g & 0x02) << 1);
-      dest[7] = ((b & 0x01)) | ((r & 0x01) << 1) | ((g & 0x01) << 2);
+  for (int y = top & ~1, addr = (top >> 1) * 80; y < bottom; y += 2) {
+    if (!gvram_line_changed[y >> 1]) {
+      addr += 80;
+      continue;
     }
+    graph_line_changed[y] = graph_line_changed[y + 1] = true;
+    bitplane->color(graph[y], gvram_b + addr, gvram_r + addr, gvram_g + addr, 80);
+    addr += 80;
     if (config.scan_line) {
       memset(graph[y + 1], 0, 640);
     } else {
@@ -3832,29 +4276,23 @@ bool PC88::draw_640x200_color_graph() {
   return true;
 }
 
-void PC88::draw_640x200_mono_graph() {
+void PC88::draw_640x200_mono_graph(int top, int bottom) {
   if (!Port31_GRAPH || (Port53_G0DS && Port53_G1DS && Port53_G2DS)) {
-    memset(graph, 0, sizeof(graph));
+    memset(graph[top], 0, sizeof(graph[0]) * (bottom - top));
     return;
   }
   uint8_t *gvram_b = Port53_G0DS ? gvram_null : (gvram + 0x0000);
   uint8_t *gvram_r = Port53_G1DS ? gvram_null : (gvram + 0x4000);
   uint8_t *gvram_g = Port53_G2DS ? gvram_null : (gvram + 0x8000);
 
-  for (int y = 0, addr = 0; y < 400; y += 2) {
-    for (int x = 0; x < 640; x += 8) {
-      uint8_t brg = gvram_b[addr] | gvram_r[addr] | gvram_g[addr];
-      addr++;
-      uint8_t *dest = &graph[y][x];
-      dest[0] = (brg & 0x80) >> 7;
-      dest[1] = (brg & 0x40) >> 6;
-      dest[2] = (brg & 0x20) >> 5;
-      dest[3] = (brg & 0x10) >> 4;
-      dest[4] = (brg & 0x08) >> 3;
-      dest[5] = (brg & 0x04) >> 2;
-      dest[6] = (brg & 0x02) >> 1;
-      dest[7] = (brg & 0x01);
+  for (int y = top & ~1, addr = (top >> 1) * 80; y < bottom; y += 2) {
+    if (!gvram_line_changed[y >> 1]) {
+      addr += 80;
+      continue;
     }
+    graph_line_changed[y] = graph_line_changed[y + 1] = true;
+    bitplane->mono(graph[y], gvram_b + addr, gvram_r + addr, gvram_g + addr, 80);
+    addr += 80;
     if (config.scan_line) {
       memset(graph[y + 1], 0, 640);
     } else {
@@ -3863,142 +4301,86 @@ void PC88::draw_640x200_mono_graph() {
   }
 }
 
-void PC88::draw_640x200_attrib_graph() {
+void PC88::draw_640x200_attrib_graph(int top, int bottom) {
   if (!Port31_GRAPH || (Port53_G0DS && Port53_G1DS && Port53_G2DS)) {
-    memset(graph, 0, sizeof(graph));
+    memset(graph[top], 0, sizeof(graph[0]) * (bottom - top));
     return;
   }
   uint8_t *gvram_b = Port53_G0DS ? gvram_null : (gvram + 0x0000);
   uint8_t *gvram_r = Port53_G1DS ? gvram_null : (gvram + 0x4000);
   uint8_t *gvram_g = Port53_G2DS ? gvram_null : (gvram + 0x8000);
 
-  for (int y = 0, addr = 0; y < 400; y += 2) {
-    for (int x = 0, cx = 0; x < 640; x += 8, cx++) {
-      uint8_t color = text_color[y >> 1][cx];
-      uint8_t brg0 = gvram_b[addr] | gvram_r[addr] | gvram_g[addr];
-      uint8_t brg1 = config.scan_line ? 0 : brg0;
-      if (text_reverse[y >> 1][cx]) {
-        brg0 ^= 0xff;
-        brg1 ^= 0xff;
-      }
-      addr++;
-      uint8_t *dest0 = &graph[y][x];
-      uint8_t *dest1 = &graph[y + 1][x];
-      dest0[0] = (brg0 & 0x80) ? color : 0;
-      dest0[1] = (brg0 & 0x40) ? color : 0;
-      dest0[2] = (brg0 & 0x20) ? color : 0;
-      dest0[3] = (brg0 & 0x10) ? color : 0;
-      dest0[4] = (brg0 & 0x08) ? color : 0;
-      dest0[5] = (brg0 & 0x04) ? color : 0;
-      dest0[6] = (brg0 & 0x02) ? color : 0;
-      dest0[7] = (brg0 & 0x01) ? color : 0;
-      if (!hireso)
-        continue;
-      dest1[0] = (brg1 & 0x80) ? color : 0;
-      dest1[1] = (brg1 & 0x40) ? color : 0;
-      dest1[2] = (brg1 & 0x20) ? color : 0;
-      dest1[3] = (brg1 & 0x10) ? color : 0;
-      dest1[4] = (brg1 & 0x08) ? color : 0;
-      dest1[5] = (brg1 & 0x04) ? color : 0;
-      dest1[6] = (brg1 & 0x02) ? color : 0;
-      dest1[7] = (brg1 & 0x01) ? color : 0;
-    }
-    if (!hireso) {
-      if (config.scan_line) {
-        memset(graph[y + 1], 0, 640);
+  for (int y = top & ~1, addr = (top >> 1) * 80; y < bottom; y += 2) {
+    if (!gvram_line_changed[y >> 1] && !text_attrib_changed[y >> 1]) {
+      addr += 80;
+      continue;
+    }
+    graph_line_changed[y] = graph_line_changed[y + 1] = true;
+    bitplane->attrib(graph[y], gvram_b + addr, gvram_r + addr, gvram_g + addr,
+                     text_color[y >> 1], text_reverse[y >> 1], 80);
+    addr += 80;
+    if (config.scan_line) {
+      if (hireso) {
+        // only reversed characters are shown on the scan line
+        bitplane->attrib(graph[y + 1], gvram_null, gvram_null, gvram_null,
+                         text_color[y >> 1], text_reverse[y >> 1], 80);
       } else {
-        memcpy(graph[y + 1], graph[y], 640);
+        memset(graph[y + 1], 0, 640);
       }
+    } else {
+      memcpy(graph[y + 1], graph[y], 640);
     }
   }
 }
 
 #if defined(PC8801_VARIANT)
-void PC88::draw_640x400_mono_graph() {
+void PC88::draw_640x400_mono_graph(int top, int bottom) {
   if (!Port31_GRAPH || (Port53_G0DS && Port53_G1DS)) {
-    memset(graph, 0, sizeof(graph));
+    memset(graph[top], 0, sizeof(graph[0]) * (bottom - top));
     return;
   }
   uint8_t *gvram_b = Port53_G0DS ? gvram_null : (gvram + 0x0000);
   uint8_t *gvram_r = Port53_G1DS ? gvram_null : (gvram + 0x4000);
 
-  for (int y = 0, addr = 0; y < 200; y++) {
-    for (int x = 0; x < 640; x += 8) {
-      uint8_t b = gvram_b[addr];
-      addr++;
-      uint8_t *dest = &graph[y][x];
-      dest[0] = (b & 0x80) >> 7;
-      dest[1] = (b & 0x40) >> 6;
-      dest[2] = (b & 0x20) >> 5;
-      dest[3] = (b & 0x10) >> 4;
-      dest[4] = (b & 0x08) >> 3;
-      dest[5] = (b & 0x04) >> 2;
-      dest[6] = (b & 0x02) >> 1;
-      dest[7] = (b & 0x01);
+  for (int y = top, addr = top * 80; y < min(bottom, 200); y++, addr += 80) {
+    if (!gvram_line_changed[y]) {
+      continue;
     }
+    graph_line_changed[y] = true;
+    bitplane->mono(graph[y], gvram_b + addr, gvram_null, gvram_null, 80);
   }
-  for (int y = 200, addr = 0; y < 400; y++) {
-    for (int x = 0; x < 640; x += 8) {
-      uint8_t r = gvram_r[addr];
-      addr++;
-      uint8_t *dest = &graph[y][x];
-      dest[0] = (r & 0x80) >> 7;
-      dest[1] = (r & 0x40) >> 6;
-      dest[2] = (r & 0x20) >> 5;
-      dest[3] = (r & 0x10) >> 4;
-      dest[4] = (r & 0x08) >> 3;
-      dest[5] = (r & 0x04) >> 2;
-      dest[6] = (r & 0x02) >> 1;
-      dest[7] = (r & 0x01);
+  for (int y = max(top, 200), addr = (y - 200) * 80; y < bottom; y++, addr += 80) {
+    if (!gvram_line_changed[y - 200]) {
+      continue;
     }
+    graph_line_changed[y] = true;
+    bitplane->mono(graph[y], gvram_r + addr, gvram_null, gvram_null, 80);
   }
 }
 
-void PC88::draw_640x400_attrib_graph() {
+void PC88::draw_640x400_attrib_graph(int top, int bottom) {
   if (!Port31_GRAPH || (Port53_G0DS && Port53_G1DS)) {
-    memset(graph, 0, sizeof(graph));
+    memset(graph[top], 0, sizeof(graph[0]) * (bottom - top));
     return;
   }
   uint8_t *gvram_b = Port53_G0DS ? gvram_null : (gvram + 0x0000);
   uint8_t *gvram_r = Port53_G1DS ? gvram_null : (gvram + 0x4000);
 
-  for (int y = 0, addr = 0; y < 200; y++) {
-    for (int x = 0, cx = 0; x < 640; x += 8, cx++) {
-      uint8_t color = text_color[y >> 1][cx];
-      uint8_t b = gvram_b[addr];
-      if (text_reverse[y >> 1][cx]) {
-        b ^= 0xff;
-      }
-      addr++;
-      uint8_t *dest = &graph[y][x];
-      dest[0] = (b & 0x80) ? color : 0;
-      dest[1] = (b & 0x40) ? color : 0;
-      dest[2] = (b & 0x20) ? color : 0;
-      dest[3] = (b & 0x10) ? color : 0;
-      dest[4] = (b & 0x08) ? color : 0;
-      dest[5] = (b & 0x04) ? color : 0;
-      dest[6] = (b & 0x02) ? color : 0;
-      dest[7] = (b & 0x01) ? color : 0;
-    }
-  }
-  for (int y = 200, addr = 0; y < 400; y++) {
-    for (int x = 0, cx = 0; x < 640; x += 8, cx++) {
-      uint8_t color = text_color[y >> 1][cx];
-      uint8_t r = gvram_r[addr];
-      if (text_reverse[y >> 1][cx]) {
-        r ^= 0xff;
-      }
-      addr++;
-      uint8_t *dest = &graph[y][x];
-      dest[0] = (r & 0x80) ? color : 0;
-      dest[1] = (r & 0x40) ? color : 0;
-      dest[2] = (r & 0x20) ? color : 0;
-      dest[3] = (r & 0x10) ? color : 0;
-      dest[4] = (r & 0x08) ? color : 0;
-      dest[5] = (r & 0x04) ? color : 0;
-      dest[6] = (r & 0x02) ? color : 0;
-      dest[7] = (r & 0x01) ? color : 0;
+  for (int y = top, addr = top * 80; y < min(bottom, 200); y++, addr += 80) {
+    if (!gvram_line_changed[y] && !text_attrib_changed[y >> 1]) {
+      continue;
+    }
+    graph_line_changed[y] = true;
+    bitplane->attrib(graph[y], gvram_b + addr, gvram_null, gvram_null,
+                     text_color[y >> 1], text_reverse[y >> 1], 80);
+  }
+  for (int y = max(top, 200), addr = (y - 200) * 80; y < bottom; y++, addr += 80) {
+    if (!gvram_line_changed[y - 200] && !text_attrib_changed[y >> 1]) {
+      continue;
     }
+    graph_line_changed[y] = true;
+    bitplane->attrib(graph[y], gvram_r + addr, gvram_null, gvram_null,
+                     text_color[y >> 1], text_reverse[y >> 1], 80);
   }
 }
 #endif
@@ -4309,6 +4691,58 @@ underrun:
   }
 }
 
+void pc88_crtc_t::expand_row(int cy) {
+  // expand one row for the line renderer, the buffer is read without flagging
+  // underruns because the row may not be transferred yet
+  int ofs = cy * (80 + attrib.num * 2);
+
+  if (cy == 0) {
+    attrib.data = 0xe0 | reverse; // Misty Blue
+  }
+  if (!(status & 0x10) || ofs + 80 + attrib.num * 2 > buffer_ptr) {
+    memset(&text.expand[cy][0], 0, width);
+    memset(&attrib.expand[cy][0], 0xe0, width); // color=7
+    return;
+  }
+  for (int cx = 0; cx < width; cx++) {
+    text.expand[cy][cx] = buffer[ofs + cx];
+  }
+  if (mode & 4) {
+    // non transparent
+    for (int cx = 0; cx < width; cx += 2) {
+      set_attrib(buffer[ofs + cx + 1]);
+      attrib.expand[cy][cx] = attrib.expand[cy][cx + 1] = attrib.data;
+    }
+  } else if (mode & 1) {
+    // transparent
+    memset(&attrib.expand[cy][0], 0xe0, 80);
+  } else {
+    // transparent
+    uint8_t flags[128];
+    memset(flags, 0, sizeof(flags));
+    for (int i = 2 * (attrib.num - 1); i >= 0; i -= 2) {
+      flags[buffer[ofs + i + 80] & 0x7f] = 1;
+    }
+    attrib.data &= 0xf3; // for PC-8801mkIIFR 付属デモ
+
+    for (int cx = 0, pos = 0; cx < width; cx++) {
+      if (flags[cx]) {
+        set_attrib(buffer[ofs + pos + 81]);
+        pos += 2;
+      }
+      attrib.expand[cy][cx] = attrib.data;
+    }
+  }
+  if (cursor.y == cy && cursor.x < 80) {
+    if ((cursor.type & 1) && blink.cursor) {
+      // no cursor
+    } else {
+      static const uint8_t ctype[5] = {0, 8, 8, 1, 1};
+      attrib.expand[cy][cursor.x] ^= ctype[cursor.type + 1];
+    }
+  }
+}
+
 void pc88_crtc_t::set_attrib(uint8_t code) {
   if (mode & 2) {
     // color mode
@@ -4673,6 +5107,9 @@ bool PC88::process_state(FILEIO *state_fio, bool loading) {
   state_fio->StateValue(pcg_data);
   state_fio->StateValue(pcg_ctrl);
   state_fio->StateArray(pcg_pattern, sizeof(pcg_pattern), 1);
+  if (loading) {
+    invalidate_glyph_cache();
+  }
 #endif
 #ifdef SUPPORT_PC88_CDROM
   state_fio->StateValue(cdda_register_id);
@@ -4698,8 +5135,9 @@ bool PC88::process_state(FILEIO *state_fio, bool loading) {
     update_tvram_memmap();
 #endif
 #endif
-    // force update palette when state file is loaded
+    // force update palette and screen when state file is loaded
     update_palette = true;
+    redraw_screen = true;
   }
   return true;
 }
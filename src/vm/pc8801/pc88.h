@@ -19,6 +19,7 @@
 #include "../vm.h"
 #include "../../emu.h"
 #include "../device.h"
+#include "bitplane.h"
 
 #define SIG_PC88_USART_IRQ	0
 #ifdef SUPPORT_PC88_OPN1
@@ -105,6 +106,7 @@ typedef struct {
 	uint8_t read_buffer(int ofs);
 	void update_blink();
 	void expand_buffer(bool hireso, bool line400);
+	void expand_row(int cy);
 	void set_attrib(uint8_t code);
 } pc88_crtc_t;
 
@@ -169,6 +171,7 @@ private:
 	uint8_t* wbank[16];
 	uint8_t wdmy[0x1000];
 	uint8_t rdmy[0x1000];
+	mem_page_t mem_pages[16];
 	
 	uint8_t ram[0x10000];
 #if defined(PC88_EXRAM_BANKS)
@@ -244,6 +247,7 @@ private:
 #if defined(PC8801SR_VARIANT)
 	int get_tvram_wait(bool read);
 #endif
+	void update_mem_pages();
 #if defined(SUPPORT_PC88_GVRAM)
 	int get_gvram_wait(bool read);
 	void update_gvram_wait();
@@ -252,6 +256,7 @@ private:
 #if defined(PC8001_VARIANT)
 	void update_n80_write();
 	void update_n80_read();
+	void update_n80_read_sub();
 #else
 	void update_low_write();
 	void update_low_write_sub();
@@ -302,21 +307,90 @@ private:
 	scrntype_t palette_vab_pc[0x10000];
 #endif
 	
+	// lines changed since the previous frame, clean lines are not rendered again
+	uint8_t screen_key[8];
+	bool redraw_screen;
+	uint8_t text_shadow[200][640];
+	uint8_t text_color_shadow[200][80];
+	bool text_reverse_shadow[200][80];
+	bool text_line_changed[200];
+	bool text_attrib_changed[200];
+#if defined(SUPPORT_PC88_GVRAM)
+	uint8_t gvram_shadow[3][200 * 80];
+	bool gvram_line_changed[200];
+#endif
+	bool graph_line_changed[400];
+	const bitplane_t *bitplane;
+	int invalidated_top, invalidated_bottom;
+	
+	// host palettes of lines where the palette is changed, the id is renewed when the colors are changed
+	scrntype_t palette_line_pc[400][4][9]; // digital text, analog text, digital graph, analog graph
+	uint32_t palette_line_pc_id[400];
+	uint32_t palette_pc_id;
+	uint32_t screen_palette_id[400];
+	
+	// character patterns with line attributes for draw_text(), the cache is invalidated when fonts are changed
+	typedef struct glyph_s {
+		uint32_t generation;
+		uint8_t pat[9]; // 8 = following lines
+	} glyph_t;
+	glyph_t glyph_cache[2 * 256 * 8 * 3]; // graph/text, code, upper/under/reverse, 80/40 left/40 right
+	uint32_t glyph_generation;
+	
+	// lines rendered by event_vline() as the beam passes them, draw_screen() only copies the changed lines
+	bool vline_rendering;
+	bool vline_redraw;
+	bool vline_published;
+	int vline_next, vline_max;
+	int vline_text_row, vline_text_ytop, vline_text_char_height, vline_text_next;
+	bool vline_text_enabled, vline_text_blank;
+	int vline_palette_src;
+	bool vline_palette_color_graph;
+	int vline_dirty_top, vline_dirty_bottom;
+	int vline_screen_lines;
+	bool vline_skip_line;
+	uint8_t vline_key[400][8];
+	scrntype_t vline_screen[400][640];
+	
+	void start_vline_frame(int disp_line);
+	void draw_vline(int v);
+	void draw_vline_text_row();
+	void draw_vline_screen();
+	
+	void update_palette_line_pc(int v, bool disp_color_graph);
+	void get_screen_key(uint8_t *key);
+	void update_changed_lines();
+	void update_changed_text_line(int y, bool redraw);
+#if defined(SUPPORT_PC88_GVRAM)
+	bool update_changed_gvram_line(int y, int planes, bool redraw);
+#endif
+	bool is_screen_line_changed(int y, uint32_t palette_id, bool redraw);
+	int draw_graph(int top, int bottom, bool *disp_color_graph, bool *draw_scanline_black);
+	bool is_400line_screen();
+	void get_line_palettes(int v, scrntype_t **pal_t, scrntype_t **pal_g);
+	void draw_screen_line(scrntype_t *dest, int y, const scrntype_t *pal_t, const scrntype_t *pal_g, bool line400, bool draw_scanline_black);
+	void invalidate_glyph_cache();
+	const uint8_t *get_glyph(bool graph, uint8_t code, bool upper_line, bool under_line, bool reverse, int half);
 	void draw_text();
+	int get_text_char_height();
+#if defined(_PC8001SR)
+	void update_kana_pattern();
+#endif
+	void draw_text_row(int cy, int ytop, int char_height);
 #if defined(SUPPORT_PC88_GVRAM)
 #if defined(PC8001_VARIANT)
 #if defined(_PC8001SR)
-	bool draw_320x200_color_graph();
+	bool draw_320x200_color_graph(int top, int bottom);
 #endif
-	bool draw_320x200_4color_graph();
-	void draw_320x200_attrib_graph();
+	bool draw_320x200_4color_graph(int top, int bottom);
+	void draw_320x200_attrib_graph(int top, int bottom);
 #endif
-	bool draw_640x200_color_graph();
-	void draw_640x200_mono_graph();
-	void draw_640x200_attrib_graph();
+	bool draw_640x200_color_graph(int top, int bottom);
+	void draw_640x200_mono_graph(int top, int bottom);
+	void draw_640x200_attrib_graph(int top, int bottom);
 #if defined(PC8801_VARIANT)
-	void draw_640x400_mono_graph();
-	void draw_640x400_attrib_graph();
+	void draw_640x400_mono_graph(int top, int bottom);
+	void draw_640x400_attrib_graph(int top, int bottom);
 #endif
 #endif
 	
@@ -485,6 +559,7 @@ public:
 	int get_exram_banks() const { return PC88_EXRAM_BANKS; }
 #endif
 	bool is_cpu_clock_low() const { return cpu_clock_low; }
+	const mem_page_t* get_mem_pages() const { return mem_pages; }
 
 	void set_context_cpu(Z80* device)
 	{
@@ -622,6 +697,7 @@ public:
 	bool is_frame_skippable();
 	
 	void draw_screen();
+	bool get_invalidated_rect(int *left, int *top, int *right, int *bottom);
 };
 
 #endif
@@ -524,6 +524,7 @@ VM::VM(EMU* parent_emu) : VM_TEMPLATE(parent_emu)
 	}
 #endif
 	pc88cpu->set_context_mem(pc88);
+	pc88cpu->set_context_mem_pages(pc88->get_mem_pages());
 	pc88cpu->set_context_io(pc88);
 	pc88cpu->set_context_intr(pc88);
 #ifdef USE_DEBUGGER
@@ -750,59 +751,78 @@ void VM::draw_screen()
 	pc88->draw_screen();
 }
 
+bool VM::get_invalidated_rect(int *left, int *top, int *right, int *bottom)
+{
+	return pc88->get_invalidated_rect(left, top, right, bottom);
+}
+
 // ----------------------------------------------------------------------------
 // soud manager
 // ----------------------------------------------------------------------------
 
+// with the resampler the sound devices mix at the native rate, and the event
+// manager converts their sound to the host rate
+static int get_sound_mix_rate(int rate)
+{
+	return config.sound_resampler ? SOUND_NATIVE_RATE : rate;
+}
+
 void VM::initialize_sound(int rate, int samples)
 {
+	int mix_rate = get_sound_mix_rate(rate);
+	
 	// init sound manager
-	pc88event->initialize_sound(rate, samples);
+	pc88event->initialize_sound(rate, samples, mix_rate);
 	
 	// init sound gen
-	pc88pcm->initialize_sound(rate, 8000);
+	pc88pcm->initialize_sound(mix_rate, 8000);
 #ifdef SUPPORT_PC88_OPN1
 	if(pc88opn1 != NULL) {
 		if(pc88opn1->is_ym2608) {
-			pc88opn1->initialize_sound(rate, 7987248, samples, 0, 0);
+			pc88opn1->initialize_sound(mix_rate, 7987248, samples, 0, 0);
 		} else {
-			pc88opn1->initialize_sound(rate, 3993624, samples, 0, 0);
+			pc88opn1->initialize_sound(mix_rate, 3993624, samples, 0, 0);
 		}
 	}
 #endif
 #ifdef SUPPORT_PC88_OPN2
 	if(pc88opn2 != NULL) {
 		if(pc88opn2->is_ym2608) {
-			pc88opn2->initialize_sound(rate, 7987248, samples, 0, 0);
+			pc88opn2->initialize_sound(mix_rate, 7987248, samples, 0, 0);
 		} else {
-			pc88opn2->initialize_sound(rate, 3993624, samples, 0, 0);
+			pc88opn2->initialize_sound(mix_rate, 3993624, samples, 0, 0);
 		}
 	}
 #endif
 #ifdef SUPPORT_PC88_HMB20
 	if(config.option_switch & OPTION_SWITCH_HMB20) {
-		pc88opm->initialize_sound(rate, 4000000, samples, 0);
+		pc88opm->initialize_sound(mix_rate, 4000000, samples, 0);
 	}
 #endif
 #ifdef SUPPORT_PC88_GSX8800
 	if(config.option_switch & OPTION_SWITCH_GSX8800) {
-		pc88gsx_psg1->initialize_sound(rate, 3993624, samples, 0, 0);
-		pc88gsx_psg2->initialize_sound(rate, 3993624, samples, 0, 0);
-		pc88gsx_psg3->initialize_sound(rate, 3993624, samples, 0, 0);
-		pc88gsx_psg4->initialize_sound(rate, 3993624, samples, 0, 0);
+		pc88gsx_psg1->initialize_sound(mix_rate, 3993624, samples, 0, 0);
+		pc88gsx_psg2->initialize_sound(mix_rate, 3993624, samples, 0, 0);
+		pc88gsx_psg3->initialize_sound(mix_rate, 3993624, samples, 0, 0);
+		pc88gsx_psg4->initialize_sound(mix_rate, 3993624, samples, 0, 0);
 	}
 #endif
 #ifdef SUPPORT_PC88_PCG8100
 	if(config.option_switch & OPTION_SWITCH_PCG8100) {
-		pc88pcg_pcm1->initialize_sound(rate, 8000);
-		pc88pcg_pcm2->initialize_sound(rate, 8000);
-		pc88pcg_pcm3->initialize_sound(rate, 8000);
+		pc88pcg_pcm1->initialize_sound(mix_rate, 8000);
+		pc88pcg_pcm2->initialize_sound(mix_rate, 8000);
+		pc88pcg_pcm3->initialize_sound(mix_rate, 8000);
 	}
 #endif
 #ifdef SUPPORT_PC88_JAST
 	if(config.printer_type == 2) {
 		PCM8BIT *pcm8 = (PCM8BIT *)pc88prn;
-		pcm8->initialize_sound(rate, 32000);
+		pcm8->initialize_sound(mix_rate, 32000);
+	}
+#endif
+#ifdef SUPPORT_PC88_CDROM
+	if(pc88scsi_cdrom != NULL) {
+		pc88scsi_cdrom->initialize_sound(mix_rate);
 	}
 #endif
 	update_mute();
@@ -810,53 +830,60 @@ void VM::initialize_sound(int rate, int samples)
 
 void VM::update_sound_rate(int rate, int samples)
 {
+	int mix_rate = get_sound_mix_rate(rate);
+	
 	// Reconfigure mixer/event manager for new host stream parameters.
-	pc88event->initialize_sound(rate, samples);
+	pc88event->initialize_sound(rate, samples, mix_rate);
 
 	// Preserve current register/tone states by changing device rate only.
-	pc88pcm->initialize_sound(rate, 8000);
+	pc88pcm->initialize_sound(mix_rate, 8000);
 #ifdef SUPPORT_PC88_OPN1
 	if(pc88opn1 != NULL) {
 		if(pc88opn1->is_ym2608) {
-			pc88opn1->change_rate(rate, 7987248);
+			pc88opn1->change_rate(mix_rate, 7987248);
 		} else {
-			pc88opn1->change_rate(rate, 3993624);
+			pc88opn1->change_rate(mix_rate, 3993624);
 		}
 	}
 #endif
 #ifdef SUPPORT_PC88_OPN2
 	if(pc88opn2 != NULL) {
 		if(pc88opn2->is_ym2608) {
-			pc88opn2->change_rate(rate, 7987248);
+			pc88opn2->change_rate(mix_rate, 7987248);
 		} else {
-			pc88opn2->change_rate(rate, 3993624);
+			pc88opn2->change_rate(mix_rate, 3993624);
 		}
 	}
 #endif
 #ifdef SUPPORT_PC88_HMB20
 	if(config.option_switch & OPTION_SWITCH_HMB20) {
-		pc88opm->change_rate(rate, 4000000);
+		pc88opm->change_rate(mix_rate, 4000000);
 	}
 #endif
 #ifdef SUPPORT_PC88_GSX8800
 	if(config.option_switch & OPTION_SWITCH_GSX8800) {
-		pc88gsx_psg1->change_rate(rate, 3993624);
-		pc88gsx_psg2->change_rate(rate, 3993624);
-		pc88gsx_psg3->change_rate(rate, 3993624);
-		pc88gsx_psg4->change_rate(rate, 3993624);
+		pc88gsx_psg1->change_rate(mix_rate, 3993624);
+		pc88gsx_psg2->change_rate(mix_rate, 3993624);
+		pc88gsx_psg3->change_rate(mix_rate, 3993624);
+		pc88gsx_psg4->change_rate(mix_rate, 3993624);
 	}
 #endif
 #ifdef SUPPORT_PC88_PCG8100
 	if(config.option_switch & OPTION_SWITCH_PCG8100) {
-		pc88pcg_pcm1->initialize_sound(rate, 8000);
-		pc88pcg_pcm2->initialize_sound(rate, 8000);
-		pc88pcg_pcm3->initialize_sound(rate, 8000);
+		pc88pcg_pcm1->initialize_sound(mix_rate, 8000);
+		pc88pcg_pcm2->initialize_sound(mix_rate, 8000);
+		pc88pcg_pcm3->initialize_sound(mix_rate, 8000);
 	}
 #endif
 #ifdef SUPPORT_PC88_JAST
 	if(config.printer_type == 2) {
 		PCM8BIT *pcm8 = (PCM8BIT *)pc88prn;
-		pcm8->initialize_sound(rate, 32000);
+		pcm8->initialize_sound(mix_rate, 32000);
+	}
+#endif
+#ifdef SUPPORT_PC88_CDROM
+	if(pc88scsi_cdrom != NULL) {
+		pc88scsi_cdrom->initialize_sound(mix_rate);
 	}
 #endif
 	update_mute();
@@ -892,6 +919,11 @@ int VM::get_sound_buffer_ptr()
 	return pc88event->get_sound_buffer_ptr();
 }
 
+void VM::set_sound_muted(bool value)
+{
+	pc88event->set_sound_muted(value);
+}
+
 #ifdef USE_SOUND_VOLUME
 void VM::set_sound_device_volume(int ch, int decibel_l, int decibel_r)
 {
@@ -143,6 +143,8 @@
 #define SCSI_DEV_IMMEDIATE_SELECT
 #endif
 #define OVERRIDE_SOUND_FREQ_48000HZ	55467
+// the sampling rate of the opn/opna, sound devices mix at it with the resampler
+#define SOUND_NATIVE_RATE		55467
 
 // device informations for win32
 #if defined(PC8001_VARIANT)
@@ -479,6 +481,7 @@ public:
 	
 	// draw screen
 	void draw_screen();
+	bool get_invalidated_rect(int *left, int *top, int *right, int *bottom);
 	
 	// sound generation
 	void initialize_sound(int rate, int samples);
@@ -486,6 +489,7 @@ public:
 	void update_mute();
 	uint16_t* create_sound(int* extra_frames);
 	int get_sound_buffer_ptr();
+	void set_sound_muted(bool value);
 #ifdef USE_SOUND_VOLUME
 	void set_sound_device_volume(int ch, int decibel_l, int decibel_r);
 #endif
@@ -0,0 +1,314 @@
+/*
+	Polyphase resampler for BubiC-8801MA
+
+	Convert the mixed sound from the rate the sound devices run at to the
+	host rate with a windowed sinc filter. The best kernel for the host cpu
+	is selected at runtime.
+
+	[ resampler ]
+*/
+
+#include "resampler.h"
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RESAMPLER_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define RESAMPLER_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define RESAMPLER_AVX2_TARGET
+#else
+#define RESAMPLER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define RESAMPLER_NEON
+#include <arm_neon.h>
+#endif
+
+// the passband ends at this fraction of the lower nyquist frequency
+#define RESAMPLER_CUTOFF	0.9
+// kaiser window, about 70db of stopband attenuation
+#define RESAMPLER_BETA		7.0
+#define RESAMPLER_PI		3.14159265358979323846
+
+// ----------------------------------------------------------------------------
+// kernels
+// ----------------------------------------------------------------------------
+
+// the coefficients are below 1.0 in Q15 and sum up to 1.0, so neither the
+// products nor the sum overflow and every kernel gives the same result
+
+static int32_t dot_generic(const int16_t *x, const int16_t *h) {
+  int32_t sum = 0;
+  for (int i = 0; i < RESAMPLER_TAPS; i++) {
+    sum += (int32_t)x[i] * h[i];
+  }
+  return sum;
+}
+
+#ifdef RESAMPLER_SSE2
+static int32_t dot_sse2(const int16_t *x, const int16_t *h) {
+  __m128i sum = _mm_setzero_si128();
+  for (int i = 0; i < RESAMPLER_TAPS; i += 8) {
+    __m128i vx = _mm_loadu_si128((const __m128i *)(x + i));
+    __m128i vh = _mm_loadu_si128((const __m128i *)(h + i));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(vx, vh));
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+#ifdef RESAMPLER_AVX2
+static bool has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  // avx and osxsave, and the os saves ymm registers
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+    return false;
+  }
+  if ((_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+RESAMPLER_AVX2_TARGET
+static int32_t dot_avx2(const int16_t *x, const int16_t *h) {
+  __m256i sum = _mm256_setzero_si256();
+  for (int i = 0; i < RESAMPLER_TAPS; i += 16) {
+    __m256i vx = _mm256_loadu_si256((const __m256i *)(x + i));
+    __m256i vh = _mm256_loadu_si256((const __m256i *)(h + i));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(vx, vh));
+  }
+  __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                            _mm256_extracti128_si256(sum, 1));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(s);
+}
+#endif
+
+#ifdef RESAMPLER_NEON
+static int32_t dot_neon(const int16_t *x, const int16_t *h) {
+  int32x4_t sum = vdupq_n_s32(0);
+  for (int i = 0; i < RESAMPLER_TAPS; i += 8) {
+    int16x8_t vx = vld1q_s16(x + i);
+    int16x8_t vh = vld1q_s16(h + i);
+    sum = vmlal_s16(sum, vget_low_s16(vx), vget_low_s16(vh));
+    sum = vmlal_s16(sum, vget_high_s16(vx), vget_high_s16(vh));
+  }
+  return vaddvq_s32(sum);
+}
+#endif
+
+static const resampler_kernel_t kernels[] = {
+    {"generic", dot_generic},
+#ifdef RESAMPLER_SSE2
+    {"sse2", dot_sse2},
+#endif
+#ifdef RESAMPLER_AVX2
+    {"avx2", dot_avx2},
+#endif
+#ifdef RESAMPLER_NEON
+    {"neon", dot_neon},
+#endif
+};
+
+int get_resampler_kernel_count() {
+  static int count = -1;
+  if (count < 0) {
+    count = (int)array_length(kernels);
+#ifdef RESAMPLER_AVX2
+    // avx2 is the last one on x86
+    if (!has_avx2()) {
+      count--;
+    }
+#endif
+  }
+  return count;
+}
+
+const resampler_kernel_t *get_resampler_kernel(int index) {
+  if (index < 0 || index >= get_resampler_kernel_count()) {
+    return NULL;
+  }
+  return &kernels[index];
+}
+
+const resampler_kernel_t *get_best_resampler_kernel() {
+  return &kernels[get_resampler_kernel_count() - 1];
+}
+
+// ----------------------------------------------------------------------------
+// resampler
+// ----------------------------------------------------------------------------
+
+RESAMPLER::RESAMPLER() {
+  kernel = get_best_resampler_kernel();
+  in_rate = out_rate = 1;
+  coef = NULL;
+  buffer[0] = buffer[1] = NULL;
+  buffer_size = buffered = 0;
+  frac = 0;
+}
+
+RESAMPLER::~RESAMPLER() {
+  free(coef);
+  free(buffer[0]);
+  free(buffer[1]);
+}
+
+void RESAMPLER::initialize(int new_in_rate, int new_out_rate, int max_input) {
+  in_rate = new_in_rate;
+  out_rate = new_out_rate;
+  free(coef);
+  free(buffer[0]);
+  free(buffer[1]);
+  coef = (int16_t *)malloc((RESAMPLER_PHASES + 1) * RESAMPLER_TAPS *
+                           sizeof(int16_t));
+  buffer_size = RESAMPLER_TAPS * 2 + max_input;
+  buffer[0] = (int16_t *)malloc(buffer_size * sizeof(int16_t));
+  buffer[1] = (int16_t *)malloc(buffer_size * sizeof(int16_t));
+  make_filter();
+  reset();
+}
+
+static double bessel_i0(double x) {
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 32; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+void RESAMPLER::make_filter() {
+  // cutoff in cycles per input sample, below the nyquist frequency of the
+  // lower of the two rates
+  double fc = 0.5 * RESAMPLER_CUTOFF;
+  if (out_rate < in_rate) {
+    fc = fc * out_rate / in_rate;
+  }
+  const double half = RESAMPLER_TAPS / 2;
+  const double i0_beta = bessel_i0(RESAMPLER_BETA);
+
+  // row p is for an output p / RESAMPLER_PHASES of a sample after the center
+  // tap, the last row is the first one shifted by one sample
+  for (int p = 0; p <= RESAMPLER_PHASES; p++) {
+    double row[RESAMPLER_TAPS];
+    double sum = 0.0;
+    for (int t = 0; t < RESAMPLER_TAPS; t++) {
+      double d = t - (half - 1) - (double)p / RESAMPLER_PHASES;
+      double x = d / half;
+      double w = (x > -1.0 && x < 1.0)
+                     ? bessel_i0(RESAMPLER_BETA * sqrt(1.0 - x * x)) / i0_beta
+                     : 0.0;
+      double s = (d == 0.0)
+                     ? 2.0 * fc
+                     : sin(2.0 * RESAMPLER_PI * fc * d) / (RESAMPLER_PI * d);
+      row[t] = s * w;
+      sum += row[t];
+    }
+    // unity gain at dc, the rounding error goes to the largest tap
+    int16_t *h = coef + p * RESAMPLER_TAPS;
+    int total = 0, peak = 0;
+    for (int t = 0; t < RESAMPLER_TAPS; t++) {
+      h[t] = (int16_t)floor(row[t] / sum * 32768.0 + 0.5);
+      total += h[t];
+      if (abs(h[t]) > abs(h[peak])) {
+        peak = t;
+      }
+    }
+    h[peak] += 32768 - total;
+  }
+}
+
+void RESAMPLER::reset() {
+  // half of the window before the first input is silence
+  buffered = RESAMPLER_TAPS / 2;
+  memset(buffer[0], 0, buffered * sizeof(int16_t));
+  memset(buffer[1], 0, buffered * sizeof(int16_t));
+  frac = 0;
+}
+
+int RESAMPLER::get_input_samples(int out_samples) {
+  if (out_samples <= 0) {
+    return 0;
+  }
+  // the window of the last output starts at buffer[last]
+  int last = (int)(((int64_t)frac + (int64_t)(out_samples - 1) * in_rate) /
+                   out_rate);
+  int samples = last + RESAMPLER_TAPS - buffered;
+  return (samples > 0) ? samples : 0;
+}
+
+int RESAMPLER::get_output_samples(int in_samples) {
+  int last = buffered + in_samples - RESAMPLER_TAPS;
+  if (last < 0) {
+    return 0;
+  }
+  // outputs whose window starts at or before buffer[last]
+  return (int)(((int64_t)(last + 1) * out_rate - frac + in_rate - 1) /
+               in_rate);
+}
+
+void RESAMPLER::process(const int32_t *src, int in_samples, uint16_t *dst,
+                        int out_samples) {
+  if (buffered + in_samples > buffer_size) {
+    in_samples = buffer_size - buffered;
+  }
+  for (int i = 0; i < in_samples; i++) {
+    for (int ch = 0; ch < 2; ch++) {
+      int32_t dat = src[i * 2 + ch];
+      buffer[ch][buffered + i] =
+          (int16_t)((dat > 32767) ? 32767 : (dat < -32768) ? -32768 : dat);
+    }
+  }
+  buffered += in_samples;
+
+  int pos = 0;
+  for (int i = 0; i < out_samples; i++) {
+    if (pos + RESAMPLER_TAPS > buffered) {
+      // not enough input, should not happen
+      memset(dst, 0, (out_samples - i) * sizeof(uint16_t) * 2);
+      break;
+    }
+    int phase = (int)(((int64_t)frac * RESAMPLER_PHASES + out_rate / 2) /
+                      out_rate);
+    const int16_t *h = coef + phase * RESAMPLER_TAPS;
+    for (int ch = 0; ch < 2; ch++) {
+      int32_t dat = (kernel->dot(buffer[ch] + pos, h) + (1 << 14)) >> 15;
+      *dst++ = (uint16_t)(int16_t)((dat > 32767)    ? 32767
+                                   : (dat < -32768) ? -32768
+                                                    : dat);
+    }
+    frac += in_rate;
+    pos += frac / out_rate;
+    frac %= out_rate;
+  }
+
+  // drop the consumed input
+  if (pos > buffered) {
+    pos = buffered;
+  }
+  buffered -= pos;
+  memmove(buffer[0], buffer[0] + pos, buffered * sizeof(int16_t));
+  memmove(buffer[1], buffer[1] + pos, buffered * sizeof(int16_t));
+}
@@ -0,0 +1,70 @@
+/*
+	Polyphase resampler for BubiC-8801MA
+
+	Convert the mixed sound from the rate the sound devices run at to the
+	host rate with a windowed sinc filter. The best kernel for the host cpu
+	is selected at runtime.
+
+	[ resampler ]
+*/
+
+#ifndef _RESAMPLER_H_
+#define _RESAMPLER_H_
+
+#include "../common.h"
+
+#define RESAMPLER_TAPS		32
+#define RESAMPLER_PHASES	512
+
+// sum of x[i] * h[i] for i < RESAMPLER_TAPS
+typedef int32_t (*resampler_dot_t)(const int16_t *x, const int16_t *h);
+
+typedef struct {
+	const char *name;
+	resampler_dot_t dot;
+} resampler_kernel_t;
+
+// kernels supported by the host cpu, 0 is the scalar code
+int get_resampler_kernel_count();
+const resampler_kernel_t *get_resampler_kernel(int index);
+
+// the fastest kernel supported by the host cpu
+const resampler_kernel_t *get_best_resampler_kernel();
+
+class RESAMPLER {
+private:
+  const resampler_kernel_t *kernel;
+  int in_rate, out_rate;
+  // (RESAMPLER_PHASES + 1) rows of RESAMPLER_TAPS coefficients in Q15
+  int16_t *coef;
+  // input not consumed yet, clipped to 16 bits, one array for each channel
+  int16_t *buffer[2];
+  int buffer_size, buffered;
+  // position of the next output after buffer[0], in 1 / out_rate samples
+  int frac;
+
+  void make_filter();
+
+public:
+  RESAMPLER();
+  ~RESAMPLER();
+
+  // max_input is the most input samples passed to process() at once
+  void initialize(int in_rate, int out_rate, int max_input);
+  void reset();
+  void set_kernel(const resampler_kernel_t *new_kernel) {
+    kernel = new_kernel;
+  }
+
+  // input samples process() needs to write out_samples
+  int get_input_samples(int out_samples);
+  // output samples process() can write after in_samples more input
+  int get_output_samples(int in_samples);
+
+  // src holds in_samples of stereo input, and in_samples must be
+  // get_input_samples(out_samples)
+  void process(const int32_t *src, int in_samples, uint16_t *dst,
+               int out_samples);
+};
+
+#endif
@@ -39,6 +39,24 @@ void SCSI_CDROM::initialize()
 	cdda_play_mode = 0;
 }
 
+void SCSI_CDROM::initialize_sound(int rate)
+{
+	// the sound may be mixed at another rate than the host rate
+	if(rate > 0 && 44100 % rate == 0) {
+		mix_loop_num = 44100 / rate;
+	} else {
+		mix_loop_num = 0;
+	}
+	if(cdda_status == CDDA_PLAYING) {
+		if(mix_loop_num == 0 && event_cdda == -1) {
+			register_event(this, EVENT_CDDA, 1000000.0 / 44100.0, true, &event_cdda);
+		} else if(mix_loop_num != 0 && event_cdda != -1) {
+			cancel_event(this, event_cdda);
+			event_cdda = -1;
+		}
+	}
+}
+
 void SCSI_CDROM::release()
 {
 	if(fio_img->IsOpened()) {
@@ -118,6 +118,7 @@ public:
 	bool mounted();
 	bool accessed();
 	void set_volume(int volume);
+	void initialize_sound(int rate);
 };
 
 #endif
@@ -55,6 +55,7 @@ public:
 	
 	// draw screen
 	virtual void draw_screen() { }
+	virtual bool get_invalidated_rect(int *left, int *top, int *right, int *bottom) { return false; }
 	
 	// multimedia
 	virtual void movie_sound_callback(uint8_t *buffer, long size) { }
@@ -65,6 +66,7 @@ public:
 	virtual void update_mute() { }
 	virtual uint16_t* create_sound(int* extra_frames) { return NULL; }
 	virtual int get_sound_buffer_ptr() { return 0; }
+	virtual void set_sound_muted(bool value) { }
 	virtual void set_sound_device_volume(int ch, int decibel_l, int decibel_r) { }
 	
 	// network
@@ -14,6 +14,17 @@
 
 #define EVENT_FM_TIMER	0
 
+// commands for the chip mixing on the sound thread
+#define SOUND_SET_REG		0
+#define SOUND_COUNT		1
+#define SOUND_RESET		2
+#define SOUND_MIX		3
+#define SOUND_SKIP		4
+#define SOUND_SET_VOLUME	5
+
+// hand the log to the thread once it has this many commands
+#define SOUND_LOG_KICK		4096
+
 #ifdef SUPPORT_MAME_FM_DLL
 // thanks PC8801MA
 #include "fmdll/fmdll.h"
@@ -25,6 +36,18 @@ static bool dont_create_multiple_chips = false;
 void YM2151::initialize()
 {
 	opm = new FM::OPM;
+	if(config.sound_worker_thread) {
+		sound_opm = new FM::OPM;
+		mix_on_thread = true;
+		sound_count = 0;
+		sound_thread_terminated = false;
+		try {
+			sound_thread = std::thread(&YM2151::sound_thread_main, this);
+			sound_thread_running = true;
+		} catch(...) {
+			sound_thread_running = false;
+		}
+	}
 #ifdef SUPPORT_MAME_FM_DLL
 	if(!fmdll) {
 //		fmdll = new CFMDLL(_T("mame2151.dll"));
@@ -47,7 +70,17 @@ void YM2151::initialize()
 
 void YM2151::release()
 {
+	if(sound_thread_running) {
+		{
+			std::lock_guard<std::mutex> lock(sound_mutex);
+			sound_thread_terminated = true;
+		}
+		sound_cond.notify_all();
+		sound_thread.join();
+		sound_thread_running = false;
+	}
 	delete opm;
+	delete sound_opm;
 #ifdef SUPPORT_MAME_FM_DLL
 	if(dllchip) {
 		fmdll->Release(dllchip);
@@ -65,6 +98,9 @@ void YM2151::reset()
 {
 	touch_sound();
 	opm->Reset();
+	if(mix_on_thread) {
+		log_sound(SOUND_RESET, 0, 0);
+	}
 #ifdef SUPPORT_MAME_FM_DLL
 	if(dllchip) {
 		fmdll->Reset(dllchip);
@@ -140,6 +176,9 @@ void YM2151::event_vline(int v, int clock)
 {
 	update_count();
 	update_interrupt();
+	if(mix_on_thread && (v & 15) == 0) {
+		kick_sound_thread();
+	}
 }
 
 void YM2151::event_callback(int event_id, int error)
@@ -156,6 +195,9 @@ void YM2151::update_count()
 	uint32_t count = clock_accum >> 20;
 	if(count) {
 		opm->Count(count);
+		if(mix_on_thread) {
+			log_sound(SOUND_COUNT, 0, count);
+		}
 		clock_accum -= count << 20;
 	}
 	clock_prev = get_current_clock();
@@ -187,7 +229,18 @@ void YM2151::update_interrupt()
 
 void YM2151::mix(int32_t* buffer, int cnt)
 {
-	if(cnt > 0 && !mute) {
+	if(mix_on_thread && cnt > 0) {
+		if(mute) {
+			log_sound(SOUND_SKIP, 0, cnt);
+			return;
+		}
+		log_sound(SOUND_MIX, 0, cnt);
+#ifdef SUPPORT_MAME_FM_DLL
+		if(dllchip) {
+			fmdll->Mix(dllchip, buffer, cnt);
+		}
+#endif
+	} else if(cnt > 0 && !mute) {
 		opm->Mix(buffer, cnt);
 #ifdef SUPPORT_MAME_FM_DLL
 		if(dllchip) {
@@ -197,9 +250,147 @@ void YM2151::mix(int32_t* buffer, int cnt)
 	}
 }
 
+bool YM2151::collect_sound(int32_t* buffer, int cnt)
+{
+	if(!mix_on_thread) {
+		return false;
+	}
+	sync_sound_thread();
+	int samples = (int)(sound_output.size() / 2);
+	if(samples > cnt) {
+		samples = cnt;
+	}
+	int32_t* dest = buffer + (cnt - samples) * 2;
+	int32_t* src = sound_output.data() + sound_output.size() - samples * 2;
+	for(int i = 0; i < samples * 2; i++) {
+		dest[i] += src[i];
+	}
+	sound_output.clear();
+	return (samples > 0);
+}
+
+void YM2151::log_sound(uint8_t type, uint32_t addr, uint32_t value)
+{
+	if(type == SOUND_COUNT && !(port_log[0x14].data & 0x80)) {
+		// the timers drive the sound only in the csm mode, so they are counted
+		// at the next command that is not a mix
+		sound_count += value;
+		return;
+	}
+	if(type == SOUND_MIX || type == SOUND_SKIP) {
+		// mix the samples between the other commands in one block
+		if(!sound_log.empty() && sound_log.back().type == type) {
+			sound_log.back().value += value;
+			return;
+		}
+	} else if(sound_count != 0) {
+		flush_sound_count();
+	}
+	sound_command_t command;
+	command.type = type;
+	command.addr = (uint16_t)addr;
+	command.value = value;
+	sound_log.push_back(command);
+	if(sound_log.size() >= SOUND_LOG_KICK) {
+		kick_sound_thread();
+	}
+}
+
+void YM2151::flush_sound_count()
+{
+	sound_command_t command;
+	command.type = SOUND_COUNT;
+	command.addr = 0;
+	command.value = sound_count;
+	sound_log.push_back(command);
+	sound_count = 0;
+}
+
+void YM2151::kick_sound_thread()
+{
+	// hand over the log if the thread has finished the last one, or keep it
+	if(sound_thread_running && !sound_log.empty()) {
+		std::lock_guard<std::mutex> lock(sound_mutex);
+		if(sound_job.empty()) {
+			sound_job.swap(sound_log);
+			sound_cond.notify_all();
+		}
+	}
+}
+
+void YM2151::sync_sound_thread()
+{
+	// mix everything logged so far, the sound chip is idle after this
+	if(sound_count != 0) {
+		flush_sound_count();
+	}
+	if(!sound_thread_running) {
+		run_sound_job(sound_log);
+		sound_log.clear();
+		return;
+	}
+	std::unique_lock<std::mutex> lock(sound_mutex);
+	sound_cond.wait(lock, [this]() { return sound_job.empty(); });
+	if(!sound_log.empty()) {
+		sound_job.swap(sound_log);
+		sound_cond.notify_all();
+		sound_cond.wait(lock, [this]() { return sound_job.empty(); });
+	}
+}
+
+void YM2151::sound_thread_main()
+{
+	std::unique_lock<std::mutex> lock(sound_mutex);
+	while(true) {
+		sound_cond.wait(lock, [this]() { return !sound_job.empty() || sound_thread_terminated; });
+		if(sound_thread_terminated) {
+			break;
+		}
+		lock.unlock();
+		run_sound_job(sound_job);
+		lock.lock();
+		sound_job.clear();
+		sound_cond.notify_all();
+	}
+}
+
+void YM2151::run_sound_job(std::vector<sound_command_t>& job)
+{
+	for(size_t i = 0; i < job.size(); i++) {
+		const sound_command_t& command = job[i];
+		switch(command.type) {
+		case SOUND_SET_REG:
+			sound_opm->SetReg(command.addr, command.value);
+			break;
+		case SOUND_COUNT:
+			sound_opm->Count(command.value);
+			break;
+		case SOUND_RESET:
+			sound_opm->Reset();
+			break;
+		case SOUND_MIX:
+		case SOUND_SKIP:
+			{
+				size_t pos = sound_output.size();
+				sound_output.resize(pos + command.value * 2, 0);
+				if(command.type == SOUND_MIX) {
+					sound_opm->Mix(sound_output.data() + pos, command.value);
+				}
+			}
+			break;
+		case SOUND_SET_VOLUME:
+			sound_opm->SetVolume((int16_t)(command.value >> 16), (int16_t)command.value);
+			break;
+		}
+	}
+}
+
 void YM2151::set_volume(int ch, int decibel_l, int decibel_r)
 {
 	opm->SetVolume(base_decibel + decibel_l, base_decibel + decibel_r);
+	if(mix_on_thread) {
+		log_sound(SOUND_SET_VOLUME, 0, ((uint32_t)(uint16_t)(base_decibel + decibel_l) << 16) | (uint16_t)(base_decibel + decibel_r));
+	}
 #ifdef SUPPORT_MAME_FM_DLL
 	if(dllchip) {
 		fmdll->SetVolumeFM(dllchip, base_decibel + decibel_l);
@@ -211,6 +402,11 @@ void YM2151::initialize_sound(int rate, int clock, int samples, int decibel)
 {
 	opm->Init(clock, rate, false);
 	opm->SetVolume(decibel, decibel);
+	if(mix_on_thread) {
+		sync_sound_thread();
+		sound_opm->Init(clock, rate, false);
+		sound_opm->SetVolume(decibel, decibel);
+	}
 	base_decibel = decibel;
 	
 #ifdef SUPPORT_MAME_FM_DLL
@@ -236,6 +432,10 @@ void YM2151::initialize_sound(int rate, int clock, int samples, int decibel)
 				mask |= 0xc0;
 			}
 			opm->SetChannelMask(mask);
+			if(mix_on_thread) {
+				sync_sound_thread();
+				sound_opm->SetChannelMask(mask);
+			}
 			fmdll->SetChannelMask(dllchip, ~mask);
 		}
 	}
@@ -250,12 +450,19 @@ void YM2151::change_rate(int rate, int clock)
 	if(opm) {
 		opm->SetRate(clock, rate, false);
 	}
+	if(mix_on_thread) {
+		sync_sound_thread();
+		sound_opm->SetRate(clock, rate, false);
+	}
 }
 
 void YM2151::set_reg(uint32_t addr, uint32_t data)
 {
 	touch_sound();
 	opm->SetReg(addr, data);
+	if(mix_on_thread) {
+		log_sound(SOUND_SET_REG, addr, data);
+	}
 #ifdef SUPPORT_MAME_FM_DLL
 	if(dllchip) {
 		fmdll->SetReg(dllchip, addr, data);
@@ -280,8 +487,22 @@ bool YM2151::process_state(FILEIO* state_fio, bool loading)
 	if(!state_fio->StateCheckInt32(this_device_id)) {
 		return false;
 	}
-	if(!opm->ProcessState((void *)state_fio, loading)) {
-		return false;
+	if(mix_on_thread) {
+		// the chip on the sound thread has the whole state, the timers and status
+		// are the same on both chips. it is loaded to both
+		sync_sound_thread();
+		long position = state_fio->Ftell();
+		if(!sound_opm->ProcessState((void *)state_fio, loading)) {
+			return false;
+		}
+		if(loading) {
+			state_fio->Fseek(position, FILEIO_SEEK_SET);
+		}
+	}
+	if(!mix_on_thread || loading) {
+		if(!opm->ProcessState((void *)state_fio, loading)) {
+			return false;
+		}
 	}
 	for(int i = 0; i < array_length(port_log); i++) {
 		state_fio->StateValue(port_log[i].written);
@@ -14,6 +14,10 @@
 #include "../emu.h"
 #include "device.h"
 #include "fmgen/opm.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef SUPPORT_WIN32_DLL
 #define SUPPORT_MAME_FM_DLL
@@ -58,6 +62,30 @@ private:
 	uint32_t clock_busy;
 	bool busy;
 	
+	// sound thread: another chip mixes the sound from a log of everything this
+	// chip is told, and this chip keeps the timers and status for the vm.
+	// the log is replayed here if the thread is not running
+	FM::OPM* sound_opm;
+	bool mix_on_thread;
+	typedef struct {
+		uint8_t type;
+		uint16_t addr;
+		uint32_t value;
+	} sound_command_t;
+	std::vector<sound_command_t> sound_log, sound_job;
+	uint32_t sound_count;
+	std::vector<int32_t> sound_output;	// mixed and not collected yet
+	std::thread sound_thread;
+	std::mutex sound_mutex;
+	std::condition_variable sound_cond;
+	bool sound_thread_running, sound_thread_terminated;
+	void log_sound(uint8_t type, uint32_t addr, uint32_t value);
+	void flush_sound_count();
+	void kick_sound_thread();
+	void sync_sound_thread();
+	void sound_thread_main();
+	void run_sound_job(std::vector<sound_command_t>& job);
+	
 	void update_count();
 	void update_event();
 	void update_interrupt();
@@ -67,6 +95,9 @@ public:
 	{
 		initialize_output_signals(&outputs_irq);
 		base_decibel = 0;
+		opm = sound_opm = NULL;
+		mix_on_thread = false;
+		sound_thread_running = sound_thread_terminated = false;
 #ifdef USE_DEBUGGER
 		d_debugger = NULL;
 #endif
@@ -84,6 +115,7 @@ public:
 	void event_vline(int v, int clock);
 	void event_callback(int event_id, int error);
 	void mix(int32_t* buffer, int cnt);
+	bool collect_sound(int32_t* buffer, int cnt);
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	void update_timing(int new_clocks, double new_frames_per_sec, int new_lines_per_frame);
 	// for debugging
@@ -14,6 +14,19 @@
 
 #define EVENT_FM_TIMER	0
 
+// commands for the chip mixing on the sound thread
+#define SOUND_SET_REG		0
+#define SOUND_GET_REG		1
+#define SOUND_READ_STATUS_EX	2
+#define SOUND_COUNT		3
+#define SOUND_RESET		4
+#define SOUND_MIX		5
+#define SOUND_SKIP		6
+#define SOUND_SET_VOLUME	7
+
+// hand the log to the thread once it has this many commands
+#define SOUND_LOG_KICK		4096
+
 #ifdef SUPPORT_MAME_FM_DLL
 // thanks PC8801MA改
 #include "fmdll/fmdll.h"
@@ -35,6 +48,22 @@ void YM2203::initialize()
 		}
 		opn = new FM::OPN;
 	}
+	if(config.sound_worker_thread) {
+		if(is_ym2608) {
+			sound_opna = new FM::OPNA;
+		} else {
+			sound_opn = new FM::OPN;
+		}
+		mix_on_thread = true;
+		sound_count = 0;
+		sound_thread_terminated = false;
+		try {
+			sound_thread = std::thread(&YM2203::sound_thread_main, this);
+			sound_thread_running = true;
+		} catch(...) {
+			sound_thread_running = false;
+		}
+	}
 #ifdef SUPPORT_MAME_FM_DLL
 	if(!fmdll) {
 //		fmdll = new CFMDLL(_T("mamefm.dll"));
@@ -45,6 +74,8 @@ void YM2203::initialize()
 	register_vline_event(this);
 	mute = false;
 	clock_prev = clock_accum = clock_busy = 0;
+	write_queue_read = write_queue_count = 0;
+	mixed_samples = 0;
 	
 #ifdef USE_DEBUGGER
 	if(d_debugger != NULL) {
@@ -61,10 +92,21 @@ void YM2203::initialize()
 
 void YM2203::release()
 {
+	if(sound_thread_running) {
+		{
+			std::lock_guard<std::mutex> lock(sound_mutex);
+			sound_thread_terminated = true;
+		}
+		sound_cond.notify_all();
+		sound_thread.join();
+		sound_thread_running = false;
+	}
 	if(is_ym2608) {
 		delete opna;
+		delete sound_opna;
 	} else {
 		delete opn;
+		delete sound_opn;
 	}
 #ifdef SUPPORT_MAME_FM_DLL
 	if(dllchip) {
@@ -82,11 +124,15 @@ void YM2203::release()
 void YM2203::reset()
 {
 	touch_sound();
+	flush_write_queue();
 	if(is_ym2608) {
 		opna->Reset();
 	} else {
 		opn->Reset();
 	}
+	if(mix_on_thread) {
+		log_sound(SOUND_RESET, 0, 0);
+	}
 #ifdef SUPPORT_MAME_FM_DLL
 	if(dllchip) {
 		fmdll->Reset(dllchip);
@@ -189,6 +235,9 @@ uint32_t YM2203::read_io8(uint32_t addr)
 			update_count();
 			update_interrupt();
 			uint32_t status = opna->ReadStatusEx() & ~0x80;
+			if(mix_on_thread) {
+				log_sound(SOUND_READ_STATUS_EX, 0, 0);
+			}
 			if(busy) {
 				// FIXME: we need to investigate the correct busy period
 				if(get_passed_usec(clock_busy) < 8) {
@@ -201,6 +250,10 @@ uint32_t YM2203::read_io8(uint32_t addr)
 		}
 	case 3:
 		if(ch1 == 8) {
+			// reads the adpcm memory and moves the address
+			if(mix_on_thread) {
+				log_sound(SOUND_GET_REG, 0x100 | ch1, 0);
+			}
 			return opna->GetReg(0x100 | ch1);
 //		} else if(ch1 == 0x0f) {
 //			return 0x80; // from mame fm.c
@@ -316,6 +369,9 @@ void YM2203::event_vline(int v, int clock)
 {
 	update_count();
 	update_interrupt();
+	if(mix_on_thread && (v & 15) == 0) {
+		kick_sound_thread();
+	}
 }
 
 void YM2203::event_callback(int event_id, int error)
@@ -336,6 +392,9 @@ void YM2203::update_count()
 		} else {
 			opn->Count(count);
 		}
+		if(mix_on_thread) {
+			log_sound(SOUND_COUNT, 0, count);
+		}
 		clock_accum -= count << 20;
 	}
 	clock_prev = get_current_clock();
@@ -381,7 +440,45 @@ void YM2203::update_interrupt()
 
 void YM2203::mix(int32_t* buffer, int cnt)
 {
-	if(cnt > 0 && !mute) {
+	// render in blocks between the queued writes
+	while(write_queue_count > 0) {
+		int offset = (int)(write_queue[write_queue_read].sample - mixed_samples);
+		if(offset > 0) {
+			if(offset >= cnt) {
+				break;
+			}
+			mix_chip(buffer, offset);
+			buffer += offset * 2;
+			cnt -= offset;
+			mixed_samples += offset;
+		}
+		write_reg(write_queue[write_queue_read].addr, write_queue[write_queue_read].data);
+		write_queue_read = (write_queue_read + 1) % YM2203_WRITE_QUEUE_SIZE;
+		write_queue_count--;
+	}
+	mix_chip(buffer, cnt);
+	mixed_samples += cnt;
+}
+
+void YM2203::mix_chip(int32_t* buffer, int cnt)
+{
+	if(mix_on_thread && cnt > 0) {
+		if(mute) {
+			log_sound(SOUND_SKIP, 0, cnt);
+			return;
+		}
+		log_sound(SOUND_MIX, 0, cnt);
+		if(is_ym2608) {
+			// keep the adpcm playing for its status flags
+			adpcm_tmp.assign(cnt * 2, 0);
+			opna->MixADPCM(&adpcm_tmp[0], cnt);
+		}
+#ifdef SUPPORT_MAME_FM_DLL
+		if(dllchip) {
+			fmdll->Mix(dllchip, buffer, cnt);
+		}
+#endif
+	} else if(cnt > 0 && !mute) {
 		if(is_ym2608) {
 			opna->Mix(buffer, cnt);
 		} else {
@@ -395,37 +492,208 @@ void YM2203::mix(int32_t* buffer, int cnt)
 	}
 }
 
+bool YM2203::collect_sound(int32_t* buffer, int cnt)
+{
+	if(!mix_on_thread) {
+		return false;
+	}
+	sync_sound_thread();
+	int samples = (int)(sound_output.size() / 2);
+	if(samples > cnt) {
+		samples = cnt;
+	}
+	int32_t* dest = buffer + (cnt - samples) * 2;
+	int32_t* src = sound_output.data() + sound_output.size() - samples * 2;
+	for(int i = 0; i < samples * 2; i++) {
+		dest[i] += src[i];
+	}
+	sound_output.clear();
+	return (samples > 0);
+}
+
+void YM2203::log_sound(uint8_t type, uint32_t addr, uint32_t value)
+{
+	if(type == SOUND_COUNT && (port_log[0x27].data & 0xc0) != 0x80) {
+		// the timers drive the sound only in the csm mode, so they are counted
+		// at the next command that is not a mix
+		sound_count += value;
+		return;
+	}
+	if(type == SOUND_MIX || type == SOUND_SKIP) {
+		// mix the samples between the other commands in one block
+		if(!sound_log.empty() && sound_log.back().type == type) {
+			sound_log.back().value += value;
+			return;
+		}
+	} else if(sound_count != 0) {
+		flush_sound_count();
+	}
+	sound_command_t command;
+	command.type = type;
+	command.addr = (uint16_t)addr;
+	command.value = value;
+	sound_log.push_back(command);
+	if(sound_log.size() >= SOUND_LOG_KICK) {
+		kick_sound_thread();
+	}
+}
+
+void YM2203::flush_sound_count()
+{
+	sound_command_t command;
+	command.type = SOUND_COUNT;
+	command.addr = 0;
+	command.value = sound_count;
+	sound_log.push_back(command);
+	sound_count = 0;
+}
+
+void YM2203::kick_sound_thread()
+{
+	// hand over the log if the thread has finished the last one, or keep it
+	if(sound_thread_running && !sound_log.empty()) {
+		std::lock_guard<std::mutex> lock(sound_mutex);
+		if(sound_job.empty()) {
+			sound_job.swap(sound_log);
+			sound_cond.notify_all();
+		}
+	}
+}
+
+void YM2203::sync_sound_thread()
+{
+	// mix everything logged so far, the sound chip is idle after this
+	if(sound_count != 0) {
+		flush_sound_count();
+	}
+	if(!sound_thread_running) {
+		run_sound_job(sound_log);
+		sound_log.clear();
+		return;
+	}
+	std::unique_lock<std::mutex> lock(sound_mutex);
+	sound_cond.wait(lock, [this]() { return sound_job.empty(); });
+	if(!sound_log.empty()) {
+		sound_job.swap(sound_log);
+		sound_cond.notify_all();
+		sound_cond.wait(lock, [this]() { return sound_job.empty(); });
+	}
+}
+
+void YM2203::sound_thread_main()
+{
+	std::unique_lock<std::mutex> lock(sound_mutex);
+	while(true) {
+		sound_cond.wait(lock, [this]() { return !sound_job.empty() || sound_thread_terminated; });
+		if(sound_thread_terminated) {
+			break;
+		}
+		lock.unlock();
+		run_sound_job(sound_job);
+		lock.lock();
+		sound_job.clear();
+		sound_cond.notify_all();
+	}
+}
+
+void YM2203::run_sound_job(std::vector<sound_command_t>& job)
+{
+	for(size_t i = 0; i < job.size(); i++) {
+		const sound_command_t& command = job[i];
+		switch(command.type) {
+		case SOUND_SET_REG:
+			if(is_ym2608) {
+				sound_opna->SetReg(command.addr, command.value);
+			} else {
+				sound_opn->SetReg(command.addr, command.value);
+			}
+			break;
+		case SOUND_GET_REG:
+			sound_opna->GetReg(command.addr);
+			break;
+		case SOUND_READ_STATUS_EX:
+			sound_opna->ReadStatusEx();
+			break;
+		case SOUND_COUNT:
+			if(is_ym2608) {
+				sound_opna->Count(command.value);
+			} else {
+				sound_opn->Count(command.value);
+			}
+			break;
+		case SOUND_RESET:
+			if(is_ym2608) {
+				sound_opna->Reset();
+			} else {
+				sound_opn->Reset();
+			}
+			break;
+		case SOUND_MIX:
+		case SOUND_SKIP:
+			{
+				size_t pos = sound_output.size();
+				sound_output.resize(pos + command.value * 2, 0);
+				if(command.type == SOUND_MIX) {
+					if(is_ym2608) {
+						sound_opna->Mix(sound_output.data() + pos, command.value);
+					} else {
+						sound_opn->Mix(sound_output.data() + pos, command.value);
+					}
+				}
+			}
+			break;
+		case SOUND_SET_VOLUME:
+			set_chip_volume(sound_opna, sound_opn, command.addr, (int16_t)(command.value >> 16), (int16_t)command.value);
+			break;
+		}
+	}
+}
+
 void YM2203::set_volume(int ch, int decibel_l, int decibel_r)
 {
 	if(ch == 0) {
-		if(is_ym2608) {
-			opna->SetVolumeFM(base_decibel_fm + decibel_l, base_decibel_fm + decibel_r);
-		} else {
-			opn->SetVolumeFM(base_decibel_fm + decibel_l, base_decibel_fm + decibel_r);
-		}
+		decibel_l += base_decibel_fm;
+		decibel_r += base_decibel_fm;
+	} else if(ch == 1) {
+		decibel_l += base_decibel_psg;
+		decibel_r += base_decibel_psg;
+	}
+	set_chip_volume(opna, opn, ch, decibel_l, decibel_r);
+	if(mix_on_thread) {
+		log_sound(SOUND_SET_VOLUME, ch, ((uint32_t)(uint16_t)decibel_l << 16) | (uint16_t)decibel_r);
+	}
 #ifdef SUPPORT_MAME_FM_DLL
-		if(dllchip) {
-			fmdll->SetVolumeFM(dllchip, base_decibel_fm + decibel_l);
+	if(dllchip) {
+		if(ch == 0) {
+			fmdll->SetVolumeFM(dllchip, decibel_l);
+		} else if(ch == 1) {
+			fmdll->SetVolumePSG(dllchip, decibel_l);
 		}
+	}
 #endif
-	} else if(ch == 1) {
+}
+
+void YM2203::set_chip_volume(FM::OPNA* chip_opna, FM::OPN* chip_opn, int ch, int decibel_l, int decibel_r)
+{
+	if(ch == 0) {
 		if(is_ym2608) {
-			opna->SetVolumePSG(base_decibel_psg + decibel_l, base_decibel_psg + decibel_r);
+			chip_opna->SetVolumeFM(decibel_l, decibel_r);
 		} else {
-			opn->SetVolumePSG(base_decibel_psg + decibel_l, base_decibel_psg + decibel_r);
+			chip_opn->SetVolumeFM(decibel_l, decibel_r);
 		}
-#ifdef SUPPORT_MAME_FM_DLL
-		if(dllchip) {
-			fmdll->SetVolumePSG(dllchip, base_decibel_psg + decibel_l);
+	} else if(ch == 1) {
+		if(is_ym2608) {
+			chip_opna->SetVolumePSG(decibel_l, decibel_r);
+		} else {
+			chip_opn->SetVolumePSG(decibel_l, decibel_r);
 		}
-#endif
 	} else if(ch == 2) {
 		if(is_ym2608) {
-			opna->SetVolumeADPCM(decibel_l, decibel_r);
+			chip_opna->SetVolumeADPCM(decibel_l, decibel_r);
 		}
 	} else if(ch == 3) {
 		if(is_ym2608) {
-			opna->SetVolumeRhythmTotal(decibel_l, decibel_r);
+			chip_opna->SetVolumeRhythmTotal(decibel_l, decibel_r);
 		}
 	}
 }
@@ -441,6 +709,18 @@ void YM2203::initialize_sound(int rate, int clock, int samples, int decibel_fm,
 		opn->SetVolumeFM(decibel_fm, decibel_fm);
 		opn->SetVolumePSG(decibel_psg, decibel_psg);
 	}
+	if(mix_on_thread) {
+		sync_sound_thread();
+		if(is_ym2608) {
+			sound_opna->Init(clock, rate, false, get_application_path());
+			sound_opna->SetVolumeFM(decibel_fm, decibel_fm);
+			sound_opna->SetVolumePSG(decibel_psg, decibel_psg);
+		} else {
+			sound_opn->Init(clock, rate, false, NULL);
+			sound_opn->SetVolumeFM(decibel_fm, decibel_fm);
+			sound_opn->SetVolumePSG(decibel_psg, decibel_psg);
+		}
+	}
 	base_decibel_fm = decibel_fm;
 	base_decibel_psg = decibel_psg;
 	
@@ -477,12 +757,7 @@ void YM2203::initialize_sound(int rate, int clock, int samples, int decibel_fm,
 			if((dwCaps & SUPPORT_RHYTHM) == SUPPORT_RHYTHM) {
 				mask |= 0xfc00;
 			}
-			if(is_ym2608) {
-				opna->SetChannelMask(mask);
-			} else {
-				opn->SetChannelMask(mask);
-			}
-			fmdll->SetChannelMask(dllchip, ~mask);
+			set_channel_mask(mask);
 		}
 	}
 #endif
@@ -491,6 +766,7 @@ void YM2203::initialize_sound(int rate, int clock, int samples, int decibel_fm,
 
 void YM2203::change_rate(int rate, int clock)
 {
+	flush_write_queue();
 	chip_clock = clock;
 	if(is_ym2608) {
 		if(opna) {
@@ -501,14 +777,19 @@ void YM2203::change_rate(int rate, int clock)
 			opn->SetRate(clock, rate, false);
 		}
 	}
+	if(mix_on_thread) {
+		sync_sound_thread();
+		if(is_ym2608) {
+			sound_opna->SetRate(clock, rate, false);
+		} else {
+			sound_opn->SetRate(clock, rate, false);
+		}
+	}
 }
 
 void YM2203::set_reg(uint32_t addr, uint32_t data)
 {
-	touch_sound();
-	if(is_ym2608) {
-		opna->SetReg(addr, data);
-	} else {
+	if(!is_ym2608) {
 		if((addr & 0xf0) == 0x10) {
 			return;
 		}
@@ -519,12 +800,16 @@ void YM2203::set_reg(uint32_t addr, uint32_t data)
 		} else if(addr >= 0xb4) {
 			data = 0xc0;
 		}
-		opn->SetReg(addr, data);
 	}
-#ifdef SUPPORT_MAME_FM_DLL
-	if(dllchip) {
-		fmdll->SetReg(dllchip, addr, data);
+	if(is_queued_reg(addr)) {
+		queue_reg(addr, data);
+	} else {
+		// the other registers are read back or drive the status and timers
+		touch_sound();
+		flush_write_queue();
+		write_reg(addr, data);
 	}
+#ifdef SUPPORT_MAME_FM_DLL
 	if(0x2d <= addr && addr <= 0x2f) {
 		port_log[0x2d].written = port_log[0x2e].written = port_log[0x2f].written = false;
 	}
@@ -533,6 +818,61 @@ void YM2203::set_reg(uint32_t addr, uint32_t data)
 	port_log[addr].data = data;
 }
 
+bool YM2203::is_queued_reg(uint32_t addr)
+{
+	// lfo, key on/off, channel and operator parameters, and rhythm
+	uint32_t reg = addr & 0xff;
+	if(addr == 0x22 || addr == 0x28 || (0x30 <= reg && reg <= 0xb6)) {
+		return true;
+	}
+	return is_ym2608 && 0x10 <= addr && addr <= 0x1d;
+}
+
+void YM2203::queue_reg(uint32_t addr, uint32_t data)
+{
+	uint32_t sample = mixed_samples + get_sound_pending_samples();
+	if(write_queue_count == 0 && sample == mixed_samples) {
+		write_reg(addr, data);
+		return;
+	}
+	if(write_queue_count == YM2203_WRITE_QUEUE_SIZE) {
+		// sound is not mixed while the vm runs muted, apply them now
+		touch_sound();
+		flush_write_queue();
+	}
+	int index = (write_queue_read + write_queue_count) % YM2203_WRITE_QUEUE_SIZE;
+	write_queue[index].sample = sample;
+	write_queue[index].addr = (uint16_t)addr;
+	write_queue[index].data = (uint8_t)data;
+	write_queue_count++;
+}
+
+void YM2203::flush_write_queue()
+{
+	while(write_queue_count > 0) {
+		write_reg(write_queue[write_queue_read].addr, write_queue[write_queue_read].data);
+		write_queue_read = (write_queue_read + 1) % YM2203_WRITE_QUEUE_SIZE;
+		write_queue_count--;
+	}
+}
+
+void YM2203::write_reg(uint32_t addr, uint32_t data)
+{
+	if(is_ym2608) {
+		opna->SetReg(addr, data);
+	} else {
+		opn->SetReg(addr, data);
+	}
+	if(mix_on_thread) {
+		log_sound(SOUND_SET_REG, addr, data);
+	}
+#ifdef SUPPORT_MAME_FM_DLL
+	if(dllchip) {
+		fmdll->SetReg(dllchip, addr, data);
+	}
+#endif
+}
+
 void YM2203::set_channel_mask(uint32_t mask)
 {
 	if(is_ym2608) {
@@ -540,6 +880,14 @@ void YM2203::set_channel_mask(uint32_t mask)
 	} else {
 		if(opn) opn->SetChannelMask(mask);
 	}
+	if(mix_on_thread) {
+		sync_sound_thread();
+		if(is_ym2608) {
+			sound_opna->SetChannelMask(mask);
+		} else {
+			sound_opn->SetChannelMask(mask);
+		}
+	}
 #ifdef SUPPORT_MAME_FM_DLL
 	if(dllchip) {
 		fmdll->SetChannelMask(dllchip, ~mask);
@@ -556,7 +904,7 @@ void YM2203::update_timing(int new_clocks, double new_frames_per_sec, int new_li
 	}
 }
 
-#define STATE_VERSION	7
+#define STATE_VERSION	8
 
 bool YM2203::process_state(FILEIO* state_fio, bool loading)
 {
@@ -566,13 +914,33 @@ bool YM2203::process_state(FILEIO* state_fio, bool loading)
 	if(!state_fio->StateCheckInt32(this_device_id)) {
 		return false;
 	}
-	if(is_ym2608) {
-		if(!opna->ProcessState((void *)state_fio, loading)) {
-			return false;
+	if(mix_on_thread) {
+		// the chip on the sound thread has the whole state, the timers, status
+		// and adpcm are the same on both chips. it is loaded to both
+		sync_sound_thread();
+		long position = state_fio->Ftell();
+		if(is_ym2608) {
+			if(!sound_opna->ProcessState((void *)state_fio, loading)) {
+				return false;
+			}
+		} else {
+			if(!sound_opn->ProcessState((void *)state_fio, loading)) {
+				return false;
+			}
 		}
-	} else {
-		if(!opn->ProcessState((void *)state_fio, loading)) {
-			return false;
+		if(loading) {
+			state_fio->Fseek(position, FILEIO_SEEK_SET);
+		}
+	}
+	if(!mix_on_thread || loading) {
+		if(is_ym2608) {
+			if(!opna->ProcessState((void *)state_fio, loading)) {
+				return false;
+			}
+		} else {
+			if(!opn->ProcessState((void *)state_fio, loading)) {
+				return false;
+			}
 		}
 	}
 	for(int i = 0; i < array_length(port_log); i++) {
@@ -600,6 +968,17 @@ bool YM2203::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(timer_event_id);
 	state_fio->StateValue(busy);
 	
+	state_fio->StateValue(mixed_samples);
+	state_fio->StateValue(write_queue_count);
+	if(write_queue_count < 0 || write_queue_count > YM2203_WRITE_QUEUE_SIZE) {
+		return false;
+	}
+	for(int i = 0; i < write_queue_count; i++) {
+		int index = (write_queue_read + i) % YM2203_WRITE_QUEUE_SIZE;
+		state_fio->StateValue(write_queue[index].sample);
+		state_fio->StateValue(write_queue[index].addr);
+		state_fio->StateValue(write_queue[index].data);
+	}
 #ifdef SUPPORT_MAME_FM_DLL
 	// post process
 	if(loading && dllchip) {
@@ -14,6 +14,10 @@
 #include "../emu.h"
 #include "device.h"
 #include "fmgen/opna.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef SUPPORT_WIN32_DLL
 #define SUPPORT_MAME_FM_DLL
@@ -24,6 +28,8 @@
 #define SIG_YM2203_PORT_B	1
 #define SIG_YM2203_MUTE		2
 
+#define YM2203_WRITE_QUEUE_SIZE	1024
+
 #ifdef USE_DEBUGGER
 class DEBUGGER;
 #endif
@@ -71,6 +77,48 @@ private:
 	uint32_t clock_busy;
 	bool busy;
 	
+	// fm and rhythm register writes are queued with the sample they are made
+	// at, and mix() replays them there instead of mixing up to every write
+	struct {
+		uint32_t sample;
+		uint16_t addr;
+		uint8_t data;
+	} write_queue[YM2203_WRITE_QUEUE_SIZE];
+	int write_queue_read, write_queue_count;
+	uint32_t mixed_samples;
+	
+	bool is_queued_reg(uint32_t addr);
+	void queue_reg(uint32_t addr, uint32_t data);
+	void flush_write_queue();
+	void write_reg(uint32_t addr, uint32_t data);
+	void mix_chip(int32_t* buffer, int cnt);
+	
+	// sound thread: another chip mixes the sound from a log of everything this
+	// chip is told, and this chip keeps the timers, status and adpcm playback
+	// for the vm. the log is replayed here if the thread is not running
+	FM::OPNA* sound_opna;
+	FM::OPN* sound_opn;
+	bool mix_on_thread;
+	typedef struct {
+		uint8_t type;
+		uint16_t addr;
+		uint32_t value;
+	} sound_command_t;
+	std::vector<sound_command_t> sound_log, sound_job;
+	uint32_t sound_count;
+	std::vector<int32_t> sound_output;	// mixed and not collected yet
+	std::vector<int32_t> adpcm_tmp;
+	std::thread sound_thread;
+	std::mutex sound_mutex;
+	std::condition_variable sound_cond;
+	bool sound_thread_running, sound_thread_terminated;
+	void log_sound(uint8_t type, uint32_t addr, uint32_t value);
+	void flush_sound_count();
+	void kick_sound_thread();
+	void sync_sound_thread();
+	void sound_thread_main();
+	void run_sound_job(std::vector<sound_command_t>& job);
+	void set_chip_volume(FM::OPNA* chip_opna, FM::OPN* chip_opn, int ch, int decibel_l, int decibel_r);
 	void update_count();
 	void update_event();
 	
@@ -91,6 +139,10 @@ public:
 		// please set is_ym2608 = true before YM2203::initializ() is called
 		is_ym2608 = false;
 		is_port_a_input = is_port_b_input = false;
+		opna = sound_opna = NULL;
+		opn = sound_opn = NULL;
+		mix_on_thread = false;
+		sound_thread_running = sound_thread_terminated = false;
 #ifdef USE_DEBUGGER
 		d_debugger = NULL;
 #endif
@@ -109,6 +161,7 @@ public:
 	void event_vline(int v, int clock);
 	void event_callback(int event_id, int error);
 	void mix(int32_t* buffer, int cnt);
+	bool collect_sound(int32_t* buffer, int cnt);
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	void update_timing(int new_clocks, double new_frames_per_sec, int new_lines_per_frame);
 	// for debugging
@@ -211,6 +211,65 @@ static const uint8_t cc_ex[0x100] = {
 	 6, 0, 0, 0, 7, 0, 0, 2, 6, 0, 0, 0, 7, 0, 0, 2
 };
 
+// operand bytes fetched after the opecode for the block cache, -1 means that
+// the prefix is ignored and the opecode is run as no prefix
+static const int8_t op_operand[0x100] = {
+	 0, 2, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+	 1, 2, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0,
+	 1, 2, 2, 0, 0, 0, 1, 0, 1, 0, 2, 0, 0, 0, 1, 0,
+	 1, 2, 2, 0, 0, 0, 1, 0, 1, 0, 2, 0, 0, 0, 1, 0,
+	 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	 0, 0, 2, 2, 2, 0, 1, 0, 0, 0, 2, 1, 2, 2, 1, 0,
+	 0, 0, 2, 1, 2, 0, 1, 0, 0, 0, 2, 1, 2, 0, 1, 0,
+	 0, 0, 2, 0, 2, 0, 1, 0, 0, 0, 2, 0, 2, 0, 1, 0,
+	 0, 0, 2, 0, 2, 0, 1, 0, 0, 0, 2, 0, 2, 0, 1, 0
+};
+
+static const int8_t ed_operand[0x100] = {
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0,
+	 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0,
+	 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0,
+	 0, 0, 0, 2, 0, 0, 0,-1, 0, 0, 0, 2, 0, 0, 0,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	 0, 0, 0, 0,-1,-1,-1,-1, 0, 0, 0, 0,-1,-1,-1,-1,
+	 0, 0, 0, 0,-1,-1,-1,-1, 0, 0, 0, 0,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1
+};
+
+static const int8_t xy_operand[0x100] = {
+	-1,-1,-1,-1,-1,-1,-1,-1,-1, 0,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1, 0,-1,-1,-1,-1,-1,-1,
+	-1, 2, 2, 0, 0, 0, 1,-1,-1, 0, 2, 0, 0, 0, 1,-1,
+	-1,-1,-1,-1, 1, 1, 2,-1,-1, 0,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1, 0, 0, 1,-1,-1,-1,-1,-1, 0, 0, 1,-1,
+	-1,-1,-1,-1, 0, 0, 1,-1,-1,-1,-1,-1, 0, 0, 1,-1,
+	 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+	 1, 1, 1, 1, 1, 1,-1, 1,-1,-1,-1,-1, 0, 0, 1,-1,
+	-1,-1,-1,-1, 0, 0, 1,-1,-1,-1,-1,-1, 0, 0, 1,-1,
+	-1,-1,-1,-1, 0, 0, 1,-1,-1,-1,-1,-1, 0, 0, 1,-1,
+	-1,-1,-1,-1, 0, 0, 1,-1,-1,-1,-1,-1, 0, 0, 1,-1,
+	-1,-1,-1,-1, 0, 0, 1,-1,-1,-1,-1,-1, 0, 0, 1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 2,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+	-1, 0,-1, 0,-1, 0,-1,-1,-1, 0,-1,-1,-1,-1,-1,-1,
+	-1,-1,-1,-1,-1,-1,-1,-1,-1, 0,-1,-1,-1,-1,-1,-1
+};
+
 // opecode definitions
 
 #define ENTER_HALT() do { \
@@ -226,7 +285,7 @@ static const uint8_t cc_ex[0x100] = {
 } while(0)
 
 #define CLOCK_IN_OP(clock) do { \
-	if(is_primary) { \
+	if(PRIMARY) { \
 		if(wait || wait_icount > 0) { \
 			wait_icount += (clock); \
 		} else { \
@@ -237,51 +296,112 @@ static const uint8_t cc_ex[0x100] = {
 } while(0)
 
 #define UPDATE_EVENT_IN_OP(clock) do { \
-	if(is_primary ) { \
+	if(PRIMARY) { \
 		if(wait || wait_icount > 0) { \
 			wait_icount += (clock); \
 		} else { \
 			event_icount += (clock); \
 		} \
 		if(event_icount > 0) { \
-			update_event_in_op(event_icount); \
+			event_margin = update_event_in_op(event_icount); \
 			event_icount = 0; \
 		} \
 		in_op_icount += (clock); \
 	} \
 } while(0)
 
+// plain memory has no side effect to other devices, so the event update can be
+// deferred until the clocks reach the margin where the next event may be fired
+#define DEFER_EVENT_IN_OP(clock) do { \
+	if(PRIMARY) { \
+		if(wait || wait_icount > 0) { \
+			wait_icount += (clock); \
+		} else { \
+			event_icount += (clock); \
+		} \
+		if(event_icount > 0 && event_icount >= event_margin) { \
+			event_margin = update_event_in_op(event_icount); \
+			event_icount = 0; \
+		} \
+		in_op_icount += (clock); \
+	} \
+} while(0)
+
+// sub cpu may run to catch up with primary cpu, so it tells the clocks passed since the
+// start of the clocks given to run() before accessing devices to let them see the clock
+// where it is running now
+#define UPDATE_SUB_CPU_CLOCK() do { \
+	if(!PRIMARY) { \
+		update_sub_cpu_clock(run_icount - icount); \
+	} \
+} while(0)
+
+// the device accessed after the event update may register an event sooner than
+// the margin, so the next clocks have to update the event again
+#define EXPIRE_EVENT_MARGIN() do { \
+	if(PRIMARY) { \
+		event_margin = 0; \
+	} \
+} while(0)
+
+template <bool PRIMARY>
 inline uint8_t Z80::RM8(uint32_t addr)
 {
-	UPDATE_EVENT_IN_OP(1);
 	int wait_clock = 0;
-	uint8_t val = d_mem->read_data8w(addr, &wait_clock);
+	uint8_t val;
+	const mem_page_t *page = mem_pages ? &mem_pages[(addr >> 12) & 15] : NULL;
+	if(page != NULL && !page->slow) {
+		DEFER_EVENT_IN_OP(1);
+		wait_clock = page->read_wait;
+		val = page->read[addr & 0xfff];
+	} else {
+		UPDATE_EVENT_IN_OP(1);
+		val = d_mem->read_data8w(addr, &wait_clock);
+		EXPIRE_EVENT_MARGIN();
+	}
 	icount -= wait_clock;
 	CLOCK_IN_OP(2 + wait_clock);
 	return val;
 }
 
+template <bool PRIMARY>
 inline void Z80::WM8(uint32_t addr, uint8_t val)
 {
-	UPDATE_EVENT_IN_OP(1);
+	idle_dirty = true;
 	int wait_clock = 0;
-	d_mem->write_data8w(addr, val, &wait_clock);
+	const mem_page_t *page = mem_pages ? &mem_pages[(addr >> 12) & 15] : NULL;
+	if(page != NULL && !page->slow) {
+		DEFER_EVENT_IN_OP(1);
+		wait_clock = page->write_wait;
+		page->write[addr & 0xfff] = val;
+		if(uop_tags[(addr >> 8) & 0xff] == page->write + (addr & 0xf00)) {
+			// self-modifying code
+			invalidate_block_cache(addr);
+		}
+	} else {
+		UPDATE_EVENT_IN_OP(1);
+		d_mem->write_data8w(addr, val, &wait_clock);
+		EXPIRE_EVENT_MARGIN();
+	}
 	icount -= wait_clock;
 	CLOCK_IN_OP(2 + wait_clock);
 }
 
+template <bool PRIMARY>
 inline void Z80::RM16(uint32_t addr, pair32_t *r)
 {
-	r->b.l = RM8(addr);
-	r->b.h = RM8((addr + 1) & 0xffff);
+	r->b.l = RM8<PRIMARY>(addr);
+	r->b.h = RM8<PRIMARY>((addr + 1) & 0xffff);
 }
 
+template <bool PRIMARY>
 inline void Z80::WM16(uint32_t addr, pair32_t *r)
 {
-	WM8(addr, r->b.l);
-	WM8((addr + 1) & 0xffff, r->b.h);
+	WM8<PRIMARY>(addr, r->b.l);
+	WM8<PRIMARY>((addr + 1) & 0xffff, r->b.h);
 }
 
+template <bool PRIMARY, bool CACHED>
 inline uint8_t Z80::FETCHOP()
 {
 	unsigned pctmp = PCD;
@@ -289,41 +409,81 @@ inline uint8_t Z80::FETCHOP()
 	R++;
 	
 	// consider m1 cycle wait
-	UPDATE_EVENT_IN_OP(1);
 	int wait_clock = 0;
-	uint8_t val = d_mem->fetch_op(pctmp, &wait_clock);
+	uint8_t val;
+	const mem_page_t *page = mem_pages ? &mem_pages[(pctmp >> 12) & 15] : NULL;
+	if(CACHED) {
+		// the opecode is decoded from the page that is not slow
+		DEFER_EVENT_IN_OP(1);
+		wait_clock = uop_page->fetch_wait;
+		val = *uop_fetch++;
+	} else if(page != NULL && !page->slow) {
+		DEFER_EVENT_IN_OP(1);
+		wait_clock = page->fetch_wait;
+		val = page->read[pctmp & 0xfff];
+	} else {
+		UPDATE_EVENT_IN_OP(1);
+		val = d_mem->fetch_op(pctmp, &wait_clock);
+		EXPIRE_EVENT_MARGIN();
+	}
 	icount -= wait_clock;
 	CLOCK_IN_OP(3 + wait_clock);
 	return val;
 }
 
+template <bool PRIMARY, bool CACHED>
 inline uint8_t Z80::FETCH8()
 {
 	unsigned pctmp = PCD;
 	PC++;
-	return RM8(pctmp);
+	if(CACHED) {
+		// same clocks as RM8() from the page that is not slow
+		DEFER_EVENT_IN_OP(1);
+		int wait_clock = uop_page->read_wait;
+		icount -= wait_clock;
+		CLOCK_IN_OP(2 + wait_clock);
+		return *uop_fetch++;
+	}
+	return RM8<PRIMARY>(pctmp);
 }
 
+template <bool PRIMARY, bool CACHED>
 inline uint32_t Z80::FETCH16()
 {
+	if(CACHED) {
+		uint32_t val = FETCH8<PRIMARY, CACHED>();
+		return val | ((uint32_t)FETCH8<PRIMARY, CACHED>() << 8);
+	}
 	unsigned pctmp = PCD;
 	PC += 2;
-	return RM8(pctmp) | ((uint32_t)RM8((pctmp + 1) & 0xffff) << 8);
+	return RM8<PRIMARY>(pctmp) | ((uint32_t)RM8<PRIMARY>((pctmp + 1) & 0xffff) << 8);
 }
 
+template <bool PRIMARY>
 inline uint8_t Z80::IN8(uint32_t addr)
 {
 	UPDATE_EVENT_IN_OP(2);
+	UPDATE_SUB_CPU_CLOCK();
+	idle_input = true;
+	idle_poll = false;
 	int wait_clock = 0;
 	uint8_t val = d_io->read_io8w(addr, &wait_clock);
+	EXPIRE_EVENT_MARGIN();
+	if(!idle_poll) {
+		// the device does not tell this is a status port without side effects
+		idle_dirty = true;
+	}
 	icount -= wait_clock;
 	CLOCK_IN_OP(2 + wait_clock);
 	return val;
 }
 
+template <bool PRIMARY>
 inline void Z80::OUT8(uint32_t addr, uint8_t val)
 {
 	UPDATE_EVENT_IN_OP(2);
+	UPDATE_SUB_CPU_CLOCK();
+	idle_dirty = true;
 #ifdef HAS_NSC800
 	if((addr & 0xff) == 0xbb) {
 		icr = val;
@@ -333,48 +493,49 @@ inline void Z80::OUT8(uint32_t addr, uint8_t val)
 #endif
 	int wait_clock = 0;
 	d_io->write_io8w(addr, val, &wait_clock);
+	EXPIRE_EVENT_MARGIN();
 	icount -= wait_clock;
 	CLOCK_IN_OP(2 + wait_clock);
 }
 
 #define EAX() do { \
-	ea = (uint32_t)(uint16_t)(IX + (int8_t)FETCH8()); \
+	ea = (uint32_t)(uint16_t)(IX + (int8_t)FETCH8<PRIMARY, CACHED>()); \
 	WZ = ea; \
 } while(0)
 
 #define EAY() do { \
-	ea = (uint32_t)(uint16_t)(IY + (int8_t)FETCH8()); \
+	ea = (uint32_t)(uint16_t)(IY + (int8_t)FETCH8<PRIMARY, CACHED>()); \
 	WZ = ea; \
 } while(0)
 
 #define POP(DR) do { \
-	RM16(SPD, &DR); \
+	RM16<PRIMARY>(SPD, &DR); \
 	SP += 2; \
 } while(0)
 
 #define PUSH(SR) do { \
 	SP -= 2; \
 	CLOCK_IN_OP(1); \
-	WM16(SPD, &SR); \
+	WM16<PRIMARY>(SPD, &SR); \
 } while(0)
 
 #define JP() do { \
-	PCD = FETCH16(); \
+	PCD = FETCH16<PRIMARY, CACHED>(); \
 	WZ = PCD; \
 } while(0)
 
 #define JP_COND(cond) do { \
 	if(cond) { \
-		PCD = FETCH16(); \
+		PCD = FETCH16<PRIMARY, CACHED>(); \
 		WZ = PCD; \
 	} else { \
-		WZ = FETCH16(); /* implicit do PC += 2 */ \
+		WZ = FETCH16<PRIMARY, CACHED>(); /* implicit do PC += 2 */ \
 	} \
 } while(0)
 
 #define JR() do { \
-	int8_t arg = (int8_t)FETCH8(); /* FETCH8() also increments PC */ \
-	PC += arg; /* so don't do PC += FETCH8() */ \
+	int8_t arg = (int8_t)FETCH8<PRIMARY, CACHED>(); /* FETCH8<PRIMARY, CACHED>() also increments PC */ \
+	PC += arg; /* so don't do PC += FETCH8<PRIMARY, CACHED>() */ \
 	WZ = PC; \
 } while(0)
 
@@ -382,11 +543,11 @@ inline void Z80::OUT8(uint32_t addr, uint8_t val)
 	if(cond) { \
 		JR(); \
 		icount -= cc_ex[opcode]; \
-	} else FETCH8(); \
+	} else FETCH8<PRIMARY, CACHED>(); \
 } while(0)
 
 #define CALL() do { \
-	ea = FETCH16(); \
+	ea = FETCH16<PRIMARY, CACHED>(); \
 	WZ = ea; \
 	PUSH(pc); \
 	PCD = ea; \
@@ -394,13 +555,13 @@ inline void Z80::OUT8(uint32_t addr, uint8_t val)
 
 #define CALL_COND(cond, opcode) do { \
 	if(cond) { \
-		ea = FETCH16(); \
+		ea = FETCH16<PRIMARY, CACHED>(); \
 		WZ = ea; \
 		PUSH(pc); \
 		PCD = ea; \
 		icount -= cc_ex[opcode]; \
 	} else { \
-		WZ = FETCH16(); /* implicit call PC+=2; */ \
+		WZ = FETCH16<PRIMARY, CACHED>(); /* implicit call PC+=2; */ \
 	} \
 } while(0)
 
@@ -492,19 +653,19 @@ inline uint8_t Z80::DEC(uint8_t value)
 } while(0)
 
 #define RRD() do { \
-	uint8_t n = RM8(HL); \
+	uint8_t n = RM8<PRIMARY>(HL); \
 	WZ = HL + 1; \
 	CLOCK_IN_OP(4); \
-	WM8(HL, (n >> 4) | (A << 4)); \
+	WM8<PRIMARY>(HL, (n >> 4) | (A << 4)); \
 	A = (A & 0xf0) | (n & 0x0f); \
 	F = (F & CF) | SZP[A]; \
 } while(0)
 
 #define RLD() do { \
-	uint8_t n = RM8(HL); \
+	uint8_t n = RM8<PRIMARY>(HL); \
 	WZ = HL + 1; \
 	CLOCK_IN_OP(4); \
-	WM8(HL, (n << 4) | (A & 0x0f)); \
+	WM8<PRIMARY>(HL, (n << 4) | (A & 0x0f)); \
 	A = (A & 0xf0) | (n >> 4); \
 	F = (F & CF) | SZP[A]; \
 } while(0)
@@ -598,9 +759,9 @@ inline uint8_t Z80::DEC(uint8_t value)
 #define EXSP(DR) do { \
 	pair32_t tmp; \
 	tmp.d = 0; \
-	RM16(SPD, &tmp); \
+	RM16<PRIMARY>(SPD, &tmp); \
 	CLOCK_IN_OP(1); \
-	WM16(SPD, &DR); \
+	WM16<PRIMARY>(SPD, &DR); \
 	CLOCK_IN_OP(2); \
 	DR = tmp; \
 	WZ = DR.d; \
@@ -722,8 +883,8 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 }
 
 #define LDI() do { \
-	uint8_t io = RM8(HL); \
-	WM8(DE, io); \
+	uint8_t io = RM8<PRIMARY>(HL); \
+	WM8<PRIMARY>(DE, io); \
 	F &= SF | ZF | CF; \
 	if((A + io) & 0x02) F |= YF; /* bit 1 -> flag 5 */ \
 	if((A + io) & 0x08) F |= XF; /* bit 3 -> flag 3 */ \
@@ -733,7 +894,7 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 } while(0)
 
 #define CPI() do { \
-	uint8_t val = RM8(HL); \
+	uint8_t val = RM8<PRIMARY>(HL); \
 	uint8_t res = A - val; \
 	WZ++; \
 	HL++; BC--; \
@@ -747,10 +908,10 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 
 #define INI() do { \
 	CLOCK_IN_OP(1); \
-	uint8_t io = IN8(BC); \
+	uint8_t io = IN8<PRIMARY>(BC); \
 	WZ = BC + 1; \
 	B--; \
-	WM8(HL, io); \
+	WM8<PRIMARY>(HL, io); \
 	HL++; \
 	F = SZ[B]; \
 	unsigned t = (unsigned)((C + 1) & 0xff) + (unsigned)io; \
@@ -761,10 +922,10 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 
 #define OUTI() do { \
 	CLOCK_IN_OP(1); \
-	uint8_t io = RM8(HL); \
+	uint8_t io = RM8<PRIMARY>(HL); \
 	B--; \
 	WZ = BC + 1; \
-	OUT8(BC, io); \
+	OUT8<PRIMARY>(BC, io); \
 	HL++; \
 	F = SZ[B]; \
 	unsigned t = (unsigned)L + (unsigned)io; \
@@ -774,8 +935,8 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 } while(0)
 
 #define LDD() do { \
-	uint8_t io = RM8(HL); \
-	WM8(DE, io); \
+	uint8_t io = RM8<PRIMARY>(HL); \
+	WM8<PRIMARY>(DE, io); \
 	F &= SF | ZF | CF; \
 	if((A + io) & 0x02) F |= YF; /* bit 1 -> flag 5 */ \
 	if((A + io) & 0x08) F |= XF; /* bit 3 -> flag 3 */ \
@@ -785,7 +946,7 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 } while(0)
 
 #define CPD() do { \
-	uint8_t val = RM8(HL); \
+	uint8_t val = RM8<PRIMARY>(HL); \
 	uint8_t res = A - val; \
 	WZ--; \
 	HL--; BC--; \
@@ -799,10 +960,10 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 
 #define IND() do { \
 	CLOCK_IN_OP(1); \
-	uint8_t io = IN8(BC); \
+	uint8_t io = IN8<PRIMARY>(BC); \
 	WZ = BC - 1; \
 	B--; \
-	WM8(HL, io); \
+	WM8<PRIMARY>(HL, io); \
 	HL--; \
 	F = SZ[B]; \
 	unsigned t = ((unsigned)(C - 1) & 0xff) + (unsigned)io; \
@@ -813,10 +974,10 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 
 #define OUTD() do { \
 	CLOCK_IN_OP(1); \
-	uint8_t io = RM8(HL); \
+	uint8_t io = RM8<PRIMARY>(HL); \
 	B--; \
 	WZ = BC - 1; \
-	OUT8(BC, io); \
+	OUT8<PRIMARY>(BC, io); \
 	HL--; \
 	F = SZ[B]; \
 	unsigned t = (unsigned)L + (unsigned)io; \
@@ -898,6 +1059,47 @@ inline uint8_t Z80::SET(uint8_t bit, uint8_t value)
 	after_ei = true; \
 } while(0)
 
+// opecode dispatch: jump through a table of label addresses (gcc/clang extension)
+// if Z80_COMPUTED_GOTO is defined, otherwise use switch statements
+
+#if defined(Z80_COMPUTED_GOTO) && (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define Z80_USE_COMPUTED_GOTO
+#endif
+
+#ifdef Z80_USE_COMPUTED_GOTO
+#define OP_DISPATCH(table, code)	goto *table[code]; do
+#define OP_DISPATCH_END			while(0)
+#define OP_CASE(code)			op_##code
+#define OP_DEFAULT			op_default
+#define OP_TABLE_ROW(p, h) \
+	&&p##h##0, &&p##h##1, &&p##h##2, &&p##h##3, &&p##h##4, &&p##h##5, &&p##h##6, &&p##h##7, \
+	&&p##h##8, &&p##h##9, &&p##h##a, &&p##h##b, &&p##h##c, &&p##h##d, &&p##h##e, &&p##h##f
+#define OP_TABLE_ALL { \
+	OP_TABLE_ROW(op_0x, 0), \
+	OP_TABLE_ROW(op_0x, 1), \
+	OP_TABLE_ROW(op_0x, 2), \
+	OP_TABLE_ROW(op_0x, 3), \
+	OP_TABLE_ROW(op_0x, 4), \
+	OP_TABLE_ROW(op_0x, 5), \
+	OP_TABLE_ROW(op_0x, 6), \
+	OP_TABLE_ROW(op_0x, 7), \
+	OP_TABLE_ROW(op_0x, 8), \
+	OP_TABLE_ROW(op_0x, 9), \
+	OP_TABLE_ROW(op_0x, a), \
+	OP_TABLE_ROW(op_0x, b), \
+	OP_TABLE_ROW(op_0x, c), \
+	OP_TABLE_ROW(op_0x, d), \
+	OP_TABLE_ROW(op_0x, e), \
+	OP_TABLE_ROW(op_0x, f) \
+}
+#else
+#define OP_DISPATCH(table, code)	switch(code)
+#define OP_DISPATCH_END
+#define OP_CASE(code)			case code
+#define OP_DEFAULT			default
+#endif
+
+template <bool PRIMARY, bool CACHED>
 void Z80::OP_CB(uint8_t code)
 {
 	// Done: M1 + M1
@@ -905,269 +1107,273 @@ void Z80::OP_CB(uint8_t code)
 	
 	icount -= cc_cb[code];
 	
-	switch(code) {
-	case 0x00: B = RLC(B); break;						/* RLC  B           */
-	case 0x01: C = RLC(C); break;						/* RLC  C           */
-	case 0x02: D = RLC(D); break;						/* RLC  D           */
-	case 0x03: E = RLC(E); break;						/* RLC  E           */
-	case 0x04: H = RLC(H); break;						/* RLC  H           */
-	case 0x05: L = RLC(L); break;						/* RLC  L           */
-	case 0x06: v = RLC(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;		/* RLC  (HL)        */
-	case 0x07: A = RLC(A); break;						/* RLC  A           */
-	case 0x08: B = RRC(B); break;						/* RRC  B           */
-	case 0x09: C = RRC(C); break;						/* RRC  C           */
-	case 0x0a: D = RRC(D); break;						/* RRC  D           */
-	case 0x0b: E = RRC(E); break;						/* RRC  E           */
-	case 0x0c: H = RRC(H); break;						/* RRC  H           */
-	case 0x0d: L = RRC(L); break;						/* RRC  L           */
-	case 0x0e: v = RRC(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;		/* RRC  (HL)        */
-	case 0x0f: A = RRC(A); break;						/* RRC  A           */
-	case 0x10: B = RL(B); break;						/* RL   B           */
-	case 0x11: C = RL(C); break;						/* RL   C           */
-	case 0x12: D = RL(D); break;						/* RL   D           */
-	case 0x13: E = RL(E); break;						/* RL   E           */
-	case 0x14: H = RL(H); break;						/* RL   H           */
-	case 0x15: L = RL(L); break;						/* RL   L           */
-	case 0x16: v = RL(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;		/* RL   (HL)        */
-	case 0x17: A = RL(A); break;						/* RL   A           */
-	case 0x18: B = RR(B); break;						/* RR   B           */
-	case 0x19: C = RR(C); break;						/* RR   C           */
-	case 0x1a: D = RR(D); break;						/* RR   D           */
-	case 0x1b: E = RR(E); break;						/* RR   E           */
-	case 0x1c: H = RR(H); break;						/* RR   H           */
-	case 0x1d: L = RR(L); break;						/* RR   L           */
-	case 0x1e: v = RR(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;		/* RR   (HL)        */
-	case 0x1f: A = RR(A); break;						/* RR   A           */
-	case 0x20: B = SLA(B); break;						/* SLA  B           */
-	case 0x21: C = SLA(C); break;						/* SLA  C           */
-	case 0x22: D = SLA(D); break;						/* SLA  D           */
-	case 0x23: E = SLA(E); break;						/* SLA  E           */
-	case 0x24: H = SLA(H); break;						/* SLA  H           */
-	case 0x25: L = SLA(L); break;						/* SLA  L           */
-	case 0x26: v = SLA(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;		/* SLA  (HL)        */
-	case 0x27: A = SLA(A); break;						/* SLA  A           */
-	case 0x28: B = SRA(B); break;						/* SRA  B           */
-	case 0x29: C = SRA(C); break;						/* SRA  C           */
-	case 0x2a: D = SRA(D); break;						/* SRA  D           */
-	case 0x2b: E = SRA(E); break;						/* SRA  E           */
-	case 0x2c: H = SRA(H); break;						/* SRA  H           */
-	case 0x2d: L = SRA(L); break;						/* SRA  L           */
-	case 0x2e: v = SRA(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;		/* SRA  (HL)        */
-	case 0x2f: A = SRA(A); break;						/* SRA  A           */
-	case 0x30: B = SLL(B); break;						/* SLL  B           */
-	case 0x31: C = SLL(C); break;						/* SLL  C           */
-	case 0x32: D = SLL(D); break;						/* SLL  D           */
-	case 0x33: E = SLL(E); break;						/* SLL  E           */
-	case 0x34: H = SLL(H); break;						/* SLL  H           */
-	case 0x35: L = SLL(L); break;						/* SLL  L           */
-	case 0x36: v = SLL(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;		/* SLL  (HL)        */
-	case 0x37: A = SLL(A); break;						/* SLL  A           */
-	case 0x38: B = SRL(B); break;						/* SRL  B           */
-	case 0x39: C = SRL(C); break;						/* SRL  C           */
-	case 0x3a: D = SRL(D); break;						/* SRL  D           */
-	case 0x3b: E = SRL(E); break;						/* SRL  E           */
-	case 0x3c: H = SRL(H); break;						/* SRL  H           */
-	case 0x3d: L = SRL(L); break;						/* SRL  L           */
-	case 0x3e: v = SRL(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;		/* SRL  (HL)        */
-	case 0x3f: A = SRL(A); break;						/* SRL  A           */
-	case 0x40: BIT(0, B); break;						/* BIT  0,B         */
-	case 0x41: BIT(0, C); break;						/* BIT  0,C         */
-	case 0x42: BIT(0, D); break;						/* BIT  0,D         */
-	case 0x43: BIT(0, E); break;						/* BIT  0,E         */
-	case 0x44: BIT(0, H); break;						/* BIT  0,H         */
-	case 0x45: BIT(0, L); break;						/* BIT  0,L         */
-	case 0x46: v = RM8(HL); CLOCK_IN_OP(1); BIT_HL(0, v); break;		/* BIT  0,(HL)      */
-	case 0x47: BIT(0, A); break;						/* BIT  0,A         */
-	case 0x48: BIT(1, B); break;						/* BIT  1,B         */
-	case 0x49: BIT(1, C); break;						/* BIT  1,C         */
-	case 0x4a: BIT(1, D); break;						/* BIT  1,D         */
-	case 0x4b: BIT(1, E); break;						/* BIT  1,E         */
-	case 0x4c: BIT(1, H); break;						/* BIT  1,H         */
-	case 0x4d: BIT(1, L); break;						/* BIT  1,L         */
-	case 0x4e: v = RM8(HL); CLOCK_IN_OP(1); BIT_HL(1, v); break;		/* BIT  1,(HL)      */
-	case 0x4f: BIT(1, A); break;						/* BIT  1,A         */
-	case 0x50: BIT(2, B); break;						/* BIT  2,B         */
-	case 0x51: BIT(2, C); break;						/* BIT  2,C         */
-	case 0x52: BIT(2, D); break;						/* BIT  2,D         */
-	case 0x53: BIT(2, E); break;						/* BIT  2,E         */
-	case 0x54: BIT(2, H); break;						/* BIT  2,H         */
-	case 0x55: BIT(2, L); break;						/* BIT  2,L         */
-	case 0x56: v = RM8(HL); CLOCK_IN_OP(1); BIT_HL(2, v); break;		/* BIT  2,(HL)      */
-	case 0x57: BIT(2, A); break;						/* BIT  2,A         */
-	case 0x58: BIT(3, B); break;						/* BIT  3,B         */
-	case 0x59: BIT(3, C); break;						/* BIT  3,C         */
-	case 0x5a: BIT(3, D); break;						/* BIT  3,D         */
-	case 0x5b: BIT(3, E); break;						/* BIT  3,E         */
-	case 0x5c: BIT(3, H); break;						/* BIT  3,H         */
-	case 0x5d: BIT(3, L); break;						/* BIT  3,L         */
-	case 0x5e: v = RM8(HL); CLOCK_IN_OP(1); BIT_HL(3, v); break;		/* BIT  3,(HL)      */
-	case 0x5f: BIT(3, A); break;						/* BIT  3,A         */
-	case 0x60: BIT(4, B); break;						/* BIT  4,B         */
-	case 0x61: BIT(4, C); break;						/* BIT  4,C         */
-	case 0x62: BIT(4, D); break;						/* BIT  4,D         */
-	case 0x63: BIT(4, E); break;						/* BIT  4,E         */
-	case 0x64: BIT(4, H); break;						/* BIT  4,H         */
-	case 0x65: BIT(4, L); break;						/* BIT  4,L         */
-	case 0x66: v = RM8(HL); CLOCK_IN_OP(1); BIT_HL(4, v); break;		/* BIT  4,(HL)      */
-	case 0x67: BIT(4, A); break;						/* BIT  4,A         */
-	case 0x68: BIT(5, B); break;						/* BIT  5,B         */
-	case 0x69: BIT(5, C); break;						/* BIT  5,C         */
-	case 0x6a: BIT(5, D); break;						/* BIT  5,D         */
-	case 0x6b: BIT(5, E); break;						/* BIT  5,E         */
-	case 0x6c: BIT(5, H); break;						/* BIT  5,H         */
-	case 0x6d: BIT(5, L); break;						/* BIT  5,L         */
-	case 0x6e: v = RM8(HL); CLOCK_IN_OP(1); BIT_HL(5, v); break;		/* BIT  5,(HL)      */
-	case 0x6f: BIT(5, A); break;						/* BIT  5,A         */
-	case 0x70: BIT(6, B); break;						/* BIT  6,B         */
-	case 0x71: BIT(6, C); break;						/* BIT  6,C         */
-	case 0x72: BIT(6, D); break;						/* BIT  6,D         */
-	case 0x73: BIT(6, E); break;						/* BIT  6,E         */
-	case 0x74: BIT(6, H); break;						/* BIT  6,H         */
-	case 0x75: BIT(6, L); break;						/* BIT  6,L         */
-	case 0x76: v = RM8(HL); CLOCK_IN_OP(1); BIT_HL(6, v); break;		/* BIT  6,(HL)      */
-	case 0x77: BIT(6, A); break;						/* BIT  6,A         */
-	case 0x78: BIT(7, B); break;						/* BIT  7,B         */
-	case 0x79: BIT(7, C); break;						/* BIT  7,C         */
-	case 0x7a: BIT(7, D); break;						/* BIT  7,D         */
-	case 0x7b: BIT(7, E); break;						/* BIT  7,E         */
-	case 0x7c: BIT(7, H); break;						/* BIT  7,H         */
-	case 0x7d: BIT(7, L); break;						/* BIT  7,L         */
-	case 0x7e: v = RM8(HL); CLOCK_IN_OP(1); BIT_HL(7, v); break;		/* BIT  7,(HL)      */
-	case 0x7f: BIT(7, A); break;						/* BIT  7,A         */
-	case 0x80: B = RES(0, B); break;					/* RES  0,B         */
-	case 0x81: C = RES(0, C); break;					/* RES  0,C         */
-	case 0x82: D = RES(0, D); break;					/* RES  0,D         */
-	case 0x83: E = RES(0, E); break;					/* RES  0,E         */
-	case 0x84: H = RES(0, H); break;					/* RES  0,H         */
-	case 0x85: L = RES(0, L); break;					/* RES  0,L         */
-	case 0x86: v = RES(0, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* RES  0,(HL)      */
-	case 0x87: A = RES(0, A); break;					/* RES  0,A         */
-	case 0x88: B = RES(1, B); break;					/* RES  1,B         */
-	case 0x89: C = RES(1, C); break;					/* RES  1,C         */
-	case 0x8a: D = RES(1, D); break;					/* RES  1,D         */
-	case 0x8b: E = RES(1, E); break;					/* RES  1,E         */
-	case 0x8c: H = RES(1, H); break;					/* RES  1,H         */
-	case 0x8d: L = RES(1, L); break;					/* RES  1,L         */
-	case 0x8e: v = RES(1, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* RES  1,(HL)      */
-	case 0x8f: A = RES(1, A); break;					/* RES  1,A         */
-	case 0x90: B = RES(2, B); break;					/* RES  2,B         */
-	case 0x91: C = RES(2, C); break;					/* RES  2,C         */
-	case 0x92: D = RES(2, D); break;					/* RES  2,D         */
-	case 0x93: E = RES(2, E); break;					/* RES  2,E         */
-	case 0x94: H = RES(2, H); break;					/* RES  2,H         */
-	case 0x95: L = RES(2, L); break;					/* RES  2,L         */
-	case 0x96: v = RES(2, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* RES  2,(HL)      */
-	case 0x97: A = RES(2, A); break;					/* RES  2,A         */
-	case 0x98: B = RES(3, B); break;					/* RES  3,B         */
-	case 0x99: C = RES(3, C); break;					/* RES  3,C         */
-	case 0x9a: D = RES(3, D); break;					/* RES  3,D         */
-	case 0x9b: E = RES(3, E); break;					/* RES  3,E         */
-	case 0x9c: H = RES(3, H); break;					/* RES  3,H         */
-	case 0x9d: L = RES(3, L); break;					/* RES  3,L         */
-	case 0x9e: v = RES(3, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* RES  3,(HL)      */
-	case 0x9f: A = RES(3, A); break;					/* RES  3,A         */
-	case 0xa0: B = RES(4,	B); break;					/* RES  4,B         */
-	case 0xa1: C = RES(4,	C); break;					/* RES  4,C         */
-	case 0xa2: D = RES(4,	D); break;					/* RES  4,D         */
-	case 0xa3: E = RES(4,	E); break;					/* RES  4,E         */
-	case 0xa4: H = RES(4,	H); break;					/* RES  4,H         */
-	case 0xa5: L = RES(4,	L); break;					/* RES  4,L         */
-	case 0xa6: v = RES(4, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* RES  4,(HL)      */
-	case 0xa7: A = RES(4,	A); break;					/* RES  4,A         */
-	case 0xa8: B = RES(5, B); break;					/* RES  5,B         */
-	case 0xa9: C = RES(5, C); break;					/* RES  5,C         */
-	case 0xaa: D = RES(5, D); break;					/* RES  5,D         */
-	case 0xab: E = RES(5, E); break;					/* RES  5,E         */
-	case 0xac: H = RES(5, H); break;					/* RES  5,H         */
-	case 0xad: L = RES(5, L); break;					/* RES  5,L         */
-	case 0xae: v = RES(5, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* RES  5,(HL)      */
-	case 0xaf: A = RES(5, A); break;					/* RES  5,A         */
-	case 0xb0: B = RES(6, B); break;					/* RES  6,B         */
-	case 0xb1: C = RES(6, C); break;					/* RES  6,C         */
-	case 0xb2: D = RES(6, D); break;					/* RES  6,D         */
-	case 0xb3: E = RES(6, E); break;					/* RES  6,E         */
-	case 0xb4: H = RES(6, H); break;					/* RES  6,H         */
-	case 0xb5: L = RES(6, L); break;					/* RES  6,L         */
-	case 0xb6: v = RES(6, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* RES  6,(HL)      */
-	case 0xb7: A = RES(6, A); break;					/* RES  6,A         */
-	case 0xb8: B = RES(7, B); break;					/* RES  7,B         */
-	case 0xb9: C = RES(7, C); break;					/* RES  7,C         */
-	case 0xba: D = RES(7, D); break;					/* RES  7,D         */
-	case 0xbb: E = RES(7, E); break;					/* RES  7,E         */
-	case 0xbc: H = RES(7, H); break;					/* RES  7,H         */
-	case 0xbd: L = RES(7, L); break;					/* RES  7,L         */
-	case 0xbe: v = RES(7, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* RES  7,(HL)      */
-	case 0xbf: A = RES(7, A); break;					/* RES  7,A         */
-	case 0xc0: B = SET(0, B); break;					/* SET  0,B         */
-	case 0xc1: C = SET(0, C); break;					/* SET  0,C         */
-	case 0xc2: D = SET(0, D); break;					/* SET  0,D         */
-	case 0xc3: E = SET(0, E); break;					/* SET  0,E         */
-	case 0xc4: H = SET(0, H); break;					/* SET  0,H         */
-	case 0xc5: L = SET(0, L); break;					/* SET  0,L         */
-	case 0xc6: v = SET(0, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* SET  0,(HL)      */
-	case 0xc7: A = SET(0, A); break;					/* SET  0,A         */
-	case 0xc8: B = SET(1, B); break;					/* SET  1,B         */
-	case 0xc9: C = SET(1, C); break;					/* SET  1,C         */
-	case 0xca: D = SET(1, D); break;					/* SET  1,D         */
-	case 0xcb: E = SET(1, E); break;					/* SET  1,E         */
-	case 0xcc: H = SET(1, H); break;					/* SET  1,H         */
-	case 0xcd: L = SET(1, L); break;					/* SET  1,L         */
-	case 0xce: v = SET(1, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* SET  1,(HL)      */
-	case 0xcf: A = SET(1, A); break;					/* SET  1,A         */
-	case 0xd0: B = SET(2, B); break;					/* SET  2,B         */
-	case 0xd1: C = SET(2, C); break;					/* SET  2,C         */
-	case 0xd2: D = SET(2, D); break;					/* SET  2,D         */
-	case 0xd3: E = SET(2, E); break;					/* SET  2,E         */
-	case 0xd4: H = SET(2, H); break;					/* SET  2,H         */
-	case 0xd5: L = SET(2, L); break;					/* SET  2,L         */
-	case 0xd6: v = SET(2, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* SET  2,(HL)      */
-	case 0xd7: A = SET(2, A); break;					/* SET  2,A         */
-	case 0xd8: B = SET(3, B); break;					/* SET  3,B         */
-	case 0xd9: C = SET(3, C); break;					/* SET  3,C         */
-	case 0xda: D = SET(3, D); break;					/* SET  3,D         */
-	case 0xdb: E = SET(3, E); break;					/* SET  3,E         */
-	case 0xdc: H = SET(3, H); break;					/* SET  3,H         */
-	case 0xdd: L = SET(3, L); break;					/* SET  3,L         */
-	case 0xde: v = SET(3, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* SET  3,(HL)      */
-	case 0xdf: A = SET(3, A); break;					/* SET  3,A         */
-	case 0xe0: B = SET(4, B); break;					/* SET  4,B         */
-	case 0xe1: C = SET(4, C); break;					/* SET  4,C         */
-	case 0xe2: D = SET(4, D); break;					/* SET  4,D         */
-	case 0xe3: E = SET(4, E); break;					/* SET  4,E         */
-	case 0xe4: H = SET(4, H); break;					/* SET  4,H         */
-	case 0xe5: L = SET(4, L); break;					/* SET  4,L         */
-	case 0xe6: v = SET(4, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* SET  4,(HL)      */
-	case 0xe7: A = SET(4, A); break;					/* SET  4,A         */
-	case 0xe8: B = SET(5, B); break;					/* SET  5,B         */
-	case 0xe9: C = SET(5, C); break;					/* SET  5,C         */
-	case 0xea: D = SET(5, D); break;					/* SET  5,D         */
-	case 0xeb: E = SET(5, E); break;					/* SET  5,E         */
-	case 0xec: H = SET(5, H); break;					/* SET  5,H         */
-	case 0xed: L = SET(5, L); break;					/* SET  5,L         */
-	case 0xee: v = SET(5, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* SET  5,(HL)      */
-	case 0xef: A = SET(5, A); break;					/* SET  5,A         */
-	case 0xf0: B = SET(6, B); break;					/* SET  6,B         */
-	case 0xf1: C = SET(6, C); break;					/* SET  6,C         */
-	case 0xf2: D = SET(6, D); break;					/* SET  6,D         */
-	case 0xf3: E = SET(6, E); break;					/* SET  6,E         */
-	case 0xf4: H = SET(6, H); break;					/* SET  6,H         */
-	case 0xf5: L = SET(6, L); break;					/* SET  6,L         */
-	case 0xf6: v = SET(6, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* SET  6,(HL)      */
-	case 0xf7: A = SET(6, A); break;					/* SET  6,A         */
-	case 0xf8: B = SET(7, B); break;					/* SET  7,B         */
-	case 0xf9: C = SET(7, C); break;					/* SET  7,C         */
-	case 0xfa: D = SET(7, D); break;					/* SET  7,D         */
-	case 0xfb: E = SET(7, E); break;					/* SET  7,E         */
-	case 0xfc: H = SET(7, H); break;					/* SET  7,H         */
-	case 0xfd: L = SET(7, L); break;					/* SET  7,L         */
-	case 0xfe: v = SET(7, RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;	/* SET  7,(HL)      */
-	case 0xff: A = SET(7, A); break;					/* SET  7,A         */
+#ifdef Z80_USE_COMPUTED_GOTO
+	static const void* const op_table[256] = OP_TABLE_ALL;
+#endif
+	OP_DISPATCH(op_table, code) {
+	OP_CASE(0x00): B = RLC(B); break;						/* RLC  B           */
+	OP_CASE(0x01): C = RLC(C); break;						/* RLC  C           */
+	OP_CASE(0x02): D = RLC(D); break;						/* RLC  D           */
+	OP_CASE(0x03): E = RLC(E); break;						/* RLC  E           */
+	OP_CASE(0x04): H = RLC(H); break;						/* RLC  H           */
+	OP_CASE(0x05): L = RLC(L); break;						/* RLC  L           */
+	OP_CASE(0x06): v = RLC(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;		/* RLC  (HL)        */
+	OP_CASE(0x07): A = RLC(A); break;						/* RLC  A           */
+	OP_CASE(0x08): B = RRC(B); break;						/* RRC  B           */
+	OP_CASE(0x09): C = RRC(C); break;						/* RRC  C           */
+	OP_CASE(0x0a): D = RRC(D); break;						/* RRC  D           */
+	OP_CASE(0x0b): E = RRC(E); break;						/* RRC  E           */
+	OP_CASE(0x0c): H = RRC(H); break;						/* RRC  H           */
+	OP_CASE(0x0d): L = RRC(L); break;						/* RRC  L           */
+	OP_CASE(0x0e): v = RRC(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;		/* RRC  (HL)        */
+	OP_CASE(0x0f): A = RRC(A); break;						/* RRC  A           */
+	OP_CASE(0x10): B = RL(B); break;						/* RL   B           */
+	OP_CASE(0x11): C = RL(C); break;						/* RL   C           */
+	OP_CASE(0x12): D = RL(D); break;						/* RL   D           */
+	OP_CASE(0x13): E = RL(E); break;						/* RL   E           */
+	OP_CASE(0x14): H = RL(H); break;						/* RL   H           */
+	OP_CASE(0x15): L = RL(L); break;						/* RL   L           */
+	OP_CASE(0x16): v = RL(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;		/* RL   (HL)        */
+	OP_CASE(0x17): A = RL(A); break;						/* RL   A           */
+	OP_CASE(0x18): B = RR(B); break;						/* RR   B           */
+	OP_CASE(0x19): C = RR(C); break;						/* RR   C           */
+	OP_CASE(0x1a): D = RR(D); break;						/* RR   D           */
+	OP_CASE(0x1b): E = RR(E); break;						/* RR   E           */
+	OP_CASE(0x1c): H = RR(H); break;						/* RR   H           */
+	OP_CASE(0x1d): L = RR(L); break;						/* RR   L           */
+	OP_CASE(0x1e): v = RR(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;		/* RR   (HL)        */
+	OP_CASE(0x1f): A = RR(A); break;						/* RR   A           */
+	OP_CASE(0x20): B = SLA(B); break;						/* SLA  B           */
+	OP_CASE(0x21): C = SLA(C); break;						/* SLA  C           */
+	OP_CASE(0x22): D = SLA(D); break;						/* SLA  D           */
+	OP_CASE(0x23): E = SLA(E); break;						/* SLA  E           */
+	OP_CASE(0x24): H = SLA(H); break;						/* SLA  H           */
+	OP_CASE(0x25): L = SLA(L); break;						/* SLA  L           */
+	OP_CASE(0x26): v = SLA(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;		/* SLA  (HL)        */
+	OP_CASE(0x27): A = SLA(A); break;						/* SLA  A           */
+	OP_CASE(0x28): B = SRA(B); break;						/* SRA  B           */
+	OP_CASE(0x29): C = SRA(C); break;						/* SRA  C           */
+	OP_CASE(0x2a): D = SRA(D); break;						/* SRA  D           */
+	OP_CASE(0x2b): E = SRA(E); break;						/* SRA  E           */
+	OP_CASE(0x2c): H = SRA(H); break;						/* SRA  H           */
+	OP_CASE(0x2d): L = SRA(L); break;						/* SRA  L           */
+	OP_CASE(0x2e): v = SRA(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;		/* SRA  (HL)        */
+	OP_CASE(0x2f): A = SRA(A); break;						/* SRA  A           */
+	OP_CASE(0x30): B = SLL(B); break;						/* SLL  B           */
+	OP_CASE(0x31): C = SLL(C); break;						/* SLL  C           */
+	OP_CASE(0x32): D = SLL(D); break;						/* SLL  D           */
+	OP_CASE(0x33): E = SLL(E); break;						/* SLL  E           */
+	OP_CASE(0x34): H = SLL(H); break;						/* SLL  H           */
+	OP_CASE(0x35): L = SLL(L); break;						/* SLL  L           */
+	OP_CASE(0x36): v = SLL(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;		/* SLL  (HL)        */
+	OP_CASE(0x37): A = SLL(A); break;						/* SLL  A           */
+	OP_CASE(0x38): B = SRL(B); break;						/* SRL  B           */
+	OP_CASE(0x39): C = SRL(C); break;						/* SRL  C           */
+	OP_CASE(0x3a): D = SRL(D); break;						/* SRL  D           */
+	OP_CASE(0x3b): E = SRL(E); break;						/* SRL  E           */
+	OP_CASE(0x3c): H = SRL(H); break;						/* SRL  H           */
+	OP_CASE(0x3d): L = SRL(L); break;						/* SRL  L           */
+	OP_CASE(0x3e): v = SRL(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;		/* SRL  (HL)        */
+	OP_CASE(0x3f): A = SRL(A); break;						/* SRL  A           */
+	OP_CASE(0x40): BIT(0, B); break;						/* BIT  0,B         */
+	OP_CASE(0x41): BIT(0, C); break;						/* BIT  0,C         */
+	OP_CASE(0x42): BIT(0, D); break;						/* BIT  0,D         */
+	OP_CASE(0x43): BIT(0, E); break;						/* BIT  0,E         */
+	OP_CASE(0x44): BIT(0, H); break;						/* BIT  0,H         */
+	OP_CASE(0x45): BIT(0, L); break;						/* BIT  0,L         */
+	OP_CASE(0x46): v = RM8<PRIMARY>(HL); CLOCK_IN_OP(1); BIT_HL(0, v); break;		/* BIT  0,(HL)      */
+	OP_CASE(0x47): BIT(0, A); break;						/* BIT  0,A         */
+	OP_CASE(0x48): BIT(1, B); break;						/* BIT  1,B         */
+	OP_CASE(0x49): BIT(1, C); break;						/* BIT  1,C         */
+	OP_CASE(0x4a): BIT(1, D); break;						/* BIT  1,D         */
+	OP_CASE(0x4b): BIT(1, E); break;						/* BIT  1,E         */
+	OP_CASE(0x4c): BIT(1, H); break;						/* BIT  1,H         */
+	OP_CASE(0x4d): BIT(1, L); break;						/* BIT  1,L         */
+	OP_CASE(0x4e): v = RM8<PRIMARY>(HL); CLOCK_IN_OP(1); BIT_HL(1, v); break;		/* BIT  1,(HL)      */
+	OP_CASE(0x4f): BIT(1, A); break;						/* BIT  1,A         */
+	OP_CASE(0x50): BIT(2, B); break;						/* BIT  2,B         */
+	OP_CASE(0x51): BIT(2, C); break;						/* BIT  2,C         */
+	OP_CASE(0x52): BIT(2, D); break;						/* BIT  2,D         */
+	OP_CASE(0x53): BIT(2, E); break;						/* BIT  2,E         */
+	OP_CASE(0x54): BIT(2, H); break;						/* BIT  2,H         */
+	OP_CASE(0x55): BIT(2, L); break;						/* BIT  2,L         */
+	OP_CASE(0x56): v = RM8<PRIMARY>(HL); CLOCK_IN_OP(1); BIT_HL(2, v); break;		/* BIT  2,(HL)      */
+	OP_CASE(0x57): BIT(2, A); break;						/* BIT  2,A         */
+	OP_CASE(0x58): BIT(3, B); break;						/* BIT  3,B         */
+	OP_CASE(0x59): BIT(3, C); break;						/* BIT  3,C         */
+	OP_CASE(0x5a): BIT(3, D); break;						/* BIT  3,D         */
+	OP_CASE(0x5b): BIT(3, E); break;						/* BIT  3,E         */
+	OP_CASE(0x5c): BIT(3, H); break;						/* BIT  3,H         */
+	OP_CASE(0x5d): BIT(3, L); break;						/* BIT  3,L         */
+	OP_CASE(0x5e): v = RM8<PRIMARY>(HL); CLOCK_IN_OP(1); BIT_HL(3, v); break;		/* BIT  3,(HL)      */
+	OP_CASE(0x5f): BIT(3, A); break;						/* BIT  3,A         */
+	OP_CASE(0x60): BIT(4, B); break;						/* BIT  4,B         */
+	OP_CASE(0x61): BIT(4, C); break;						/* BIT  4,C         */
+	OP_CASE(0x62): BIT(4, D); break;						/* BIT  4,D         */
+	OP_CASE(0x63): BIT(4, E); break;						/* BIT  4,E         */
+	OP_CASE(0x64): BIT(4, H); break;						/* BIT  4,H         */
+	OP_CASE(0x65): BIT(4, L); break;						/* BIT  4,L         */
+	OP_CASE(0x66): v = RM8<PRIMARY>(HL); CLOCK_IN_OP(1); BIT_HL(4, v); break;		/* BIT  4,(HL)      */
+	OP_CASE(0x67): BIT(4, A); break;						/* BIT  4,A         */
+	OP_CASE(0x68): BIT(5, B); break;						/* BIT  5,B         */
+	OP_CASE(0x69): BIT(5, C); break;						/* BIT  5,C         */
+	OP_CASE(0x6a): BIT(5, D); break;						/* BIT  5,D         */
+	OP_CASE(0x6b): BIT(5, E); break;						/* BIT  5,E         */
+	OP_CASE(0x6c): BIT(5, H); break;						/* BIT  5,H         */
+	OP_CASE(0x6d): BIT(5, L); break;						/* BIT  5,L         */
+	OP_CASE(0x6e): v = RM8<PRIMARY>(HL); CLOCK_IN_OP(1); BIT_HL(5, v); break;		/* BIT  5,(HL)      */
+	OP_CASE(0x6f): BIT(5, A); break;						/* BIT  5,A         */
+	OP_CASE(0x70): BIT(6, B); break;						/* BIT  6,B         */
+	OP_CASE(0x71): BIT(6, C); break;						/* BIT  6,C         */
+	OP_CASE(0x72): BIT(6, D); break;						/* BIT  6,D         */
+	OP_CASE(0x73): BIT(6, E); break;						/* BIT  6,E         */
+	OP_CASE(0x74): BIT(6, H); break;						/* BIT  6,H         */
+	OP_CASE(0x75): BIT(6, L); break;						/* BIT  6,L         */
+	OP_CASE(0x76): v = RM8<PRIMARY>(HL); CLOCK_IN_OP(1); BIT_HL(6, v); break;		/* BIT  6,(HL)      */
+	OP_CASE(0x77): BIT(6, A); break;						/* BIT  6,A         */
+	OP_CASE(0x78): BIT(7, B); break;						/* BIT  7,B         */
+	OP_CASE(0x79): BIT(7, C); break;						/* BIT  7,C         */
+	OP_CASE(0x7a): BIT(7, D); break;						/* BIT  7,D         */
+	OP_CASE(0x7b): BIT(7, E); break;						/* BIT  7,E         */
+	OP_CASE(0x7c): BIT(7, H); break;						/* BIT  7,H         */
+	OP_CASE(0x7d): BIT(7, L); break;						/* BIT  7,L         */
+	OP_CASE(0x7e): v = RM8<PRIMARY>(HL); CLOCK_IN_OP(1); BIT_HL(7, v); break;		/* BIT  7,(HL)      */
+	OP_CASE(0x7f): BIT(7, A); break;						/* BIT  7,A         */
+	OP_CASE(0x80): B = RES(0, B); break;					/* RES  0,B         */
+	OP_CASE(0x81): C = RES(0, C); break;					/* RES  0,C         */
+	OP_CASE(0x82): D = RES(0, D); break;					/* RES  0,D         */
+	OP_CASE(0x83): E = RES(0, E); break;					/* RES  0,E         */
+	OP_CASE(0x84): H = RES(0, H); break;					/* RES  0,H         */
+	OP_CASE(0x85): L = RES(0, L); break;					/* RES  0,L         */
+	OP_CASE(0x86): v = RES(0, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* RES  0,(HL)      */
+	OP_CASE(0x87): A = RES(0, A); break;					/* RES  0,A         */
+	OP_CASE(0x88): B = RES(1, B); break;					/* RES  1,B         */
+	OP_CASE(0x89): C = RES(1, C); break;					/* RES  1,C         */
+	OP_CASE(0x8a): D = RES(1, D); break;					/* RES  1,D         */
+	OP_CASE(0x8b): E = RES(1, E); break;					/* RES  1,E         */
+	OP_CASE(0x8c): H = RES(1, H); break;					/* RES  1,H         */
+	OP_CASE(0x8d): L = RES(1, L); break;					/* RES  1,L         */
+	OP_CASE(0x8e): v = RES(1, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* RES  1,(HL)      */
+	OP_CASE(0x8f): A = RES(1, A); break;					/* RES  1,A         */
+	OP_CASE(0x90): B = RES(2, B); break;					/* RES  2,B         */
+	OP_CASE(0x91): C = RES(2, C); break;					/* RES  2,C         */
+	OP_CASE(0x92): D = RES(2, D); break;					/* RES  2,D         */
+	OP_CASE(0x93): E = RES(2, E); break;					/* RES  2,E         */
+	OP_CASE(0x94): H = RES(2, H); break;					/* RES  2,H         */
+	OP_CASE(0x95): L = RES(2, L); break;					/* RES  2,L         */
+	OP_CASE(0x96): v = RES(2, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* RES  2,(HL)      */
+	OP_CASE(0x97): A = RES(2, A); break;					/* RES  2,A         */
+	OP_CASE(0x98): B = RES(3, B); break;					/* RES  3,B         */
+	OP_CASE(0x99): C = RES(3, C); break;					/* RES  3,C         */
+	OP_CASE(0x9a): D = RES(3, D); break;					/* RES  3,D         */
+	OP_CASE(0x9b): E = RES(3, E); break;					/* RES  3,E         */
+	OP_CASE(0x9c): H = RES(3, H); break;					/* RES  3,H         */
+	OP_CASE(0x9d): L = RES(3, L); break;					/* RES  3,L         */
+	OP_CASE(0x9e): v = RES(3, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* RES  3,(HL)      */
+	OP_CASE(0x9f): A = RES(3, A); break;					/* RES  3,A         */
+	OP_CASE(0xa0): B = RES(4,	B); break;					/* RES  4,B         */
+	OP_CASE(0xa1): C = RES(4,	C); break;					/* RES  4,C         */
+	OP_CASE(0xa2): D = RES(4,	D); break;					/* RES  4,D         */
+	OP_CASE(0xa3): E = RES(4,	E); break;					/* RES  4,E         */
+	OP_CASE(0xa4): H = RES(4,	H); break;					/* RES  4,H         */
+	OP_CASE(0xa5): L = RES(4,	L); break;					/* RES  4,L         */
+	OP_CASE(0xa6): v = RES(4, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* RES  4,(HL)      */
+	OP_CASE(0xa7): A = RES(4,	A); break;					/* RES  4,A         */
+	OP_CASE(0xa8): B = RES(5, B); break;					/* RES  5,B         */
+	OP_CASE(0xa9): C = RES(5, C); break;					/* RES  5,C         */
+	OP_CASE(0xaa): D = RES(5, D); break;					/* RES  5,D         */
+	OP_CASE(0xab): E = RES(5, E); break;					/* RES  5,E         */
+	OP_CASE(0xac): H = RES(5, H); break;					/* RES  5,H         */
+	OP_CASE(0xad): L = RES(5, L); break;					/* RES  5,L         */
+	OP_CASE(0xae): v = RES(5, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* RES  5,(HL)      */
+	OP_CASE(0xaf): A = RES(5, A); break;					/* RES  5,A         */
+	OP_CASE(0xb0): B = RES(6, B); break;					/* RES  6,B         */
+	OP_CASE(0xb1): C = RES(6, C); break;					/* RES  6,C         */
+	OP_CASE(0xb2): D = RES(6, D); break;					/* RES  6,D         */
+	OP_CASE(0xb3): E = RES(6, E); break;					/* RES  6,E         */
+	OP_CASE(0xb4): H = RES(6, H); break;					/* RES  6,H         */
+	OP_CASE(0xb5): L = RES(6, L); break;					/* RES  6,L         */
+	OP_CASE(0xb6): v = RES(6, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* RES  6,(HL)      */
+	OP_CASE(0xb7): A = RES(6, A); break;					/* RES  6,A         */
+	OP_CASE(0xb8): B = RES(7, B); break;					/* RES  7,B         */
+	OP_CASE(0xb9): C = RES(7, C); break;					/* RES  7,C         */
+	OP_CASE(0xba): D = RES(7, D); break;					/* RES  7,D         */
+	OP_CASE(0xbb): E = RES(7, E); break;					/* RES  7,E         */
+	OP_CASE(0xbc): H = RES(7, H); break;					/* RES  7,H         */
+	OP_CASE(0xbd): L = RES(7, L); break;					/* RES  7,L         */
+	OP_CASE(0xbe): v = RES(7, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* RES  7,(HL)      */
+	OP_CASE(0xbf): A = RES(7, A); break;					/* RES  7,A         */
+	OP_CASE(0xc0): B = SET(0, B); break;					/* SET  0,B         */
+	OP_CASE(0xc1): C = SET(0, C); break;					/* SET  0,C         */
+	OP_CASE(0xc2): D = SET(0, D); break;					/* SET  0,D         */
+	OP_CASE(0xc3): E = SET(0, E); break;					/* SET  0,E         */
+	OP_CASE(0xc4): H = SET(0, H); break;					/* SET  0,H         */
+	OP_CASE(0xc5): L = SET(0, L); break;					/* SET  0,L         */
+	OP_CASE(0xc6): v = SET(0, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* SET  0,(HL)      */
+	OP_CASE(0xc7): A = SET(0, A); break;					/* SET  0,A         */
+	OP_CASE(0xc8): B = SET(1, B); break;					/* SET  1,B         */
+	OP_CASE(0xc9): C = SET(1, C); break;					/* SET  1,C         */
+	OP_CASE(0xca): D = SET(1, D); break;					/* SET  1,D         */
+	OP_CASE(0xcb): E = SET(1, E); break;					/* SET  1,E         */
+	OP_CASE(0xcc): H = SET(1, H); break;					/* SET  1,H         */
+	OP_CASE(0xcd): L = SET(1, L); break;					/* SET  1,L         */
+	OP_CASE(0xce): v = SET(1, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* SET  1,(HL)      */
+	OP_CASE(0xcf): A = SET(1, A); break;					/* SET  1,A         */
+	OP_CASE(0xd0): B = SET(2, B); break;					/* SET  2,B         */
+	OP_CASE(0xd1): C = SET(2, C); break;					/* SET  2,C         */
+	OP_CASE(0xd2): D = SET(2, D); break;					/* SET  2,D         */
+	OP_CASE(0xd3): E = SET(2, E); break;					/* SET  2,E         */
+	OP_CASE(0xd4): H = SET(2, H); break;					/* SET  2,H         */
+	OP_CASE(0xd5): L = SET(2, L); break;					/* SET  2,L         */
+	OP_CASE(0xd6): v = SET(2, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* SET  2,(HL)      */
+	OP_CASE(0xd7): A = SET(2, A); break;					/* SET  2,A         */
+	OP_CASE(0xd8): B = SET(3, B); break;					/* SET  3,B         */
+	OP_CASE(0xd9): C = SET(3, C); break;					/* SET  3,C         */
+	OP_CASE(0xda): D = SET(3, D); break;					/* SET  3,D         */
+	OP_CASE(0xdb): E = SET(3, E); break;					/* SET  3,E         */
+	OP_CASE(0xdc): H = SET(3, H); break;					/* SET  3,H         */
+	OP_CASE(0xdd): L = SET(3, L); break;					/* SET  3,L         */
+	OP_CASE(0xde): v = SET(3, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* SET  3,(HL)      */
+	OP_CASE(0xdf): A = SET(3, A); break;					/* SET  3,A         */
+	OP_CASE(0xe0): B = SET(4, B); break;					/* SET  4,B         */
+	OP_CASE(0xe1): C = SET(4, C); break;					/* SET  4,C         */
+	OP_CASE(0xe2): D = SET(4, D); break;					/* SET  4,D         */
+	OP_CASE(0xe3): E = SET(4, E); break;					/* SET  4,E         */
+	OP_CASE(0xe4): H = SET(4, H); break;					/* SET  4,H         */
+	OP_CASE(0xe5): L = SET(4, L); break;					/* SET  4,L         */
+	OP_CASE(0xe6): v = SET(4, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* SET  4,(HL)      */
+	OP_CASE(0xe7): A = SET(4, A); break;					/* SET  4,A         */
+	OP_CASE(0xe8): B = SET(5, B); break;					/* SET  5,B         */
+	OP_CASE(0xe9): C = SET(5, C); break;					/* SET  5,C         */
+	OP_CASE(0xea): D = SET(5, D); break;					/* SET  5,D         */
+	OP_CASE(0xeb): E = SET(5, E); break;					/* SET  5,E         */
+	OP_CASE(0xec): H = SET(5, H); break;					/* SET  5,H         */
+	OP_CASE(0xed): L = SET(5, L); break;					/* SET  5,L         */
+	OP_CASE(0xee): v = SET(5, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* SET  5,(HL)      */
+	OP_CASE(0xef): A = SET(5, A); break;					/* SET  5,A         */
+	OP_CASE(0xf0): B = SET(6, B); break;					/* SET  6,B         */
+	OP_CASE(0xf1): C = SET(6, C); break;					/* SET  6,C         */
+	OP_CASE(0xf2): D = SET(6, D); break;					/* SET  6,D         */
+	OP_CASE(0xf3): E = SET(6, E); break;					/* SET  6,E         */
+	OP_CASE(0xf4): H = SET(6, H); break;					/* SET  6,H         */
+	OP_CASE(0xf5): L = SET(6, L); break;					/* SET  6,L         */
+	OP_CASE(0xf6): v = SET(6, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* SET  6,(HL)      */
+	OP_CASE(0xf7): A = SET(6, A); break;					/* SET  6,A         */
+	OP_CASE(0xf8): B = SET(7, B); break;					/* SET  7,B         */
+	OP_CASE(0xf9): C = SET(7, C); break;					/* SET  7,C         */
+	OP_CASE(0xfa): D = SET(7, D); break;					/* SET  7,D         */
+	OP_CASE(0xfb): E = SET(7, E); break;					/* SET  7,E         */
+	OP_CASE(0xfc): H = SET(7, H); break;					/* SET  7,H         */
+	OP_CASE(0xfd): L = SET(7, L); break;					/* SET  7,L         */
+	OP_CASE(0xfe): v = SET(7, RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;	/* SET  7,(HL)      */
+	OP_CASE(0xff): A = SET(7, A); break;					/* SET  7,A         */
 #if defined(_MSC_VER) && (_MSC_VER >= 1200)
 	default: __assume(0);
 #endif
-	}
+	} OP_DISPATCH_END;
 }
 
+template <bool PRIMARY, bool CACHED>
 void Z80::OP_XY(uint8_t code)
 {
 	// Done: M1 + M1 + R + R + 2
@@ -1175,269 +1381,273 @@ void Z80::OP_XY(uint8_t code)
 	
 	icount -= cc_xycb[code];
 	
-	switch(code) {
-	case 0x00: B = RLC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;		/* RLC  B=(XY+o)    */
-	case 0x01: C = RLC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;		/* RLC  C=(XY+o)    */
-	case 0x02: D = RLC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;		/* RLC  D=(XY+o)    */
-	case 0x03: E = RLC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;		/* RLC  E=(XY+o)    */
-	case 0x04: H = RLC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;		/* RLC  H=(XY+o)    */
-	case 0x05: L = RLC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;		/* RLC  L=(XY+o)    */
-	case 0x06: v = RLC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;		/* RLC  (XY+o)      */
-	case 0x07: A = RLC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;		/* RLC  A=(XY+o)    */
-	case 0x08: B = RRC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;		/* RRC  B=(XY+o)    */
-	case 0x09: C = RRC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;		/* RRC  C=(XY+o)    */
-	case 0x0a: D = RRC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;		/* RRC  D=(XY+o)    */
-	case 0x0b: E = RRC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;		/* RRC  E=(XY+o)    */
-	case 0x0c: H = RRC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;		/* RRC  H=(XY+o)    */
-	case 0x0d: L = RRC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;		/* RRC  L=(XY+o)    */
-	case 0x0e: v = RRC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;		/* RRC  (XY+o)      */
-	case 0x0f: A = RRC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;		/* RRC  A=(XY+o)    */
-	case 0x10: B = RL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;		/* RL   B=(XY+o)    */
-	case 0x11: C = RL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;		/* RL   C=(XY+o)    */
-	case 0x12: D = RL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;		/* RL   D=(XY+o)    */
-	case 0x13: E = RL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;		/* RL   E=(XY+o)    */
-	case 0x14: H = RL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;		/* RL   H=(XY+o)    */
-	case 0x15: L = RL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;		/* RL   L=(XY+o)    */
-	case 0x16: v = RL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;		/* RL   (XY+o)      */
-	case 0x17: A = RL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;		/* RL   A=(XY+o)    */
-	case 0x18: B = RR(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;		/* RR   B=(XY+o)    */
-	case 0x19: C = RR(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;		/* RR   C=(XY+o)    */
-	case 0x1a: D = RR(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;		/* RR   D=(XY+o)    */
-	case 0x1b: E = RR(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;		/* RR   E=(XY+o)    */
-	case 0x1c: H = RR(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;		/* RR   H=(XY+o)    */
-	case 0x1d: L = RR(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;		/* RR   L=(XY+o)    */
-	case 0x1e: v = RR(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;		/* RR   (XY+o)      */
-	case 0x1f: A = RR(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;		/* RR   A=(XY+o)    */
-	case 0x20: B = SLA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;		/* SLA  B=(XY+o)    */
-	case 0x21: C = SLA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;		/* SLA  C=(XY+o)    */
-	case 0x22: D = SLA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;		/* SLA  D=(XY+o)    */
-	case 0x23: E = SLA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;		/* SLA  E=(XY+o)    */
-	case 0x24: H = SLA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;		/* SLA  H=(XY+o)    */
-	case 0x25: L = SLA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;		/* SLA  L=(XY+o)    */
-	case 0x26: v = SLA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;		/* SLA  (XY+o)      */
-	case 0x27: A = SLA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;		/* SLA  A=(XY+o)    */
-	case 0x28: B = SRA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;		/* SRA  B=(XY+o)    */
-	case 0x29: C = SRA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;		/* SRA  C=(XY+o)    */
-	case 0x2a: D = SRA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;		/* SRA  D=(XY+o)    */
-	case 0x2b: E = SRA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;		/* SRA  E=(XY+o)    */
-	case 0x2c: H = SRA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;		/* SRA  H=(XY+o)    */
-	case 0x2d: L = SRA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;		/* SRA  L=(XY+o)    */
-	case 0x2e: v = SRA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;		/* SRA  (XY+o)      */
-	case 0x2f: A = SRA(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;		/* SRA  A=(XY+o)    */
-	case 0x30: B = SLL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;		/* SLL  B=(XY+o)    */
-	case 0x31: C = SLL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;		/* SLL  C=(XY+o)    */
-	case 0x32: D = SLL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;		/* SLL  D=(XY+o)    */
-	case 0x33: E = SLL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;		/* SLL  E=(XY+o)    */
-	case 0x34: H = SLL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;		/* SLL  H=(XY+o)    */
-	case 0x35: L = SLL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;		/* SLL  L=(XY+o)    */
-	case 0x36: v = SLL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;		/* SLL  (XY+o)      */
-	case 0x37: A = SLL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;		/* SLL  A=(XY+o)    */
-	case 0x38: B = SRL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;		/* SRL  B=(XY+o)    */
-	case 0x39: C = SRL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;		/* SRL  C=(XY+o)    */
-	case 0x3a: D = SRL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;		/* SRL  D=(XY+o)    */
-	case 0x3b: E = SRL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;		/* SRL  E=(XY+o)    */
-	case 0x3c: H = SRL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;		/* SRL  H=(XY+o)    */
-	case 0x3d: L = SRL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;		/* SRL  L=(XY+o)    */
-	case 0x3e: v = SRL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;		/* SRL  (XY+o)      */
-	case 0x3f: A = SRL(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;		/* SRL  A=(XY+o)    */
-	case 0x40: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
-	case 0x41: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
-	case 0x42: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
-	case 0x43: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
-	case 0x44: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
-	case 0x45: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
-	case 0x46: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
-	case 0x47: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
-	case 0x48: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
-	case 0x49: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
-	case 0x4a: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
-	case 0x4b: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
-	case 0x4c: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
-	case 0x4d: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
-	case 0x4e: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
-	case 0x4f: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
-	case 0x50: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
-	case 0x51: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
-	case 0x52: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
-	case 0x53: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
-	case 0x54: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
-	case 0x55: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
-	case 0x56: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
-	case 0x57: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
-	case 0x58: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
-	case 0x59: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
-	case 0x5a: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
-	case 0x5b: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
-	case 0x5c: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
-	case 0x5d: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
-	case 0x5e: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
-	case 0x5f: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
-	case 0x60: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
-	case 0x61: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
-	case 0x62: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
-	case 0x63: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
-	case 0x64: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
-	case 0x65: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
-	case 0x66: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
-	case 0x67: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
-	case 0x68: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
-	case 0x69: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
-	case 0x6a: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
-	case 0x6b: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
-	case 0x6c: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
-	case 0x6d: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
-	case 0x6e: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
-	case 0x6f: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
-	case 0x70: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
-	case 0x71: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
-	case 0x72: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
-	case 0x73: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
-	case 0x74: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
-	case 0x75: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
-	case 0x76: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
-	case 0x77: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
-	case 0x78: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
-	case 0x79: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
-	case 0x7a: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
-	case 0x7b: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
-	case 0x7c: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
-	case 0x7d: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
-	case 0x7e: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
-	case 0x7f: v = RM8(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
-	case 0x80: B = RES(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* RES  0,B=(XY+o)  */
-	case 0x81: C = RES(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* RES  0,C=(XY+o)  */
-	case 0x82: D = RES(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* RES  0,D=(XY+o)  */
-	case 0x83: E = RES(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* RES  0,E=(XY+o)  */
-	case 0x84: H = RES(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* RES  0,H=(XY+o)  */
-	case 0x85: L = RES(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* RES  0,L=(XY+o)  */
-	case 0x86: v = RES(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* RES  0,(XY+o)    */
-	case 0x87: A = RES(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* RES  0,A=(XY+o)  */
-	case 0x88: B = RES(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* RES  1,B=(XY+o)  */
-	case 0x89: C = RES(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* RES  1,C=(XY+o)  */
-	case 0x8a: D = RES(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* RES  1,D=(XY+o)  */
-	case 0x8b: E = RES(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* RES  1,E=(XY+o)  */
-	case 0x8c: H = RES(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* RES  1,H=(XY+o)  */
-	case 0x8d: L = RES(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* RES  1,L=(XY+o)  */
-	case 0x8e: v = RES(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* RES  1,(XY+o)    */
-	case 0x8f: A = RES(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* RES  1,A=(XY+o)  */
-	case 0x90: B = RES(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* RES  2,B=(XY+o)  */
-	case 0x91: C = RES(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* RES  2,C=(XY+o)  */
-	case 0x92: D = RES(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* RES  2,D=(XY+o)  */
-	case 0x93: E = RES(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* RES  2,E=(XY+o)  */
-	case 0x94: H = RES(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* RES  2,H=(XY+o)  */
-	case 0x95: L = RES(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* RES  2,L=(XY+o)  */
-	case 0x96: v = RES(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* RES  2,(XY+o)    */
-	case 0x97: A = RES(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* RES  2,A=(XY+o)  */
-	case 0x98: B = RES(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* RES  3,B=(XY+o)  */
-	case 0x99: C = RES(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* RES  3,C=(XY+o)  */
-	case 0x9a: D = RES(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* RES  3,D=(XY+o)  */
-	case 0x9b: E = RES(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* RES  3,E=(XY+o)  */
-	case 0x9c: H = RES(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* RES  3,H=(XY+o)  */
-	case 0x9d: L = RES(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* RES  3,L=(XY+o)  */
-	case 0x9e: v = RES(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* RES  3,(XY+o)    */
-	case 0x9f: A = RES(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* RES  3,A=(XY+o)  */
-	case 0xa0: B = RES(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* RES  4,B=(XY+o)  */
-	case 0xa1: C = RES(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* RES  4,C=(XY+o)  */
-	case 0xa2: D = RES(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* RES  4,D=(XY+o)  */
-	case 0xa3: E = RES(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* RES  4,E=(XY+o)  */
-	case 0xa4: H = RES(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* RES  4,H=(XY+o)  */
-	case 0xa5: L = RES(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* RES  4,L=(XY+o)  */
-	case 0xa6: v = RES(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* RES  4,(XY+o)    */
-	case 0xa7: A = RES(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* RES  4,A=(XY+o)  */
-	case 0xa8: B = RES(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* RES  5,B=(XY+o)  */
-	case 0xa9: C = RES(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* RES  5,C=(XY+o)  */
-	case 0xaa: D = RES(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* RES  5,D=(XY+o)  */
-	case 0xab: E = RES(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* RES  5,E=(XY+o)  */
-	case 0xac: H = RES(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* RES  5,H=(XY+o)  */
-	case 0xad: L = RES(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* RES  5,L=(XY+o)  */
-	case 0xae: v = RES(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* RES  5,(XY+o)    */
-	case 0xaf: A = RES(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* RES  5,A=(XY+o)  */
-	case 0xb0: B = RES(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* RES  6,B=(XY+o)  */
-	case 0xb1: C = RES(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* RES  6,C=(XY+o)  */
-	case 0xb2: D = RES(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* RES  6,D=(XY+o)  */
-	case 0xb3: E = RES(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* RES  6,E=(XY+o)  */
-	case 0xb4: H = RES(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* RES  6,H=(XY+o)  */
-	case 0xb5: L = RES(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* RES  6,L=(XY+o)  */
-	case 0xb6: v = RES(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* RES  6,(XY+o)    */
-	case 0xb7: A = RES(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* RES  6,A=(XY+o)  */
-	case 0xb8: B = RES(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* RES  7,B=(XY+o)  */
-	case 0xb9: C = RES(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* RES  7,C=(XY+o)  */
-	case 0xba: D = RES(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* RES  7,D=(XY+o)  */
-	case 0xbb: E = RES(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* RES  7,E=(XY+o)  */
-	case 0xbc: H = RES(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* RES  7,H=(XY+o)  */
-	case 0xbd: L = RES(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* RES  7,L=(XY+o)  */
-	case 0xbe: v = RES(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* RES  7,(XY+o)    */
-	case 0xbf: A = RES(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* RES  7,A=(XY+o)  */
-	case 0xc0: B = SET(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* SET  0,B=(XY+o)  */
-	case 0xc1: C = SET(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* SET  0,C=(XY+o)  */
-	case 0xc2: D = SET(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* SET  0,D=(XY+o)  */
-	case 0xc3: E = SET(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* SET  0,E=(XY+o)  */
-	case 0xc4: H = SET(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* SET  0,H=(XY+o)  */
-	case 0xc5: L = SET(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* SET  0,L=(XY+o)  */
-	case 0xc6: v = SET(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* SET  0,(XY+o)    */
-	case 0xc7: A = SET(0, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* SET  0,A=(XY+o)  */
-	case 0xc8: B = SET(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* SET  1,B=(XY+o)  */
-	case 0xc9: C = SET(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* SET  1,C=(XY+o)  */
-	case 0xca: D = SET(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* SET  1,D=(XY+o)  */
-	case 0xcb: E = SET(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* SET  1,E=(XY+o)  */
-	case 0xcc: H = SET(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* SET  1,H=(XY+o)  */
-	case 0xcd: L = SET(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* SET  1,L=(XY+o)  */
-	case 0xce: v = SET(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* SET  1,(XY+o)    */
-	case 0xcf: A = SET(1, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* SET  1,A=(XY+o)  */
-	case 0xd0: B = SET(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* SET  2,B=(XY+o)  */
-	case 0xd1: C = SET(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* SET  2,C=(XY+o)  */
-	case 0xd2: D = SET(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* SET  2,D=(XY+o)  */
-	case 0xd3: E = SET(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* SET  2,E=(XY+o)  */
-	case 0xd4: H = SET(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* SET  2,H=(XY+o)  */
-	case 0xd5: L = SET(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* SET  2,L=(XY+o)  */
-	case 0xd6: v = SET(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* SET  2,(XY+o)    */
-	case 0xd7: A = SET(2, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* SET  2,A=(XY+o)  */
-	case 0xd8: B = SET(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* SET  3,B=(XY+o)  */
-	case 0xd9: C = SET(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* SET  3,C=(XY+o)  */
-	case 0xda: D = SET(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* SET  3,D=(XY+o)  */
-	case 0xdb: E = SET(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* SET  3,E=(XY+o)  */
-	case 0xdc: H = SET(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* SET  3,H=(XY+o)  */
-	case 0xdd: L = SET(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* SET  3,L=(XY+o)  */
-	case 0xde: v = SET(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* SET  3,(XY+o)    */
-	case 0xdf: A = SET(3, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* SET  3,A=(XY+o)  */
-	case 0xe0: B = SET(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* SET  4,B=(XY+o)  */
-	case 0xe1: C = SET(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* SET  4,C=(XY+o)  */
-	case 0xe2: D = SET(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* SET  4,D=(XY+o)  */
-	case 0xe3: E = SET(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* SET  4,E=(XY+o)  */
-	case 0xe4: H = SET(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* SET  4,H=(XY+o)  */
-	case 0xe5: L = SET(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* SET  4,L=(XY+o)  */
-	case 0xe6: v = SET(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* SET  4,(XY+o)    */
-	case 0xe7: A = SET(4, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* SET  4,A=(XY+o)  */
-	case 0xe8: B = SET(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* SET  5,B=(XY+o)  */
-	case 0xe9: C = SET(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* SET  5,C=(XY+o)  */
-	case 0xea: D = SET(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* SET  5,D=(XY+o)  */
-	case 0xeb: E = SET(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* SET  5,E=(XY+o)  */
-	case 0xec: H = SET(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* SET  5,H=(XY+o)  */
-	case 0xed: L = SET(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* SET  5,L=(XY+o)  */
-	case 0xee: v = SET(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* SET  5,(XY+o)    */
-	case 0xef: A = SET(5, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* SET  5,A=(XY+o)  */
-	case 0xf0: B = SET(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* SET  6,B=(XY+o)  */
-	case 0xf1: C = SET(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* SET  6,C=(XY+o)  */
-	case 0xf2: D = SET(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* SET  6,D=(XY+o)  */
-	case 0xf3: E = SET(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* SET  6,E=(XY+o)  */
-	case 0xf4: H = SET(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* SET  6,H=(XY+o)  */
-	case 0xf5: L = SET(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* SET  6,L=(XY+o)  */
-	case 0xf6: v = SET(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* SET  6,(XY+o)    */
-	case 0xf7: A = SET(6, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* SET  6,A=(XY+o)  */
-	case 0xf8: B = SET(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, B); break;	/* SET  7,B=(XY+o)  */
-	case 0xf9: C = SET(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, C); break;	/* SET  7,C=(XY+o)  */
-	case 0xfa: D = SET(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, D); break;	/* SET  7,D=(XY+o)  */
-	case 0xfb: E = SET(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, E); break;	/* SET  7,E=(XY+o)  */
-	case 0xfc: H = SET(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, H); break;	/* SET  7,H=(XY+o)  */
-	case 0xfd: L = SET(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, L); break;	/* SET  7,L=(XY+o)  */
-	case 0xfe: v = SET(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* SET  7,(XY+o)    */
-	case 0xff: A = SET(7, RM8(ea)); CLOCK_IN_OP(1); WM8(ea, A); break;	/* SET  7,A=(XY+o)  */
+#ifdef Z80_USE_COMPUTED_GOTO
+	static const void* const op_table[256] = OP_TABLE_ALL;
+#endif
+	OP_DISPATCH(op_table, code) {
+	OP_CASE(0x00): B = RLC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;		/* RLC  B=(XY+o)    */
+	OP_CASE(0x01): C = RLC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;		/* RLC  C=(XY+o)    */
+	OP_CASE(0x02): D = RLC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;		/* RLC  D=(XY+o)    */
+	OP_CASE(0x03): E = RLC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;		/* RLC  E=(XY+o)    */
+	OP_CASE(0x04): H = RLC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;		/* RLC  H=(XY+o)    */
+	OP_CASE(0x05): L = RLC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;		/* RLC  L=(XY+o)    */
+	OP_CASE(0x06): v = RLC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;		/* RLC  (XY+o)      */
+	OP_CASE(0x07): A = RLC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;		/* RLC  A=(XY+o)    */
+	OP_CASE(0x08): B = RRC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;		/* RRC  B=(XY+o)    */
+	OP_CASE(0x09): C = RRC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;		/* RRC  C=(XY+o)    */
+	OP_CASE(0x0a): D = RRC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;		/* RRC  D=(XY+o)    */
+	OP_CASE(0x0b): E = RRC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;		/* RRC  E=(XY+o)    */
+	OP_CASE(0x0c): H = RRC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;		/* RRC  H=(XY+o)    */
+	OP_CASE(0x0d): L = RRC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;		/* RRC  L=(XY+o)    */
+	OP_CASE(0x0e): v = RRC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;		/* RRC  (XY+o)      */
+	OP_CASE(0x0f): A = RRC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;		/* RRC  A=(XY+o)    */
+	OP_CASE(0x10): B = RL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;		/* RL   B=(XY+o)    */
+	OP_CASE(0x11): C = RL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;		/* RL   C=(XY+o)    */
+	OP_CASE(0x12): D = RL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;		/* RL   D=(XY+o)    */
+	OP_CASE(0x13): E = RL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;		/* RL   E=(XY+o)    */
+	OP_CASE(0x14): H = RL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;		/* RL   H=(XY+o)    */
+	OP_CASE(0x15): L = RL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;		/* RL   L=(XY+o)    */
+	OP_CASE(0x16): v = RL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;		/* RL   (XY+o)      */
+	OP_CASE(0x17): A = RL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;		/* RL   A=(XY+o)    */
+	OP_CASE(0x18): B = RR(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;		/* RR   B=(XY+o)    */
+	OP_CASE(0x19): C = RR(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;		/* RR   C=(XY+o)    */
+	OP_CASE(0x1a): D = RR(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;		/* RR   D=(XY+o)    */
+	OP_CASE(0x1b): E = RR(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;		/* RR   E=(XY+o)    */
+	OP_CASE(0x1c): H = RR(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;		/* RR   H=(XY+o)    */
+	OP_CASE(0x1d): L = RR(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;		/* RR   L=(XY+o)    */
+	OP_CASE(0x1e): v = RR(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;		/* RR   (XY+o)      */
+	OP_CASE(0x1f): A = RR(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;		/* RR   A=(XY+o)    */
+	OP_CASE(0x20): B = SLA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;		/* SLA  B=(XY+o)    */
+	OP_CASE(0x21): C = SLA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;		/* SLA  C=(XY+o)    */
+	OP_CASE(0x22): D = SLA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;		/* SLA  D=(XY+o)    */
+	OP_CASE(0x23): E = SLA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;		/* SLA  E=(XY+o)    */
+	OP_CASE(0x24): H = SLA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;		/* SLA  H=(XY+o)    */
+	OP_CASE(0x25): L = SLA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;		/* SLA  L=(XY+o)    */
+	OP_CASE(0x26): v = SLA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;		/* SLA  (XY+o)      */
+	OP_CASE(0x27): A = SLA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;		/* SLA  A=(XY+o)    */
+	OP_CASE(0x28): B = SRA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;		/* SRA  B=(XY+o)    */
+	OP_CASE(0x29): C = SRA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;		/* SRA  C=(XY+o)    */
+	OP_CASE(0x2a): D = SRA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;		/* SRA  D=(XY+o)    */
+	OP_CASE(0x2b): E = SRA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;		/* SRA  E=(XY+o)    */
+	OP_CASE(0x2c): H = SRA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;		/* SRA  H=(XY+o)    */
+	OP_CASE(0x2d): L = SRA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;		/* SRA  L=(XY+o)    */
+	OP_CASE(0x2e): v = SRA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;		/* SRA  (XY+o)      */
+	OP_CASE(0x2f): A = SRA(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;		/* SRA  A=(XY+o)    */
+	OP_CASE(0x30): B = SLL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;		/* SLL  B=(XY+o)    */
+	OP_CASE(0x31): C = SLL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;		/* SLL  C=(XY+o)    */
+	OP_CASE(0x32): D = SLL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;		/* SLL  D=(XY+o)    */
+	OP_CASE(0x33): E = SLL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;		/* SLL  E=(XY+o)    */
+	OP_CASE(0x34): H = SLL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;		/* SLL  H=(XY+o)    */
+	OP_CASE(0x35): L = SLL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;		/* SLL  L=(XY+o)    */
+	OP_CASE(0x36): v = SLL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;		/* SLL  (XY+o)      */
+	OP_CASE(0x37): A = SLL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;		/* SLL  A=(XY+o)    */
+	OP_CASE(0x38): B = SRL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;		/* SRL  B=(XY+o)    */
+	OP_CASE(0x39): C = SRL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;		/* SRL  C=(XY+o)    */
+	OP_CASE(0x3a): D = SRL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;		/* SRL  D=(XY+o)    */
+	OP_CASE(0x3b): E = SRL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;		/* SRL  E=(XY+o)    */
+	OP_CASE(0x3c): H = SRL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;		/* SRL  H=(XY+o)    */
+	OP_CASE(0x3d): L = SRL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;		/* SRL  L=(XY+o)    */
+	OP_CASE(0x3e): v = SRL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;		/* SRL  (XY+o)      */
+	OP_CASE(0x3f): A = SRL(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;		/* SRL  A=(XY+o)    */
+	OP_CASE(0x40): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
+	OP_CASE(0x41): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
+	OP_CASE(0x42): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
+	OP_CASE(0x43): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
+	OP_CASE(0x44): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
+	OP_CASE(0x45): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
+	OP_CASE(0x46): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
+	OP_CASE(0x47): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(0, v); break;		/* BIT  0,(XY+o)    */
+	OP_CASE(0x48): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
+	OP_CASE(0x49): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
+	OP_CASE(0x4a): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
+	OP_CASE(0x4b): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
+	OP_CASE(0x4c): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
+	OP_CASE(0x4d): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
+	OP_CASE(0x4e): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
+	OP_CASE(0x4f): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(1, v); break;		/* BIT  1,(XY+o)    */
+	OP_CASE(0x50): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
+	OP_CASE(0x51): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
+	OP_CASE(0x52): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
+	OP_CASE(0x53): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
+	OP_CASE(0x54): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
+	OP_CASE(0x55): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
+	OP_CASE(0x56): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
+	OP_CASE(0x57): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(2, v); break;		/* BIT  2,(XY+o)    */
+	OP_CASE(0x58): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
+	OP_CASE(0x59): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
+	OP_CASE(0x5a): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
+	OP_CASE(0x5b): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
+	OP_CASE(0x5c): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
+	OP_CASE(0x5d): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
+	OP_CASE(0x5e): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
+	OP_CASE(0x5f): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(3, v); break;		/* BIT  3,(XY+o)    */
+	OP_CASE(0x60): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
+	OP_CASE(0x61): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
+	OP_CASE(0x62): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
+	OP_CASE(0x63): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
+	OP_CASE(0x64): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
+	OP_CASE(0x65): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
+	OP_CASE(0x66): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
+	OP_CASE(0x67): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(4, v); break;		/* BIT  4,(XY+o)    */
+	OP_CASE(0x68): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
+	OP_CASE(0x69): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
+	OP_CASE(0x6a): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
+	OP_CASE(0x6b): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
+	OP_CASE(0x6c): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
+	OP_CASE(0x6d): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
+	OP_CASE(0x6e): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
+	OP_CASE(0x6f): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(5, v); break;		/* BIT  5,(XY+o)    */
+	OP_CASE(0x70): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
+	OP_CASE(0x71): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
+	OP_CASE(0x72): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
+	OP_CASE(0x73): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
+	OP_CASE(0x74): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
+	OP_CASE(0x75): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
+	OP_CASE(0x76): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
+	OP_CASE(0x77): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(6, v); break;		/* BIT  6,(XY+o)    */
+	OP_CASE(0x78): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
+	OP_CASE(0x79): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
+	OP_CASE(0x7a): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
+	OP_CASE(0x7b): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
+	OP_CASE(0x7c): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
+	OP_CASE(0x7d): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
+	OP_CASE(0x7e): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
+	OP_CASE(0x7f): v = RM8<PRIMARY>(ea); CLOCK_IN_OP(1); BIT_XY(7, v); break;		/* BIT  7,(XY+o)    */
+	OP_CASE(0x80): B = RES(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* RES  0,B=(XY+o)  */
+	OP_CASE(0x81): C = RES(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* RES  0,C=(XY+o)  */
+	OP_CASE(0x82): D = RES(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* RES  0,D=(XY+o)  */
+	OP_CASE(0x83): E = RES(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* RES  0,E=(XY+o)  */
+	OP_CASE(0x84): H = RES(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* RES  0,H=(XY+o)  */
+	OP_CASE(0x85): L = RES(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* RES  0,L=(XY+o)  */
+	OP_CASE(0x86): v = RES(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* RES  0,(XY+o)    */
+	OP_CASE(0x87): A = RES(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* RES  0,A=(XY+o)  */
+	OP_CASE(0x88): B = RES(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* RES  1,B=(XY+o)  */
+	OP_CASE(0x89): C = RES(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* RES  1,C=(XY+o)  */
+	OP_CASE(0x8a): D = RES(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* RES  1,D=(XY+o)  */
+	OP_CASE(0x8b): E = RES(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* RES  1,E=(XY+o)  */
+	OP_CASE(0x8c): H = RES(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* RES  1,H=(XY+o)  */
+	OP_CASE(0x8d): L = RES(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* RES  1,L=(XY+o)  */
+	OP_CASE(0x8e): v = RES(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* RES  1,(XY+o)    */
+	OP_CASE(0x8f): A = RES(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* RES  1,A=(XY+o)  */
+	OP_CASE(0x90): B = RES(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* RES  2,B=(XY+o)  */
+	OP_CASE(0x91): C = RES(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* RES  2,C=(XY+o)  */
+	OP_CASE(0x92): D = RES(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* RES  2,D=(XY+o)  */
+	OP_CASE(0x93): E = RES(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* RES  2,E=(XY+o)  */
+	OP_CASE(0x94): H = RES(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* RES  2,H=(XY+o)  */
+	OP_CASE(0x95): L = RES(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* RES  2,L=(XY+o)  */
+	OP_CASE(0x96): v = RES(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* RES  2,(XY+o)    */
+	OP_CASE(0x97): A = RES(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* RES  2,A=(XY+o)  */
+	OP_CASE(0x98): B = RES(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* RES  3,B=(XY+o)  */
+	OP_CASE(0x99): C = RES(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* RES  3,C=(XY+o)  */
+	OP_CASE(0x9a): D = RES(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* RES  3,D=(XY+o)  */
+	OP_CASE(0x9b): E = RES(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* RES  3,E=(XY+o)  */
+	OP_CASE(0x9c): H = RES(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* RES  3,H=(XY+o)  */
+	OP_CASE(0x9d): L = RES(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* RES  3,L=(XY+o)  */
+	OP_CASE(0x9e): v = RES(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* RES  3,(XY+o)    */
+	OP_CASE(0x9f): A = RES(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* RES  3,A=(XY+o)  */
+	OP_CASE(0xa0): B = RES(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* RES  4,B=(XY+o)  */
+	OP_CASE(0xa1): C = RES(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* RES  4,C=(XY+o)  */
+	OP_CASE(0xa2): D = RES(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* RES  4,D=(XY+o)  */
+	OP_CASE(0xa3): E = RES(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* RES  4,E=(XY+o)  */
+	OP_CASE(0xa4): H = RES(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* RES  4,H=(XY+o)  */
+	OP_CASE(0xa5): L = RES(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* RES  4,L=(XY+o)  */
+	OP_CASE(0xa6): v = RES(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* RES  4,(XY+o)    */
+	OP_CASE(0xa7): A = RES(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* RES  4,A=(XY+o)  */
+	OP_CASE(0xa8): B = RES(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* RES  5,B=(XY+o)  */
+	OP_CASE(0xa9): C = RES(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* RES  5,C=(XY+o)  */
+	OP_CASE(0xaa): D = RES(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* RES  5,D=(XY+o)  */
+	OP_CASE(0xab): E = RES(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* RES  5,E=(XY+o)  */
+	OP_CASE(0xac): H = RES(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* RES  5,H=(XY+o)  */
+	OP_CASE(0xad): L = RES(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* RES  5,L=(XY+o)  */
+	OP_CASE(0xae): v = RES(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* RES  5,(XY+o)    */
+	OP_CASE(0xaf): A = RES(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* RES  5,A=(XY+o)  */
+	OP_CASE(0xb0): B = RES(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* RES  6,B=(XY+o)  */
+	OP_CASE(0xb1): C = RES(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* RES  6,C=(XY+o)  */
+	OP_CASE(0xb2): D = RES(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* RES  6,D=(XY+o)  */
+	OP_CASE(0xb3): E = RES(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* RES  6,E=(XY+o)  */
+	OP_CASE(0xb4): H = RES(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* RES  6,H=(XY+o)  */
+	OP_CASE(0xb5): L = RES(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* RES  6,L=(XY+o)  */
+	OP_CASE(0xb6): v = RES(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* RES  6,(XY+o)    */
+	OP_CASE(0xb7): A = RES(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* RES  6,A=(XY+o)  */
+	OP_CASE(0xb8): B = RES(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* RES  7,B=(XY+o)  */
+	OP_CASE(0xb9): C = RES(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* RES  7,C=(XY+o)  */
+	OP_CASE(0xba): D = RES(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* RES  7,D=(XY+o)  */
+	OP_CASE(0xbb): E = RES(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* RES  7,E=(XY+o)  */
+	OP_CASE(0xbc): H = RES(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* RES  7,H=(XY+o)  */
+	OP_CASE(0xbd): L = RES(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* RES  7,L=(XY+o)  */
+	OP_CASE(0xbe): v = RES(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* RES  7,(XY+o)    */
+	OP_CASE(0xbf): A = RES(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* RES  7,A=(XY+o)  */
+	OP_CASE(0xc0): B = SET(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* SET  0,B=(XY+o)  */
+	OP_CASE(0xc1): C = SET(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* SET  0,C=(XY+o)  */
+	OP_CASE(0xc2): D = SET(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* SET  0,D=(XY+o)  */
+	OP_CASE(0xc3): E = SET(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* SET  0,E=(XY+o)  */
+	OP_CASE(0xc4): H = SET(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* SET  0,H=(XY+o)  */
+	OP_CASE(0xc5): L = SET(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* SET  0,L=(XY+o)  */
+	OP_CASE(0xc6): v = SET(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* SET  0,(XY+o)    */
+	OP_CASE(0xc7): A = SET(0, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* SET  0,A=(XY+o)  */
+	OP_CASE(0xc8): B = SET(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* SET  1,B=(XY+o)  */
+	OP_CASE(0xc9): C = SET(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* SET  1,C=(XY+o)  */
+	OP_CASE(0xca): D = SET(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* SET  1,D=(XY+o)  */
+	OP_CASE(0xcb): E = SET(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* SET  1,E=(XY+o)  */
+	OP_CASE(0xcc): H = SET(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* SET  1,H=(XY+o)  */
+	OP_CASE(0xcd): L = SET(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* SET  1,L=(XY+o)  */
+	OP_CASE(0xce): v = SET(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* SET  1,(XY+o)    */
+	OP_CASE(0xcf): A = SET(1, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* SET  1,A=(XY+o)  */
+	OP_CASE(0xd0): B = SET(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* SET  2,B=(XY+o)  */
+	OP_CASE(0xd1): C = SET(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* SET  2,C=(XY+o)  */
+	OP_CASE(0xd2): D = SET(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* SET  2,D=(XY+o)  */
+	OP_CASE(0xd3): E = SET(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* SET  2,E=(XY+o)  */
+	OP_CASE(0xd4): H = SET(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* SET  2,H=(XY+o)  */
+	OP_CASE(0xd5): L = SET(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* SET  2,L=(XY+o)  */
+	OP_CASE(0xd6): v = SET(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* SET  2,(XY+o)    */
+	OP_CASE(0xd7): A = SET(2, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* SET  2,A=(XY+o)  */
+	OP_CASE(0xd8): B = SET(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* SET  3,B=(XY+o)  */
+	OP_CASE(0xd9): C = SET(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* SET  3,C=(XY+o)  */
+	OP_CASE(0xda): D = SET(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* SET  3,D=(XY+o)  */
+	OP_CASE(0xdb): E = SET(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* SET  3,E=(XY+o)  */
+	OP_CASE(0xdc): H = SET(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* SET  3,H=(XY+o)  */
+	OP_CASE(0xdd): L = SET(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* SET  3,L=(XY+o)  */
+	OP_CASE(0xde): v = SET(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* SET  3,(XY+o)    */
+	OP_CASE(0xdf): A = SET(3, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* SET  3,A=(XY+o)  */
+	OP_CASE(0xe0): B = SET(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* SET  4,B=(XY+o)  */
+	OP_CASE(0xe1): C = SET(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* SET  4,C=(XY+o)  */
+	OP_CASE(0xe2): D = SET(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* SET  4,D=(XY+o)  */
+	OP_CASE(0xe3): E = SET(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* SET  4,E=(XY+o)  */
+	OP_CASE(0xe4): H = SET(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* SET  4,H=(XY+o)  */
+	OP_CASE(0xe5): L = SET(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* SET  4,L=(XY+o)  */
+	OP_CASE(0xe6): v = SET(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* SET  4,(XY+o)    */
+	OP_CASE(0xe7): A = SET(4, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* SET  4,A=(XY+o)  */
+	OP_CASE(0xe8): B = SET(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* SET  5,B=(XY+o)  */
+	OP_CASE(0xe9): C = SET(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* SET  5,C=(XY+o)  */
+	OP_CASE(0xea): D = SET(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* SET  5,D=(XY+o)  */
+	OP_CASE(0xeb): E = SET(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* SET  5,E=(XY+o)  */
+	OP_CASE(0xec): H = SET(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* SET  5,H=(XY+o)  */
+	OP_CASE(0xed): L = SET(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* SET  5,L=(XY+o)  */
+	OP_CASE(0xee): v = SET(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* SET  5,(XY+o)    */
+	OP_CASE(0xef): A = SET(5, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* SET  5,A=(XY+o)  */
+	OP_CASE(0xf0): B = SET(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* SET  6,B=(XY+o)  */
+	OP_CASE(0xf1): C = SET(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* SET  6,C=(XY+o)  */
+	OP_CASE(0xf2): D = SET(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* SET  6,D=(XY+o)  */
+	OP_CASE(0xf3): E = SET(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* SET  6,E=(XY+o)  */
+	OP_CASE(0xf4): H = SET(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* SET  6,H=(XY+o)  */
+	OP_CASE(0xf5): L = SET(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* SET  6,L=(XY+o)  */
+	OP_CASE(0xf6): v = SET(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* SET  6,(XY+o)    */
+	OP_CASE(0xf7): A = SET(6, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* SET  6,A=(XY+o)  */
+	OP_CASE(0xf8): B = SET(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, B); break;	/* SET  7,B=(XY+o)  */
+	OP_CASE(0xf9): C = SET(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, C); break;	/* SET  7,C=(XY+o)  */
+	OP_CASE(0xfa): D = SET(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, D); break;	/* SET  7,D=(XY+o)  */
+	OP_CASE(0xfb): E = SET(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, E); break;	/* SET  7,E=(XY+o)  */
+	OP_CASE(0xfc): H = SET(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, H); break;	/* SET  7,H=(XY+o)  */
+	OP_CASE(0xfd): L = SET(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, L); break;	/* SET  7,L=(XY+o)  */
+	OP_CASE(0xfe): v = SET(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* SET  7,(XY+o)    */
+	OP_CASE(0xff): A = SET(7, RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, A); break;	/* SET  7,A=(XY+o)  */
 #if defined(_MSC_VER) && (_MSC_VER >= 1200)
 	default: __assume(0);
 #endif
-	}
+	} OP_DISPATCH_END;
 }
 
+template <bool PRIMARY, bool CACHED>
 void Z80::OP_DD(uint8_t code)
 {
 	// Done: M1 + M1
@@ -1445,97 +1655,118 @@ void Z80::OP_DD(uint8_t code)
 	
 	icount -= cc_xy[code];
 	
-	switch(code) {
-	case 0x09: ADD16(ix, bc); break;					/* ADD  IX,BC       */
-	case 0x19: ADD16(ix, de); break;					/* ADD  IX,DE       */
-	case 0x21: IX = FETCH16(); break;					/* LD   IX,w        */
-	case 0x22: ea = FETCH16(); WM16(ea, &ix); WZ = ea + 1; break;		/* LD   (w),IX      */
-	case 0x23: IX++; break;							/* INC  IX          */
-	case 0x24: HX = INC(HX); break;						/* INC  HX          */
-	case 0x25: HX = DEC(HX); break;						/* DEC  HX          */
-	case 0x26: HX = FETCH8(); break;					/* LD   HX,n        */
-	case 0x29: ADD16(ix, ix); break;					/* ADD  IX,IX       */
-	case 0x2a: ea = FETCH16(); RM16(ea, &ix); WZ = ea + 1; break;		/* LD   IX,(w)      */
-	case 0x2b: IX--; break;							/* DEC  IX          */
-	case 0x2c: LX = INC(LX); break;						/* INC  LX          */
-	case 0x2d: LX = DEC(LX); break;						/* DEC  LX          */
-	case 0x2e: LX = FETCH8(); break;					/* LD   LX,n        */
-	case 0x34: EAX(); CLOCK_IN_OP(5); v = INC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* INC  (IX+o)      */
-	case 0x35: EAX(); CLOCK_IN_OP(5); v = DEC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* DEC  (IX+o)      */
-	case 0x36: EAX(); v = FETCH8(); CLOCK_IN_OP(2); WM8(ea, v); break;	/* LD   (IX+o),n    */
-	case 0x39: ADD16(ix, sp); break;					/* ADD  IX,SP       */
-	case 0x44: B = HX; break;						/* LD   B,HX        */
-	case 0x45: B = LX; break;						/* LD   B,LX        */
-	case 0x46: EAX(); CLOCK_IN_OP(5); B = RM8(ea); break;			/* LD   B,(IX+o)    */
-	case 0x4c: C = HX; break;						/* LD   C,HX        */
-	case 0x4d: C = LX; break;						/* LD   C,LX        */
-	case 0x4e: EAX(); CLOCK_IN_OP(5); C = RM8(ea); break;			/* LD   C,(IX+o)    */
-	case 0x54: D = HX; break;						/* LD   D,HX        */
-	case 0x55: D = LX; break;						/* LD   D,LX        */
-	case 0x56: EAX(); CLOCK_IN_OP(5); D = RM8(ea); break;			/* LD   D,(IX+o)    */
-	case 0x5c: E = HX; break;						/* LD   E,HX        */
-	case 0x5d: E = LX; break;						/* LD   E,LX        */
-	case 0x5e: EAX(); CLOCK_IN_OP(5); E = RM8(ea); break;			/* LD   E,(IX+o)    */
-	case 0x60: HX = B; break;						/* LD   HX,B        */
-	case 0x61: HX = C; break;						/* LD   HX,C        */
-	case 0x62: HX = D; break;						/* LD   HX,D        */
-	case 0x63: HX = E; break;						/* LD   HX,E        */
-	case 0x64: break;							/* LD   HX,HX       */
-	case 0x65: HX = LX; break;						/* LD   HX,LX       */
-	case 0x66: EAX(); CLOCK_IN_OP(5); H = RM8(ea); break;			/* LD   H,(IX+o)    */
-	case 0x67: HX = A; break;						/* LD   HX,A        */
-	case 0x68: LX = B; break;						/* LD   LX,B        */
-	case 0x69: LX = C; break;						/* LD   LX,C        */
-	case 0x6a: LX = D; break;						/* LD   LX,D        */
-	case 0x6b: LX = E; break;						/* LD   LX,E        */
-	case 0x6c: LX = HX; break;						/* LD   LX,HX       */
-	case 0x6d: break;							/* LD   LX,LX       */
-	case 0x6e: EAX(); CLOCK_IN_OP(5); L = RM8(ea); break;			/* LD   L,(IX+o)    */
-	case 0x6f: LX = A; break;						/* LD   LX,A        */
-	case 0x70: EAX(); CLOCK_IN_OP(5); WM8(ea, B); break;			/* LD   (IX+o),B    */
-	case 0x71: EAX(); CLOCK_IN_OP(5); WM8(ea, C); break;			/* LD   (IX+o),C    */
-	case 0x72: EAX(); CLOCK_IN_OP(5); WM8(ea, D); break;			/* LD   (IX+o),D    */
-	case 0x73: EAX(); CLOCK_IN_OP(5); WM8(ea, E); break;			/* LD   (IX+o),E    */
-	case 0x74: EAX(); CLOCK_IN_OP(5); WM8(ea, H); break;			/* LD   (IX+o),H    */
-	case 0x75: EAX(); CLOCK_IN_OP(5); WM8(ea, L); break;			/* LD   (IX+o),L    */
-	case 0x77: EAX(); CLOCK_IN_OP(5); WM8(ea, A); break;			/* LD   (IX+o),A    */
-	case 0x7c: A = HX; break;						/* LD   A,HX        */
-	case 0x7d: A = LX; break;						/* LD   A,LX        */
-	case 0x7e: EAX(); CLOCK_IN_OP(5); A = RM8(ea); break;			/* LD   A,(IX+o)    */
-	case 0x84: ADD(HX); break;						/* ADD  A,HX        */
-	case 0x85: ADD(LX); break;						/* ADD  A,LX        */
-	case 0x86: EAX(); CLOCK_IN_OP(5); ADD(RM8(ea)); break;			/* ADD  A,(IX+o)    */
-	case 0x8c: ADC(HX); break;						/* ADC  A,HX        */
-	case 0x8d: ADC(LX); break;						/* ADC  A,LX        */
-	case 0x8e: EAX(); CLOCK_IN_OP(5); ADC(RM8(ea)); break;			/* ADC  A,(IX+o)    */
-	case 0x94: SUB(HX); break;						/* SUB  HX          */
-	case 0x95: SUB(LX); break;						/* SUB  LX          */
-	case 0x96: EAX(); CLOCK_IN_OP(5); SUB(RM8(ea)); break;			/* SUB  (IX+o)      */
-	case 0x9c: SBC(HX); break;						/* SBC  A,HX        */
-	case 0x9d: SBC(LX); break;						/* SBC  A,LX        */
-	case 0x9e: EAX(); CLOCK_IN_OP(5); SBC(RM8(ea)); break;			/* SBC  A,(IX+o)    */
-	case 0xa4: AND(HX); break;						/* AND  HX          */
-	case 0xa5: AND(LX); break;						/* AND  LX          */
-	case 0xa6: EAX(); CLOCK_IN_OP(5); AND(RM8(ea)); break;			/* AND  (IX+o)      */
-	case 0xac: XOR(HX); break;						/* XOR  HX          */
-	case 0xad: XOR(LX); break;						/* XOR  LX          */
-	case 0xae: EAX(); CLOCK_IN_OP(5); XOR(RM8(ea)); break;			/* XOR  (IX+o)      */
-	case 0xb4: OR(HX); break;						/* OR   HX          */
-	case 0xb5: OR(LX); break;						/* OR   LX          */
-	case 0xb6: EAX(); CLOCK_IN_OP(5); OR(RM8(ea)); break;			/* OR   (IX+o)      */
-	case 0xbc: CP(HX); break;						/* CP   HX          */
-	case 0xbd: CP(LX); break;						/* CP   LX          */
-	case 0xbe: EAX(); CLOCK_IN_OP(5); CP(RM8(ea)); break;			/* CP   (IX+o)      */
-	case 0xcb: EAX(); v = FETCH8(); CLOCK_IN_OP(2); OP_XY(v); break;	/* **   DD CB xx    */
-	case 0xe1: POP(ix); break;						/* POP  IX          */
-	case 0xe3: EXSP(ix); break;						/* EX   (SP),IX     */
-	case 0xe5: PUSH(ix); break;						/* PUSH IX          */
-	case 0xe9: PC = IX; break;						/* JP   (IX)        */
-	case 0xf9: SP = IX; break;						/* LD   SP,IX       */
-	default:   OP(code); break;
-	}
+#ifdef Z80_USE_COMPUTED_GOTO
+	static const void* const op_table[256] = {
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x09, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x19, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_default, &&op_default, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x34, &&op_0x35, &&op_0x36, &&op_default, &&op_default, &&op_0x39, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x44, &&op_0x45, &&op_0x46, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x54, &&op_0x55, &&op_0x56, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_default,
+		&&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67, &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+		&&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_default, &&op_0x77, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x84, &&op_0x85, &&op_0x86, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x94, &&op_0x95, &&op_0x96, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xac, &&op_0xad, &&op_0xae, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xcb, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_0xe1, &&op_default, &&op_0xe3, &&op_default, &&op_0xe5, &&op_default, &&op_default, &&op_default, &&op_0xe9, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xf9, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default
+	};
+#endif
+	OP_DISPATCH(op_table, code) {
+	OP_CASE(0x09): ADD16(ix, bc); break;					/* ADD  IX,BC       */
+	OP_CASE(0x19): ADD16(ix, de); break;					/* ADD  IX,DE       */
+	OP_CASE(0x21): IX = FETCH16<PRIMARY, CACHED>(); break;					/* LD   IX,w        */
+	OP_CASE(0x22): ea = FETCH16<PRIMARY, CACHED>(); WM16<PRIMARY>(ea, &ix); WZ = ea + 1; break;		/* LD   (w),IX      */
+	OP_CASE(0x23): IX++; break;							/* INC  IX          */
+	OP_CASE(0x24): HX = INC(HX); break;						/* INC  HX          */
+	OP_CASE(0x25): HX = DEC(HX); break;						/* DEC  HX          */
+	OP_CASE(0x26): HX = FETCH8<PRIMARY, CACHED>(); break;					/* LD   HX,n        */
+	OP_CASE(0x29): ADD16(ix, ix); break;					/* ADD  IX,IX       */
+	OP_CASE(0x2a): ea = FETCH16<PRIMARY, CACHED>(); RM16<PRIMARY>(ea, &ix); WZ = ea + 1; break;		/* LD   IX,(w)      */
+	OP_CASE(0x2b): IX--; break;							/* DEC  IX          */
+	OP_CASE(0x2c): LX = INC(LX); break;						/* INC  LX          */
+	OP_CASE(0x2d): LX = DEC(LX); break;						/* DEC  LX          */
+	OP_CASE(0x2e): LX = FETCH8<PRIMARY, CACHED>(); break;					/* LD   LX,n        */
+	OP_CASE(0x34): EAX(); CLOCK_IN_OP(5); v = INC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* INC  (IX+o)      */
+	OP_CASE(0x35): EAX(); CLOCK_IN_OP(5); v = DEC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* DEC  (IX+o)      */
+	OP_CASE(0x36): EAX(); v = FETCH8<PRIMARY, CACHED>(); CLOCK_IN_OP(2); WM8<PRIMARY>(ea, v); break;	/* LD   (IX+o),n    */
+	OP_CASE(0x39): ADD16(ix, sp); break;					/* ADD  IX,SP       */
+	OP_CASE(0x44): B = HX; break;						/* LD   B,HX        */
+	OP_CASE(0x45): B = LX; break;						/* LD   B,LX        */
+	OP_CASE(0x46): EAX(); CLOCK_IN_OP(5); B = RM8<PRIMARY>(ea); break;			/* LD   B,(IX+o)    */
+	OP_CASE(0x4c): C = HX; break;						/* LD   C,HX        */
+	OP_CASE(0x4d): C = LX; break;						/* LD   C,LX        */
+	OP_CASE(0x4e): EAX(); CLOCK_IN_OP(5); C = RM8<PRIMARY>(ea); break;			/* LD   C,(IX+o)    */
+	OP_CASE(0x54): D = HX; break;						/* LD   D,HX        */
+	OP_CASE(0x55): D = LX; break;						/* LD   D,LX        */
+	OP_CASE(0x56): EAX(); CLOCK_IN_OP(5); D = RM8<PRIMARY>(ea); break;			/* LD   D,(IX+o)    */
+	OP_CASE(0x5c): E = HX; break;						/* LD   E,HX        */
+	OP_CASE(0x5d): E = LX; break;						/* LD   E,LX        */
+	OP_CASE(0x5e): EAX(); CLOCK_IN_OP(5); E = RM8<PRIMARY>(ea); break;			/* LD   E,(IX+o)    */
+	OP_CASE(0x60): HX = B; break;						/* LD   HX,B        */
+	OP_CASE(0x61): HX = C; break;						/* LD   HX,C        */
+	OP_CASE(0x62): HX = D; break;						/* LD   HX,D        */
+	OP_CASE(0x63): HX = E; break;						/* LD   HX,E        */
+	OP_CASE(0x64): break;							/* LD   HX,HX       */
+	OP_CASE(0x65): HX = LX; break;						/* LD   HX,LX       */
+	OP_CASE(0x66): EAX(); CLOCK_IN_OP(5); H = RM8<PRIMARY>(ea); break;			/* LD   H,(IX+o)    */
+	OP_CASE(0x67): HX = A; break;						/* LD   HX,A        */
+	OP_CASE(0x68): LX = B; break;						/* LD   LX,B        */
+	OP_CASE(0x69): LX = C; break;						/* LD   LX,C        */
+	OP_CASE(0x6a): LX = D; break;						/* LD   LX,D        */
+	OP_CASE(0x6b): LX = E; break;						/* LD   LX,E        */
+	OP_CASE(0x6c): LX = HX; break;						/* LD   LX,HX       */
+	OP_CASE(0x6d): break;							/* LD   LX,LX       */
+	OP_CASE(0x6e): EAX(); CLOCK_IN_OP(5); L = RM8<PRIMARY>(ea); break;			/* LD   L,(IX+o)    */
+	OP_CASE(0x6f): LX = A; break;						/* LD   LX,A        */
+	OP_CASE(0x70): EAX(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, B); break;			/* LD   (IX+o),B    */
+	OP_CASE(0x71): EAX(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, C); break;			/* LD   (IX+o),C    */
+	OP_CASE(0x72): EAX(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, D); break;			/* LD   (IX+o),D    */
+	OP_CASE(0x73): EAX(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, E); break;			/* LD   (IX+o),E    */
+	OP_CASE(0x74): EAX(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, H); break;			/* LD   (IX+o),H    */
+	OP_CASE(0x75): EAX(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, L); break;			/* LD   (IX+o),L    */
+	OP_CASE(0x77): EAX(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, A); break;			/* LD   (IX+o),A    */
+	OP_CASE(0x7c): A = HX; break;						/* LD   A,HX        */
+	OP_CASE(0x7d): A = LX; break;						/* LD   A,LX        */
+	OP_CASE(0x7e): EAX(); CLOCK_IN_OP(5); A = RM8<PRIMARY>(ea); break;			/* LD   A,(IX+o)    */
+	OP_CASE(0x84): ADD(HX); break;						/* ADD  A,HX        */
+	OP_CASE(0x85): ADD(LX); break;						/* ADD  A,LX        */
+	OP_CASE(0x86): EAX(); CLOCK_IN_OP(5); ADD(RM8<PRIMARY>(ea)); break;			/* ADD  A,(IX+o)    */
+	OP_CASE(0x8c): ADC(HX); break;						/* ADC  A,HX        */
+	OP_CASE(0x8d): ADC(LX); break;						/* ADC  A,LX        */
+	OP_CASE(0x8e): EAX(); CLOCK_IN_OP(5); ADC(RM8<PRIMARY>(ea)); break;			/* ADC  A,(IX+o)    */
+	OP_CASE(0x94): SUB(HX); break;						/* SUB  HX          */
+	OP_CASE(0x95): SUB(LX); break;						/* SUB  LX          */
+	OP_CASE(0x96): EAX(); CLOCK_IN_OP(5); SUB(RM8<PRIMARY>(ea)); break;			/* SUB  (IX+o)      */
+	OP_CASE(0x9c): SBC(HX); break;						/* SBC  A,HX        */
+	OP_CASE(0x9d): SBC(LX); break;						/* SBC  A,LX        */
+	OP_CASE(0x9e): EAX(); CLOCK_IN_OP(5); SBC(RM8<PRIMARY>(ea)); break;			/* SBC  A,(IX+o)    */
+	OP_CASE(0xa4): AND(HX); break;						/* AND  HX          */
+	OP_CASE(0xa5): AND(LX); break;						/* AND  LX          */
+	OP_CASE(0xa6): EAX(); CLOCK_IN_OP(5); AND(RM8<PRIMARY>(ea)); break;			/* AND  (IX+o)      */
+	OP_CASE(0xac): XOR(HX); break;						/* XOR  HX          */
+	OP_CASE(0xad): XOR(LX); break;						/* XOR  LX          */
+	OP_CASE(0xae): EAX(); CLOCK_IN_OP(5); XOR(RM8<PRIMARY>(ea)); break;			/* XOR  (IX+o)      */
+	OP_CASE(0xb4): OR(HX); break;						/* OR   HX          */
+	OP_CASE(0xb5): OR(LX); break;						/* OR   LX          */
+	OP_CASE(0xb6): EAX(); CLOCK_IN_OP(5); OR(RM8<PRIMARY>(ea)); break;			/* OR   (IX+o)      */
+	OP_CASE(0xbc): CP(HX); break;						/* CP   HX          */
+	OP_CASE(0xbd): CP(LX); break;						/* CP   LX          */
+	OP_CASE(0xbe): EAX(); CLOCK_IN_OP(5); CP(RM8<PRIMARY>(ea)); break;			/* CP   (IX+o)      */
+	OP_CASE(0xcb): EAX(); v = FETCH8<PRIMARY, CACHED>(); CLOCK_IN_OP(2); OP_XY<PRIMARY, CACHED>(v); break;	/* **   DD CB xx    */
+	OP_CASE(0xe1): POP(ix); break;						/* POP  IX          */
+	OP_CASE(0xe3): EXSP(ix); break;						/* EX   (SP),IX     */
+	OP_CASE(0xe5): PUSH(ix); break;						/* PUSH IX          */
+	OP_CASE(0xe9): PC = IX; break;						/* JP   (IX)        */
+	OP_CASE(0xf9): SP = IX; break;						/* LD   SP,IX       */
+	OP_DEFAULT: OP<PRIMARY, CACHED>(code); break;
+	} OP_DISPATCH_END;
 }
 
+template <bool PRIMARY, bool CACHED>
 void Z80::OP_FD(uint8_t code)
 {
 	// Done: M1 + M1
@@ -1543,185 +1774,227 @@ void Z80::OP_FD(uint8_t code)
 	
 	icount -= cc_xy[code];
 	
-	switch(code) {
-	case 0x09: ADD16(iy, bc); break;					/* ADD  IY,BC       */
-	case 0x19: ADD16(iy, de); break;					/* ADD  IY,DE       */
-	case 0x21: IY = FETCH16(); break;					/* LD   IY,w        */
-	case 0x22: ea = FETCH16(); WM16(ea, &iy); WZ = ea + 1; break;		/* LD   (w),IY      */
-	case 0x23: IY++; break;							/* INC  IY          */
-	case 0x24: HY = INC(HY); break;						/* INC  HY          */
-	case 0x25: HY = DEC(HY); break;						/* DEC  HY          */
-	case 0x26: HY = FETCH8(); break;					/* LD   HY,n        */
-	case 0x29: ADD16(iy, iy); break;					/* ADD  IY,IY       */
-	case 0x2a: ea = FETCH16(); RM16(ea, &iy); WZ = ea + 1; break;		/* LD   IY,(w)      */
-	case 0x2b: IY--; break;							/* DEC  IY          */
-	case 0x2c: LY = INC(LY); break;						/* INC  LY          */
-	case 0x2d: LY = DEC(LY); break;						/* DEC  LY          */
-	case 0x2e: LY = FETCH8(); break;					/* LD   LY,n        */
-	case 0x34: EAY(); CLOCK_IN_OP(5); v = INC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* INC  (IY+o)      */
-	case 0x35: EAY(); CLOCK_IN_OP(5); v = DEC(RM8(ea)); CLOCK_IN_OP(1); WM8(ea, v); break;	/* DEC  (IY+o)      */
-	case 0x36: EAY(); v = FETCH8(); CLOCK_IN_OP(2); WM8(ea, v); break;	/* LD   (IY+o),n    */
-	case 0x39: ADD16(iy, sp); break;					/* ADD  IY,SP       */
-	case 0x44: B = HY; break;						/* LD   B,HY        */
-	case 0x45: B = LY; break;						/* LD   B,LY        */
-	case 0x46: EAY(); CLOCK_IN_OP(5); B = RM8(ea); break;			/* LD   B,(IY+o)    */
-	case 0x4c: C = HY; break;						/* LD   C,HY        */
-	case 0x4d: C = LY; break;						/* LD   C,LY        */
-	case 0x4e: EAY(); CLOCK_IN_OP(5); C = RM8(ea); break;			/* LD   C,(IY+o)    */
-	case 0x54: D = HY; break;						/* LD   D,HY        */
-	case 0x55: D = LY; break;						/* LD   D,LY        */
-	case 0x56: EAY(); CLOCK_IN_OP(5); D = RM8(ea); break;			/* LD   D,(IY+o)    */
-	case 0x5c: E = HY; break;						/* LD   E,HY        */
-	case 0x5d: E = LY; break;						/* LD   E,LY        */
-	case 0x5e: EAY(); CLOCK_IN_OP(5); E = RM8(ea); break;			/* LD   E,(IY+o)    */
-	case 0x60: HY = B; break;						/* LD   HY,B        */
-	case 0x61: HY = C; break;						/* LD   HY,C        */
-	case 0x62: HY = D; break;						/* LD   HY,D        */
-	case 0x63: HY = E; break;						/* LD   HY,E        */
-	case 0x64: break;							/* LD   HY,HY       */
-	case 0x65: HY = LY; break;						/* LD   HY,LY       */
-	case 0x66: EAY(); CLOCK_IN_OP(5); H = RM8(ea); break;			/* LD   H,(IY+o)    */
-	case 0x67: HY = A; break;						/* LD   HY,A        */
-	case 0x68: LY = B; break;						/* LD   LY,B        */
-	case 0x69: LY = C; break;						/* LD   LY,C        */
-	case 0x6a: LY = D; break;						/* LD   LY,D        */
-	case 0x6b: LY = E; break;						/* LD   LY,E        */
-	case 0x6c: LY = HY; break;						/* LD   LY,HY       */
-	case 0x6d: break;							/* LD   LY,LY       */
-	case 0x6e: EAY(); CLOCK_IN_OP(5); L = RM8(ea); break;			/* LD   L,(IY+o)    */
-	case 0x6f: LY = A; break;						/* LD   LY,A        */
-	case 0x70: EAY(); CLOCK_IN_OP(5); WM8(ea, B); break;			/* LD   (IY+o),B    */
-	case 0x71: EAY(); CLOCK_IN_OP(5); WM8(ea, C); break;			/* LD   (IY+o),C    */
-	case 0x72: EAY(); CLOCK_IN_OP(5); WM8(ea, D); break;			/* LD   (IY+o),D    */
-	case 0x73: EAY(); CLOCK_IN_OP(5); WM8(ea, E); break;			/* LD   (IY+o),E    */
-	case 0x74: EAY(); CLOCK_IN_OP(5); WM8(ea, H); break;			/* LD   (IY+o),H    */
-	case 0x75: EAY(); CLOCK_IN_OP(5); WM8(ea, L); break;			/* LD   (IY+o),L    */
-	case 0x77: EAY(); CLOCK_IN_OP(5); WM8(ea, A); break;			/* LD   (IY+o),A    */
-	case 0x7c: A = HY; break;						/* LD   A,HY        */
-	case 0x7d: A = LY; break;						/* LD   A,LY        */
-	case 0x7e: EAY(); CLOCK_IN_OP(5); A = RM8(ea); break;			/* LD   A,(IY+o)    */
-	case 0x84: ADD(HY); break;						/* ADD  A,HY        */
-	case 0x85: ADD(LY); break;						/* ADD  A,LY        */
-	case 0x86: EAY(); CLOCK_IN_OP(5); ADD(RM8(ea)); break;			/* ADD  A,(IY+o)    */
-	case 0x8c: ADC(HY); break;						/* ADC  A,HY        */
-	case 0x8d: ADC(LY); break;						/* ADC  A,LY        */
-	case 0x8e: EAY(); CLOCK_IN_OP(5); ADC(RM8(ea)); break;			/* ADC  A,(IY+o)    */
-	case 0x94: SUB(HY); break;						/* SUB  HY          */
-	case 0x95: SUB(LY); break;						/* SUB  LY          */
-	case 0x96: EAY(); CLOCK_IN_OP(5); SUB(RM8(ea)); break;			/* SUB  (IY+o)      */
-	case 0x9c: SBC(HY); break;						/* SBC  A,HY        */
-	case 0x9d: SBC(LY); break;						/* SBC  A,LY        */
-	case 0x9e: EAY(); CLOCK_IN_OP(5); SBC(RM8(ea)); break;			/* SBC  A,(IY+o)    */
-	case 0xa4: AND(HY); break;						/* AND  HY          */
-	case 0xa5: AND(LY); break;						/* AND  LY          */
-	case 0xa6: EAY(); CLOCK_IN_OP(5); AND(RM8(ea)); break;			/* AND  (IY+o)      */
-	case 0xac: XOR(HY); break;						/* XOR  HY          */
-	case 0xad: XOR(LY); break;						/* XOR  LY          */
-	case 0xae: EAY(); CLOCK_IN_OP(5); XOR(RM8(ea)); break;			/* XOR  (IY+o)      */
-	case 0xb4: OR(HY); break;						/* OR   HY          */
-	case 0xb5: OR(LY); break;						/* OR   LY          */
-	case 0xb6: EAY(); CLOCK_IN_OP(5); OR(RM8(ea)); break;			/* OR   (IY+o)      */
-	case 0xbc: CP(HY); break;						/* CP   HY          */
-	case 0xbd: CP(LY); break;						/* CP   LY          */
-	case 0xbe: EAY(); CLOCK_IN_OP(5); CP(RM8(ea)); break;			/* CP   (IY+o)      */
-	case 0xcb: EAY(); v = FETCH8(); CLOCK_IN_OP(2); OP_XY(v); break;	/* **   FD CB xx    */
-	case 0xe1: POP(iy); break;						/* POP  IY          */
-	case 0xe3: EXSP(iy); break;						/* EX   (SP),IY     */
-	case 0xe5: PUSH(iy); break;						/* PUSH IY          */
-	case 0xe9: PC = IY; break;						/* JP   (IY)        */
-	case 0xf9: SP = IY; break;						/* LD   SP,IY       */
-	default:   OP(code); break;
-	}
+#ifdef Z80_USE_COMPUTED_GOTO
+	static const void* const op_table[256] = {
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x09, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x19, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_default, &&op_default, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x34, &&op_0x35, &&op_0x36, &&op_default, &&op_default, &&op_0x39, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x44, &&op_0x45, &&op_0x46, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x54, &&op_0x55, &&op_0x56, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_default,
+		&&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67, &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+		&&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_default, &&op_0x77, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x84, &&op_0x85, &&op_0x86, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0x94, &&op_0x95, &&op_0x96, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xac, &&op_0xad, &&op_0xae, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xcb, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_0xe1, &&op_default, &&op_0xe3, &&op_default, &&op_0xe5, &&op_default, &&op_default, &&op_default, &&op_0xe9, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xf9, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default
+	};
+#endif
+	OP_DISPATCH(op_table, code) {
+	OP_CASE(0x09): ADD16(iy, bc); break;					/* ADD  IY,BC       */
+	OP_CASE(0x19): ADD16(iy, de); break;					/* ADD  IY,DE       */
+	OP_CASE(0x21): IY = FETCH16<PRIMARY, CACHED>(); break;					/* LD   IY,w        */
+	OP_CASE(0x22): ea = FETCH16<PRIMARY, CACHED>(); WM16<PRIMARY>(ea, &iy); WZ = ea + 1; break;		/* LD   (w),IY      */
+	OP_CASE(0x23): IY++; break;							/* INC  IY          */
+	OP_CASE(0x24): HY = INC(HY); break;						/* INC  HY          */
+	OP_CASE(0x25): HY = DEC(HY); break;						/* DEC  HY          */
+	OP_CASE(0x26): HY = FETCH8<PRIMARY, CACHED>(); break;					/* LD   HY,n        */
+	OP_CASE(0x29): ADD16(iy, iy); break;					/* ADD  IY,IY       */
+	OP_CASE(0x2a): ea = FETCH16<PRIMARY, CACHED>(); RM16<PRIMARY>(ea, &iy); WZ = ea + 1; break;		/* LD   IY,(w)      */
+	OP_CASE(0x2b): IY--; break;							/* DEC  IY          */
+	OP_CASE(0x2c): LY = INC(LY); break;						/* INC  LY          */
+	OP_CASE(0x2d): LY = DEC(LY); break;						/* DEC  LY          */
+	OP_CASE(0x2e): LY = FETCH8<PRIMARY, CACHED>(); break;					/* LD   LY,n        */
+	OP_CASE(0x34): EAY(); CLOCK_IN_OP(5); v = INC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* INC  (IY+o)      */
+	OP_CASE(0x35): EAY(); CLOCK_IN_OP(5); v = DEC(RM8<PRIMARY>(ea)); CLOCK_IN_OP(1); WM8<PRIMARY>(ea, v); break;	/* DEC  (IY+o)      */
+	OP_CASE(0x36): EAY(); v = FETCH8<PRIMARY, CACHED>(); CLOCK_IN_OP(2); WM8<PRIMARY>(ea, v); break;	/* LD   (IY+o),n    */
+	OP_CASE(0x39): ADD16(iy, sp); break;					/* ADD  IY,SP       */
+	OP_CASE(0x44): B = HY; break;						/* LD   B,HY        */
+	OP_CASE(0x45): B = LY; break;						/* LD   B,LY        */
+	OP_CASE(0x46): EAY(); CLOCK_IN_OP(5); B = RM8<PRIMARY>(ea); break;			/* LD   B,(IY+o)    */
+	OP_CASE(0x4c): C = HY; break;						/* LD   C,HY        */
+	OP_CASE(0x4d): C = LY; break;						/* LD   C,LY        */
+	OP_CASE(0x4e): EAY(); CLOCK_IN_OP(5); C = RM8<PRIMARY>(ea); break;			/* LD   C,(IY+o)    */
+	OP_CASE(0x54): D = HY; break;						/* LD   D,HY        */
+	OP_CASE(0x55): D = LY; break;						/* LD   D,LY        */
+	OP_CASE(0x56): EAY(); CLOCK_IN_OP(5); D = RM8<PRIMARY>(ea); break;			/* LD   D,(IY+o)    */
+	OP_CASE(0x5c): E = HY; break;						/* LD   E,HY        */
+	OP_CASE(0x5d): E = LY; break;						/* LD   E,LY        */
+	OP_CASE(0x5e): EAY(); CLOCK_IN_OP(5); E = RM8<PRIMARY>(ea); break;			/* LD   E,(IY+o)    */
+	OP_CASE(0x60): HY = B; break;						/* LD   HY,B        */
+	OP_CASE(0x61): HY = C; break;						/* LD   HY,C        */
+	OP_CASE(0x62): HY = D; break;						/* LD   HY,D        */
+	OP_CASE(0x63): HY = E; break;						/* LD   HY,E        */
+	OP_CASE(0x64): break;							/* LD   HY,HY       */
+	OP_CASE(0x65): HY = LY; break;						/* LD   HY,LY       */
+	OP_CASE(0x66): EAY(); CLOCK_IN_OP(5); H = RM8<PRIMARY>(ea); break;			/* LD   H,(IY+o)    */
+	OP_CASE(0x67): HY = A; break;						/* LD   HY,A        */
+	OP_CASE(0x68): LY = B; break;						/* LD   LY,B        */
+	OP_CASE(0x69): LY = C; break;						/* LD   LY,C        */
+	OP_CASE(0x6a): LY = D; break;						/* LD   LY,D        */
+	OP_CASE(0x6b): LY = E; break;						/* LD   LY,E        */
+	OP_CASE(0x6c): LY = HY; break;						/* LD   LY,HY       */
+	OP_CASE(0x6d): break;							/* LD   LY,LY       */
+	OP_CASE(0x6e): EAY(); CLOCK_IN_OP(5); L = RM8<PRIMARY>(ea); break;			/* LD   L,(IY+o)    */
+	OP_CASE(0x6f): LY = A; break;						/* LD   LY,A        */
+	OP_CASE(0x70): EAY(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, B); break;			/* LD   (IY+o),B    */
+	OP_CASE(0x71): EAY(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, C); break;			/* LD   (IY+o),C    */
+	OP_CASE(0x72): EAY(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, D); break;			/* LD   (IY+o),D    */
+	OP_CASE(0x73): EAY(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, E); break;			/* LD   (IY+o),E    */
+	OP_CASE(0x74): EAY(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, H); break;			/* LD   (IY+o),H    */
+	OP_CASE(0x75): EAY(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, L); break;			/* LD   (IY+o),L    */
+	OP_CASE(0x77): EAY(); CLOCK_IN_OP(5); WM8<PRIMARY>(ea, A); break;			/* LD   (IY+o),A    */
+	OP_CASE(0x7c): A = HY; break;						/* LD   A,HY        */
+	OP_CASE(0x7d): A = LY; break;						/* LD   A,LY        */
+	OP_CASE(0x7e): EAY(); CLOCK_IN_OP(5); A = RM8<PRIMARY>(ea); break;			/* LD   A,(IY+o)    */
+	OP_CASE(0x84): ADD(HY); break;						/* ADD  A,HY        */
+	OP_CASE(0x85): ADD(LY); break;						/* ADD  A,LY        */
+	OP_CASE(0x86): EAY(); CLOCK_IN_OP(5); ADD(RM8<PRIMARY>(ea)); break;			/* ADD  A,(IY+o)    */
+	OP_CASE(0x8c): ADC(HY); break;						/* ADC  A,HY        */
+	OP_CASE(0x8d): ADC(LY); break;						/* ADC  A,LY        */
+	OP_CASE(0x8e): EAY(); CLOCK_IN_OP(5); ADC(RM8<PRIMARY>(ea)); break;			/* ADC  A,(IY+o)    */
+	OP_CASE(0x94): SUB(HY); break;						/* SUB  HY          */
+	OP_CASE(0x95): SUB(LY); break;						/* SUB  LY          */
+	OP_CASE(0x96): EAY(); CLOCK_IN_OP(5); SUB(RM8<PRIMARY>(ea)); break;			/* SUB  (IY+o)      */
+	OP_CASE(0x9c): SBC(HY); break;						/* SBC  A,HY        */
+	OP_CASE(0x9d): SBC(LY); break;						/* SBC  A,LY        */
+	OP_CASE(0x9e): EAY(); CLOCK_IN_OP(5); SBC(RM8<PRIMARY>(ea)); break;			/* SBC  A,(IY+o)    */
+	OP_CASE(0xa4): AND(HY); break;						/* AND  HY          */
+	OP_CASE(0xa5): AND(LY); break;						/* AND  LY          */
+	OP_CASE(0xa6): EAY(); CLOCK_IN_OP(5); AND(RM8<PRIMARY>(ea)); break;			/* AND  (IY+o)      */
+	OP_CASE(0xac): XOR(HY); break;						/* XOR  HY          */
+	OP_CASE(0xad): XOR(LY); break;						/* XOR  LY          */
+	OP_CASE(0xae): EAY(); CLOCK_IN_OP(5); XOR(RM8<PRIMARY>(ea)); break;			/* XOR  (IY+o)      */
+	OP_CASE(0xb4): OR(HY); break;						/* OR   HY          */
+	OP_CASE(0xb5): OR(LY); break;						/* OR   LY          */
+	OP_CASE(0xb6): EAY(); CLOCK_IN_OP(5); OR(RM8<PRIMARY>(ea)); break;			/* OR   (IY+o)      */
+	OP_CASE(0xbc): CP(HY); break;						/* CP   HY          */
+	OP_CASE(0xbd): CP(LY); break;						/* CP   LY          */
+	OP_CASE(0xbe): EAY(); CLOCK_IN_OP(5); CP(RM8<PRIMARY>(ea)); break;			/* CP   (IY+o)      */
+	OP_CASE(0xcb): EAY(); v = FETCH8<PRIMARY, CACHED>(); CLOCK_IN_OP(2); OP_XY<PRIMARY, CACHED>(v); break;	/* **   FD CB xx    */
+	OP_CASE(0xe1): POP(iy); break;						/* POP  IY          */
+	OP_CASE(0xe3): EXSP(iy); break;						/* EX   (SP),IY     */
+	OP_CASE(0xe5): PUSH(iy); break;						/* PUSH IY          */
+	OP_CASE(0xe9): PC = IY; break;						/* JP   (IY)        */
+	OP_CASE(0xf9): SP = IY; break;						/* LD   SP,IY       */
+	OP_DEFAULT: OP<PRIMARY, CACHED>(code); break;
+	} OP_DISPATCH_END;
 }
 
+template <bool PRIMARY, bool CACHED>
 void Z80::OP_ED(uint8_t code)
 {
 	// Done: M1 + M1
 	icount -= cc_ed[code];
 	
-	switch(code) {
-	case 0x40: B = IN8(BC); F = (F & CF) | SZP[B]; break;			/* IN   B,(C)       */
-	case 0x41: OUT8(BC, B); break;						/* OUT  (C),B       */
-	case 0x42: SBC16(bc); break;						/* SBC  HL,BC       */
-	case 0x43: ea = FETCH16(); WM16(ea, &bc); WZ = ea + 1; break;		/* LD   (w),BC      */
-	case 0x44: NEG(); break;						/* NEG              */
-	case 0x45: RETN(); break;						/* RETN             */
-	case 0x46: im = 0; break;						/* im   0           */
-	case 0x47: LD_I_A(); break;						/* LD   i,A         */
-	case 0x48: C = IN8(BC); F = (F & CF) | SZP[C]; break;			/* IN   C,(C)       */
-	case 0x49: OUT8(BC, C); break;						/* OUT  (C),C       */
-	case 0x4a: ADC16(bc); break;						/* ADC  HL,BC       */
-	case 0x4b: ea = FETCH16(); RM16(ea, &bc); WZ = ea + 1; break;		/* LD   BC,(w)      */
-	case 0x4c: NEG(); break;						/* NEG              */
-	case 0x4d: RETI(); break;						/* RETI             */
-	case 0x4e: im = 0; break;						/* im   0           */
-	case 0x4f: LD_R_A(); break;						/* LD   r,A         */
-	case 0x50: D = IN8(BC); F = (F & CF) | SZP[D]; break;			/* IN   D,(C)       */
-	case 0x51: OUT8(BC, D); break;						/* OUT  (C),D       */
-	case 0x52: SBC16(de); break;						/* SBC  HL,DE       */
-	case 0x53: ea = FETCH16(); WM16(ea, &de); WZ = ea + 1; break;		/* LD   (w),DE      */
-	case 0x54: NEG(); break;						/* NEG              */
-	case 0x55: RETN(); break;						/* RETN             */
-	case 0x56: im = 1; break;						/* im   1           */
-	case 0x57: LD_A_I(); break;						/* LD   A,i         */
-	case 0x58: E = IN8(BC); F = (F & CF) | SZP[E]; break;			/* IN   E,(C)       */
-	case 0x59: OUT8(BC, E); break;						/* OUT  (C),E       */
-	case 0x5a: ADC16(de); break;						/* ADC  HL,DE       */
-	case 0x5b: ea = FETCH16(); RM16(ea, &de); WZ = ea + 1; break;		/* LD   DE,(w)      */
-	case 0x5c: NEG(); break;						/* NEG              */
-	case 0x5d: RETI(); break;						/* RETI             */
-	case 0x5e: im = 2; break;						/* im   2           */
-	case 0x5f: LD_A_R(); break;						/* LD   A,r         */
-	case 0x60: H = IN8(BC); F = (F & CF) | SZP[H]; break;			/* IN   H,(C)       */
-	case 0x61: OUT8(BC, H); break;						/* OUT  (C),H       */
-	case 0x62: SBC16(hl); break;						/* SBC  HL,HL       */
-	case 0x63: ea = FETCH16(); WM16(ea, &hl); WZ = ea + 1; break;		/* LD   (w),HL      */
-	case 0x64: NEG(); break;						/* NEG              */
-	case 0x65: RETN(); break;						/* RETN             */
-	case 0x66: im = 0; break;						/* im   0           */
-	case 0x67: RRD(); break;						/* RRD  (HL)        */
-	case 0x68: L = IN8(BC); F = (F & CF) | SZP[L]; break;			/* IN   L,(C)       */
-	case 0x69: OUT8(BC, L); break;						/* OUT  (C),L       */
-	case 0x6a: ADC16(hl); break;						/* ADC  HL,HL       */
-	case 0x6b: ea = FETCH16(); RM16(ea, &hl); WZ = ea + 1; break;		/* LD   HL,(w)      */
-	case 0x6c: NEG(); break;						/* NEG              */
-	case 0x6d: RETI(); break;						/* RETI             */
-	case 0x6e: im = 0; break;						/* im   0           */
-	case 0x6f: RLD(); break;						/* RLD  (HL)        */
-	case 0x70: {uint8_t res = IN8(BC); F = (F & CF) | SZP[res];} break;	/* IN   F,(C)       */
-	case 0x71: OUT8(BC, 0); break;						/* OUT  (C),0       */
-	case 0x72: SBC16(sp); break;						/* SBC  HL,SP       */
-	case 0x73: ea = FETCH16(); WM16(ea, &sp); WZ = ea + 1; break;		/* LD   (w),SP      */
-	case 0x74: NEG(); break;						/* NEG              */
-	case 0x75: RETN(); break;						/* RETN             */
-	case 0x76: im = 1; break;						/* im   1           */
-	case 0x78: A = IN8(BC); F = (F & CF) | SZP[A]; WZ = BC + 1; break;	/* IN   A,(C)       */
-	case 0x79: OUT8(BC, A); WZ = BC + 1; break;				/* OUT  (C),A       */
-	case 0x7a: ADC16(sp); break;						/* ADC  HL,SP       */
-	case 0x7b: ea = FETCH16(); RM16(ea, &sp); WZ = ea + 1; break;		/* LD   SP,(w)      */
-	case 0x7c: NEG(); break;						/* NEG              */
-	case 0x7d: RETI(); break;						/* RETI             */
-	case 0x7e: im = 2; break;						/* im   2           */
-	case 0xa0: LDI(); break;						/* LDI              */
-	case 0xa1: CPI(); break;						/* CPI              */
-	case 0xa2: INI(); break;						/* INI              */
-	case 0xa3: OUTI(); break;						/* OUTI             */
-	case 0xa8: LDD(); break;						/* LDD              */
-	case 0xa9: CPD(); break;						/* CPD              */
-	case 0xaa: IND(); break;						/* IND              */
-	case 0xab: OUTD(); break;						/* OUTD             */
-	case 0xb0: LDIR(); break;						/* LDIR             */
-	case 0xb1: CPIR(); break;						/* CPIR             */
-	case 0xb2: INIR(); break;						/* INIR             */
-	case 0xb3: OTIR(); break;						/* OTIR             */
-	case 0xb8: LDDR(); break;						/* LDDR             */
-	case 0xb9: CPDR(); break;						/* CPDR             */
-	case 0xba: INDR(); break;						/* INDR             */
-	case 0xbb: OTDR(); break;						/* OTDR             */
-	default:   OP(code); break;
-	}
+#ifdef Z80_USE_COMPUTED_GOTO
+	static const void* const op_table[256] = {
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47, &&op_0x48, &&op_0x49, &&op_0x4a, &&op_0x4b, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f,
+		&&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57, &&op_0x58, &&op_0x59, &&op_0x5a, &&op_0x5b, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f,
+		&&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67, &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+		&&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_default, &&op_0x78, &&op_0x79, &&op_0x7a, &&op_0x7b, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_0xab, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_0xb0, &&op_0xb1, &&op_0xb2, &&op_0xb3, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_0xbb, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default
+	};
+#endif
+	OP_DISPATCH(op_table, code) {
+	OP_CASE(0x40): B = IN8<PRIMARY>(BC); F = (F & CF) | SZP[B]; break;			/* IN   B,(C)       */
+	OP_CASE(0x41): OUT8<PRIMARY>(BC, B); break;						/* OUT  (C),B       */
+	OP_CASE(0x42): SBC16(bc); break;						/* SBC  HL,BC       */
+	OP_CASE(0x43): ea = FETCH16<PRIMARY, CACHED>(); WM16<PRIMARY>(ea, &bc); WZ = ea + 1; break;		/* LD   (w),BC      */
+	OP_CASE(0x44): NEG(); break;						/* NEG              */
+	OP_CASE(0x45): RETN(); break;						/* RETN             */
+	OP_CASE(0x46): im = 0; break;						/* im   0           */
+	OP_CASE(0x47): LD_I_A(); break;						/* LD   i,A         */
+	OP_CASE(0x48): C = IN8<PRIMARY>(BC); F = (F & CF) | SZP[C]; break;			/* IN   C,(C)       */
+	OP_CASE(0x49): OUT8<PRIMARY>(BC, C); break;						/* OUT  (C),C       */
+	OP_CASE(0x4a): ADC16(bc); break;						/* ADC  HL,BC       */
+	OP_CASE(0x4b): ea = FETCH16<PRIMARY, CACHED>(); RM16<PRIMARY>(ea, &bc); WZ = ea + 1; break;		/* LD   BC,(w)      */
+	OP_CASE(0x4c): NEG(); break;						/* NEG              */
+	OP_CASE(0x4d): RETI(); break;						/* RETI             */
+	OP_CASE(0x4e): im = 0; break;						/* im   0           */
+	OP_CASE(0x4f): LD_R_A(); break;						/* LD   r,A         */
+	OP_CASE(0x50): D = IN8<PRIMARY>(BC); F = (F & CF) | SZP[D]; break;			/* IN   D,(C)       */
+	OP_CASE(0x51): OUT8<PRIMARY>(BC, D); break;						/* OUT  (C),D       */
+	OP_CASE(0x52): SBC16(de); break;						/* SBC  HL,DE       */
+	OP_CASE(0x53): ea = FETCH16<PRIMARY, CACHED>(); WM16<PRIMARY>(ea, &de); WZ = ea + 1; break;		/* LD   (w),DE      */
+	OP_CASE(0x54): NEG(); break;						/* NEG              */
+	OP_CASE(0x55): RETN(); break;						/* RETN             */
+	OP_CASE(0x56): im = 1; break;						/* im   1           */
+	OP_CASE(0x57): LD_A_I(); break;						/* LD   A,i         */
+	OP_CASE(0x58): E = IN8<PRIMARY>(BC); F = (F & CF) | SZP[E]; break;			/* IN   E,(C)       */
+	OP_CASE(0x59): OUT8<PRIMARY>(BC, E); break;						/* OUT  (C),E       */
+	OP_CASE(0x5a): ADC16(de); break;						/* ADC  HL,DE       */
+	OP_CASE(0x5b): ea = FETCH16<PRIMARY, CACHED>(); RM16<PRIMARY>(ea, &de); WZ = ea + 1; break;		/* LD   DE,(w)      */
+	OP_CASE(0x5c): NEG(); break;						/* NEG              */
+	OP_CASE(0x5d): RETI(); break;						/* RETI             */
+	OP_CASE(0x5e): im = 2; break;						/* im   2           */
+	OP_CASE(0x5f): LD_A_R(); break;						/* LD   A,r         */
+	OP_CASE(0x60): H = IN8<PRIMARY>(BC); F = (F & CF) | SZP[H]; break;			/* IN   H,(C)       */
+	OP_CASE(0x61): OUT8<PRIMARY>(BC, H); break;						/* OUT  (C),H       */
+	OP_CASE(0x62): SBC16(hl); break;						/* SBC  HL,HL       */
+	OP_CASE(0x63): ea = FETCH16<PRIMARY, CACHED>(); WM16<PRIMARY>(ea, &hl); WZ = ea + 1; break;		/* LD   (w),HL      */
+	OP_CASE(0x64): NEG(); break;						/* NEG              */
+	OP_CASE(0x65): RETN(); break;						/* RETN             */
+	OP_CASE(0x66): im = 0; break;						/* im   0           */
+	OP_CASE(0x67): RRD(); break;						/* RRD  (HL)        */
+	OP_CASE(0x68): L = IN8<PRIMARY>(BC); F = (F & CF) | SZP[L]; break;			/* IN   L,(C)       */
+	OP_CASE(0x69): OUT8<PRIMARY>(BC, L); break;						/* OUT  (C),L       */
+	OP_CASE(0x6a): ADC16(hl); break;						/* ADC  HL,HL       */
+	OP_CASE(0x6b): ea = FETCH16<PRIMARY, CACHED>(); RM16<PRIMARY>(ea, &hl); WZ = ea + 1; break;		/* LD   HL,(w)      */
+	OP_CASE(0x6c): NEG(); break;						/* NEG              */
+	OP_CASE(0x6d): RETI(); break;						/* RETI             */
+	OP_CASE(0x6e): im = 0; break;						/* im   0           */
+	OP_CASE(0x6f): RLD(); break;						/* RLD  (HL)        */
+	OP_CASE(0x70): {uint8_t res = IN8<PRIMARY>(BC); F = (F & CF) | SZP[res];} break;	/* IN   F,(C)       */
+	OP_CASE(0x71): OUT8<PRIMARY>(BC, 0); break;						/* OUT  (C),0       */
+	OP_CASE(0x72): SBC16(sp); break;						/* SBC  HL,SP       */
+	OP_CASE(0x73): ea = FETCH16<PRIMARY, CACHED>(); WM16<PRIMARY>(ea, &sp); WZ = ea + 1; break;		/* LD   (w),SP      */
+	OP_CASE(0x74): NEG(); break;						/* NEG              */
+	OP_CASE(0x75): RETN(); break;						/* RETN             */
+	OP_CASE(0x76): im = 1; break;						/* im   1           */
+	OP_CASE(0x78): A = IN8<PRIMARY>(BC); F = (F & CF) | SZP[A]; WZ = BC + 1; break;	/* IN   A,(C)       */
+	OP_CASE(0x79): OUT8<PRIMARY>(BC, A); WZ = BC + 1; break;				/* OUT  (C),A       */
+	OP_CASE(0x7a): ADC16(sp); break;						/* ADC  HL,SP       */
+	OP_CASE(0x7b): ea = FETCH16<PRIMARY, CACHED>(); RM16<PRIMARY>(ea, &sp); WZ = ea + 1; break;		/* LD   SP,(w)      */
+	OP_CASE(0x7c): NEG(); break;						/* NEG              */
+	OP_CASE(0x7d): RETI(); break;						/* RETI             */
+	OP_CASE(0x7e): im = 2; break;						/* im   2           */
+	OP_CASE(0xa0): LDI(); break;						/* LDI              */
+	OP_CASE(0xa1): CPI(); break;						/* CPI              */
+	OP_CASE(0xa2): INI(); break;						/* INI              */
+	OP_CASE(0xa3): OUTI(); break;						/* OUTI             */
+	OP_CASE(0xa8): LDD(); break;						/* LDD              */
+	OP_CASE(0xa9): CPD(); break;						/* CPD              */
+	OP_CASE(0xaa): IND(); break;						/* IND              */
+	OP_CASE(0xab): OUTD(); break;						/* OUTD             */
+	OP_CASE(0xb0): LDIR(); break;						/* LDIR             */
+	OP_CASE(0xb1): CPIR(); break;						/* CPIR             */
+	OP_CASE(0xb2): INIR(); break;						/* INIR             */
+	OP_CASE(0xb3): OTIR(); break;						/* OTIR             */
+	OP_CASE(0xb8): LDDR(); break;						/* LDDR             */
+	OP_CASE(0xb9): CPDR(); break;						/* CPDR             */
+	OP_CASE(0xba): INDR(); break;						/* INDR             */
+	OP_CASE(0xbb): OTDR(); break;						/* OTDR             */
+	OP_DEFAULT: OP<PRIMARY, CACHED>(code); break;
+	} OP_DISPATCH_END;
 }
 
+template <bool PRIMARY, bool CACHED>
 void Z80::OP(uint8_t code)
 {
 	// Done: M1
@@ -1730,275 +2003,278 @@ void Z80::OP(uint8_t code)
 	prevpc = PC - 1;
 	icount -= cc_op[code];
 	
-	switch(code) {
-	case 0x00: break;												/* NOP              */
-	case 0x01: BC = FETCH16(); break;										/* LD   BC,w        */
-	case 0x02: WM8(BC, A); WZ_L = (BC + 1) & 0xff; WZ_H = A; break;							/* LD (BC),A        */
-	case 0x03: BC++; break;												/* INC  BC          */
-	case 0x04: B = INC(B); break;											/* INC  B           */
-	case 0x05: B = DEC(B); break;											/* DEC  B           */
-	case 0x06: B = FETCH8(); break;											/* LD   B,n         */
-	case 0x07: RLCA(); break;											/* RLCA             */
-	case 0x08: EX_AF(); break;											/* EX   AF,AF'      */
-	case 0x09: ADD16(hl, bc); break;										/* ADD  HL,BC       */
-	case 0x0a: A = RM8(BC); WZ = BC+1; break;									/* LD   A,(BC)      */
-	case 0x0b: BC--; break;												/* DEC  BC          */
-	case 0x0c: C = INC(C); break;											/* INC  C           */
-	case 0x0d: C = DEC(C); break;											/* DEC  C           */
-	case 0x0e: C = FETCH8(); break;											/* LD   C,n         */
-	case 0x0f: RRCA(); break;											/* RRCA             */
-	case 0x10: B--; JR_COND(B, 0x10); break;									/* DJNZ o           */
-	case 0x11: DE = FETCH16(); break;										/* LD   DE,w        */
-	case 0x12: WM8(DE, A); WZ_L = (DE + 1) & 0xff; WZ_H = A; break;							/* LD (DE),A        */
-	case 0x13: DE++; break;												/* INC  DE          */
-	case 0x14: D = INC(D); break;											/* INC  D           */
-	case 0x15: D = DEC(D); break;											/* DEC  D           */
-	case 0x16: D = FETCH8(); break;											/* LD   D,n         */
-	case 0x17: RLA(); break;											/* RLA              */
-	case 0x18: JR(); break;												/* JR   o           */
-	case 0x19: ADD16(hl, de); break;										/* ADD  HL,DE       */
-	case 0x1a: A = RM8(DE); WZ = DE + 1; break;									/* LD   A,(DE)      */
-	case 0x1b: DE--; break;												/* DEC  DE          */
-	case 0x1c: E = INC(E); break;											/* INC  E           */
-	case 0x1d: E = DEC(E); break;											/* DEC  E           */
-	case 0x1e: E = FETCH8(); break;											/* LD   E,n         */
-	case 0x1f: RRA(); break;											/* RRA              */
-	case 0x20: JR_COND(!(F & ZF), 0x20); break;									/* JR   NZ,o        */
-	case 0x21: HL = FETCH16(); break;										/* LD   HL,w        */
-	case 0x22: ea = FETCH16(); WM16(ea, &hl); WZ = ea + 1; break;							/* LD   (w),HL      */
-	case 0x23: HL++; break;												/* INC  HL          */
-	case 0x24: H = INC(H); break;											/* INC  H           */
-	case 0x25: H = DEC(H); break;											/* DEC  H           */
-	case 0x26: H = FETCH8(); break;											/* LD   H,n         */
-	case 0x27: DAA(); break;											/* DAA              */
-	case 0x28: JR_COND(F & ZF, 0x28); break;									/* JR   Z,o         */
-	case 0x29: ADD16(hl, hl); break;										/* ADD  HL,HL       */
-	case 0x2a: ea = FETCH16(); RM16(ea, &hl); WZ = ea + 1; break;							/* LD   HL,(w)      */
-	case 0x2b: HL--; break;												/* DEC  HL          */
-	case 0x2c: L = INC(L); break;											/* INC  L           */
-	case 0x2d: L = DEC(L); break;											/* DEC  L           */
-	case 0x2e: L = FETCH8(); break;											/* LD   L,n         */
-	case 0x2f: A ^= 0xff; F = (F & (SF | ZF | PF | CF)) | HF | NF | (A & (YF | XF)); break;				/* CPL              */
-	case 0x30: JR_COND(!(F & CF), 0x30); break;									/* JR   NC,o        */
-	case 0x31: SP = FETCH16(); break;										/* LD   SP,w        */
-	case 0x32: ea = FETCH16(); WM8(ea, A); WZ_L = (ea + 1) & 0xff; WZ_H = A; break;					/* LD   (w),A       */
-	case 0x33: SP++; break;												/* INC  SP          */
-	case 0x34: v = INC(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;							/* INC  (HL)        */
-	case 0x35: v = DEC(RM8(HL)); CLOCK_IN_OP(1); WM8(HL, v); break;							/* DEC  (HL)        */
-	case 0x36: WM8(HL, FETCH8()); break;										/* LD   (HL),n      */
-	case 0x37: F = (F & (SF | ZF | YF | XF | PF)) | CF | (A & (YF | XF)); break;					/* SCF              */
-	case 0x38: JR_COND(F & CF, 0x38); break;									/* JR   C,o         */
-	case 0x39: ADD16(hl, sp); break;										/* ADD  HL,SP       */
-	case 0x3a: ea = FETCH16(); A = RM8(ea); WZ = ea + 1; break;							/* LD   A,(w)       */
-	case 0x3b: SP--; break;												/* DEC  SP          */
-	case 0x3c: A = INC(A); break;											/* INC  A           */
-	case 0x3d: A = DEC(A); break;											/* DEC  A           */
-	case 0x3e: A = FETCH8(); break;											/* LD   A,n         */
-	case 0x3f: F = ((F & (SF | ZF | YF | XF | PF | CF)) | ((F & CF) << 4) | (A & (YF | XF))) ^ CF; break;		/* CCF              */
-	case 0x40: break;												/* LD   B,B         */
-	case 0x41: B = C; break;											/* LD   B,C         */
-	case 0x42: B = D; break;											/* LD   B,D         */
-	case 0x43: B = E; break;											/* LD   B,E         */
-	case 0x44: B = H; break;											/* LD   B,H         */
-	case 0x45: B = L; break;											/* LD   B,L         */
-	case 0x46: B = RM8(HL); break;											/* LD   B,(HL)      */
-	case 0x47: B = A; break;											/* LD   B,A         */
-	case 0x48: C = B; break;											/* LD   C,B         */
-	case 0x49: break;												/* LD   C,C         */
-	case 0x4a: C = D; break;											/* LD   C,D         */
-	case 0x4b: C = E; break;											/* LD   C,E         */
-	case 0x4c: C = H; break;											/* LD   C,H         */
-	case 0x4d: C = L; break;											/* LD   C,L         */
-	case 0x4e: C = RM8(HL); break;											/* LD   C,(HL)      */
-	case 0x4f: C = A; break;											/* LD   C,A         */
-	case 0x50: D = B; break;											/* LD   D,B         */
-	case 0x51: D = C; break;											/* LD   D,C         */
-	case 0x52: break;												/* LD   D,D         */
-	case 0x53: D = E; break;											/* LD   D,E         */
-	case 0x54: D = H; break;											/* LD   D,H         */
-	case 0x55: D = L; break;											/* LD   D,L         */
-	case 0x56: D = RM8(HL); break;											/* LD   D,(HL)      */
-	case 0x57: D = A; break;											/* LD   D,A         */
-	case 0x58: E = B; break;											/* LD   E,B         */
-	case 0x59: E = C; break;											/* LD   E,C         */
-	case 0x5a: E = D; break;											/* LD   E,D         */
-	case 0x5b: break;												/* LD   E,E         */
-	case 0x5c: E = H; break;											/* LD   E,H         */
-	case 0x5d: E = L; break;											/* LD   E,L         */
-	case 0x5e: E = RM8(HL); break;											/* LD   E,(HL)      */
-	case 0x5f: E = A; break;											/* LD   E,A         */
-	case 0x60: H = B; break;											/* LD   H,B         */
-	case 0x61: H = C; break;											/* LD   H,C         */
-	case 0x62: H = D; break;											/* LD   H,D         */
-	case 0x63: H = E; break;											/* LD   H,E         */
-	case 0x64: break;												/* LD   H,H         */
-	case 0x65: H = L; break;											/* LD   H,L         */
-	case 0x66: H = RM8(HL); break;											/* LD   H,(HL)      */
-	case 0x67: H = A; break;											/* LD   H,A         */
-	case 0x68: L = B; break;											/* LD   L,B         */
-	case 0x69: L = C; break;											/* LD   L,C         */
-	case 0x6a: L = D; break;											/* LD   L,D         */
-	case 0x6b: L = E; break;											/* LD   L,E         */
-	case 0x6c: L = H; break;											/* LD   L,H         */
-	case 0x6d: break;												/* LD   L,L         */
-	case 0x6e: L = RM8(HL); break;											/* LD   L,(HL)      */
-	case 0x6f: L = A; break;											/* LD   L,A         */
-	case 0x70: WM8(HL, B); break;											/* LD   (HL),B      */
-	case 0x71: WM8(HL, C); break;											/* LD   (HL),C      */
-	case 0x72: WM8(HL, D); break;											/* LD   (HL),D      */
-	case 0x73: WM8(HL, E); break;											/* LD   (HL),E      */
-	case 0x74: WM8(HL, H); break;											/* LD   (HL),H      */
-	case 0x75: WM8(HL, L); break;											/* LD   (HL),L      */
-	case 0x76: ENTER_HALT(); break;											/* halt             */
-	case 0x77: WM8(HL, A); break;											/* LD   (HL),A      */
-	case 0x78: A = B; break;											/* LD   A,B         */
-	case 0x79: A = C; break;											/* LD   A,C         */
-	case 0x7a: A = D; break;											/* LD   A,D         */
-	case 0x7b: A = E; break;											/* LD   A,E         */
-	case 0x7c: A = H; break;											/* LD   A,H         */
-	case 0x7d: A = L; break;											/* LD   A,L         */
-	case 0x7e: A = RM8(HL); break;											/* LD   A,(HL)      */
-	case 0x7f: break;												/* LD   A,A         */
-	case 0x80: ADD(B); break;											/* ADD  A,B         */
-	case 0x81: ADD(C); break;											/* ADD  A,C         */
-	case 0x82: ADD(D); break;											/* ADD  A,D         */
-	case 0x83: ADD(E); break;											/* ADD  A,E         */
-	case 0x84: ADD(H); break;											/* ADD  A,H         */
-	case 0x85: ADD(L); break;											/* ADD  A,L         */
-	case 0x86: ADD(RM8(HL)); break;											/* ADD  A,(HL)      */
-	case 0x87: ADD(A); break;											/* ADD  A,A         */
-	case 0x88: ADC(B); break;											/* ADC  A,B         */
-	case 0x89: ADC(C); break;											/* ADC  A,C         */
-	case 0x8a: ADC(D); break;											/* ADC  A,D         */
-	case 0x8b: ADC(E); break;											/* ADC  A,E         */
-	case 0x8c: ADC(H); break;											/* ADC  A,H         */
-	case 0x8d: ADC(L); break;											/* ADC  A,L         */
-	case 0x8e: ADC(RM8(HL)); break;											/* ADC  A,(HL)      */
-	case 0x8f: ADC(A); break;											/* ADC  A,A         */
-	case 0x90: SUB(B); break;											/* SUB  B           */
-	case 0x91: SUB(C); break;											/* SUB  C           */
-	case 0x92: SUB(D); break;											/* SUB  D           */
-	case 0x93: SUB(E); break;											/* SUB  E           */
-	case 0x94: SUB(H); break;											/* SUB  H           */
-	case 0x95: SUB(L); break;											/* SUB  L           */
-	case 0x96: SUB(RM8(HL)); break;											/* SUB  (HL)        */
-	case 0x97: SUB(A); break;											/* SUB  A           */
-	case 0x98: SBC(B); break;											/* SBC  A,B         */
-	case 0x99: SBC(C); break;											/* SBC  A,C         */
-	case 0x9a: SBC(D); break;											/* SBC  A,D         */
-	case 0x9b: SBC(E); break;											/* SBC  A,E         */
-	case 0x9c: SBC(H); break;											/* SBC  A,H         */
-	case 0x9d: SBC(L); break;											/* SBC  A,L         */
-	case 0x9e: SBC(RM8(HL)); break;											/* SBC  A,(HL)      */
-	case 0x9f: SBC(A); break;											/* SBC  A,A         */
-	case 0xa0: AND(B); break;											/* AND  B           */
-	case 0xa1: AND(C); break;											/* AND  C           */
-	case 0xa2: AND(D); break;											/* AND  D           */
-	case 0xa3: AND(E); break;											/* AND  E           */
-	case 0xa4: AND(H); break;											/* AND  H           */
-	case 0xa5: AND(L); break;											/* AND  L           */
-	case 0xa6: AND(RM8(HL)); break;											/* AND  (HL)        */
-	case 0xa7: AND(A); break;											/* AND  A           */
-	case 0xa8: XOR(B); break;											/* XOR  B           */
-	case 0xa9: XOR(C); break;											/* XOR  C           */
-	case 0xaa: XOR(D); break;											/* XOR  D           */
-	case 0xab: XOR(E); break;											/* XOR  E           */
-	case 0xac: XOR(H); break;											/* XOR  H           */
-	case 0xad: XOR(L); break;											/* XOR  L           */
-	case 0xae: XOR(RM8(HL)); break;											/* XOR  (HL)        */
-	case 0xaf: XOR(A); break;											/* XOR  A           */
-	case 0xb0: OR(B); break;											/* OR   B           */
-	case 0xb1: OR(C); break;											/* OR   C           */
-	case 0xb2: OR(D); break;											/* OR   D           */
-	case 0xb3: OR(E); break;											/* OR   E           */
-	case 0xb4: OR(H); break;											/* OR   H           */
-	case 0xb5: OR(L); break;											/* OR   L           */
-	case 0xb6: OR(RM8(HL)); break;											/* OR   (HL)        */
-	case 0xb7: OR(A); break;											/* OR   A           */
-	case 0xb8: CP(B); break;											/* CP   B           */
-	case 0xb9: CP(C); break;											/* CP   C           */
-	case 0xba: CP(D); break;											/* CP   D           */
-	case 0xbb: CP(E); break;											/* CP   E           */
-	case 0xbc: CP(H); break;											/* CP   H           */
-	case 0xbd: CP(L); break;											/* CP   L           */
-	case 0xbe: CP(RM8(HL)); break;											/* CP   (HL)        */
-	case 0xbf: CP(A); break;											/* CP   A           */
-	case 0xc0: RET_COND(!(F & ZF), 0xc0); break;									/* RET  NZ          */
-	case 0xc1: POP(bc); break;											/* POP  BC          */
-	case 0xc2: JP_COND(!(F & ZF)); break;										/* JP   NZ,a        */
-	case 0xc3: JP(); break;												/* JP   a           */
-	case 0xc4: CALL_COND(!(F & ZF), 0xc4); break;									/* CALL NZ,a        */
-	case 0xc5: PUSH(bc); break;											/* PUSH BC          */
-	case 0xc6: ADD(FETCH8()); break;										/* ADD  A,n         */
-	case 0xc7: RST(0x00); break;											/* RST  0           */
-	case 0xc8: RET_COND(F & ZF, 0xc8); break;									/* RET  Z           */
+#ifdef Z80_USE_COMPUTED_GOTO
+	static const void* const op_table[256] = OP_TABLE_ALL;
+#endif
+	OP_DISPATCH(op_table, code) {
+	OP_CASE(0x00): break;												/* NOP              */
+	OP_CASE(0x01): BC = FETCH16<PRIMARY, CACHED>(); break;										/* LD   BC,w        */
+	OP_CASE(0x02): WM8<PRIMARY>(BC, A); WZ_L = (BC + 1) & 0xff; WZ_H = A; break;							/* LD (BC),A        */
+	OP_CASE(0x03): BC++; break;												/* INC  BC          */
+	OP_CASE(0x04): B = INC(B); break;											/* INC  B           */
+	OP_CASE(0x05): B = DEC(B); break;											/* DEC  B           */
+	OP_CASE(0x06): B = FETCH8<PRIMARY, CACHED>(); break;											/* LD   B,n         */
+	OP_CASE(0x07): RLCA(); break;											/* RLCA             */
+	OP_CASE(0x08): EX_AF(); break;											/* EX   AF,AF'      */
+	OP_CASE(0x09): ADD16(hl, bc); break;										/* ADD  HL,BC       */
+	OP_CASE(0x0a): A = RM8<PRIMARY>(BC); WZ = BC+1; break;									/* LD   A,(BC)      */
+	OP_CASE(0x0b): BC--; break;												/* DEC  BC          */
+	OP_CASE(0x0c): C = INC(C); break;											/* INC  C           */
+	OP_CASE(0x0d): C = DEC(C); break;											/* DEC  C           */
+	OP_CASE(0x0e): C = FETCH8<PRIMARY, CACHED>(); break;											/* LD   C,n         */
+	OP_CASE(0x0f): RRCA(); break;											/* RRCA             */
+	OP_CASE(0x10): B--; JR_COND(B, 0x10); break;									/* DJNZ o           */
+	OP_CASE(0x11): DE = FETCH16<PRIMARY, CACHED>(); break;										/* LD   DE,w        */
+	OP_CASE(0x12): WM8<PRIMARY>(DE, A); WZ_L = (DE + 1) & 0xff; WZ_H = A; break;							/* LD (DE),A        */
+	OP_CASE(0x13): DE++; break;												/* INC  DE          */
+	OP_CASE(0x14): D = INC(D); break;											/* INC  D           */
+	OP_CASE(0x15): D = DEC(D); break;											/* DEC  D           */
+	OP_CASE(0x16): D = FETCH8<PRIMARY, CACHED>(); break;											/* LD   D,n         */
+	OP_CASE(0x17): RLA(); break;											/* RLA              */
+	OP_CASE(0x18): JR(); break;												/* JR   o           */
+	OP_CASE(0x19): ADD16(hl, de); break;										/* ADD  HL,DE       */
+	OP_CASE(0x1a): A = RM8<PRIMARY>(DE); WZ = DE + 1; break;									/* LD   A,(DE)      */
+	OP_CASE(0x1b): DE--; break;												/* DEC  DE          */
+	OP_CASE(0x1c): E = INC(E); break;											/* INC  E           */
+	OP_CASE(0x1d): E = DEC(E); break;											/* DEC  E           */
+	OP_CASE(0x1e): E = FETCH8<PRIMARY, CACHED>(); break;											/* LD   E,n         */
+	OP_CASE(0x1f): RRA(); break;											/* RRA              */
+	OP_CASE(0x20): JR_COND(!(F & ZF), 0x20); break;									/* JR   NZ,o        */
+	OP_CASE(0x21): HL = FETCH16<PRIMARY, CACHED>(); break;										/* LD   HL,w        */
+	OP_CASE(0x22): ea = FETCH16<PRIMARY, CACHED>(); WM16<PRIMARY>(ea, &hl); WZ = ea + 1; break;							/* LD   (w),HL      */
+	OP_CASE(0x23): HL++; break;												/* INC  HL          */
+	OP_CASE(0x24): H = INC(H); break;											/* INC  H           */
+	OP_CASE(0x25): H = DEC(H); break;											/* DEC  H           */
+	OP_CASE(0x26): H = FETCH8<PRIMARY, CACHED>(); break;											/* LD   H,n         */
+	OP_CASE(0x27): DAA(); break;											/* DAA              */
+	OP_CASE(0x28): JR_COND(F & ZF, 0x28); break;									/* JR   Z,o         */
+	OP_CASE(0x29): ADD16(hl, hl); break;										/* ADD  HL,HL       */
+	OP_CASE(0x2a): ea = FETCH16<PRIMARY, CACHED>(); RM16<PRIMARY>(ea, &hl); WZ = ea + 1; break;							/* LD   HL,(w)      */
+	OP_CASE(0x2b): HL--; break;												/* DEC  HL          */
+	OP_CASE(0x2c): L = INC(L); break;											/* INC  L           */
+	OP_CASE(0x2d): L = DEC(L); break;											/* DEC  L           */
+	OP_CASE(0x2e): L = FETCH8<PRIMARY, CACHED>(); break;											/* LD   L,n         */
+	OP_CASE(0x2f): A ^= 0xff; F = (F & (SF | ZF | PF | CF)) | HF | NF | (A & (YF | XF)); break;				/* CPL              */
+	OP_CASE(0x30): JR_COND(!(F & CF), 0x30); break;									/* JR   NC,o        */
+	OP_CASE(0x31): SP = FETCH16<PRIMARY, CACHED>(); break;										/* LD   SP,w        */
+	OP_CASE(0x32): ea = FETCH16<PRIMARY, CACHED>(); WM8<PRIMARY>(ea, A); WZ_L = (ea + 1) & 0xff; WZ_H = A; break;					/* LD   (w),A       */
+	OP_CASE(0x33): SP++; break;												/* INC  SP          */
+	OP_CASE(0x34): v = INC(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;							/* INC  (HL)        */
+	OP_CASE(0x35): v = DEC(RM8<PRIMARY>(HL)); CLOCK_IN_OP(1); WM8<PRIMARY>(HL, v); break;							/* DEC  (HL)        */
+	OP_CASE(0x36): WM8<PRIMARY>(HL, FETCH8<PRIMARY, CACHED>()); break;										/* LD   (HL),n      */
+	OP_CASE(0x37): F = (F & (SF | ZF | YF | XF | PF)) | CF | (A & (YF | XF)); break;					/* SCF              */
+	OP_CASE(0x38): JR_COND(F & CF, 0x38); break;									/* JR   C,o         */
+	OP_CASE(0x39): ADD16(hl, sp); break;										/* ADD  HL,SP       */
+	OP_CASE(0x3a): ea = FETCH16<PRIMARY, CACHED>(); A = RM8<PRIMARY>(ea); WZ = ea + 1; break;							/* LD   A,(w)       */
+	OP_CASE(0x3b): SP--; break;												/* DEC  SP          */
+	OP_CASE(0x3c): A = INC(A); break;											/* INC  A           */
+	OP_CASE(0x3d): A = DEC(A); break;											/* DEC  A           */
+	OP_CASE(0x3e): A = FETCH8<PRIMARY, CACHED>(); break;											/* LD   A,n         */
+	OP_CASE(0x3f): F = ((F & (SF | ZF | YF | XF | PF | CF)) | ((F & CF) << 4) | (A & (YF | XF))) ^ CF; break;		/* CCF              */
+	OP_CASE(0x40): break;												/* LD   B,B         */
+	OP_CASE(0x41): B = C; break;											/* LD   B,C         */
+	OP_CASE(0x42): B = D; break;											/* LD   B,D         */
+	OP_CASE(0x43): B = E; break;											/* LD   B,E         */
+	OP_CASE(0x44): B = H; break;											/* LD   B,H         */
+	OP_CASE(0x45): B = L; break;											/* LD   B,L         */
+	OP_CASE(0x46): B = RM8<PRIMARY>(HL); break;											/* LD   B,(HL)      */
+	OP_CASE(0x47): B = A; break;											/* LD   B,A         */
+	OP_CASE(0x48): C = B; break;											/* LD   C,B         */
+	OP_CASE(0x49): break;												/* LD   C,C         */
+	OP_CASE(0x4a): C = D; break;											/* LD   C,D         */
+	OP_CASE(0x4b): C = E; break;											/* LD   C,E         */
+	OP_CASE(0x4c): C = H; break;											/* LD   C,H         */
+	OP_CASE(0x4d): C = L; break;											/* LD   C,L         */
+	OP_CASE(0x4e): C = RM8<PRIMARY>(HL); break;											/* LD   C,(HL)      */
+	OP_CASE(0x4f): C = A; break;											/* LD   C,A         */
+	OP_CASE(0x50): D = B; break;											/* LD   D,B         */
+	OP_CASE(0x51): D = C; break;											/* LD   D,C         */
+	OP_CASE(0x52): break;												/* LD   D,D         */
+	OP_CASE(0x53): D = E; break;											/* LD   D,E         */
+	OP_CASE(0x54): D = H; break;											/* LD   D,H         */
+	OP_CASE(0x55): D = L; break;											/* LD   D,L         */
+	OP_CASE(0x56): D = RM8<PRIMARY>(HL); break;											/* LD   D,(HL)      */
+	OP_CASE(0x57): D = A; break;											/* LD   D,A         */
+	OP_CASE(0x58): E = B; break;											/* LD   E,B         */
+	OP_CASE(0x59): E = C; break;											/* LD   E,C         */
+	OP_CASE(0x5a): E = D; break;											/* LD   E,D         */
+	OP_CASE(0x5b): break;												/* LD   E,E         */
+	OP_CASE(0x5c): E = H; break;											/* LD   E,H         */
+	OP_CASE(0x5d): E = L; break;											/* LD   E,L         */
+	OP_CASE(0x5e): E = RM8<PRIMARY>(HL); break;											/* LD   E,(HL)      */
+	OP_CASE(0x5f): E = A; break;											/* LD   E,A         */
+	OP_CASE(0x60): H = B; break;											/* LD   H,B         */
+	OP_CASE(0x61): H = C; break;											/* LD   H,C         */
+	OP_CASE(0x62): H = D; break;											/* LD   H,D         */
+	OP_CASE(0x63): H = E; break;											/* LD   H,E         */
+	OP_CASE(0x64): break;												/* LD   H,H         */
+	OP_CASE(0x65): H = L; break;											/* LD   H,L         */
+	OP_CASE(0x66): H = RM8<PRIMARY>(HL); break;											/* LD   H,(HL)      */
+	OP_CASE(0x67): H = A; break;											/* LD   H,A         */
+	OP_CASE(0x68): L = B; break;											/* LD   L,B         */
+	OP_CASE(0x69): L = C; break;											/* LD   L,C         */
+	OP_CASE(0x6a): L = D; break;											/* LD   L,D         */
+	OP_CASE(0x6b): L = E; break;											/* LD   L,E         */
+	OP_CASE(0x6c): L = H; break;											/* LD   L,H         */
+	OP_CASE(0x6d): break;												/* LD   L,L         */
+	OP_CASE(0x6e): L = RM8<PRIMARY>(HL); break;											/* LD   L,(HL)      */
+	OP_CASE(0x6f): L = A; break;											/* LD   L,A         */
+	OP_CASE(0x70): WM8<PRIMARY>(HL, B); break;											/* LD   (HL),B      */
+	OP_CASE(0x71): WM8<PRIMARY>(HL, C); break;											/* LD   (HL),C      */
+	OP_CASE(0x72): WM8<PRIMARY>(HL, D); break;											/* LD   (HL),D      */
+	OP_CASE(0x73): WM8<PRIMARY>(HL, E); break;											/* LD   (HL),E      */
+	OP_CASE(0x74): WM8<PRIMARY>(HL, H); break;											/* LD   (HL),H      */
+	OP_CASE(0x75): WM8<PRIMARY>(HL, L); break;											/* LD   (HL),L      */
+	OP_CASE(0x76): ENTER_HALT(); break;											/* halt             */
+	OP_CASE(0x77): WM8<PRIMARY>(HL, A); break;											/* LD   (HL),A      */
+	OP_CASE(0x78): A = B; break;											/* LD   A,B         */
+	OP_CASE(0x79): A = C; break;											/* LD   A,C         */
+	OP_CASE(0x7a): A = D; break;											/* LD   A,D         */
+	OP_CASE(0x7b): A = E; break;											/* LD   A,E         */
+	OP_CASE(0x7c): A = H; break;											/* LD   A,H         */
+	OP_CASE(0x7d): A = L; break;											/* LD   A,L         */
+	OP_CASE(0x7e): A = RM8<PRIMARY>(HL); break;											/* LD   A,(HL)      */
+	OP_CASE(0x7f): break;												/* LD   A,A         */
+	OP_CASE(0x80): ADD(B); break;											/* ADD  A,B         */
+	OP_CASE(0x81): ADD(C); break;											/* ADD  A,C         */
+	OP_CASE(0x82): ADD(D); break;											/* ADD  A,D         */
+	OP_CASE(0x83): ADD(E); break;											/* ADD  A,E         */
+	OP_CASE(0x84): ADD(H); break;											/* ADD  A,H         */
+	OP_CASE(0x85): ADD(L); break;											/* ADD  A,L         */
+	OP_CASE(0x86): ADD(RM8<PRIMARY>(HL)); break;											/* ADD  A,(HL)      */
+	OP_CASE(0x87): ADD(A); break;											/* ADD  A,A         */
+	OP_CASE(0x88): ADC(B); break;											/* ADC  A,B         */
+	OP_CASE(0x89): ADC(C); break;											/* ADC  A,C         */
+	OP_CASE(0x8a): ADC(D); break;											/* ADC  A,D         */
+	OP_CASE(0x8b): ADC(E); break;											/* ADC  A,E         */
+	OP_CASE(0x8c): ADC(H); break;											/* ADC  A,H         */
+	OP_CASE(0x8d): ADC(L); break;											/* ADC  A,L         */
+	OP_CASE(0x8e): ADC(RM8<PRIMARY>(HL)); break;											/* ADC  A,(HL)      */
+	OP_CASE(0x8f): ADC(A); break;											/* ADC  A,A         */
+	OP_CASE(0x90): SUB(B); break;											/* SUB  B           */
+	OP_CASE(0x91): SUB(C); break;											/* SUB  C           */
+	OP_CASE(0x92): SUB(D); break;											/* SUB  D           */
+	OP_CASE(0x93): SUB(E); break;											/* SUB  E           */
+	OP_CASE(0x94): SUB(H); break;											/* SUB  H           */
+	OP_CASE(0x95): SUB(L); break;											/* SUB  L           */
+	OP_CASE(0x96): SUB(RM8<PRIMARY>(HL)); break;											/* SUB  (HL)        */
+	OP_CASE(0x97): SUB(A); break;											/* SUB  A           */
+	OP_CASE(0x98): SBC(B); break;											/* SBC  A,B         */
+	OP_CASE(0x99): SBC(C); break;											/* SBC  A,C         */
+	OP_CASE(0x9a): SBC(D); break;											/* SBC  A,D         */
+	OP_CASE(0x9b): SBC(E); break;											/* SBC  A,E         */
+	OP_CASE(0x9c): SBC(H); break;											/* SBC  A,H         */
+	OP_CASE(0x9d): SBC(L); break;											/* SBC  A,L         */
+	OP_CASE(0x9e): SBC(RM8<PRIMARY>(HL)); break;											/* SBC  A,(HL)      */
+	OP_CASE(0x9f): SBC(A); break;											/* SBC  A,A         */
+	OP_CASE(0xa0): AND(B); break;											/* AND  B           */
+	OP_CASE(0xa1): AND(C); break;											/* AND  C           */
+	OP_CASE(0xa2): AND(D); break;											/* AND  D           */
+	OP_CASE(0xa3): AND(E); break;											/* AND  E           */
+	OP_CASE(0xa4): AND(H); break;											/* AND  H           */
+	OP_CASE(0xa5): AND(L); break;											/* AND  L           */
+	OP_CASE(0xa6): AND(RM8<PRIMARY>(HL)); break;											/* AND  (HL)        */
+	OP_CASE(0xa7): AND(A); break;											/* AND  A           */
+	OP_CASE(0xa8): XOR(B); break;											/* XOR  B           */
+	OP_CASE(0xa9): XOR(C); break;											/* XOR  C           */
+	OP_CASE(0xaa): XOR(D); break;											/* XOR  D           */
+	OP_CASE(0xab): XOR(E); break;											/* XOR  E           */
+	OP_CASE(0xac): XOR(H); break;											/* XOR  H           */
+	OP_CASE(0xad): XOR(L); break;											/* XOR  L           */
+	OP_CASE(0xae): XOR(RM8<PRIMARY>(HL)); break;											/* XOR  (HL)        */
+	OP_CASE(0xaf): XOR(A); break;											/* XOR  A           */
+	OP_CASE(0xb0): OR(B); break;											/* OR   B           */
+	OP_CASE(0xb1): OR(C); break;											/* OR   C           */
+	OP_CASE(0xb2): OR(D); break;											/* OR   D           */
+	OP_CASE(0xb3): OR(E); break;											/* OR   E           */
+	OP_CASE(0xb4): OR(H); break;											/* OR   H           */
+	OP_CASE(0xb5): OR(L); break;											/* OR   L           */
+	OP_CASE(0xb6): OR(RM8<PRIMARY>(HL)); break;											/* OR   (HL)        */
+	OP_CASE(0xb7): OR(A); break;											/* OR   A           */
+	OP_CASE(0xb8): CP(B); break;											/* CP   B           */
+	OP_CASE(0xb9): CP(C); break;											/* CP   C           */
+	OP_CASE(0xba): CP(D); break;											/* CP   D           */
+	OP_CASE(0xbb): CP(E); break;											/* CP   E           */
+	OP_CASE(0xbc): CP(H); break;											/* CP   H           */
+	OP_CASE(0xbd): CP(L); break;											/* CP   L           */
+	OP_CASE(0xbe): CP(RM8<PRIMARY>(HL)); break;											/* CP   (HL)        */
+	OP_CASE(0xbf): CP(A); break;											/* CP   A           */
+	OP_CASE(0xc0): RET_COND(!(F & ZF), 0xc0); break;									/* RET  NZ          */
+	OP_CASE(0xc1): POP(bc); break;											/* POP  BC          */
+	OP_CASE(0xc2): JP_COND(!(F & ZF)); break;										/* JP   NZ,a        */
+	OP_CASE(0xc3): JP(); break;												/* JP   a           */
+	OP_CASE(0xc4): CALL_COND(!(F & ZF), 0xc4); break;									/* CALL NZ,a        */
+	OP_CASE(0xc5): PUSH(bc); break;											/* PUSH BC          */
+	OP_CASE(0xc6): ADD((FETCH8<PRIMARY, CACHED>())); break;										/* ADD  A,n         */
+	OP_CASE(0xc7): RST(0x00); break;											/* RST  0           */
+	OP_CASE(0xc8): RET_COND(F & ZF, 0xc8); break;									/* RET  Z           */
 #ifdef Z80_PSEUDO_BIOS
-	case 0xc9:
+	OP_CASE(0xc9):
 		if(d_bios != NULL) {
 			d_bios->bios_ret_z80(prevpc, &af, &bc, &de, &hl, &ix, &iy, &iff1);
 		}
 		POP(pc); WZ = PCD; break;										/* RET              */
 #else
-	case 0xc9: POP(pc); WZ = PCD; break;										/* RET              */
+	OP_CASE(0xc9): POP(pc); WZ = PCD; break;										/* RET              */
 #endif
-	case 0xca: JP_COND(F & ZF); break;										/* JP   Z,a         */
-	case 0xcb: OP_CB(FETCHOP()); break;										/* **** CB xx       */
-	case 0xcc: CALL_COND(F & ZF, 0xcc); break;									/* CALL Z,a         */
-	case 0xcd: CALL(); break;											/* CALL a           */
-	case 0xce: ADC(FETCH8()); break;										/* ADC  A,n         */
-	case 0xcf: RST(0x08); break;											/* RST  1           */
-	case 0xd0: RET_COND(!(F & CF), 0xd0); break;									/* RET  NC          */
-	case 0xd1: POP(de); break;											/* POP  DE          */
-	case 0xd2: JP_COND(!(F & CF)); break;										/* JP   NC,a        */
-	case 0xd3: {unsigned n = FETCH8() | (A << 8); OUT8(n, A); WZ_L = ((n & 0xff) + 1) & 0xff; WZ_H = A;} break;	/* OUT  (n),A       */
-	case 0xd4: CALL_COND(!(F & CF), 0xd4); break;									/* CALL NC,a        */
-	case 0xd5: PUSH(de); break;											/* PUSH DE          */
-	case 0xd6: SUB(FETCH8()); break;										/* SUB  n           */
-	case 0xd7: RST(0x10); break;											/* RST  2           */
-	case 0xd8: RET_COND(F & CF, 0xd8); break;									/* RET  C           */
-	case 0xd9: EXX(); break;											/* EXX              */
-	case 0xda: JP_COND(F & CF); break;										/* JP   C,a         */
-	case 0xdb: {unsigned n = FETCH8() | (A << 8); A = IN8(n); WZ = n + 1;} break;					/* IN   A,(n)       */
-	case 0xdc: CALL_COND(F & CF, 0xdc); break;									/* CALL C,a         */
-	case 0xdd: OP_DD(FETCHOP()); break;										/* **** DD xx       */
-	case 0xde: SBC(FETCH8()); break;										/* SBC  A,n         */
-	case 0xdf: RST(0x18); break;											/* RST  3           */
-	case 0xe0: RET_COND(!(F & PF), 0xe0); break;									/* RET  PO          */
-	case 0xe1: POP(hl); break;											/* POP  HL          */
-	case 0xe2: JP_COND(!(F & PF)); break;										/* JP   PO,a        */
-	case 0xe3: EXSP(hl); break;											/* EX   HL,(SP)     */
-	case 0xe4: CALL_COND(!(F & PF), 0xe4); break;									/* CALL PO,a        */
-	case 0xe5: PUSH(hl); break;											/* PUSH HL          */
-	case 0xe6: AND(FETCH8()); break;										/* AND  n           */
-	case 0xe7: RST(0x20); break;											/* RST  4           */
-	case 0xe8: RET_COND(F & PF, 0xe8); break;									/* RET  PE          */
-	case 0xe9: PC = HL; break;											/* JP   (HL)        */
-	case 0xea: JP_COND(F & PF); break;										/* JP   PE,a        */
-	case 0xeb: EX_DE_HL(); break;											/* EX   DE,HL       */
-	case 0xec: CALL_COND(F & PF, 0xec); break;									/* CALL PE,a        */
-	case 0xed: OP_ED(FETCHOP()); break;										/* **** ED xx       */
-	case 0xee: XOR(FETCH8()); break;										/* XOR  n           */
-	case 0xef: RST(0x28); break;											/* RST  5           */
-	case 0xf0: RET_COND(!(F & SF), 0xf0); break;									/* RET  P           */
-	case 0xf1: POP(af); break;											/* POP  AF          */
-	case 0xf2: JP_COND(!(F & SF)); break;										/* JP   P,a         */
-	case 0xf3: iff1 = iff2 = 0; after_di = true; break;								/* DI               */
-	case 0xf4: CALL_COND(!(F & SF), 0xf4); break;									/* CALL P,a         */
-	case 0xf5: PUSH(af); break;											/* PUSH AF          */
-	case 0xf6: OR(FETCH8()); break;											/* OR   n           */
-	case 0xf7: RST(0x30); break;											/* RST  6           */
-	case 0xf8: RET_COND(F & SF, 0xf8); break;									/* RET  M           */
-	case 0xf9: SP = HL; break;											/* LD   SP,HL       */
-	case 0xfa: JP_COND(F & SF); break;										/* JP   M,a         */
-	case 0xfb: EI(); break;												/* EI               */
-	case 0xfc: CALL_COND(F & SF, 0xfc); break;									/* CALL M,a         */
-	case 0xfd: OP_FD(FETCHOP()); break;										/* **** FD xx       */
-	case 0xfe: CP(FETCH8()); break;											/* CP   n           */
-	case 0xff: RST(0x38); break;											/* RST  7           */
+	OP_CASE(0xca): JP_COND(F & ZF); break;										/* JP   Z,a         */
+	OP_CASE(0xcb): OP_CB<PRIMARY, CACHED>(FETCHOP<PRIMARY, CACHED>()); break;										/* **** CB xx       */
+	OP_CASE(0xcc): CALL_COND(F & ZF, 0xcc); break;									/* CALL Z,a         */
+	OP_CASE(0xcd): CALL(); break;											/* CALL a           */
+	OP_CASE(0xce): ADC((FETCH8<PRIMARY, CACHED>())); break;										/* ADC  A,n         */
+	OP_CASE(0xcf): RST(0x08); break;											/* RST  1           */
+	OP_CASE(0xd0): RET_COND(!(F & CF), 0xd0); break;									/* RET  NC          */
+	OP_CASE(0xd1): POP(de); break;											/* POP  DE          */
+	OP_CASE(0xd2): JP_COND(!(F & CF)); break;										/* JP   NC,a        */
+	OP_CASE(0xd3): {unsigned n = FETCH8<PRIMARY, CACHED>() | (A << 8); OUT8<PRIMARY>(n, A); WZ_L = ((n & 0xff) + 1) & 0xff; WZ_H = A;} break;	/* OUT  (n),A       */
+	OP_CASE(0xd4): CALL_COND(!(F & CF), 0xd4); break;									/* CALL NC,a        */
+	OP_CASE(0xd5): PUSH(de); break;											/* PUSH DE          */
+	OP_CASE(0xd6): SUB((FETCH8<PRIMARY, CACHED>())); break;										/* SUB  n           */
+	OP_CASE(0xd7): RST(0x10); break;											/* RST  2           */
+	OP_CASE(0xd8): RET_COND(F & CF, 0xd8); break;									/* RET  C           */
+	OP_CASE(0xd9): EXX(); break;											/* EXX              */
+	OP_CASE(0xda): JP_COND(F & CF); break;										/* JP   C,a         */
+	OP_CASE(0xdb): {unsigned n = FETCH8<PRIMARY, CACHED>() | (A << 8); A = IN8<PRIMARY>(n); WZ = n + 1;} break;					/* IN   A,(n)       */
+	OP_CASE(0xdc): CALL_COND(F & CF, 0xdc); break;									/* CALL C,a         */
+	OP_CASE(0xdd): OP_DD<PRIMARY, CACHED>(FETCHOP<PRIMARY, CACHED>()); break;										/* **** DD xx       */
+	OP_CASE(0xde): SBC((FETCH8<PRIMARY, CACHED>())); break;										/* SBC  A,n         */
+	OP_CASE(0xdf): RST(0x18); break;											/* RST  3           */
+	OP_CASE(0xe0): RET_COND(!(F & PF), 0xe0); break;									/* RET  PO          */
+	OP_CASE(0xe1): POP(hl); break;											/* POP  HL          */
+	OP_CASE(0xe2): JP_COND(!(F & PF)); break;										/* JP   PO,a        */
+	OP_CASE(0xe3): EXSP(hl); break;											/* EX   HL,(SP)     */
+	OP_CASE(0xe4): CALL_COND(!(F & PF), 0xe4); break;									/* CALL PO,a        */
+	OP_CASE(0xe5): PUSH(hl); break;											/* PUSH HL          */
+	OP_CASE(0xe6): AND((FETCH8<PRIMARY, CACHED>())); break;										/* AND  n           */
+	OP_CASE(0xe7): RST(0x20); break;											/* RST  4           */
+	OP_CASE(0xe8): RET_COND(F & PF, 0xe8); break;									/* RET  PE          */
+	OP_CASE(0xe9): PC = HL; break;											/* JP   (HL)        */
+	OP_CASE(0xea): JP_COND(F & PF); break;										/* JP   PE,a        */
+	OP_CASE(0xeb): EX_DE_HL(); break;											/* EX   DE,HL       */
+	OP_CASE(0xec): CALL_COND(F & PF, 0xec); break;									/* CALL PE,a        */
+	OP_CASE(0xed): OP_ED<PRIMARY, CACHED>(FETCHOP<PRIMARY, CACHED>()); break;										/* **** ED xx       */
+	OP_CASE(0xee): XOR((FETCH8<PRIMARY, CACHED>())); break;										/* XOR  n           */
+	OP_CASE(0xef): RST(0x28); break;											/* RST  5           */
+	OP_CASE(0xf0): RET_COND(!(F & SF), 0xf0); break;									/* RET  P           */
+	OP_CASE(0xf1): POP(af); break;											/* POP  AF          */
+	OP_CASE(0xf2): JP_COND(!(F & SF)); break;										/* JP   P,a         */
+	OP_CASE(0xf3): iff1 = iff2 = 0; after_di = true; break;								/* DI               */
+	OP_CASE(0xf4): CALL_COND(!(F & SF), 0xf4); break;									/* CALL P,a         */
+	OP_CASE(0xf5): PUSH(af); break;											/* PUSH AF          */
+	OP_CASE(0xf6): OR((FETCH8<PRIMARY, CACHED>())); break;											/* OR   n           */
+	OP_CASE(0xf7): RST(0x30); break;											/* RST  6           */
+	OP_CASE(0xf8): RET_COND(F & SF, 0xf8); break;									/* RET  M           */
+	OP_CASE(0xf9): SP = HL; break;											/* LD   SP,HL       */
+	OP_CASE(0xfa): JP_COND(F & SF); break;										/* JP   M,a         */
+	OP_CASE(0xfb): EI(); break;												/* EI               */
+	OP_CASE(0xfc): CALL_COND(F & SF, 0xfc); break;									/* CALL M,a         */
+	OP_CASE(0xfd): OP_FD<PRIMARY, CACHED>(FETCHOP<PRIMARY, CACHED>()); break;										/* **** FD xx       */
+	OP_CASE(0xfe): CP((FETCH8<PRIMARY, CACHED>())); break;											/* CP   n           */
+	OP_CASE(0xff): RST(0x38); break;											/* RST  7           */
 #if defined(_MSC_VER) && (_MSC_VER >= 1200)
 	default: __assume(0);
 #endif
-	}
+	} OP_DISPATCH_END;
 }
 
 // main
@@ -2075,10 +2351,14 @@ void Z80::initialize()
 		flags_initialized = true;
 	}
 	is_primary = is_primary_cpu(this);
+	idle_skip = is_primary ? config.skip_main_cpu_idle : config.skip_sub_cpu_idle;
+	flush_block_cache();
+	update_block_cache();
 	
 #ifdef USE_DEBUGGER
 	d_mem_stored = d_mem;
 	d_io_stored = d_io;
+	mem_pages_stored = mem_pages;
 	d_debugger->set_context_mem(d_mem);
 	d_debugger->set_context_io(d_io);
 #endif
@@ -2102,11 +2382,40 @@ void Z80::special_reset()
 	intr_enb = true;
 }
 
+void Z80::release()
+{
+	if(uops != NULL) {
+		free(uops);
+		uops = NULL;
+	}
+}
+
 void Z80::reset()
 {
 	IXD = IYD = 0xffff;	/* IX and IY are FFFF after a reset! */
 	special_reset();
-	icount = dma_icount = wait_icount = 0;
+	icount = dma_icount = wait_icount = run_icount = 0;
+	idle_dirty = true;
+	flush_block_cache();
+}
+
+void Z80::update_config()
+{
+	idle_skip = is_primary ? config.skip_main_cpu_idle : config.skip_sub_cpu_idle;
+	update_block_cache();
+}
+
+void Z80::update_block_cache()
+{
+	// opecodes are decoded only from the memory mapped to the page table
+	if(config.z80_block_cache && mem_pages != NULL) {
+		if(uops == NULL) {
+			uops = (uop_t *)calloc(0x10000, sizeof(uop_t));
+			flush_block_cache();
+		}
+	} else {
+		release();
+	}
 }
 
 void Z80::write_signal(int id, uint32_t data, uint32_t mask)
@@ -2122,6 +2431,9 @@ void Z80::write_signal(int id, uint32_t data, uint32_t mask)
 		write_signals(&outputs_busack, busreq ? 0xffffffff : 0);
 	} else if(id == SIG_CPU_WAIT) {
 		wait = ((data & mask) != 0);
+	} else if(id == SIG_Z80_IDLE_POLL) {
+		// the port now being read is a status port without side effects
+		idle_poll = true;
 #ifdef HAS_NSC800
 	} else if(id == SIG_NSC800_INT) {
 		intr_req_bit = (data & mask) ? (intr_req_bit | 1) : (intr_req_bit & ~1);
@@ -2143,6 +2455,50 @@ uint32_t Z80::read_signal(int id)
 	return 0;
 }
 
+// run one opecode with the implementation specialized for primary/sub cpu and
+// the debugger state, so that the normal path has no checks for them
+#ifdef USE_DEBUGGER
+#define RUN_ONE_OPECODE(primary) do { \
+	if(d_debugger->now_debugging) { \
+		run_one_opecode<primary, true>(); \
+	} else { \
+		run_one_opecode<primary, false>(); \
+	} \
+} while(0)
+#else
+#define RUN_ONE_OPECODE(primary) run_one_opecode<primary, false>()
+#endif
+
+// run one opecode of primary cpu, event_icount may have the clocks carried over
+// from the previous opecodes in batch mode
+int Z80::run_primary_opecode()
+{
+	icount = in_op_icount = 0;
+	RUN_ONE_OPECODE(true);
+	if(idle_skip && PC <= prevpc && !(wait || wait_icount > 0)) {
+		check_idle_loop();
+	}
+	if(wait || wait_icount > 0) {
+		event_icount = (-icount) - in_op_icount;
+		#ifdef _DEBUG
+			assert(event_icount >= 0);
+		#endif
+		if(event_icount > 0) wait_icount += event_icount;
+		// clocks of the iteration are not fixed while waiting
+		idle_dirty = true;
+	}
+	#ifdef USE_DEBUGGER
+		total_icount += (-icount);
+	#endif
+	// run dma once
+	#ifdef SINGLE_MODE_DMA
+		if(d_dma && dma_icount == 0 && !(wait || wait_icount > 0)) {
+			d_dma->do_dma();
+		}
+	#endif
+	return (-icount);
+}
+
 int Z80::run(int clock)
 {
 	if(clock == -1) {
@@ -2181,29 +2537,43 @@ int Z80::run(int clock)
 			return icount;
 		} else {
 			// run only one opcode
-			icount = event_icount = in_op_icount = 0;
-			run_one_opecode();
-			if(wait || wait_icount > 0) {
-				event_icount = (-icount) - in_op_icount;
-				#ifdef _DEBUG
-					assert(event_icount >= 0);
-				#endif
-				if(event_icount > 0) wait_icount += event_icount;
+			event_icount = 0;
+			event_margin = update_event_in_op(0);
+			return run_primary_opecode();
+		}
+	} else if(is_primary) {
+		// this is primary cpu in batch mode: run opecodes until the given clocks are done
+		if(wait || wait_icount > 0 || busreq || dma_icount > 0) {
+			return Z80::run(-1);
+		}
+		event_icount = 0;
+		event_margin = update_event_in_op(0);
+		int passed_icount = run_primary_opecode();
+		while(passed_icount < clock && !(wait || wait_icount > 0 || busreq || dma_icount > 0)) {
+			// remaining clocks of this opecode are carried over to the next opecode,
+			// and the event is updated before they reach the next event clock,
+			// so that the next opecode starts at the exact event clock as if it is
+			// run by drive() one by one
+			event_icount += (-icount) - in_op_icount;
+			if(event_icount > 0 && event_icount >= event_margin) {
+				event_margin = update_event_in_op(event_icount);
+				event_icount = 0;
 			}
-			#ifdef USE_DEBUGGER
-				total_icount += (-icount);
-			#endif
-			// run dma once
-			#ifdef SINGLE_MODE_DMA
-				if(d_dma && dma_icount == 0 && !(wait || wait_icount > 0)) {
-					d_dma->do_dma();
-				}
-			#endif
-			return (-icount);
+			passed_icount += run_primary_opecode();
 		}
+		return passed_icount;
 	} else if((icount += clock) > 0) {
+
 		int first_icount = icount;
 		int tmp_icount;
+		run_icount = clock;
+		
+		// external inputs may be changed since the previous call, so the iteration
+		// is not trusted if it has read any input before this call
+		if(idle_input) {
+			idle_dirty = true;
+		}
+		idle_icount += clock;
 		
 		if(busreq && !wait) {
 			if(dma_icount > 0) {
@@ -2235,7 +2605,10 @@ int Z80::run(int clock)
 					#ifdef USE_DEBUGGER
 						tmp_icount = icount;
 					#endif
-					run_one_opecode();
+					RUN_ONE_OPECODE(false);
+					if(idle_skip && PC <= prevpc) {
+						check_idle_loop();
+					}
 					#ifdef USE_DEBUGGER
 						total_icount += tmp_icount - icount;
 					#endif
@@ -2260,29 +2633,100 @@ int Z80::run(int clock)
 		}
 		return first_icount - icount;
 	} else {
+		idle_icount += clock;
 		return 0;
 	}
 }
 
+void Z80::check_idle_loop()
+{
+	// this is called when cpu jumps backward to the loop head, and if the registers are
+	// same as the previous arrival and nothing is written (and only status ports are polled)
+	// while one iteration, the next iterations are exactly same until any input is changed
+	#define IDLE_REGS_EQUAL(r) (idle_regs.r == r)
+	#define IDLE_PAIRS_EQUAL(r) (idle_regs.r.d == r.d)
+	bool same = !idle_dirty && PC == idle_pc &&
+	   IDLE_PAIRS_EQUAL(sp) && IDLE_PAIRS_EQUAL(af) && IDLE_PAIRS_EQUAL(bc) && IDLE_PAIRS_EQUAL(de) &&
+	   IDLE_PAIRS_EQUAL(hl) && IDLE_PAIRS_EQUAL(ix) && IDLE_PAIRS_EQUAL(iy) && IDLE_PAIRS_EQUAL(wz) &&
+	   IDLE_PAIRS_EQUAL(af2) && IDLE_PAIRS_EQUAL(bc2) && IDLE_PAIRS_EQUAL(de2) && IDLE_PAIRS_EQUAL(hl2) &&
+	   IDLE_REGS_EQUAL(intr_req_bit) && IDLE_REGS_EQUAL(I) && IDLE_REGS_EQUAL(im) &&
+	   IDLE_REGS_EQUAL(iff1) && IDLE_REGS_EQUAL(iff2) && IDLE_REGS_EQUAL(after_halt) &&
+	   IDLE_REGS_EQUAL(after_di) && IDLE_REGS_EQUAL(after_ei) && IDLE_REGS_EQUAL(after_ldair);
+	#undef IDLE_REGS_EQUAL
+	#undef IDLE_PAIRS_EQUAL
+#ifdef USE_DEBUGGER
+	if(d_debugger->now_debugging) {
+		same = false;
+	}
+#endif
+	int loops = 0, loop_icount = 0;
+	
+	if(is_primary) {
+		// inputs of primary cpu are changed only by events, so skip iterations that will be
+		// done before the next event (except sound mixing) is fired
+		uint32_t cur_clock = get_current_clock() + (-icount) - in_op_icount + event_icount;
+		uint32_t horizon_clock = get_current_clock() + get_clocks_until_input_event();
+		if(same && (int)(idle_horizon_clock - cur_clock) >= 0) {
+			loop_icount = (int)(cur_clock - idle_clock);
+			int idle_icount = (int)(horizon_clock - cur_clock);
+			if(loop_icount > 0 && idle_icount >= loop_icount) {
+				loops = idle_icount / loop_icount;
+			}
+		}
+		idle_clock = cur_clock + loops * loop_icount;
+		idle_horizon_clock = horizon_clock;
+	} else {
+		// inputs of sub cpu are changed only between run() calls, so skip iterations that
+		// end within the given clocks, and run the one across the end of them so that its
+		// inputs are read at the same clocks as without skipping
+		loop_icount = idle_icount - icount;
+		if(same && loop_icount > 0 && icount > 0) {
+			loops = icount / loop_icount;
+		}
+	}
+	if(loops > 0) {
+		int skip_icount = loops * loop_icount;
+		icount -= skip_icount;
+		R += (uint8_t)(loops * (uint8_t)(R - idle_R));
+		idle_skipped_clocks += skip_icount;
+	}
+	
+	// start the next iteration
+	idle_dirty = idle_input = false;
+	idle_pc = PC;
+	idle_icount = icount;
+	idle_R = R;
+	idle_regs.sp = sp; idle_regs.af = af; idle_regs.bc = bc; idle_regs.de = de;
+	idle_regs.hl = hl; idle_regs.ix = ix; idle_regs.iy = iy; idle_regs.wz = wz;
+	idle_regs.af2 = af2; idle_regs.bc2 = bc2; idle_regs.de2 = de2; idle_regs.hl2 = hl2;
+	idle_regs.intr_req_bit = intr_req_bit;
+	idle_regs.I = I; idle_regs.im = im; idle_regs.iff1 = iff1; idle_regs.iff2 = iff2;
+	idle_regs.after_halt = after_halt; idle_regs.after_di = after_di;
+	idle_regs.after_ei = after_ei; idle_regs.after_ldair = after_ldair;
+}
+
+template <bool PRIMARY, bool DEBUGGING>
 void Z80::run_one_opecode()
 {
 	if(!after_ei) {
 #ifdef USE_DEBUGGER
-		if(d_debugger->now_debugging) {
+		if(DEBUGGING && d_debugger->now_debugging) {
 			d_mem = d_io = d_debugger;
+			mem_pages = NULL;
 			
 			// not just after EI is done
 			if(prev_after_ei && !after_di) {
 				// EI and any instruction (ex. RET, not DI/EI) are done
 				d_pic->notify_intr_ei();
 			}
-			check_interrupt();
+			check_interrupt<PRIMARY>();
 			
 			if(!d_debugger->now_going) {
 				d_debugger->now_suspended = true;
 			}
 			d_mem = d_mem_stored;
 			d_io = d_io_stored;
+			mem_pages = mem_pages_stored;
 		} else {
 #endif
 			// not just after EI is done
@@ -2290,7 +2734,7 @@ void Z80::run_one_opecode()
 				// EI and any instruction (ex. RET, not DI/EI) are done
 				d_pic->notify_intr_ei();
 			}
-			check_interrupt();
+			check_interrupt<PRIMARY>();
 #ifdef USE_DEBUGGER
 		}
 #endif
@@ -2302,7 +2746,7 @@ void Z80::run_one_opecode()
 	after_ldair = false;
 	
 #ifdef USE_DEBUGGER
-	bool now_debugging = d_debugger->now_debugging;
+	bool now_debugging = DEBUGGING && d_debugger->now_debugging;
 	if(now_debugging) {
 		d_debugger->check_break_points(PC);
 		if(d_debugger->now_suspended) {
@@ -2316,11 +2760,12 @@ void Z80::run_one_opecode()
 		}
 		if(d_debugger->now_debugging) {
 			d_mem = d_io = d_debugger;
+			mem_pages = NULL;
 		} else {
 			now_debugging = false;
 		}
 		d_debugger->add_cpu_trace(PC);
-		OP(FETCHOP());
+		OP<PRIMARY, false>(FETCHOP<PRIMARY, false>());
 #if HAS_LDAIR_QUIRK
 		if(after_ldair) {
 			F &= ~PF;	// reset parity flag after LD A,I or LD A,R
@@ -2332,11 +2777,18 @@ void Z80::run_one_opecode()
 			}
 			d_mem = d_mem_stored;
 			d_io = d_io_stored;
+			mem_pages = mem_pages_stored;
 		}
 	} else {
-		d_debugger->add_cpu_trace(PC);
+		if(DEBUGGING) {
+			d_debugger->add_cpu_trace(PC);
+		}
 #endif
-		OP(FETCHOP());
+		if(!DEBUGGING && uops != NULL) {
+			run_cached_opecode<PRIMARY>();
+		} else {
+			OP<PRIMARY, false>(FETCHOP<PRIMARY, false>());
+		}
 #if HAS_LDAIR_QUIRK
 		if(after_ldair) {
 			F &= ~PF;	// reset parity flag after LD A,I or LD A,R
@@ -2347,6 +2799,81 @@ void Z80::run_one_opecode()
 #endif
 }
 
+template <bool PRIMARY>
+inline void Z80::run_cached_opecode()
+{
+	// the block continues while opecodes fall through in the same 256 bytes,
+	// otherwise check that the page still maps the memory they are decoded from
+	if(PC != uop_next_pc) {
+		const mem_page_t *page = &mem_pages[PC >> 12];
+		if(page->slow) {
+			uop_next_pc = -1;
+			OP<PRIMARY, false>(FETCHOP<PRIMARY, false>());
+			return;
+		}
+		const uint8_t *src = page->read + (PC & 0xf00);
+		if(uop_tags[PC >> 8] != src) {
+			// remapped or written since decoded
+			for(int i = 0; i < 256; i++) {
+				uops[(PC & 0xff00) | i].len = 0;
+			}
+			uop_tags[PC >> 8] = src;
+		}
+		uop_page = page;
+	}
+	uop_t *uop = &uops[PC];
+	if(uop->len == 0) {
+		decode_uop(uop, uop_page->read + (PC & 0xfff), 0x100 - (PC & 0xff));
+	}
+	if(uop->len > sizeof(uop->code)) {
+		// prefixes are repeated or the opecode crosses the 256 bytes
+		uop_next_pc = -1;
+		OP<PRIMARY, false>(FETCHOP<PRIMARY, false>());
+		return;
+	}
+	uop_next_pc = ((PC & 0xff) + uop->len < 0x100) ? PC + uop->len : -1;
+	uop_fetch = uop->code;
+	OP<PRIMARY, true>(FETCHOP<PRIMARY, true>());
+}
+
+void Z80::decode_uop(uop_t *uop, const uint8_t *src, int remain)
+{
+	// count the bytes fetched by the opecode handlers
+	int len = 0;
+	uint8_t prefix = 0;
+	while(len < remain && len < (int)sizeof(uop->code)) {
+		uint8_t code = src[len++];
+		int operand = -1;
+		if(prefix == 0xed) {
+			operand = ed_operand[code];
+		} else if(prefix != 0) {
+			operand = xy_operand[code];
+		}
+		if(operand < 0) {
+			if(code == 0xdd || code == 0xed || code == 0xfd) {
+				prefix = code;
+				continue;
+			}
+			operand = op_operand[code];
+		}
+		if(len + operand <= remain && len + operand <= (int)sizeof(uop->code)) {
+			memcpy(uop->code, src, len + operand);
+			uop->len = len + operand;
+			return;
+		}
+		break;
+	}
+	uop->len = 0xff;
+}
+
+void Z80::flush_block_cache()
+{
+	memset(uop_tags, 0, sizeof(uop_tags));
+	uop_page = NULL;
+	uop_next_pc = -1;
+}
+
+template <bool PRIMARY>
 void Z80::check_interrupt()
 {
 	// check interrupt
@@ -2426,7 +2953,7 @@ void Z80::check_interrupt()
 			} else {
 				// mode 2
 				PUSH(pc);
-				RM16((vector & 0xff) | (I << 8), &pc);
+				RM16<PRIMARY>((vector & 0xff) | (I << 8), &pc);
 				icount -= cc_op[0xcd] + cc_ex[0xff];
 			}
 			iff1 = iff2 = 0;
@@ -2444,6 +2971,7 @@ void Z80::write_debug_data8(uint32_t addr, uint32_t data)
 {
 	int wait_tmp;
 	d_mem_stored->write_data8w(addr, data, &wait_tmp);
+	idle_dirty = true;
 }
 
 uint32_t Z80::read_debug_data8(uint32_t addr)
@@ -2456,6 +2984,7 @@ void Z80::write_debug_io8(uint32_t addr, uint32_t data)
 {
 	int wait_tmp;
 	d_io_stored->write_io8w(addr, data, &wait_tmp);
+	idle_dirty = true;
 }
 
 uint32_t Z80::read_debug_io8(uint32_t addr)
@@ -4026,6 +4555,10 @@ bool Z80::process_state(FILEIO* state_fio, bool loading)
 		prev_total_icount = total_icount;
 	}
 #endif
+	if(loading) {
+		idle_dirty = true;
+		flush_block_cache();
+	}
 	return true;
 }
 
@@ -15,6 +15,8 @@
 #include "../emu.h"
 #include "device.h"
 
+#define SIG_Z80_IDLE_POLL	4
+
 #ifdef HAS_NSC800
 #define SIG_NSC800_INT	0
 #define SIG_NSC800_RSTA	1
@@ -34,6 +36,7 @@ private:
 	--------------------------------------------------------------------------- */
 	
 	DEVICE *d_mem, *d_io, *d_pic;
+	const mem_page_t *mem_pages;
 #ifdef Z80_PSEUDO_BIOS
 	DEVICE *d_bios;
 #endif
@@ -43,11 +46,37 @@ private:
 #ifdef USE_DEBUGGER
 	DEBUGGER *d_debugger;
 	DEVICE *d_mem_stored, *d_io_stored;
+	const mem_page_t *mem_pages_stored;
 #endif
 	outputs_t outputs_busack;
 	
 	bool is_primary;
 	
+	// idle loop detection
+	bool idle_skip, idle_dirty, idle_input, idle_poll;
+	uint16_t idle_pc;
+	int idle_icount;
+	uint32_t idle_clock, idle_horizon_clock;
+	uint8_t idle_R;
+	struct {
+		pair32_t sp, af, bc, de, hl, ix, iy, wz, af2, bc2, de2, hl2;
+		uint32_t intr_req_bit;
+		uint8_t I, im, iff1, iff2;
+		bool after_halt, after_di, after_ei, after_ldair;
+	} idle_regs;
+	uint64_t idle_skipped_clocks;
+	
+	// pre-decoded block cache
+	typedef struct {
+		uint8_t code[4];	// opecode bytes
+		uint8_t len;		// 0 if not decoded yet
+	} uop_t;
+	uop_t *uops;				// decoded opecodes at each address
+	const uint8_t *uop_tags[256];		// memory each 256 bytes are decoded from
+	const mem_page_t *uop_page;		// page of the running block
+	const uint8_t *uop_fetch;		// next byte of the running opecode
+	int uop_next_pc;			// address where the running block continues
+	
 	/* ---------------------------------------------------------------------------
 	registers
 	--------------------------------------------------------------------------- */
@@ -59,6 +88,8 @@ private:
 	int icount;
 	int dma_icount;
 	int wait_icount, event_icount, in_op_icount;
+	int run_icount;	// clocks given to run()
+	int event_margin;
 	uint16_t prevpc;
 	pair32_t pc, sp, af, bc, de, hl, ix, iy, wz;
 	pair32_t af2, bc2, de2, hl2;
@@ -72,15 +103,17 @@ private:
 	uint32_t intr_req_bit, intr_pend_bit;
 	bool intr_enb;
 	
-	inline uint8_t RM8(uint32_t addr);
-	inline void WM8(uint32_t addr, uint8_t val);
-	inline void RM16(uint32_t addr, pair32_t *r);
-	inline void WM16(uint32_t addr, pair32_t *r);
-	inline uint8_t FETCHOP();
-	inline uint8_t FETCH8();
-	inline uint32_t FETCH16();
-	inline uint8_t IN8(uint32_t addr);
-	inline void OUT8(uint32_t addr, uint8_t val);
+	// opecodes are instantiated for primary/sub cpu, debugger on/off and
+	// whether they are fetched from memory or from the block cache
+	template <bool PRIMARY> inline uint8_t RM8(uint32_t addr);
+	template <bool PRIMARY> inline void WM8(uint32_t addr, uint8_t val);
+	template <bool PRIMARY> inline void RM16(uint32_t addr, pair32_t *r);
+	template <bool PRIMARY> inline void WM16(uint32_t addr, pair32_t *r);
+	template <bool PRIMARY, bool CACHED> inline uint8_t FETCHOP();
+	template <bool PRIMARY, bool CACHED> inline uint8_t FETCH8();
+	template <bool PRIMARY, bool CACHED> inline uint32_t FETCH16();
+	template <bool PRIMARY> inline uint8_t IN8(uint32_t addr);
+	template <bool PRIMARY> inline void OUT8(uint32_t addr, uint8_t val);
 	
 	inline uint8_t INC(uint8_t value);
 	inline uint8_t DEC(uint8_t value);
@@ -97,14 +130,20 @@ private:
 	inline uint8_t RES(uint8_t bit, uint8_t value);
 	inline uint8_t SET(uint8_t bit, uint8_t value);
 	
-	void OP_CB(uint8_t code);
-	void OP_XY(uint8_t code);
-	void OP_DD(uint8_t code);
-	void OP_FD(uint8_t code);
-	void OP_ED(uint8_t code);
-	void OP(uint8_t code);
-	void run_one_opecode();
-	void check_interrupt();
+	template <bool PRIMARY, bool CACHED> void OP_CB(uint8_t code);
+	template <bool PRIMARY, bool CACHED> void OP_XY(uint8_t code);
+	template <bool PRIMARY, bool CACHED> void OP_DD(uint8_t code);
+	template <bool PRIMARY, bool CACHED> void OP_FD(uint8_t code);
+	template <bool PRIMARY, bool CACHED> void OP_ED(uint8_t code);
+	template <bool PRIMARY, bool CACHED> void OP(uint8_t code);
+	template <bool PRIMARY, bool DEBUGGING> void run_one_opecode();
+	template <bool PRIMARY> inline void run_cached_opecode();
+	void decode_uop(uop_t *uop, const uint8_t *src, int remain);
+	void flush_block_cache();
+	void update_block_cache();
+	int run_primary_opecode();
+	template <bool PRIMARY> void check_interrupt();
+	void check_idle_loop();
 	
 	/* ---------------------------------------------------------------------------
 	debug
@@ -123,17 +162,27 @@ public:
 #ifdef SINGLE_MODE_DMA
 		d_dma = NULL;
 #endif
+		mem_pages = NULL;
 		initialize_output_signals(&outputs_busack);
 		is_primary = false;
+		idle_skip = false;
+		idle_dirty = idle_input = true;
+		idle_poll = false;
+		idle_clock = idle_horizon_clock = 0;
+		idle_skipped_clocks = 0;
+		uops = NULL;
+		flush_block_cache();
 		set_device_name(_T("Z80 CPU"));
 	}
 	~Z80() {}
 	
 	// common functions
 	void initialize();
+	void release();
 	void reset();
 	void special_reset();
 	int run(int clock);
+	void update_config();
 	void write_signal(int id, uint32_t data, uint32_t mask);
 	uint32_t read_signal(int id);
 	void set_intr_line(bool line, bool pending, uint32_t bit)
@@ -158,6 +207,21 @@ public:
 	{
 		return pc.w.l;
 	}
+	uint64_t get_idle_skipped_clocks()
+	{
+		return idle_skipped_clocks;
+	}
+	// memory at the address is written without this cpu
+	void invalidate_block_cache(uint32_t addr)
+	{
+		uop_tags[(addr >> 8) & 0xff] = NULL;
+		uop_next_pc = -1;
+	}
+	// memory pages are remapped, the running block has to look them up again
+	void notify_mem_pages_changed()
+	{
+		uop_next_pc = -1;
+	}
 #ifdef USE_DEBUGGER
 	bool is_cpu()
 	{
@@ -194,6 +258,10 @@ public:
 	{
 		d_mem = device;
 	}
+	void set_context_mem_pages(const mem_page_t* pages)
+	{
+		mem_pages = pages;
+	}
 	void set_context_io(DEVICE* device)
 	{
 		d_io = device;